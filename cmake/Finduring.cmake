@@ -0,0 +1,47 @@
+# Tries to find liburing headers and libraries
+#
+# Usage of this module as follows:
+#
+# find_package(uring)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# uring_ROOT_DIR  Set this variable to the root installation of liburing if the
+# module has problems finding the proper installation path.
+#
+# Variables defined by this module:
+#
+# uring_FOUND              System has liburing libs/headers uring_LIBRARIES The
+# liburing libraries uring_INCLUDE_DIR        The location of liburing headers
+
+find_package(PkgConfig QUIET)
+pkg_check_modules(PC_uring QUIET liburing)
+
+find_path(
+  uring_INCLUDE_DIR
+  NAMES liburing.h
+  HINTS ${uring_ROOT_DIR}/include ${PC_uring_INCLUDE_DIRS})
+
+find_library(
+  uring_LIBRARIES
+  NAMES uring
+  HINTS ${uring_ROOT_DIR}/lib ${PC_uring_LIBRARY_DIRS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(uring DEFAULT_MSG uring_LIBRARIES
+                                  uring_INCLUDE_DIR)
+
+mark_as_advanced(uring_ROOT_DIR uring_LIBRARIES uring_INCLUDE_DIR)
+
+if (uring_FOUND)
+  message(STATUS "Found liburing: ${uring_LIBRARIES}")
+endif ()
+
+# create IMPORTED target for liburing dependency
+if (uring_FOUND AND NOT TARGET uring::uring)
+  add_library(uring::uring UNKNOWN IMPORTED GLOBAL)
+  set_target_properties(
+    uring::uring PROPERTIES IMPORTED_LOCATION "${uring_LIBRARIES}"
+                            INTERFACE_INCLUDE_DIRECTORIES "${uring_INCLUDE_DIR}")
+endif ()
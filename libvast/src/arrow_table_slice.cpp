@@ -18,13 +18,13 @@
 #  include "vast/arrow_table_slice.hpp"
 
 #  include "vast/arrow_table_slice_builder.hpp"
+#  include "vast/detail/assert.hpp"
 #  include "vast/detail/byte_swap.hpp"
 #  include "vast/detail/narrow.hpp"
 #  include "vast/detail/overload.hpp"
 #  include "vast/die.hpp"
 #  include "vast/error.hpp"
 #  include "vast/fbs/table_slice.hpp"
-#  include "vast/fbs/utils.hpp"
 #  include "vast/logger.hpp"
 #  include "vast/value_index.hpp"
 
@@ -32,6 +32,7 @@
 #  include <arrow/io/api.h>
 #  include <arrow/ipc/api.h>
 
+#  include <tuple>
 #  include <type_traits>
 
 namespace vast {
@@ -588,17 +589,26 @@ template <class FlatBuffer>
 arrow_table_slice<FlatBuffer>::arrow_table_slice(
   const FlatBuffer& slice) noexcept
   : slice_{slice}, state_{} {
-  if (auto err = fbs::deserialize_bytes(slice_.layout(), state_.layout))
-    die("failed to deserialize layout: " + render(err));
+  auto serialized_layout = span<const std::byte>{};
+  if (auto layout = slice_.layout())
+    serialized_layout = {reinterpret_cast<const std::byte*>(layout->data()),
+                         layout->size()};
+  std::tie(state_.layout_id, state_.layout)
+    = layout_interner::instance().resolve(slice_.layout_id(),
+                                          serialized_layout);
+  if (!state_.layout)
+    die("failed to resolve layout");
   auto decoder = record_batch_decoder{};
   state_.record_batch = decoder.decode(slice.schema(), slice.record_batch());
 }
 
 template <class FlatBuffer>
-arrow_table_slice<FlatBuffer>::arrow_table_slice(const FlatBuffer& slice,
-                                                 record_type layout) noexcept
+arrow_table_slice<FlatBuffer>::arrow_table_slice(
+  const FlatBuffer& slice, const record_type& layout) noexcept
   : slice_{slice}, state_{} {
-  state_.layout = std::move(layout);
+  VAST_ASSERT(slice_.layout_id() != 0);
+  state_.layout_id = slice_.layout_id();
+  state_.layout = layout_interner::instance().intern(state_.layout_id, layout);
   auto decoder = record_batch_decoder{};
   state_.record_batch = decoder.decode(slice.schema(), slice.record_batch());
 }
@@ -612,7 +622,12 @@ arrow_table_slice<FlatBuffer>::~arrow_table_slice() noexcept {
 
 template <class FlatBuffer>
 const record_type& arrow_table_slice<FlatBuffer>::layout() const noexcept {
-  return state_.layout;
+  return *state_.layout;
+}
+
+template <class FlatBuffer>
+layout_fingerprint arrow_table_slice<FlatBuffer>::layout_id() const noexcept {
+  return state_.layout_id;
 }
 
 template <class FlatBuffer>
@@ -637,9 +652,9 @@ void arrow_table_slice<FlatBuffer>::append_column_to_index(
   if (auto&& batch = record_batch()) {
     auto f = index_applier{offset, index};
     auto array = batch->column(detail::narrow_cast<int>(column));
-    auto offset = state_.layout.offset_from_index(column);
+    auto offset = state_.layout->offset_from_index(column);
     VAST_ASSERT(offset);
-    decode(state_.layout.at(*offset)->type, *array, f);
+    decode(state_.layout->at(*offset)->type, *array, f);
   }
 }
 
@@ -650,16 +665,16 @@ arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
   auto&& batch = record_batch();
   VAST_ASSERT(batch);
   auto array = batch->column(detail::narrow_cast<int>(column));
-  auto offset = state_.layout.offset_from_index(column);
+  auto offset = state_.layout->offset_from_index(column);
   VAST_ASSERT(offset);
-  return value_at(state_.layout.at(*offset)->type, *array, row);
+  return value_at(state_.layout->at(*offset)->type, *array, row);
 }
 
 template <class FlatBuffer>
 data_view arrow_table_slice<FlatBuffer>::at(table_slice::size_type row,
                                             table_slice::size_type column,
                                             const type& t) const {
-  VAST_ASSERT(state_.layout.at(*state_.layout.offset_from_index(column))->type
+  VAST_ASSERT(state_.layout->at(*state_.layout->offset_from_index(column))->type
               == t);
   auto&& batch = record_batch();
   VAST_ASSERT(batch);
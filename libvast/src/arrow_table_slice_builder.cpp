@@ -255,6 +255,53 @@ public:
       return false;
   }
 
+  bool reserve(const table_slice_builder::column_view& xs) override {
+    auto f = [&](const auto& values) {
+      using value_type = typename std::decay_t<decltype(values)>::value_type;
+      if constexpr (std::is_same_v<value_type, typename Trait::view_type>) {
+        auto n = detail::narrow_cast<int64_t>(values.size());
+        if (!arrow_builder_->Reserve(n).ok())
+          return false;
+        if constexpr (std::is_same_v<value_type, std::string_view>) {
+          auto bytes = size_t{0};
+          for (auto x : values)
+            bytes += x.size();
+          auto m = detail::narrow_cast<int64_t>(bytes);
+          return arrow_builder_->ReserveData(m).ok();
+        }
+        return true;
+      } else {
+        return false;
+      }
+    };
+    return caf::visit(f, xs);
+  }
+
+  bool append(const table_slice_builder::column_view& xs) override {
+    auto f = [&](const auto& values) {
+      using value_type = typename std::decay_t<decltype(values)>::value_type;
+      if constexpr (std::is_same_v<value_type, typename Trait::view_type>) {
+        auto n = detail::narrow_cast<int64_t>(values.size());
+        // Values with the same representation in VAST and Arrow are copied
+        // in one go, all others one by one into the reserved memory.
+        if constexpr (detail::is_any_v<value_type, integer, count, real>) {
+          return arrow_builder_->AppendValues(values.data(), n).ok();
+        } else if constexpr (std::is_same_v<value_type, bool>) {
+          auto ptr = reinterpret_cast<const uint8_t*>(values.data());
+          return arrow_builder_->AppendValues(ptr, n).ok();
+        } else {
+          for (auto x : values)
+            if (!Trait::append(*arrow_builder_, x))
+              return false;
+          return true;
+        }
+      } else {
+        return false;
+      }
+    };
+    return caf::visit(f, xs);
+  }
+
   std::shared_ptr<arrow::Array> finish() override {
     std::shared_ptr<arrow::Array> result;
     if (!arrow_builder_->Finish(&result).ok())
@@ -396,6 +443,14 @@ arrow_table_slice_builder::column_builder::~column_builder() noexcept {
   // nop
 }
 
+bool arrow_table_slice_builder::column_builder::reserve(const column_view&) {
+  return false;
+}
+
+bool arrow_table_slice_builder::column_builder::append(const column_view&) {
+  return false;
+}
+
 std::unique_ptr<arrow_table_slice_builder::column_builder>
 arrow_table_slice_builder::column_builder::make(const type& t,
                                                 arrow::MemoryPool* pool) {
@@ -449,70 +504,90 @@ size_t arrow_table_slice_builder::columns() const noexcept {
   return flat_layout_.fields.size();
 }
 
-table_slice arrow_table_slice_builder::finish(
-  [[maybe_unused]] span<const std::byte> serialized_layout) {
+table_slice
+arrow_table_slice_builder::finish(span<const std::byte> serialized_layout) {
   // Sanity check: If this triggers, the calls to add() did not match the number
   // of fields in the layout.
   VAST_ASSERT(column_ == 0);
+  // Assemble the record batch from the column builders.
+  auto columns = std::vector<std::shared_ptr<arrow::Array>>{};
+  columns.reserve(column_builders_.size());
+  for (auto&& builder : column_builders_)
+    columns.emplace_back(builder->finish());
+  auto record_batch
+    = arrow::RecordBatch::Make(schema_, rows_, std::move(columns));
+  // Reset the builder state.
+  rows_ = {};
+  return finish(serialized_layout, *record_batch);
+}
+
+table_slice arrow_table_slice_builder::create(
+  const std::shared_ptr<arrow::RecordBatch>& record_batch,
+  const record_type& layout, size_t initial_buffer_size) {
+  auto builder = caf::intrusive_ptr<arrow_table_slice_builder>{
+    new arrow_table_slice_builder{layout, initial_buffer_size}, false};
+  VAST_ASSERT(builder->schema_->Equals(*record_batch->schema()));
+  return builder->finish({}, *record_batch);
+}
+
+size_t arrow_table_slice_builder::rows() const noexcept {
+  return rows_;
+}
+
+table_slice_encoding
+arrow_table_slice_builder::implementation_id() const noexcept {
+  return table_slice_encoding::arrow;
+}
+
+void arrow_table_slice_builder::reserve(size_t num_rows) {
+  // Reserving is only an optimization, so we can ignore failures here.
+  auto n = detail::narrow_cast<int64_t>(num_rows);
+  for (auto& builder : column_builders_) {
+    [[maybe_unused]] auto status = builder->arrow_builder()->Reserve(n);
+  }
+}
+
+// -- implementation details ---------------------------------------------------
+
+table_slice
+arrow_table_slice_builder::finish(span<const std::byte> serialized_layout,
+                                  const arrow::RecordBatch& record_batch) {
   // Pack layout.
-  auto layout_buffer
-    = serialized_layout.empty()
-        ? *fbs::serialize_bytes(builder_, layout())
-        : builder_.CreateVector(
-          reinterpret_cast<const unsigned char*>(serialized_layout.data()),
-          serialized_layout.size());
+  if (serialized_layout.empty())
+    serialized_layout = this->serialized_layout();
+  auto layout_buffer = builder_.CreateVector(
+    reinterpret_cast<const unsigned char*>(serialized_layout.data()),
+    serialized_layout.size());
   // Pack schema.
 #if ARROW_VERSION_MAJOR >= 2
-  auto flat_schema = arrow::ipc::SerializeSchema(*schema_).ValueOrDie();
+  auto flat_schema
+    = arrow::ipc::SerializeSchema(*record_batch.schema()).ValueOrDie();
 #else
   auto flat_schema
-    = arrow::ipc::SerializeSchema(*schema_, nullptr).ValueOrDie();
+    = arrow::ipc::SerializeSchema(*record_batch.schema(), nullptr).ValueOrDie();
 #endif
   auto schema_buffer
     = builder_.CreateVector(flat_schema->data(), flat_schema->size());
   // Pack record batch.
-  auto columns = std::vector<std::shared_ptr<arrow::Array>>{};
-  columns.reserve(column_builders_.size());
-  for (auto&& builder : column_builders_)
-    columns.emplace_back(builder->finish());
-  auto record_batch
-    = arrow::RecordBatch::Make(schema_, rows_, std::move(columns));
   auto flat_record_batch
-    = arrow::ipc::SerializeRecordBatch(*record_batch,
+    = arrow::ipc::SerializeRecordBatch(record_batch,
                                        arrow::ipc::IpcWriteOptions::Defaults())
         .ValueOrDie();
   auto record_batch_buffer = builder_.CreateVector(flat_record_batch->data(),
                                                    flat_record_batch->size());
   // Create Arrow-encoded table slices.
   auto arrow_table_slice_buffer = fbs::table_slice::arrow::Createv0(
-    builder_, layout_buffer, schema_buffer, record_batch_buffer);
+    builder_, layout_buffer, schema_buffer, record_batch_buffer, layout_id());
   // Create and finish table slice.
   auto table_slice_buffer
     = fbs::CreateTableSlice(builder_, fbs::table_slice::TableSlice::arrow_v0,
                             arrow_table_slice_buffer.Union());
   fbs::FinishTableSliceBuffer(builder_, table_slice_buffer);
-  // Reset the builder state.
-  rows_ = {};
   // Create the table slice from the chunk.
   auto chunk = fbs::release(builder_);
   return table_slice{std::move(chunk), table_slice::verify::no, layout()};
 }
 
-size_t arrow_table_slice_builder::rows() const noexcept {
-  return rows_;
-}
-
-table_slice_encoding
-arrow_table_slice_builder::implementation_id() const noexcept {
-  return table_slice_encoding::arrow;
-}
-
-void arrow_table_slice_builder::reserve([[maybe_unused]] size_t num_rows) {
-  // nop
-}
-
-// -- implementation details ---------------------------------------------------
-
 arrow_table_slice_builder::arrow_table_slice_builder(record_type layout,
                                                      size_t initial_buffer_size)
   : table_slice_builder{std::move(layout)},
@@ -538,6 +613,25 @@ bool arrow_table_slice_builder::add_impl(data_view x) {
   return true;
 }
 
+bool arrow_table_slice_builder::append_columns_impl(
+  span<const column_view> columns) {
+  // A batch must not begin in the middle of a row.
+  VAST_ASSERT(column_ == 0);
+  VAST_ASSERT(columns.size() == column_builders_.size());
+  // Appending to reserved memory cannot fail, so reserving in all column
+  // builders first ensures that either all columns grow or none does.
+  for (size_t i = 0; i < columns.size(); ++i)
+    if (!column_builders_[i]->reserve(columns[i]))
+      return false;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    [[maybe_unused]] auto appended = column_builders_[i]->append(columns[i]);
+    VAST_ASSERT(appended);
+  }
+  rows_ += caf::visit([](const auto& values) { return values.size(); },
+                      columns[0]);
+  return true;
+}
+
 // -- utility functions --------------------------------------------------------
 
 std::shared_ptr<arrow::Schema> make_arrow_schema(const record_type& t) {
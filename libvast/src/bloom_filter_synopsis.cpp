@@ -14,6 +14,9 @@
 #include "vast/bloom_filter_synopsis.hpp"
 
 #include <vast/detail/assert.hpp>
+#include <vast/detail/string.hpp>
+
+#include <string_view>
 
 namespace vast {
 
@@ -25,15 +28,45 @@ type annotate_parameters(type type, const bloom_filter_parameters& params) {
   return std::move(type).attributes({{"synopsis", std::move(v)}});
 }
 
-caf::optional<bloom_filter_parameters> parse_parameters(const type& x) {
+type annotate_blocked_parameters(type type,
+                                 const bloom_filter_parameters& params) {
+  using namespace std::string_literals;
+  auto v = "blocked_bloomfilter("s + std::to_string(*params.n) + ','
+           + std::to_string(*params.p) + ')';
+  // Replaces any previously existing attributes.
+  return std::move(type).attributes({{"synopsis", std::move(v)}});
+}
+
+namespace {
+
+constexpr auto blocked_prefix = std::string_view{"blocked_"};
+
+const std::string* synopsis_attribute(const type& x) {
   auto pred = [](auto& attr) {
     return attr.key == "synopsis" && attr.value != caf::none;
   };
   auto i = std::find_if(x.attributes().begin(), x.attributes().end(), pred);
   if (i == x.attributes().end())
-    return caf::none;
+    return nullptr;
   VAST_ASSERT(i->value);
-  return parse_parameters(*i->value);
+  return &*i->value;
+}
+
+} // namespace
+
+bool has_blocked_parameters(const type& x) {
+  auto attr = synopsis_attribute(x);
+  return attr != nullptr && detail::starts_with(*attr, blocked_prefix);
+}
+
+caf::optional<bloom_filter_parameters> parse_parameters(const type& x) {
+  auto attr = synopsis_attribute(x);
+  if (!attr)
+    return caf::none;
+  auto value = std::string_view{*attr};
+  if (detail::starts_with(value, blocked_prefix))
+    value.remove_prefix(blocked_prefix.size());
+  return parse_parameters(value);
 }
 
 } // namespace vast
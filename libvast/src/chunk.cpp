@@ -25,6 +25,7 @@
 #include <caf/serializer.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <fcntl.h>
 #include <memory>
@@ -110,6 +111,25 @@ caf::expected<chunk::size_type> chunk::incore() const noexcept {
 #endif
 }
 
+caf::error chunk::prefetch() const noexcept {
+#if VAST_LINUX || VAST_BSD || VAST_MACOS
+  if (size() == 0)
+    return caf::none;
+  // madvise(2) requires a page-aligned address, so we widen the range to the
+  // start of the page that contains the first byte of the chunk.
+  auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto first = reinterpret_cast<uintptr_t>(data());
+  auto aligned = first & ~(page_size - 1);
+  if (madvise(reinterpret_cast<void*>(aligned), size() + (first - aligned),
+              MADV_WILLNEED))
+    return caf::make_error(ec::system_error,
+                           "failed in madvise(2):", std::strerror(errno));
+  return caf::none;
+#else
+  return caf::make_error(ec::unimplemented);
+#endif
+}
+
 chunk::iterator chunk::begin() const noexcept {
   return view_.begin();
 }
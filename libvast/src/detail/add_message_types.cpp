@@ -32,6 +32,9 @@
 #include "vast/subnet.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/component_registry.hpp"
+#include "vast/system/query_order.hpp"
+#include "vast/system/query_profile.hpp"
+#include "vast/system/query_scheduler.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/type_registry.hpp"
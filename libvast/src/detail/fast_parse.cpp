@@ -0,0 +1,211 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/fast_parse.hpp"
+
+#include "vast/address.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
+#include "vast/time.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+namespace vast::detail {
+
+namespace {
+
+// The largest number of decimal digits that we accumulate without risking
+// overflow or a loss of precision when converting the result to a double.
+constexpr size_t max_exact_digits = 15;
+
+// Exact powers of ten that we use for scaling the fractional part of a real.
+// They match the results of std::pow for the same exponents.
+constexpr double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                    1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15};
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Consumes up to `max` decimal digits at the beginning of `x` and returns the
+// number of consumed digits.
+size_t accumulate(std::string_view x, size_t max, uint64_t& result) {
+  size_t i = 0;
+  for (result = 0; i < x.size() && i < max && is_digit(x[i]); ++i)
+    result = result * 10 + (x[i] - '0');
+  return i;
+}
+
+// Parses exactly two decimal digits.
+bool parse_two_digits(const char* p, int& result) {
+  if (!is_digit(p[0]) || !is_digit(p[1]))
+    return false;
+  result = (p[0] - '0') * 10 + (p[1] - '0');
+  return true;
+}
+
+// Parses an IPv6 address in its textual representation without an embedded
+// IPv4 address. For this subset, the generic parser's grammar and inet_pton
+// agree on what constitutes a valid address, so we can skip the former.
+bool parse_v6(std::string_view x, address& result) {
+  char buf[INET6_ADDRSTRLEN];
+  if (x.size() < 2 || x.size() >= sizeof(buf))
+    return false;
+  for (auto c : x)
+    if (c != ':' && !std::isxdigit(static_cast<unsigned char>(c)))
+      return false;
+  std::memcpy(buf, x.data(), x.size());
+  buf[x.size()] = '\0';
+  alignas(uint64_t) uint8_t bytes[16];
+  if (::inet_pton(AF_INET6, buf, bytes) != 1)
+    return false;
+  result = address::v6(bytes, address::network);
+  return true;
+}
+
+} // namespace
+
+bool fast_parse_count(std::string_view x, count& result) noexcept {
+  // Nineteen digits always fit into 64 bits; anything longer goes through
+  // the generic parser to retain its behavior.
+  uint64_t n;
+  auto digits = accumulate(x, 19, n);
+  if (digits == 0 || digits != x.size())
+    return false;
+  result = n;
+  return true;
+}
+
+bool fast_parse_integer(std::string_view x, integer& result) noexcept {
+  if (x.empty())
+    return false;
+  auto negative = x[0] == '-';
+  if (negative || x[0] == '+')
+    x.remove_prefix(1);
+  uint64_t n;
+  auto digits = accumulate(x, 18, n);
+  if (digits == 0 || digits != x.size())
+    return false;
+  result = negative ? -static_cast<integer>(n) : static_cast<integer>(n);
+  return true;
+}
+
+bool fast_parse_real(std::string_view x, real& result,
+                     bool require_dot) noexcept {
+  if (x.empty())
+    return false;
+  auto negative = x[0] == '-';
+  if (negative || x[0] == '+')
+    x.remove_prefix(1);
+  uint64_t integral;
+  auto integral_digits = accumulate(x, max_exact_digits + 1, integral);
+  if (integral_digits > max_exact_digits)
+    return false;
+  x.remove_prefix(integral_digits);
+  auto got_dot = !x.empty() && x[0] == '.';
+  if (!got_dot && (integral_digits == 0 || require_dot))
+    return false;
+  uint64_t fractional = 0;
+  size_t fractional_digits = 0;
+  if (got_dot) {
+    x.remove_prefix(1);
+    fractional_digits = accumulate(x, max_exact_digits + 1, fractional);
+    if (fractional_digits > max_exact_digits)
+      return false;
+    x.remove_prefix(fractional_digits);
+  }
+  if (!x.empty() || (integral_digits == 0 && fractional_digits == 0))
+    return false;
+  // Both parts are exactly representable as double, so the computation
+  // below matches the generic parser bit for bit.
+  auto a = static_cast<double>(integral);
+  if (fractional_digits > 0)
+    a += static_cast<double>(fractional) / powers_of_ten[fractional_digits];
+  result = negative ? -a : a;
+  return true;
+}
+
+bool fast_parse_seconds(std::string_view x, duration& result) noexcept {
+  real secs;
+  if (!fast_parse_real(x, secs))
+    return false;
+  result = std::chrono::duration_cast<duration>(double_seconds{secs});
+  return true;
+}
+
+bool fast_parse_ymdhms(std::string_view x, time& result) noexcept {
+  using namespace std::chrono;
+  // YYYY-MM-DDTHH:MM:SS is the shortest form we handle here.
+  if (x.size() < 19)
+    return false;
+  auto p = x.data();
+  int yrs;
+  int century;
+  if (!parse_two_digits(p, century) || !parse_two_digits(p + 2, yrs))
+    return false;
+  yrs += century * 100;
+  int mons;
+  int dys;
+  int hrs;
+  int mins;
+  if (yrs < 1900 || p[4] != '-' || !parse_two_digits(p + 5, mons)
+      || mons < 1 || mons > 12 || p[7] != '-'
+      || !parse_two_digits(p + 8, dys) || dys < 1 || dys > 31)
+    return false;
+  if (p[10] != 'T' && p[10] != ' ' && p[10] != '+')
+    return false;
+  if (!parse_two_digits(p + 11, hrs) || hrs > 23 || p[13] != ':'
+      || !parse_two_digits(p + 14, mins) || mins > 59 || p[16] != ':')
+    return false;
+  auto rest = x.substr(17);
+  if (rest.back() == 'Z')
+    rest.remove_suffix(1);
+  real secs;
+  if (!fast_parse_real(rest, secs, false) || secs < 0.0 || secs > 60.0)
+    return false;
+  sys_days ymd = ymdhms_parser{}.to_days(yrs, mons, dys);
+  auto delta = hours{hrs} + minutes{mins} + double_seconds{secs};
+  result = time{ymd} + duration_cast<vast::duration>(delta);
+  return true;
+}
+
+bool fast_parse_address(std::string_view x, address& result) noexcept {
+  if (x.find(':') != std::string_view::npos)
+    return parse_v6(x, result);
+  uint32_t n = 0;
+  for (auto i = 0; i < 4; ++i) {
+    if (i > 0) {
+      if (x.empty() || x[0] != '.')
+        return false;
+      x.remove_prefix(1);
+    }
+    uint64_t octet;
+    auto digits = accumulate(x, 3, octet);
+    if (digits == 0 || octet > 255)
+      return false;
+    x.remove_prefix(digits);
+    n = (n << 8) | static_cast<uint32_t>(octet);
+  }
+  if (!x.empty())
+    return false;
+  result = address::v4(&n);
+  return true;
+}
+
+} // namespace vast::detail
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/enumeration_synopsis.hpp"
+
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include <algorithm>
+
+namespace vast {
+
+namespace {
+
+std::bitset<enumeration_synopsis::capacity>
+to_bitset(const enumeration_synopsis::words_type& words) {
+  auto result = std::bitset<enumeration_synopsis::capacity>{};
+  for (size_t i = 0; i < result.size(); ++i)
+    if (words[i / 64] & (uint64_t{1} << (i % 64)))
+      result.set(i);
+  return result;
+}
+
+} // namespace
+
+enumeration_synopsis::enumeration_synopsis(vast::type x)
+  : synopsis{std::move(x)} {
+  VAST_ASSERT(caf::holds_alternative<enumeration_type>(type()));
+}
+
+enumeration_synopsis::enumeration_synopsis(const words_type& words)
+  : synopsis{enumeration_type{}}, values_{to_bitset(words)} {
+  // nop
+}
+
+void enumeration_synopsis::add(data_view x) {
+  VAST_ASSERT(caf::holds_alternative<view<enumeration>>(x));
+  values_.set(caf::get<view<enumeration>>(x));
+}
+
+caf::optional<bool>
+enumeration_synopsis::lookup(relational_operator op, data_view rhs) const {
+  auto contains = [&](data_view x) -> caf::optional<bool> {
+    if (auto e = caf::get_if<view<enumeration>>(&x))
+      return values_.test(*e);
+    return caf::none;
+  };
+  switch (op) {
+    case relational_operator::equal:
+      return contains(rhs);
+    case relational_operator::not_equal:
+      if (auto e = caf::get_if<view<enumeration>>(&rhs))
+        return !(values_.count() == 1 && values_.test(*e));
+      return caf::none;
+    case relational_operator::in:
+      if (auto xs = caf::get_if<view<list>>(&rhs)) {
+        for (auto x : **xs)
+          if (auto result = contains(x); result && *result)
+            return true;
+        return false;
+      }
+      return caf::none;
+    case relational_operator::not_in:
+      if (auto xs = caf::get_if<view<list>>(&rhs)) {
+        auto remaining = values_;
+        for (auto x : **xs)
+          if (auto e = caf::get_if<view<enumeration>>(&x))
+            remaining.reset(*e);
+        return remaining.any();
+      }
+      return caf::none;
+    default:
+      return caf::none;
+  }
+}
+
+bool enumeration_synopsis::equals(const synopsis& other) const noexcept {
+  if (typeid(other) != typeid(enumeration_synopsis))
+    return false;
+  auto& rhs = static_cast<const enumeration_synopsis&>(other);
+  return type() == rhs.type() && values_ == rhs.values_;
+}
+
+size_t enumeration_synopsis::memusage() const {
+  return sizeof(enumeration_synopsis);
+}
+
+caf::error enumeration_synopsis::serialize(caf::serializer& sink) const {
+  auto xs = words();
+  return sink(xs[0], xs[1], xs[2], xs[3]);
+}
+
+caf::error enumeration_synopsis::deserialize(caf::deserializer& source) {
+  auto xs = words_type{};
+  if (auto err = source(xs[0], xs[1], xs[2], xs[3]))
+    return err;
+  values_ = to_bitset(xs);
+  return caf::none;
+}
+
+const std::bitset<enumeration_synopsis::capacity>&
+enumeration_synopsis::values() const noexcept {
+  return values_;
+}
+
+enumeration_synopsis::words_type enumeration_synopsis::words() const noexcept {
+  auto result = words_type{};
+  for (size_t i = 0; i < capacity; ++i)
+    if (values_.test(i))
+      result[i / 64] |= uint64_t{1} << (i % 64);
+  return result;
+}
+
+std::optional<data> translate_enumeration(const type& t, const data& rhs) {
+  auto e = caf::get_if<enumeration_type>(&t);
+  if (!e)
+    return std::nullopt;
+  auto translate = [&](const data& x) -> data {
+    if (auto str = caf::get_if<std::string>(&x)) {
+      auto i = std::find(e->fields.begin(), e->fields.end(), *str);
+      if (i != e->fields.end())
+        return data{
+          static_cast<enumeration>(std::distance(e->fields.begin(), i))};
+    }
+    return x;
+  };
+  if (auto xs = caf::get_if<list>(&rhs)) {
+    auto result = list{};
+    result.reserve(xs->size());
+    for (const auto& x : *xs)
+      result.push_back(translate(x));
+    return data{std::move(result)};
+  }
+  return translate(rhs);
+}
+
+} // namespace vast
@@ -278,31 +278,22 @@ struct container_parser_builder {
 
 template <class Iterator>
 struct csv_parser_factory {
-  using result_type = reader::parser_type;
+  using result_type = rule<Iterator, data>;
 
-  csv_parser_factory(options opt, table_slice_builder_ptr bptr)
-    : opt_{std::move(opt)}, bptr_{std::move(bptr)} {
+  explicit csv_parser_factory(options opt) : opt_{std::move(opt)} {
     // nop
   }
 
-  template <class T>
-  struct add_t {
-    bool operator()(const caf::optional<T>& x) const {
-      return bptr_->add(make_data_view(x));
-    }
-    table_slice_builder_ptr bptr_;
-  };
-
   template <class T>
   result_type operator()(const T& t) const {
     if constexpr (std::is_same_v<T, duration_type>) {
-      auto make_duration_parser = [&](auto period) {
+      auto make_duration_parser = [&](auto period) -> result_type {
         // clang-format off
-        return (-parsers::real_opt_dot ->* [](double x) {
+        return parsers::real_opt_dot ->* [](double x) {
           using period_type = decltype(period);
           using double_duration = std::chrono::duration<double, period_type>;
           return std::chrono::duration_cast<duration>(double_duration{x});
-        }).with(add_t<duration>{bptr_});
+        };
         // clang-format on
       };
       if (auto attr = find_attribute(t, "unit")) {
@@ -324,33 +315,16 @@ struct csv_parser_factory {
         }
       }
       // If we do not have an explicit unit given, we require the unit suffix.
-      return (-parsers::duration).with(add_t<duration>{bptr_});
-    } else if constexpr (std::is_same_v<T, string_type>) {
-      return (-+(parsers::any - opt_.separator))
-        .with(add_t<std::string>{bptr_});
-    } else if constexpr (std::is_same_v<T, pattern_type>) {
-      return (-as<pattern>(as<std::string>(+(parsers::any - opt_.separator))))
-        .with(add_t<pattern>{bptr_});
-    } else if constexpr (std::is_same_v<T, enumeration_type>) {
-      auto to_enumeration = [t](std::string s) -> caf::optional<enumeration> {
-        auto i = std::find(t.fields.begin(), t.fields.end(), s);
-        if (i == t.fields.end()) {
-          VAST_WARN("csv reader failed to parse unexpected enum value {}", s);
-          return caf::none;
-        }
-        return detail::narrow_cast<enumeration>(
-          std::distance(t.fields.begin(), i));
-      };
-      // clang-format off
-      return ((+(parsers::any - opt_.separator))
-              ->* to_enumeration).with(add_t<enumeration>{bptr_});
-      // clang-format on
+      return parsers::duration ->* [](duration x) { return x; };
+    } else if constexpr (detail::is_any_v<T, string_type, pattern_type,
+                                          enumeration_type>) {
+      // The field parser handles these types without a fallback.
+      return {};
     } else if constexpr (detail::is_any_v<T, list_type, map_type>) {
-      return (-container_parser_builder<Iterator, data>{opt_}(t))
-        .with(add_t<data>{bptr_});
+      return container_parser_builder<Iterator, data>{opt_}(t);
     } else if constexpr (has_parser_v<type_to_data<T>>) {
       using value_type = type_to_data<T>;
-      return (-make_parser<value_type>{}).with(add_t<value_type>{bptr_});
+      return make_parser<value_type>{} ->* [](value_type x) { return x; };
     } else {
       VAST_ERROR("csv parser builder failed to fetch a parser for type "
                  "{}",
@@ -360,21 +334,17 @@ struct csv_parser_factory {
   }
 
   options opt_;
-  table_slice_builder_ptr bptr_;
 };
 
-template <class Iterator>
-caf::optional<reader::parser_type>
-make_csv_parser(const record_type& layout, table_slice_builder_ptr builder,
-                const options& opt) {
-  auto num_fields = layout.fields.size();
-  VAST_ASSERT(num_fields > 0);
-  auto factory = csv_parser_factory<Iterator>{opt, builder};
-  auto result = caf::visit(factory, layout.fields[0].type);
-  for (size_t i = 1; i < num_fields; ++i) {
-    auto p = caf::visit(factory, layout.fields[i].type);
-    result = result >> opt.separator >> std::move(p);
-  }
+std::vector<field_parser>
+make_csv_parsers(const record_type& layout, const options& opt) {
+  VAST_ASSERT(!layout.fields.empty());
+  auto factory = csv_parser_factory<field_parser::iterator_type>{opt};
+  std::vector<field_parser> result;
+  result.reserve(layout.fields.size());
+  for (auto& field : layout.fields)
+    result.emplace_back(field.type, field_parser::dialect::csv,
+                        caf::visit(factory, field.type));
   return result;
 }
 
@@ -395,7 +365,7 @@ vast::system::report reader::status() const {
   };
 }
 
-caf::expected<reader::parser_type> reader::read_header(std::string_view line) {
+caf::error reader::read_header(std::string_view line) {
   auto ws = ignore(*parsers::space);
   auto column_name = +(parsers::printable - opt_.separator);
   auto p = (ws >> column_name >> ws) % opt_.separator;
@@ -411,10 +381,22 @@ caf::expected<reader::parser_type> reader::read_header(std::string_view line) {
   if (!reset_builder(*layout))
     return caf::make_error(ec::parse_error, "unable to create a builder for "
                                             "layout");
-  auto parser = make_csv_parser<iterator_type>(*layout, builder_, opt_);
-  if (!parser)
-    return caf::make_error(ec::parse_error, "unable to generate a parser");
-  return *parser;
+  parsers_ = make_csv_parsers(*layout, opt_);
+  row_.resize(parsers_.size());
+  return caf::none;
+}
+
+bool reader::parse_line(std::string_view line) {
+  for (size_t i = 0; i < parsers_.size(); ++i) {
+    if (i > 0) {
+      if (line.empty() || line[0] != opt_.separator)
+        return false;
+      line.remove_prefix(1);
+    }
+    if (!parsers_[i].parse_prefix(line, opt_.separator, row_[i]))
+      return false;
+  }
+  return line.empty();
 }
 
 caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
@@ -428,16 +410,13 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
                  detail::pretty_type_name(this), lines_->line_number());
     return timed_out;
   };
-  if (!parser_) {
+  if (parsers_.empty()) {
     bool timed_out = next_line();
     if (timed_out)
       return ec::stalled;
-    auto p = read_header(lines_->get());
-    if (!p)
-      return p.error();
-    parser_ = *std::move(p);
+    if (auto err = read_header(lines_->get()))
+      return err;
   }
-  auto& p = *parser_;
   size_t produced = 0;
   while (produced < max_events) {
     // EOF check.
@@ -460,13 +439,19 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       continue;
     }
     ++num_lines_;
-    if (!p(line)) {
+    // We only hand complete rows to the builder, so that an invalid line
+    // cannot leave a partial row behind.
+    if (!parse_line(line)) {
       if (num_invalid_lines_ == 0)
         VAST_WARN("{} failed to parse line {} : {}",
                   detail::pretty_type_name(this), lines_->line_number(), line);
       ++num_invalid_lines_;
       continue;
     }
+    for (size_t i = 0; i < row_.size(); ++i)
+      if (!builder_->add(make_data_view(row_[i])))
+        return finish(callback, caf::make_error(ec::type_clash, "field", i,
+                                                "line", lines_->line_number()));
     ++produced;
     ++batch_events_;
     if (builder_->rows() == max_slice_size)
@@ -0,0 +1,230 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/format/field_parser.hpp"
+
+#include "vast/detail/fast_parse.hpp"
+#include "vast/detail/narrow.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/logger.hpp"
+#include "vast/pattern.hpp"
+#include "vast/type.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <ratio>
+
+namespace vast::format {
+
+namespace {
+
+template <class Period>
+duration scale_duration(double x) {
+  using double_duration = std::chrono::duration<double, Period>;
+  return std::chrono::duration_cast<duration>(double_duration{x});
+}
+
+duration (*make_scale(const type& t))(double) {
+  auto attr = find_attribute(t, "unit");
+  if (!attr || !attr->value)
+    return nullptr;
+  auto& unit = *attr->value;
+  if (unit == "ns")
+    return scale_duration<std::nano>;
+  if (unit == "us")
+    return scale_duration<std::micro>;
+  if (unit == "ms")
+    return scale_duration<std::milli>;
+  if (unit == "s")
+    return scale_duration<std::ratio<1>>;
+  if (unit == "min")
+    return scale_duration<std::ratio<60>>;
+  if (unit == "h")
+    return scale_duration<std::ratio<3600>>;
+  if (unit == "d")
+    return scale_duration<std::ratio<86400>>;
+  return nullptr;
+}
+
+// Reuses the allocation of a string that the data already holds.
+void assign_string(data& x, std::string_view str) {
+  if (auto s = caf::get_if<std::string>(&x))
+    s->assign(str.begin(), str.end());
+  else
+    x = std::string{str};
+}
+
+} // namespace
+
+field_parser::field_parser(const type& t, dialect d, rule_type fallback)
+  : fallback_{std::move(fallback)} {
+  auto csv = d == dialect::csv;
+  if (caf::holds_alternative<bool_type>(t)) {
+    kind_ = kind::boolean;
+  } else if (caf::holds_alternative<integer_type>(t)) {
+    kind_ = kind::integer;
+  } else if (caf::holds_alternative<count_type>(t)) {
+    kind_ = kind::count;
+  } else if (caf::holds_alternative<real_type>(t)) {
+    kind_ = kind::real;
+  } else if (caf::holds_alternative<duration_type>(t)) {
+    if (!csv)
+      kind_ = kind::seconds;
+    else if ((scale_ = make_scale(t)))
+      kind_ = kind::scaled_duration;
+  } else if (caf::holds_alternative<time_type>(t)) {
+    kind_ = csv ? kind::ymdhms : kind::unix_time;
+  } else if (caf::holds_alternative<string_type>(t)) {
+    kind_ = csv ? kind::string : kind::escaped_string;
+  } else if (caf::holds_alternative<pattern_type>(t)) {
+    // Zeek logs render patterns as strings.
+    kind_ = csv ? kind::pattern : kind::escaped_string;
+  } else if (auto e = caf::get_if<enumeration_type>(&t); e && csv) {
+    kind_ = kind::enumeration;
+    enumeration_ = e->fields;
+  } else if (caf::holds_alternative<address_type>(t)) {
+    kind_ = kind::address;
+  }
+}
+
+bool field_parser::parse(std::string_view field, data& x) const {
+  return parse_fast(field, x) || fallback_(field, x);
+}
+
+bool field_parser::parse_prefix(std::string_view& input, char separator,
+                                data& x) const {
+  auto field = input.substr(0, input.find(separator));
+  switch (kind_) {
+    default:
+      break;
+    case kind::string:
+      if (field.empty())
+        x = caf::none;
+      else
+        assign_string(x, field);
+      input.remove_prefix(field.size());
+      return true;
+    case kind::pattern:
+      if (field.empty())
+        x = caf::none;
+      else
+        x = pattern{std::string{field}};
+      input.remove_prefix(field.size());
+      return true;
+    case kind::enumeration: {
+      if (field.empty())
+        return false;
+      auto i = std::find(enumeration_.begin(), enumeration_.end(), field);
+      if (i == enumeration_.end()) {
+        VAST_WARN("csv reader failed to parse unexpected enum value {}",
+                  field);
+        return false;
+      }
+      x = detail::narrow_cast<enumeration>(
+        std::distance(enumeration_.begin(), i));
+      input.remove_prefix(field.size());
+      return true;
+    }
+  }
+  if (!field.empty() && parse_fast(field, x)) {
+    input.remove_prefix(field.size());
+    return true;
+  }
+  // Like the optional parser, we accept a field that we cannot parse as
+  // null and leave it to the caller to check for the separator.
+  auto f = input.begin();
+  auto l = input.end();
+  if (!fallback_(f, l, x))
+    x = caf::none;
+  input.remove_prefix(std::distance(input.begin(), f));
+  return true;
+}
+
+bool field_parser::parse_fast(std::string_view field, data& x) const {
+  switch (kind_) {
+    case kind::boolean:
+      if (field != "T" && field != "F")
+        return false;
+      x = field[0] == 'T';
+      return true;
+    case kind::integer: {
+      integer i;
+      if (!detail::fast_parse_integer(field, i))
+        return false;
+      x = i;
+      return true;
+    }
+    case kind::count: {
+      count c;
+      if (!detail::fast_parse_count(field, c))
+        return false;
+      x = c;
+      return true;
+    }
+    case kind::real: {
+      real r;
+      if (!detail::fast_parse_real(field, r))
+        return false;
+      x = r;
+      return true;
+    }
+    case kind::scaled_duration: {
+      real r;
+      if (!detail::fast_parse_real(field, r, false))
+        return false;
+      x = scale_(r);
+      return true;
+    }
+    case kind::seconds: {
+      duration d;
+      if (!detail::fast_parse_seconds(field, d))
+        return false;
+      x = d;
+      return true;
+    }
+    case kind::unix_time: {
+      duration d;
+      if (!detail::fast_parse_seconds(field, d))
+        return false;
+      x = time{d};
+      return true;
+    }
+    case kind::ymdhms: {
+      time t;
+      if (!detail::fast_parse_ymdhms(field, t))
+        return false;
+      x = t;
+      return true;
+    }
+    case kind::escaped_string:
+      if (field.empty())
+        return false;
+      if (field.find('\\') == std::string_view::npos)
+        assign_string(x, field);
+      else
+        x = detail::byte_unescape(field);
+      return true;
+    case kind::address: {
+      address a;
+      if (!detail::fast_parse_address(field, a))
+        return false;
+      x = a;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+} // namespace vast::format
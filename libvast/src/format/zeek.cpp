@@ -340,7 +340,7 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
           xs[i] = caf::none;
         else if (is_empty(i))
           xs[i] = construct(layout_.fields[i].type);
-        else if (!parsers_[i](fields[i], xs[i]))
+        else if (!parsers_[i].parse(fields[i], xs[i]))
           return finish(f, caf::make_error(ec::parse_error, "field", i, "line",
                                            lines_->line_number(),
                                            std::string{fields[i]}));
@@ -505,12 +505,12 @@ caf::error reader::parse_header() {
   // type and can now safely copy it.
   type_ = layout_;
   // Create Zeek parsers.
-  auto make_parser = [](const auto& type, const auto& set_sep) {
-    return make_zeek_parser<iterator_type>(type, set_sep);
-  };
-  parsers_.resize(layout_.fields.size());
-  for (size_t i = 0; i < layout_.fields.size(); i++)
-    parsers_[i] = make_parser(layout_.fields[i].type, set_separator_);
+  parsers_.clear();
+  parsers_.reserve(layout_.fields.size());
+  for (auto& field : layout_.fields)
+    parsers_.emplace_back(
+      field.type, field_parser::dialect::zeek,
+      make_zeek_parser<iterator_type>(field.type, set_separator_));
   return caf::none;
 }
 
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/hyperloglog.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/bit.hpp"
+#include "vast/error.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vast {
+
+hyperloglog::hyperloglog(uint8_t precision)
+  : precision_{precision}, registers_(size_t{1} << precision) {
+  VAST_ASSERT(min_precision <= precision && precision <= max_precision);
+}
+
+void hyperloglog::add(uint64_t digest) {
+  auto index = digest >> (64 - precision_);
+  auto rest = digest << precision_;
+  auto rank = rest == 0 ? 64 - precision_ + 1 : detail::countl_zero(rest) + 1;
+  auto& x = registers_[index];
+  x = std::max(x, static_cast<uint8_t>(rank));
+}
+
+void hyperloglog::merge(const hyperloglog& other) {
+  if (other.precision_ < precision_)
+    fold(other.precision_);
+  if (other.precision_ > precision_) {
+    auto copy = other;
+    copy.fold(precision_);
+    merge(copy);
+    return;
+  }
+  for (size_t i = 0; i < registers_.size(); ++i)
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+}
+
+void hyperloglog::fold(uint8_t precision) {
+  VAST_ASSERT(min_precision <= precision && precision <= precision_);
+  if (precision == precision_)
+    return;
+  // The bits of an old register index that do not make it into the new index
+  // become the leading bits of the remaining hash bits.
+  auto shift = precision_ - precision;
+  auto mask = (size_t{1} << shift) - 1;
+  auto result = std::vector<uint8_t>(size_t{1} << precision);
+  for (size_t i = 0; i < registers_.size(); ++i) {
+    if (registers_[i] == 0)
+      continue;
+    auto low = i & mask;
+    auto rank = low != 0 ? shift - detail::log2p1(low) + 1
+                         : shift + registers_[i];
+    auto& x = result[i >> shift];
+    x = std::max(x, static_cast<uint8_t>(rank));
+  }
+  precision_ = precision;
+  registers_ = std::move(result);
+}
+
+uint64_t hyperloglog::estimate() const {
+  auto m = static_cast<double>(registers_.size());
+  auto sum = 0.0;
+  size_t zeros = 0;
+  for (auto x : registers_) {
+    sum += std::ldexp(1.0, -static_cast<int>(x));
+    if (x == 0)
+      ++zeros;
+  }
+  auto alpha = [&] {
+    switch (registers_.size()) {
+      case 16:
+        return 0.673;
+      case 32:
+        return 0.697;
+      case 64:
+        return 0.709;
+      default:
+        return 0.7213 / (1.0 + 1.079 / m);
+    }
+  }();
+  auto result = alpha * m * m / sum;
+  // Fall back to linear counting for small cardinalities, where the raw
+  // estimate has a large bias.
+  if (result <= 2.5 * m && zeros > 0)
+    result = m * std::log(m / static_cast<double>(zeros));
+  return static_cast<uint64_t>(std::llround(result));
+}
+
+uint8_t hyperloglog::precision() const noexcept {
+  return precision_;
+}
+
+size_t hyperloglog::memusage() const {
+  return sizeof(*this) + registers_.capacity();
+}
+
+bool operator==(const hyperloglog& x, const hyperloglog& y) {
+  return x.precision_ == y.precision_ && x.registers_ == y.registers_;
+}
+
+caf::expected<flatbuffers::Offset<fbs::hyperloglog::v0>>
+pack(flatbuffers::FlatBufferBuilder& builder, const hyperloglog& x) {
+  auto registers = builder.CreateVector(x.registers_);
+  fbs::hyperloglog::v0Builder hyperloglog_builder(builder);
+  hyperloglog_builder.add_precision(x.precision_);
+  hyperloglog_builder.add_registers(registers);
+  return hyperloglog_builder.Finish();
+}
+
+caf::error unpack(const fbs::hyperloglog::v0& x, hyperloglog& y) {
+  auto precision = x.precision();
+  if (precision < hyperloglog::min_precision
+      || precision > hyperloglog::max_precision)
+    return caf::make_error(ec::format_error, "invalid hyperloglog precision",
+                           static_cast<uint32_t>(precision));
+  if (!x.registers() || x.registers()->size() != size_t{1} << precision)
+    return caf::make_error(ec::format_error, "invalid hyperloglog registers");
+  y.precision_ = precision;
+  y.registers_.assign(x.registers()->begin(), x.registers()->end());
+  return caf::none;
+}
+
+} // namespace vast
@@ -13,6 +13,7 @@
 
 #include "vast/index/address_index.hpp"
 
+#include "vast/detail/assert.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/index/container_lookup.hpp"
 #include "vast/type.hpp"
@@ -21,10 +22,41 @@
 #include <caf/serializer.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace vast {
 
+namespace {
+
+// Computes the union of the equality lookups for a sorted range of addresses
+// by descending into the byte indexes one byte at a time. Addresses that share
+// a prefix also share the intermediate bitmap for that prefix, and a prefix
+// that matches no row prunes all addresses below it.
+void probe_prefixes(const std::array<address_index::byte_index, 16>& bytes,
+                    std::vector<address>::const_iterator first,
+                    std::vector<address>::const_iterator last, size_t byte,
+                    const ids& prefix, ids& result) {
+  if (byte == bytes.size()) {
+    result |= prefix;
+    return;
+  }
+  while (first != last) {
+    auto value = first->data()[byte];
+    auto next = std::find_if(first, last, [&](const address& x) {
+      return x.data()[byte] != value;
+    });
+    auto matches = prefix;
+    matches &= bytes[byte].lookup(relational_operator::equal, value);
+    if (!all<0>(matches))
+      probe_prefixes(bytes, first, next, byte + 1, matches, result);
+    first = next;
+  }
+}
+
+} // namespace
+
 address_index::address_index(vast::type t, caf::settings opts)
   : value_index{std::move(t), std::move(opts)} {
   bytes_.fill(byte_index{8});
@@ -106,11 +138,49 @@ address_index::lookup_impl(relational_operator op, data_view d) const {
           result.flip();
         return result;
       },
-      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); },
+      [&](view<list> xs) -> caf::expected<ids> {
+        if (!(op == relational_operator::in
+              || op == relational_operator::not_in))
+          return caf::make_error(ec::unsupported_operator, op);
+        return lookup_membership(op, xs);
+      },
     },
     d);
 }
 
+caf::expected<ids>
+address_index::lookup_membership(relational_operator op,
+                                 view<list> xs) const {
+  VAST_ASSERT(op == relational_operator::in
+              || op == relational_operator::not_in);
+  std::vector<address> v4;
+  std::vector<address> v6;
+  for (auto x : *xs) {
+    auto addr = caf::get_if<view<address>>(&x);
+    // Lists with subnets or other types take the slow path that unifies the
+    // results of the individual lookups.
+    if (!addr)
+      return detail::container_lookup(*this, op, xs);
+    (addr->is_v4() ? v4 : v6).push_back(*addr);
+  }
+  // Sorting the addresses groups common prefixes, which allows for probing
+  // each distinct prefix only once.
+  auto result = ids{offset(), false};
+  for (auto* addrs : {&v4, &v6}) {
+    std::sort(addrs->begin(), addrs->end());
+    addrs->erase(std::unique(addrs->begin(), addrs->end()), addrs->end());
+  }
+  if (!v4.empty())
+    probe_prefixes(bytes_, v4.begin(), v4.end(), 12, v4_.coder().storage(),
+                   result);
+  if (!v6.empty())
+    probe_prefixes(bytes_, v6.begin(), v6.end(), 0, ids{offset(), true},
+                   result);
+  if (op == relational_operator::not_in)
+    result.flip();
+  return result;
+}
+
 size_t address_index::memusage_impl() const {
   auto acc = v4_.memusage();
   for (const auto& byte_index : bytes_)
@@ -0,0 +1,229 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/index/time_index.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/detail/varbyte.hpp"
+#include "vast/detail/zigzag.hpp"
+#include "vast/index/container_lookup.hpp"
+#include "vast/time.hpp"
+#include "vast/type.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+#include <caf/settings.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace vast {
+
+namespace {
+
+// Iterates over the values of a block by accumulating the encoded deltas.
+class block_decoder {
+public:
+  block_decoder(const time_index::block& x, const uint8_t* deltas)
+    : value_{x.first}, ptr_{deltas + x.offset} {
+    // nop
+  }
+
+  int64_t value() const {
+    return value_;
+  }
+
+  // Advances to the next value.
+  // @pre The block contains another value.
+  void next() {
+    uint64_t encoded;
+    ptr_ += detail::varbyte::decode(encoded, ptr_);
+    auto delta = detail::zigzag::decode(encoded);
+    value_ = static_cast<int64_t>(static_cast<uint64_t>(value_)
+                                  + static_cast<uint64_t>(delta));
+  }
+
+private:
+  int64_t value_;
+  const uint8_t* ptr_;
+};
+
+} // namespace
+
+time_index::time_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  // nop
+}
+
+caf::error time_index::serialize(caf::serializer& sink) const {
+  return caf::error::eval(
+    [&] { return value_index::serialize(sink); },
+    [&] { return sink(runs_, blocks_, deltas_, last_); });
+}
+
+caf::error time_index::deserialize(caf::deserializer& source) {
+  return caf::error::eval(
+    [&] { return value_index::deserialize(source); },
+    [&] { return source(runs_, blocks_, deltas_, last_); });
+}
+
+bool time_index::append_impl(data_view x, id pos) {
+  auto t = caf::get_if<view<time>>(&x);
+  if (!t)
+    return false;
+  auto value = t->time_since_epoch().count();
+  // A gap in the IDs starts a new run.
+  if (runs_.empty() || pos != runs_.back().first + runs_.back().size)
+    runs_.push_back(run{pos, 0, blocks_.size(), true});
+  auto& r = runs_.back();
+  if (r.size > 0 && value < last_)
+    r.sorted = false;
+  if (r.size % block_size == 0) {
+    blocks_.push_back(block{value, value, value, deltas_.size()});
+  } else {
+    auto delta = static_cast<int64_t>(static_cast<uint64_t>(value)
+                                      - static_cast<uint64_t>(last_));
+    auto encoded = detail::zigzag::encode(delta);
+    auto size = deltas_.size();
+    deltas_.resize(size + detail::varbyte::size(encoded));
+    detail::varbyte::encode(encoded, deltas_.data() + size);
+    auto& b = blocks_.back();
+    b.min = std::min(b.min, value);
+    b.max = std::max(b.max, value);
+  }
+  last_ = value;
+  ++r.size;
+  return true;
+}
+
+caf::expected<ids>
+time_index::lookup_impl(relational_operator op, data_view d) const {
+  constexpr auto min = std::numeric_limits<int64_t>::min();
+  constexpr auto max = std::numeric_limits<int64_t>::max();
+  return caf::visit(
+    detail::overload{
+      [&](auto x) -> caf::expected<ids> {
+        return caf::make_error(ec::type_clash, materialize(x));
+      },
+      [&](view<time> x) -> caf::expected<ids> {
+        auto value = x.time_since_epoch().count();
+        switch (op) {
+          default:
+            return caf::make_error(ec::unsupported_operator, op);
+          case relational_operator::equal:
+            return lookup_range(value, value);
+          case relational_operator::not_equal: {
+            // The range lookup stops at the last match, so we pad it to the
+            // full length before flipping.
+            auto result = lookup_range(value, value);
+            if (result.size() < offset())
+              result.append_bits(false, offset() - result.size());
+            result.flip();
+            return result;
+          }
+          case relational_operator::less:
+            if (value == min)
+              return ids{};
+            return lookup_range(min, value - 1);
+          case relational_operator::less_equal:
+            return lookup_range(min, value);
+          case relational_operator::greater:
+            if (value == max)
+              return ids{};
+            return lookup_range(value + 1, max);
+          case relational_operator::greater_equal:
+            return lookup_range(value, max);
+        }
+      },
+      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); },
+    },
+    d);
+}
+
+size_t time_index::memusage_impl() const {
+  return runs_.capacity() * sizeof(run) + blocks_.capacity() * sizeof(block)
+         + deltas_.capacity();
+}
+
+ids time_index::lookup_range(int64_t lo, int64_t hi) const {
+  ewah_bitmap result;
+  auto fill = [&](id first, id last) {
+    if (first >= last)
+      return;
+    result.append_bits(false, first - result.size());
+    result.append_bits(true, last - first);
+  };
+  for (auto& r : runs_) {
+    auto num_blocks = (r.size + block_size - 1) / block_size;
+    auto first_block = blocks_.begin() + r.blocks;
+    auto last_block = first_block + num_blocks;
+    auto length = [&](size_t i) {
+      return std::min<uint64_t>(block_size, r.size - i * block_size);
+    };
+    if (r.sorted) {
+      // In a sorted run, the matching values form a contiguous range that we
+      // find by binary search over the blocks and a partial decode of the
+      // block that contains the boundary.
+      auto partition_point = [&](auto pred) -> uint64_t {
+        auto i = std::partition_point(first_block, last_block,
+                                      [&](const block& b) {
+                                        return pred(b.first);
+                                      });
+        if (i == first_block)
+          return 0;
+        auto n = static_cast<size_t>(std::distance(first_block, i)) - 1;
+        auto result = n * block_size;
+        auto len = length(n);
+        if (pred(first_block[n].max))
+          return result + len;
+        auto decoder = block_decoder{first_block[n], deltas_.data()};
+        for (size_t j = 0; j < len; ++j) {
+          if (!pred(decoder.value()))
+            return result + j;
+          if (j + 1 < len)
+            decoder.next();
+        }
+        return result + len;
+      };
+      auto lower = partition_point([&](int64_t x) { return x < lo; });
+      auto upper = partition_point([&](int64_t x) { return x <= hi; });
+      fill(r.first + lower, r.first + upper);
+      continue;
+    }
+    // In an unsorted run, we consult the minimum and maximum of every block
+    // to skip or fill it entirely, and only decode the overlapping blocks.
+    for (size_t i = 0; i < num_blocks; ++i) {
+      auto& b = first_block[i];
+      auto first = r.first + i * block_size;
+      auto len = length(i);
+      if (b.max < lo || b.min > hi)
+        continue;
+      if (lo <= b.min && b.max <= hi) {
+        fill(first, first + len);
+        continue;
+      }
+      auto decoder = block_decoder{b, deltas_.data()};
+      for (size_t j = 0; j < len; ++j) {
+        if (lo <= decoder.value() && decoder.value() <= hi)
+          fill(first + j, first + j + 1);
+        if (j + 1 < len)
+          decoder.next();
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace vast
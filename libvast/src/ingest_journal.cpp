@@ -0,0 +1,283 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/ingest_journal.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/filesystem.hpp"
+#include "vast/config.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/directory.hpp"
+#include "vast/error.hpp"
+#include "vast/io/read.hpp"
+#include "vast/logger.hpp"
+#include "vast/table_slice.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace vast {
+
+namespace {
+
+/// The fixed-size part of a journal record.
+struct record_header {
+  uint64_t size;
+  uint64_t offset;
+  uint64_t checksum;
+};
+
+static_assert(sizeof(record_header) == 24);
+
+/// The alignment of records within a journal file.
+constexpr size_t record_alignment = 8;
+
+size_t padded(size_t size) {
+  return (size + record_alignment - 1) / record_alignment * record_alignment;
+}
+
+uint64_t checksum(span<const std::byte> xs) {
+  xxhash64 h;
+  h(xs.data(), xs.size());
+  return static_cast<uint64_t>(static_cast<xxhash64::result_type>(h));
+}
+
+caf::error write_all(int fd, const std::byte* data, size_t size) {
+  while (size > 0) {
+    auto n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return caf::make_error(ec::filesystem_error,
+                             "failed in write(2):", std::strerror(errno));
+    }
+    data += n;
+    size -= n;
+  }
+  return caf::none;
+}
+
+caf::error sync(int fd) {
+#if VAST_LINUX
+  auto result = ::fdatasync(fd);
+#else
+  auto result = ::fsync(fd);
+#endif
+  if (result != 0)
+    return caf::make_error(ec::filesystem_error,
+                           "failed to sync journal:", std::strerror(errno));
+  return caf::none;
+}
+
+} // namespace
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+caf::expected<ingest_journal_ptr>
+ingest_journal::make(path dir, size_t max_file_size) {
+  if (auto err = mkdir(dir))
+    return err;
+  auto result
+    = ingest_journal_ptr{new ingest_journal{std::move(dir), max_file_size}};
+  std::vector<std::pair<id, path>> filenames;
+  for (auto filename : directory{result->dir_}) {
+    if (filename.extension() != ".journal")
+      continue;
+    // Journal files are named after the first ID they contain, which
+    // establishes the order for replaying them.
+    auto name = filename.basename(true).str();
+    auto first = id{0};
+    auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(),
+                                     first);
+    if (ec != std::errc{} || ptr != name.data() + name.size()) {
+      VAST_WARN("{} ignores unexpected file {}",
+                detail::pretty_type_name(result.get()), filename);
+      continue;
+    }
+    filenames.emplace_back(first, std::move(filename));
+  }
+  std::sort(filenames.begin(), filenames.end());
+  for (auto& [_, filename] : filenames)
+    result->files_.push_back({std::move(filename)});
+  return result;
+}
+
+ingest_journal::ingest_journal(path dir, size_t max_file_size)
+  : dir_{std::move(dir)}, max_file_size_{max_file_size} {
+  // nop
+}
+
+ingest_journal::~ingest_journal() noexcept {
+  if (fd_ != -1)
+    ::close(fd_);
+}
+
+// -- properties ---------------------------------------------------------------
+
+size_t ingest_journal::pending() const noexcept {
+  return buffer_.size();
+}
+
+size_t ingest_journal::files() const noexcept {
+  return files_.size();
+}
+
+size_t ingest_journal::size() const noexcept {
+  auto result = size_t{0};
+  for (const auto& file : files_)
+    result += file.size;
+  return result;
+}
+
+size_t ingest_journal::commits() const noexcept {
+  return commits_;
+}
+
+// -- modifiers ----------------------------------------------------------------
+
+caf::expected<std::vector<table_slice>> ingest_journal::replay() {
+  std::vector<table_slice> result;
+  for (auto& file : files_) {
+    auto bytes = io::read(file.path);
+    if (!bytes)
+      return bytes.error();
+    auto chk = chunk::make(std::move(*bytes));
+    auto pos = size_t{0};
+    while (pos + sizeof(record_header) <= chk->size()) {
+      auto header = record_header{};
+      std::memcpy(&header, chk->data() + pos, sizeof(record_header));
+      auto first = pos + sizeof(record_header);
+      if (header.size == 0 || header.size > chk->size() - first)
+        break;
+      auto payload = chk->slice(first, header.size);
+      if (checksum(as_bytes(payload)) != header.checksum)
+        break;
+      auto slice = table_slice{std::move(payload), table_slice::verify::yes};
+      if (slice.encoding() == table_slice_encoding::none)
+        break;
+      slice.offset(header.offset);
+      file.first = std::min(file.first, slice.offset());
+      file.last = std::max(file.last, slice.offset() + slice.rows());
+      result.push_back(std::move(slice));
+      pos = std::min(first + padded(header.size), chk->size());
+    }
+    if (pos < chk->size()) {
+      VAST_WARN("{} discards {} bytes of an incomplete record in {}",
+                detail::pretty_type_name(this), chk->size() - pos, file.path);
+      if (::truncate(file.path.str().c_str(), pos) != 0)
+        return caf::make_error(ec::filesystem_error, "failed in truncate(2):",
+                               std::strerror(errno));
+    }
+    file.size = pos;
+  }
+  return result;
+}
+
+void ingest_journal::append(const table_slice& slice) {
+  VAST_ASSERT(slice.offset() != invalid_id);
+  auto materialized = materialize(slice);
+  auto bytes = as_bytes(materialized);
+  auto header = record_header{bytes.size(), slice.offset(), checksum(bytes)};
+  auto header_bytes = reinterpret_cast<const std::byte*>(&header);
+  buffer_.insert(buffer_.end(), header_bytes,
+                 header_bytes + sizeof(record_header));
+  buffer_.insert(buffer_.end(), bytes.begin(), bytes.end());
+  buffer_.resize(padded(buffer_.size()), std::byte{0});
+  buffer_first_ = std::min(buffer_first_, slice.offset());
+  buffer_last_ = std::max(buffer_last_, slice.offset() + slice.rows());
+}
+
+caf::error ingest_journal::commit() {
+  if (buffer_.empty())
+    return caf::none;
+  if (fd_ == -1 || files_.back().size >= max_file_size_)
+    if (auto err = rotate())
+      return err;
+  auto& file = files_.back();
+  // Cut off a partially written batch, so that a later commit does not
+  // append after a torn record that stops the replay.
+  auto rollback = [&](caf::error err) {
+    if (::ftruncate(fd_, file.size) != 0)
+      VAST_ERROR("{} failed to truncate {} after a failed commit: {}",
+                 detail::pretty_type_name(this), file.path,
+                 std::strerror(errno));
+    return err;
+  };
+  if (auto err = write_all(fd_, buffer_.data(), buffer_.size()))
+    return rollback(std::move(err));
+  if (auto err = sync(fd_))
+    return rollback(std::move(err));
+  file.first = std::min(file.first, buffer_first_);
+  file.last = std::max(file.last, buffer_last_);
+  file.size += buffer_.size();
+  buffer_.clear();
+  buffer_first_ = invalid_id;
+  buffer_last_ = 0;
+  ++commits_;
+  return caf::none;
+}
+
+caf::error ingest_journal::truncate(id watermark) {
+  std::vector<file_info> remaining;
+  for (size_t i = 0; i < files_.size(); ++i) {
+    auto& file = files_[i];
+    // Never remove the file we currently append to.
+    auto active = fd_ != -1 && i + 1 == files_.size();
+    if (active || file.last > watermark) {
+      remaining.push_back(std::move(file));
+      continue;
+    }
+    VAST_DEBUG("{} removes {} that ends at ID {}",
+               detail::pretty_type_name(this), file.path, file.last);
+    if (!rm(file.path)) {
+      auto filename = file.path.str();
+      // Keep the remaining files consistent with the ones on disk.
+      std::move(files_.begin() + i, files_.end(),
+                std::back_inserter(remaining));
+      files_ = std::move(remaining);
+      return caf::make_error(ec::filesystem_error,
+                             "failed to remove journal file", filename);
+    }
+  }
+  files_ = std::move(remaining);
+  return caf::none;
+}
+
+caf::error ingest_journal::rotate() {
+  if (fd_ != -1) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  auto filename = dir_ / (std::to_string(buffer_first_) + ".journal");
+  fd_ = ::open(filename.str().c_str(), O_CREAT | O_WRONLY | O_APPEND, 0644);
+  if (fd_ == -1)
+    return caf::make_error(ec::filesystem_error,
+                           "failed in open(2):", std::strerror(errno));
+  // Make the new directory entry durable as well.
+  if (auto dir = ::open(dir_.str().c_str(), O_RDONLY); dir != -1) {
+    ::fsync(dir);
+    ::close(dir);
+  }
+  files_.push_back({filename});
+  return caf::none;
+}
+
+} // namespace vast
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/layout_interner.hpp"
+
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/logger.hpp"
+#include "vast/type.hpp"
+
+#include <caf/binary_deserializer.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+namespace vast {
+
+layout_fingerprint
+fingerprint(span<const std::byte> serialized_layout) noexcept {
+  xxhash64 h;
+  h(serialized_layout.data(), serialized_layout.size());
+  auto result = static_cast<uint64_t>(static_cast<xxhash64::result_type>(h));
+  return result != 0 ? result : 1;
+}
+
+layout_interner& layout_interner::instance() noexcept {
+  static layout_interner interner;
+  return interner;
+}
+
+std::shared_ptr<const record_type>
+layout_interner::intern(layout_fingerprint id,
+                        span<const std::byte> serialized_layout) {
+  auto matches = [&](const entry& x) {
+    return std::equal(x.serialized_layout.begin(), x.serialized_layout.end(),
+                      serialized_layout.begin(), serialized_layout.end());
+  };
+  {
+    auto lock = std::shared_lock{mutex_};
+    if (auto it = layouts_.find(id);
+        it != layouts_.end() && matches(it->second))
+      return it->second.layout;
+  }
+  auto layout = std::make_shared<record_type>();
+  caf::binary_deserializer source{
+    nullptr, reinterpret_cast<const char*>(serialized_layout.data()),
+    serialized_layout.size()};
+  if (auto err = source(*layout))
+    return nullptr;
+  auto lock = std::unique_lock{mutex_};
+  auto [it, inserted] = layouts_.try_emplace(id);
+  auto& x = it->second;
+  if (inserted) {
+    x.layout = std::move(layout);
+  } else if (matches(x)) {
+    // Another thread interned the same layout in the meantime.
+    return x.layout;
+  } else if (!x.serialized_layout.empty() || !(*x.layout == *layout)) {
+    VAST_WARN("{} found colliding fingerprint {} for layouts {} and {}",
+              __func__, id, x.layout->name(), layout->name());
+    return layout;
+  }
+  // Remember the serialized form, so that later lookups compare bytes instead
+  // of deserializing the layout again.
+  x.serialized_layout.assign(serialized_layout.begin(),
+                             serialized_layout.end());
+  return x.layout;
+}
+
+std::shared_ptr<const record_type>
+layout_interner::intern(layout_fingerprint id, const record_type& layout) {
+  {
+    auto lock = std::shared_lock{mutex_};
+    if (auto it = layouts_.find(id); it != layouts_.end()) {
+      if (*it->second.layout == layout)
+        return it->second.layout;
+      VAST_WARN("{} found colliding fingerprint {} for layouts {} and {}",
+                __func__, id, it->second.layout->name(), layout.name());
+      return std::make_shared<record_type>(layout);
+    }
+  }
+  auto lock = std::unique_lock{mutex_};
+  auto& x = layouts_.try_emplace(id).first->second;
+  if (!x.layout)
+    x.layout = std::make_shared<record_type>(layout);
+  else if (!(*x.layout == layout))
+    return std::make_shared<record_type>(layout);
+  return x.layout;
+}
+
+std::shared_ptr<const record_type>
+layout_interner::find(layout_fingerprint id) const {
+  auto lock = std::shared_lock{mutex_};
+  if (auto it = layouts_.find(id); it != layouts_.end())
+    return it->second.layout;
+  return nullptr;
+}
+
+std::pair<layout_fingerprint, std::shared_ptr<const record_type>>
+layout_interner::resolve(layout_fingerprint id,
+                         span<const std::byte> serialized_layout) {
+  if (serialized_layout.empty())
+    return {id, id != 0 ? find(id) : nullptr};
+  // Slices that predate layout fingerprints do not carry one, so we compute it
+  // from the serialized layout.
+  if (id == 0)
+    id = fingerprint(serialized_layout);
+  return {id, intern(id, serialized_layout)};
+}
+
+size_t layout_interner::size() const {
+  auto lock = std::shared_lock{mutex_};
+  return layouts_.size();
+}
+
+} // namespace vast
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/membership_set.hpp"
+
+#include "vast/address.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/hasher.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+namespace vast {
+
+namespace {
+
+template <class T>
+membership_set::digest_pair make_digests(const T& x) {
+  using hash_function = membership_set::hash_function;
+  return {
+    detail::seeded_hash<hash_function>{membership_set::seed1}(x),
+    detail::seeded_hash<hash_function>{membership_set::seed2}(x),
+  };
+}
+
+} // namespace
+
+membership_set::membership_set(view<list> xs) {
+  VAST_ASSERT(xs);
+  values_.reserve(xs->size());
+  for (auto x : *xs)
+    values_.push_back(materialize(x));
+  std::sort(values_.begin(), values_.end());
+  values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+  values_.shrink_to_fit();
+  digests_.reserve(values_.size());
+  auto f = detail::overload{
+    [](const std::string& x) { return make_digests(std::string_view{x}); },
+    [](const address& x) { return make_digests(x); },
+    [](const auto&) { return membership_set::digest_pair{}; },
+  };
+  for (auto& x : values_)
+    digests_.push_back(caf::visit(f, x));
+}
+
+const list& membership_set::values() const noexcept {
+  return values_;
+}
+
+const std::vector<membership_set::digest_pair>&
+membership_set::digests() const noexcept {
+  return digests_;
+}
+
+size_t membership_set::size() const noexcept {
+  return values_.size();
+}
+
+bool membership_set::empty() const noexcept {
+  return values_.empty();
+}
+
+bool membership_set::contains(const data& x) const {
+  return std::binary_search(values_.begin(), values_.end(), x);
+}
+
+} // namespace vast
@@ -13,16 +13,17 @@
 
 #include "vast/msgpack_table_slice.hpp"
 
+#include "vast/detail/assert.hpp"
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/type_traits.hpp"
 #include "vast/die.hpp"
 #include "vast/fbs/table_slice.hpp"
-#include "vast/fbs/utils.hpp"
 #include "vast/logger.hpp"
 #include "vast/msgpack.hpp"
 #include "vast/value_index.hpp"
 
+#include <tuple>
 #include <type_traits>
 
 namespace vast {
@@ -250,17 +251,26 @@ template <class FlatBuffer>
 msgpack_table_slice<FlatBuffer>::msgpack_table_slice(
   const FlatBuffer& slice) noexcept
   : slice_{slice}, state_{} {
-  if (auto err = fbs::deserialize_bytes(slice_.layout(), state_.layout))
-    die("failed to deserialize layout: " + render(err));
-  state_.columns = state_.layout.num_leaves();
+  auto serialized_layout = span<const std::byte>{};
+  if (auto layout = slice_.layout())
+    serialized_layout = {reinterpret_cast<const std::byte*>(layout->data()),
+                         layout->size()};
+  std::tie(state_.layout_id, state_.layout)
+    = layout_interner::instance().resolve(slice_.layout_id(),
+                                          serialized_layout);
+  if (!state_.layout)
+    die("failed to resolve layout");
+  state_.columns = state_.layout->num_leaves();
 }
 
 template <class FlatBuffer>
 msgpack_table_slice<FlatBuffer>::msgpack_table_slice(
-  const FlatBuffer& slice, record_type layout) noexcept
+  const FlatBuffer& slice, const record_type& layout) noexcept
   : slice_{slice}, state_{} {
-  state_.layout = std::move(layout);
-  state_.columns = state_.layout.num_leaves();
+  VAST_ASSERT(slice_.layout_id() != 0);
+  state_.layout_id = slice_.layout_id();
+  state_.layout = layout_interner::instance().intern(state_.layout_id, layout);
+  state_.columns = state_.layout->num_leaves();
 }
 
 template <class FlatBuffer>
@@ -272,7 +282,13 @@ msgpack_table_slice<FlatBuffer>::~msgpack_table_slice() noexcept {
 
 template <class FlatBuffer>
 const record_type& msgpack_table_slice<FlatBuffer>::layout() const noexcept {
-  return state_.layout;
+  return *state_.layout;
+}
+
+template <class FlatBuffer>
+layout_fingerprint
+msgpack_table_slice<FlatBuffer>::layout_id() const noexcept {
+  return state_.layout_id;
 }
 
 template <class FlatBuffer>
@@ -293,9 +309,9 @@ void msgpack_table_slice<FlatBuffer>::append_column_to_index(
   id offset, table_slice::size_type column, value_index& index) const {
   const auto& offset_table = *slice_.offset_table();
   auto view = as_bytes(*slice_.data());
-  auto layout_offset = state_.layout.offset_from_index(column);
+  auto layout_offset = state_.layout->offset_from_index(column);
   VAST_ASSERT(layout_offset);
-  auto type = state_.layout.at(*layout_offset)->type;
+  auto type = state_.layout->at(*layout_offset)->type;
   for (size_t row = 0; row < rows(); ++row) {
     auto row_offset = offset_table[row];
     auto xs = msgpack::overlay{view.subspan(row_offset)};
@@ -318,9 +334,9 @@ msgpack_table_slice<FlatBuffer>::at(table_slice::size_type row,
   auto xs = msgpack::overlay{view.subspan(offset)};
   // ...then skip (decode) up to the desired column.
   xs.next(column);
-  auto layout_offset = state_.layout.offset_from_index(column);
+  auto layout_offset = state_.layout->offset_from_index(column);
   VAST_ASSERT(layout_offset);
-  return decode(xs, state_.layout.at(*layout_offset)->type);
+  return decode(xs, state_.layout->at(*layout_offset)->type);
 }
 
 template <class FlatBuffer>
@@ -331,7 +347,7 @@ data_view msgpack_table_slice<FlatBuffer>::at(table_slice::size_type row,
   auto view = as_bytes(*slice_.data());
   // First find the desired row...
   VAST_ASSERT(row < offset_table.size());
-  VAST_ASSERT(state_.layout.at(*state_.layout.offset_from_index(column))->type
+  VAST_ASSERT(state_.layout->at(*state_.layout->offset_from_index(column))->type
               == t);
   auto offset = offset_table[row];
   VAST_ASSERT(offset < static_cast<size_t>(view.size()));
@@ -118,12 +118,11 @@ msgpack_table_slice_builder::finish(span<const std::byte> serialized_layout) {
   // of fields in the layout.
   VAST_ASSERT(column_ == 0);
   // Pack layout.
-  auto layout_buffer
-    = serialized_layout.empty()
-        ? *fbs::serialize_bytes(builder_, layout())
-        : builder_.CreateVector(
-          reinterpret_cast<const unsigned char*>(serialized_layout.data()),
-          serialized_layout.size());
+  if (serialized_layout.empty())
+    serialized_layout = this->serialized_layout();
+  auto layout_buffer = builder_.CreateVector(
+    reinterpret_cast<const unsigned char*>(serialized_layout.data()),
+    serialized_layout.size());
   // Pack offset table.
   auto offset_table_buffer = builder_.CreateVector(offset_table_);
   // Pack data.
@@ -131,7 +130,7 @@ msgpack_table_slice_builder::finish(span<const std::byte> serialized_layout) {
     reinterpret_cast<const uint8_t*>(data_.data()), data_.size());
   // Create MessagePack-encoded table slices.
   auto msgpack_table_slice_buffer = fbs::table_slice::msgpack::Createv0(
-    builder_, layout_buffer, offset_table_buffer, data_buffer);
+    builder_, layout_buffer, offset_table_buffer, data_buffer, layout_id());
   // Create and finish table slice.
   auto table_slice_buffer
     = fbs::CreateTableSlice(builder_, fbs::table_slice::TableSlice::msgpack_v0,
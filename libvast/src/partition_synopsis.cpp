@@ -13,12 +13,34 @@
 
 #include "vast/partition_synopsis.hpp"
 
+#include "vast/concept/hashable/uhash.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/string.hpp"
 #include "vast/error.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/synopsis_factory.hpp"
 
+#include <caf/settings.hpp>
+
+#include <algorithm>
+
 namespace vast {
 
+namespace {
+
+/// Checks whether a column gets a sketch of its number of distinct values.
+/// Other columns either have a tiny domain or hardly repeat their values.
+bool has_sketch(const type& t) {
+  return caf::holds_alternative<integer_type>(t)
+         || caf::holds_alternative<count_type>(t)
+         || caf::holds_alternative<address_type>(t)
+         || caf::holds_alternative<subnet_type>(t)
+         || caf::holds_alternative<string_type>(t);
+}
+
+} // namespace
+
 void partition_synopsis::shrink() {
   for (auto& [field, synopsis] : field_synopses_) {
     if (!synopsis)
@@ -45,6 +67,19 @@ void partition_synopsis::add(const table_slice& slice,
     return has_skip_attribute(t) ? nullptr
                                  : factory<synopsis>::make(t, synopsis_options);
   };
+  offset = std::min(offset, slice.offset());
+  events += slice.rows();
+  auto first = slice.offset();
+  auto last = first + slice.rows();
+  if (!id_ranges.empty() && id_ranges.back().second == first)
+    id_ranges.back().second = last;
+  else
+    id_ranges.emplace_back(first, last);
+  auto precision = caf::get_or(synopsis_options, "hyperloglog-precision",
+                               defaults::system::hyperloglog_precision);
+  if (precision > 0)
+    precision = std::clamp(precision, size_t{hyperloglog::min_precision},
+                           size_t{hyperloglog::max_precision});
   auto& layout = slice.layout();
   auto each = record_type::each(layout);
   auto field_it = each.begin();
@@ -58,6 +93,22 @@ void partition_synopsis::add(const table_slice& slice,
       }
     };
     auto key = qualified_record_field{layout.name(), *field_it};
+    if (null_fields_.count(key) == 0)
+      for (size_t row = 0; row < slice.rows(); ++row)
+        if (caf::holds_alternative<caf::none_t>(slice.at(row, col, type))) {
+          null_fields_.insert(key);
+          break;
+        }
+    if (precision > 0 && has_sketch(type)) {
+      auto& sketch
+        = field_sketches_.try_emplace(key, static_cast<uint8_t>(precision))
+            .first->second;
+      for (size_t row = 0; row < slice.rows(); ++row) {
+        auto view = slice.at(row, col, type);
+        if (!caf::holds_alternative<caf::none_t>(view))
+          sketch.add(uhash<xxhash64>{}(view));
+      }
+    }
     if (!caf::holds_alternative<string_type>(type)) {
       // Locate the relevant synopsis.
       auto it = field_synopses_.find(key);
@@ -84,6 +135,28 @@ size_t partition_synopsis::memusage() const {
   size_t result = 0;
   for (auto& [field, synopsis] : field_synopses_)
     result += synopsis ? synopsis->memusage() : 0ull;
+  for (auto& [field, sketch] : field_sketches_)
+    result += sketch.memusage();
+  return result;
+}
+
+caf::optional<hyperloglog>
+partition_synopsis::sketch(std::string_view field) const {
+  caf::optional<hyperloglog> result;
+  for (const auto& [column, sketch] : field_sketches_) {
+    auto fqn = column.fqn();
+    auto matches
+      = fqn == field
+        || (fqn.size() > field.size()
+            && fqn[fqn.size() - field.size() - 1] == '.'
+            && detail::ends_with(fqn, field));
+    if (!matches)
+      continue;
+    if (result)
+      result->merge(sketch);
+    else
+      result = sketch;
+  }
   return result;
 }
 
@@ -105,8 +178,42 @@ pack(flatbuffers::FlatBufferBuilder& builder, const partition_synopsis& x) {
     synopses.push_back(*maybe_synopsis);
   }
   auto synopses_vector = builder.CreateVector(synopses);
+  std::vector<fbs::partition_synopsis::id_range> ranges;
+  ranges.reserve(x.id_ranges.size());
+  for (auto [first, last] : x.id_ranges)
+    ranges.emplace_back(first, last);
+  auto ranges_vector = builder.CreateVectorOfStructs(ranges);
+  std::vector<flatbuffers::Offset<fbs::field_sketch::v0>> sketches;
+  for (auto& [fqf, sketch] : x.field_sketches_) {
+    auto column_name = fbs::serialize_bytes(builder, fqf);
+    if (!column_name)
+      return column_name.error();
+    auto hyperloglog = pack(builder, sketch);
+    if (!hyperloglog)
+      return hyperloglog.error();
+    fbs::field_sketch::v0Builder sketch_builder(builder);
+    sketch_builder.add_qualified_record_field(*column_name);
+    sketch_builder.add_hyperloglog(*hyperloglog);
+    sketches.push_back(sketch_builder.Finish());
+  }
+  auto sketches_vector = builder.CreateVector(sketches);
+  std::vector<flatbuffers::Offset<fbs::null_field::v0>> null_fields;
+  for (auto& fqf : x.null_fields_) {
+    auto column_name = fbs::serialize_bytes(builder, fqf);
+    if (!column_name)
+      return column_name.error();
+    null_fields.push_back(fbs::null_field::Createv0(builder, *column_name));
+  }
+  auto null_fields_vector = builder.CreateVector(null_fields);
   fbs::partition_synopsis::v0Builder ps_builder(builder);
   ps_builder.add_synopses(synopses_vector);
+  ps_builder.add_offset(x.offset);
+  ps_builder.add_events(x.events);
+  ps_builder.add_id_ranges(ranges_vector);
+  ps_builder.add_sketches(sketches_vector);
+  // Synopses of older versions must not claim to be free of null values.
+  if (x.tracks_nulls_)
+    ps_builder.add_null_fields(null_fields_vector);
   return ps_builder.Finish();
 }
 
@@ -129,6 +236,44 @@ unpack(const fbs::partition_synopsis::v0& x, partition_synopsis& ps) {
     else
       ps.type_synopses_[qf.type] = std::move(ptr);
   }
+  // Synopses written by older versions have no offset.
+  ps.offset = x.events() > 0 ? x.offset() : invalid_id;
+  ps.events = x.events();
+  ps.id_ranges.clear();
+  if (auto ranges = x.id_ranges()) {
+    for (auto range : *ranges)
+      ps.id_ranges.emplace_back(range->begin_id(), range->end_id());
+  } else if (ps.events > 0) {
+    ps.id_ranges.emplace_back(ps.offset, ps.offset + ps.events);
+  }
+  ps.field_sketches_.clear();
+  if (auto sketches = x.sketches()) {
+    for (auto sketch : *sketches) {
+      if (!sketch || !sketch->hyperloglog())
+        return caf::make_error(ec::format_error, "sketch is null");
+      qualified_record_field qf;
+      if (auto error
+          = fbs::deserialize_bytes(sketch->qualified_record_field(), qf))
+        return error;
+      hyperloglog hll;
+      if (auto error = unpack(*sketch->hyperloglog(), hll))
+        return error;
+      ps.field_sketches_.emplace(std::move(qf), std::move(hll));
+    }
+  }
+  ps.null_fields_.clear();
+  ps.tracks_nulls_ = x.null_fields() != nullptr;
+  if (auto null_fields = x.null_fields()) {
+    for (auto null_field : *null_fields) {
+      if (!null_field)
+        return caf::make_error(ec::format_error, "null field is null");
+      qualified_record_field qf;
+      if (auto error
+          = fbs::deserialize_bytes(null_field->qualified_record_field(), qf))
+        return error;
+      ps.null_fields_.insert(std::move(qf));
+    }
+  }
   return caf::none;
 }
 
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/port_synopsis.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace vast {
+
+port_synopsis::port_synopsis(vast::type x)
+  : super{std::move(x), std::numeric_limits<count>::max(),
+          std::numeric_limits<count>::min()} {
+  VAST_ASSERT(caf::holds_alternative<count_type>(type()));
+}
+
+port_synopsis::port_synopsis(count min, count max,
+                             std::optional<std::vector<count>> values)
+  : super{count_type{}.name("port"), min, max} {
+  if (values)
+    values_ = std::move(*values);
+  else
+    overflow_ = true;
+}
+
+void port_synopsis::add(data_view x) {
+  super::add(x);
+  if (overflow_)
+    return;
+  auto value = caf::get<view<count>>(x);
+  auto i = std::lower_bound(values_.begin(), values_.end(), value);
+  if (i != values_.end() && *i == value)
+    return;
+  if (values_.size() == max_values) {
+    // Too many distinct values; fall back to the min-max synopsis.
+    overflow_ = true;
+    values_ = {};
+    return;
+  }
+  values_.insert(i, value);
+}
+
+caf::optional<bool>
+port_synopsis::lookup(relational_operator op, data_view rhs) const {
+  if (overflow_)
+    return super::lookup(op, rhs);
+  switch (op) {
+    case relational_operator::equal:
+      if (auto x = caf::get_if<view<count>>(&rhs))
+        return contains(*x);
+      return caf::none;
+    case relational_operator::not_equal:
+      if (auto x = caf::get_if<view<count>>(&rhs))
+        return !(values_.size() == 1 && values_.front() == *x);
+      return caf::none;
+    case relational_operator::in:
+      if (auto xs = caf::get_if<view<list>>(&rhs)) {
+        for (auto x : **xs)
+          if (auto y = caf::get_if<view<count>>(&x); y && contains(*y))
+            return true;
+        return false;
+      }
+      return caf::none;
+    case relational_operator::not_in:
+      if (auto xs = caf::get_if<view<list>>(&rhs)) {
+        auto excluded = std::vector<count>{};
+        for (auto x : **xs)
+          if (auto y = caf::get_if<view<count>>(&x))
+            excluded.push_back(*y);
+        return std::any_of(values_.begin(), values_.end(), [&](count value) {
+          return std::find(excluded.begin(), excluded.end(), value)
+                 == excluded.end();
+        });
+      }
+      return caf::none;
+    default:
+      return super::lookup(op, rhs);
+  }
+}
+
+bool port_synopsis::equals(const synopsis& other) const noexcept {
+  if (typeid(other) != typeid(port_synopsis))
+    return false;
+  auto& rhs = static_cast<const port_synopsis&>(other);
+  return type() == rhs.type() && min() == rhs.min() && max() == rhs.max()
+         && overflow_ == rhs.overflow_ && values_ == rhs.values_;
+}
+
+size_t port_synopsis::memusage() const {
+  return sizeof(port_synopsis) + values_.capacity() * sizeof(count);
+}
+
+caf::error port_synopsis::serialize(caf::serializer& sink) const {
+  return caf::error::eval([&] { return super::serialize(sink); },
+                          [&] { return sink(values_, overflow_); });
+}
+
+caf::error port_synopsis::deserialize(caf::deserializer& source) {
+  return caf::error::eval([&] { return super::deserialize(source); },
+                          [&] { return source(values_, overflow_); });
+}
+
+const std::vector<count>* port_synopsis::values() const noexcept {
+  return overflow_ ? nullptr : &values_;
+}
+
+bool port_synopsis::contains(count x) const {
+  return std::binary_search(values_.begin(), values_.end(), x);
+}
+
+} // namespace vast
@@ -26,6 +26,7 @@
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/ids.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/logger.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/table_slice.hpp"
@@ -54,6 +55,22 @@ caf::expected<segment> segment::make(chunk_ptr chunk) {
   VAST_ASSERT(s); // `GetSegment` is just a cast, so this cant become null.
   if (s->segment_type() != fbs::segment::Segment::v0)
     return caf::make_error(ec::format_error, "unsupported segment version");
+  // Intern the layout dictionary so that contained table slices that do not
+  // embed their layout can resolve it. Older segments have no dictionary.
+  if (auto layouts = s->segment_as_v0()->layouts()) {
+    for (auto layout : *layouts) {
+      if (!layout->layout())
+        return caf::make_error(ec::format_error,
+                               "missing layout with fingerprint", layout->id());
+      auto serialized_layout = span<const std::byte>{
+        reinterpret_cast<const std::byte*>(layout->layout()->data()),
+        layout->layout()->size()};
+      if (!layout_interner::instance().intern(layout->id(), serialized_layout))
+        return caf::make_error(ec::format_error,
+                               "failed to deserialize layout with fingerprint",
+                               layout->id());
+    }
+  }
   return segment{std::move(chunk)};
 }
 
@@ -37,7 +37,16 @@ segment_builder::segment_builder(size_t initial_buffer_size)
 caf::error segment_builder::add(table_slice x) {
   if (x.offset() < min_table_slice_offset_)
     return caf::make_error(ec::unspecified, "slice offsets not increasing");
-  auto bytes = fbs::pack_bytes(builder_, x);
+  // Store the layout once per segment rather than once per slice.
+  if (layout_ids_.count(x.layout_id()) == 0) {
+    auto layout_buffer = fbs::serialize_bytes(builder_, x.layout());
+    if (!layout_buffer)
+      return layout_buffer.error();
+    layouts_.push_back(
+      fbs::layout::Createv0(builder_, x.layout_id(), *layout_buffer));
+    layout_ids_.insert(x.layout_id());
+  }
+  auto bytes = pack_without_layout(builder_, x);
   auto slice = fbs::CreateFlatTableSlice(builder_, bytes);
   flat_slices_.push_back(slice);
   intervals_.emplace_back(x.offset(), x.offset() + x.rows());
@@ -50,11 +59,13 @@ segment segment_builder::finish() {
   auto table_slices_offset = builder_.CreateVector(flat_slices_);
   auto uuid_offset = pack(builder_, id_);
   auto ids_offset = builder_.CreateVectorOfStructs(intervals_);
+  auto layouts_offset = builder_.CreateVector(layouts_);
   fbs::segment::v0Builder segment_v0_builder{builder_};
   segment_v0_builder.add_slices(table_slices_offset);
   segment_v0_builder.add_uuid(*uuid_offset);
   segment_v0_builder.add_ids(ids_offset);
   segment_v0_builder.add_events(num_events_);
+  segment_v0_builder.add_layouts(layouts_offset);
   auto segment_v0_offset = segment_v0_builder.Finish();
   fbs::SegmentBuilder segment_builder{builder_};
   segment_builder.add_segment_type(vast::fbs::segment::Segment::v0);
@@ -109,6 +120,8 @@ void segment_builder::reset() {
   builder_.Clear();
   flat_slices_.clear();
   intervals_.clear();
+  layouts_.clear();
+  layout_ids_.clear();
   slices_.clear();
 }
 
@@ -32,6 +32,10 @@
 #include <caf/dictionary.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+
 namespace vast {
 
 // TODO: return expected<segment_store_ptr> for better error propagation.
@@ -64,6 +68,12 @@ segment_store::~segment_store() {
 
 caf::error segment_store::put(table_slice xs) {
   VAST_TRACE_SCOPE("{}", VAST_ARG(xs));
+  // Table slices replayed after a crash may already be part of a segment.
+  if (segments_.lookup(xs.offset()) != nullptr) {
+    VAST_DEBUG("{} skips table slice with already stored ID {}",
+               detail::pretty_type_name(this), xs.offset());
+    return caf::none;
+  }
   if (!segments_.inject(xs.offset(), xs.offset() + xs.rows(), builder_.id()))
     return caf::make_error(ec::unspecified, "failed to update range_map");
   num_events_ += xs.rows();
@@ -224,10 +234,13 @@ caf::error segment_store::erase(const ids& xs) {
                  new_slices.size());
     // Remove stale state.
     segments_.erase_value(segment_id);
-    // Estimate the size of the new segment.
+    // Estimate the size of the new segment. Slices from `select` share the
+    // chunk of their parent, which we must only count once.
     auto size_estimate = size_t{};
+    auto parents = std::unordered_set<const std::byte*>{};
     for (const auto& slice : new_slices)
-      size_estimate += as_bytes(slice).size();
+      if (auto bytes = as_bytes(slice); parents.insert(bytes.data()).second)
+        size_estimate += bytes.size();
     size_estimate *= 1.1;
     // Create a new segment from the remaining slices.
     segment_builder tmp_builder{size_estimate};
@@ -257,6 +270,9 @@ caf::error segment_store::erase(const ids& xs) {
       if (auto err = write(filename, new_segment.chunk()))
         VAST_ERROR("{} failed to persist the new segment",
                    detail::pretty_type_name(this));
+      else
+        bytes_ += new_segment.chunk()->size();
+      bytes_ -= std::min(bytes_, uint64_t{seg.chunk()->size()});
       auto stale_filename = segment_path() / to_string(segment_id);
       // Schedule deletion of the segment file when releasing the chunk.
       seg.chunk()->add_deletion_step([=]() noexcept { rm(stale_filename); });
@@ -275,6 +291,10 @@ caf::error segment_store::erase(const ids& xs) {
       VAST_DEBUG("{} erases from the active segment {}",
                  detail::pretty_type_name(this), candidate);
       impl(builder_);
+    } else if (auto n = try_drop(candidate, xs)) {
+      VAST_DEBUG("{} erases the segment {} without loading it",
+                 detail::pretty_type_name(this), candidate);
+      erased_events += *n;
     } else if (auto s = load_segment(candidate)) {
       VAST_DEBUG("{} erases from the segment {}",
                  detail::pretty_type_name(this), candidate);
@@ -336,6 +356,14 @@ caf::expected<std::vector<table_slice>> segment_store::get(const ids& xs) {
   return result;
 }
 
+id segment_store::watermark() const {
+  if (dirty())
+    return builder_.table_slices().front().offset();
+  if (segments_.empty())
+    return 0;
+  return (*std::prev(segments_.end())).right;
+}
+
 caf::error segment_store::flush() {
   if (!dirty())
     return caf::none;
@@ -344,6 +372,7 @@ caf::error segment_store::flush() {
   auto filename = segment_path() / to_string(seg.id());
   if (auto err = write(filename, seg.chunk()))
     return err;
+  bytes_ += seg.chunk()->size();
   // Keep new segment in the cache.
   cache_.emplace(seg.id(), seg);
   VAST_DEBUG("{} wrote new segment to {}", detail::pretty_type_name(this),
@@ -351,6 +380,10 @@ caf::error segment_store::flush() {
   return caf::none;
 }
 
+uint64_t segment_store::bytes() const {
+  return bytes_;
+}
+
 void segment_store::inspect_status(caf::settings& xs,
                                    system::status_verbosity v) {
   using caf::put;
@@ -398,6 +431,7 @@ caf::error segment_store::register_segment(const path& filename) {
   if (!s0)
     return caf::make_error(ec::format_error, "unknown segment version");
   num_events_ += s0->events();
+  bytes_ += chk->size();
   uuid segment_uuid;
   if (auto error = unpack(*s0->uuid(), segment_uuid))
     return error;
@@ -461,10 +495,39 @@ uint64_t segment_store::drop(segment& x) {
   // Schedule deletion of the segment file when releasing the chunk.
   auto filename = segment_path() / to_string(segment_id);
   x.chunk()->add_deletion_step([=]() noexcept { rm(filename); });
+  bytes_ -= std::min(bytes_, uint64_t{x.chunk()->size()});
   segments_.erase_value(segment_id);
   return erased_events;
 }
 
+std::optional<uint64_t>
+segment_store::try_drop(const uuid& segment_id, const ids& xs) {
+  // The range map knows the ID intervals of every segment, which suffices to
+  // decide whether we can drop the file as a whole.
+  ids segment_ids;
+  uint64_t events = 0;
+  for (auto [first, last, value] : segments_) {
+    if (value != segment_id)
+      continue;
+    segment_ids.append_bits(false, first - segment_ids.size());
+    segment_ids.append_bits(true, last - first);
+    events += last - first;
+  }
+  if (events == 0 || !is_subset(segment_ids, xs))
+    return std::nullopt;
+  VAST_INFO("{} erases entire segment {}", detail::pretty_type_name(this),
+            segment_id);
+  auto filename = segment_path() / to_string(segment_id);
+  auto size = file_size(filename);
+  if (!rm(filename))
+    VAST_WARN("{} failed to remove segment file {}",
+              detail::pretty_type_name(this), filename);
+  else if (size)
+    bytes_ -= std::min(bytes_, uint64_t{*size});
+  segments_.erase_value(segment_id);
+  return events;
+}
+
 uint64_t segment_store::drop(segment_builder& x) {
   uint64_t erased_events = 0;
   auto segment_id = x.id();
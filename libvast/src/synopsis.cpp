@@ -13,12 +13,19 @@
 
 #include "vast/synopsis.hpp"
 
+#include "vast/address_synopsis.hpp"
 #include "vast/bool_synopsis.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/enumeration_synopsis.hpp"
 #include "vast/error.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/logger.hpp"
+#include "vast/membership_set.hpp"
+#include "vast/numeric_synopsis.hpp"
+#include "vast/port_synopsis.hpp"
 #include "vast/qualified_record_field.hpp"
+#include "vast/string_synopsis.hpp"
 #include "vast/synopsis_factory.hpp"
 #include "vast/time_synopsis.hpp"
 
@@ -26,10 +33,40 @@
 #include <caf/binary_serializer.hpp>
 #include <caf/error.hpp>
 
+#include <algorithm>
 #include <typeindex>
+#include <vector>
 
 namespace vast {
 
+namespace {
+
+template <class BlockedSynopsis>
+caf::expected<flatbuffers::Offset<fbs::synopsis::v0>>
+pack_blocked(flatbuffers::FlatBufferBuilder& builder,
+             flatbuffers::Offset<flatbuffers::Vector<uint8_t>> column_name,
+             const BlockedSynopsis& synopsis,
+             fbs::bloom_filter_synopsis::ElementType element_type) {
+  auto params = parse_parameters(synopsis.type());
+  if (!params || !params->n || !params->p)
+    return caf::make_error(ec::format_error, "missing Bloom filter parameters");
+  const auto& filter = synopsis.filter();
+  auto words = builder.CreateVector(filter.words());
+  fbs::bloom_filter_synopsis::v0Builder bloom_filter_builder(builder);
+  bloom_filter_builder.add_element_type(element_type);
+  bloom_filter_builder.add_n(*params->n);
+  bloom_filter_builder.add_p(*params->p);
+  bloom_filter_builder.add_seed(filter.seed());
+  bloom_filter_builder.add_words(words);
+  auto bloom_filter_synopsis = bloom_filter_builder.Finish();
+  fbs::synopsis::v0Builder synopsis_builder(builder);
+  synopsis_builder.add_qualified_record_field(column_name);
+  synopsis_builder.add_bloom_filter_synopsis(bloom_filter_synopsis);
+  return synopsis_builder.Finish();
+}
+
+} // namespace
+
 synopsis::synopsis(vast::type x) : type_{std::move(x)} {
   // nop
 }
@@ -42,6 +79,10 @@ const vast::type& synopsis::type() const {
   return type_;
 }
 
+caf::optional<bool> synopsis::lookup_any(const membership_set& xs) const {
+  return lookup(relational_operator::in, make_view(xs.values()));
+}
+
 synopsis_ptr synopsis::shrink() const {
   return nullptr;
 }
@@ -99,6 +140,63 @@ pack(flatbuffers::FlatBufferBuilder& builder, const synopsis_ptr& synopsis,
     synopsis_builder.add_qualified_record_field(*column_name);
     synopsis_builder.add_bool_synopsis(&bool_synopsis);
     return synopsis_builder.Finish();
+  } else if (auto cptr = dynamic_cast<numeric_synopsis<count>*>(ptr)) {
+    fbs::count_synopsis::v0 count_synopsis(cptr->min(), cptr->max());
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_count_synopsis(&count_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto iptr = dynamic_cast<numeric_synopsis<integer>*>(ptr)) {
+    fbs::integer_synopsis::v0 integer_synopsis(iptr->min(), iptr->max());
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_integer_synopsis(&integer_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto rptr = dynamic_cast<numeric_synopsis<real>*>(ptr)) {
+    fbs::real_synopsis::v0 real_synopsis(rptr->min(), rptr->max());
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_real_synopsis(&real_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto dptr = dynamic_cast<numeric_synopsis<duration>*>(ptr)) {
+    fbs::duration_synopsis::v0 duration_synopsis(dptr->min().count(),
+                                                 dptr->max().count());
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_duration_synopsis(&duration_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto eptr = dynamic_cast<enumeration_synopsis*>(ptr)) {
+    auto words = eptr->words();
+    auto values = builder.CreateVector(words.data(), words.size());
+    fbs::enumeration_synopsis::v0Builder enumeration_builder(builder);
+    enumeration_builder.add_values(values);
+    auto enumeration_synopsis = enumeration_builder.Finish();
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_enumeration_synopsis(enumeration_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto pptr = dynamic_cast<port_synopsis*>(ptr)) {
+    auto values = flatbuffers::Offset<flatbuffers::Vector<uint64_t>>{};
+    if (auto xs = pptr->values())
+      values = builder.CreateVector(*xs);
+    fbs::port_synopsis::v0Builder port_builder(builder);
+    port_builder.add_min(pptr->min());
+    port_builder.add_max(pptr->max());
+    if (!values.IsNull())
+      port_builder.add_values(values);
+    auto port_synopsis = port_builder.Finish();
+    fbs::synopsis::v0Builder synopsis_builder(builder);
+    synopsis_builder.add_qualified_record_field(*column_name);
+    synopsis_builder.add_port_synopsis(port_synopsis);
+    return synopsis_builder.Finish();
+  } else if (auto aptr = dynamic_cast<blocked_address_synopsis<xxhash64>*>(
+               ptr)) {
+    return pack_blocked(builder, *column_name, *aptr,
+                        fbs::bloom_filter_synopsis::ElementType::Address);
+  } else if (auto sptr
+             = dynamic_cast<blocked_string_synopsis<xxhash64>*>(ptr)) {
+    return pack_blocked(builder, *column_name, *sptr,
+                        fbs::bloom_filter_synopsis::ElementType::String);
   } else {
     auto data = fbs::serialize_bytes(builder, synopsis);
     if (!data)
@@ -122,7 +220,56 @@ caf::error unpack(const fbs::synopsis::v0& synopsis, synopsis_ptr& ptr) {
     ptr = std::make_unique<time_synopsis>(
       vast::time{} + vast::duration{ts->start()},
       vast::time{} + vast::duration{ts->end()});
-  else if (auto os = synopsis.opaque_synopsis()) {
+  else if (auto cs = synopsis.count_synopsis())
+    ptr = std::make_unique<numeric_synopsis<count>>(count_type{}, cs->min(),
+                                                    cs->max());
+  else if (auto is = synopsis.integer_synopsis())
+    ptr = std::make_unique<numeric_synopsis<integer>>(integer_type{},
+                                                      is->min(), is->max());
+  else if (auto rs = synopsis.real_synopsis())
+    ptr = std::make_unique<numeric_synopsis<real>>(real_type{}, rs->min(),
+                                                   rs->max());
+  else if (auto ds = synopsis.duration_synopsis())
+    ptr = std::make_unique<numeric_synopsis<duration>>(
+      duration_type{}, duration{ds->min()}, duration{ds->max()});
+  else if (auto es = synopsis.enumeration_synopsis()) {
+    auto words = enumeration_synopsis::words_type{};
+    if (!es->values() || es->values()->size() != words.size())
+      return caf::make_error(ec::format_error, "invalid enumeration synopsis");
+    std::copy(es->values()->begin(), es->values()->end(), words.begin());
+    ptr = std::make_unique<enumeration_synopsis>(words);
+  } else if (auto ps = synopsis.port_synopsis()) {
+    auto values = std::optional<std::vector<count>>{};
+    if (ps->values())
+      values.emplace(ps->values()->begin(), ps->values()->end());
+    ptr = std::make_unique<port_synopsis>(ps->min(), ps->max(),
+                                          std::move(values));
+  } else if (auto bs = synopsis.bloom_filter_synopsis()) {
+    using filter_type = blocked_bloom_filter<xxhash64>;
+    if (!bs->words() || bs->words()->size() % filter_type::words_per_block != 0)
+      return caf::make_error(ec::format_error, "invalid Bloom filter synopsis");
+    auto params = bloom_filter_parameters{};
+    params.n = bs->n();
+    params.p = bs->p();
+    auto words = std::vector<filter_type::word_type>(bs->words()->begin(),
+                                                     bs->words()->end());
+    auto filter = filter_type{std::move(words), bs->seed()};
+    switch (bs->element_type()) {
+      case fbs::bloom_filter_synopsis::ElementType::Address:
+        ptr = std::make_unique<blocked_address_synopsis<xxhash64>>(
+          annotate_blocked_parameters(address_type{}, params),
+          std::move(filter));
+        break;
+      case fbs::bloom_filter_synopsis::ElementType::String:
+        ptr = std::make_unique<blocked_string_synopsis<xxhash64>>(
+          annotate_blocked_parameters(string_type{}, params),
+          std::move(filter));
+        break;
+      default:
+        return caf::make_error(ec::format_error, "invalid Bloom filter "
+                                                 "synopsis element type");
+    }
+  } else if (auto os = synopsis.opaque_synopsis()) {
     caf::binary_deserializer sink(
       nullptr, reinterpret_cast<const char*>(os->data()->data()),
       os->data()->size());
@@ -16,14 +16,34 @@
 #include "vast/address_synopsis.hpp"
 #include "vast/bool_synopsis.hpp"
 #include "vast/concept/hashable/xxhash.hpp"
+#include "vast/enumeration_synopsis.hpp"
+#include "vast/numeric_synopsis.hpp"
+#include "vast/port_synopsis.hpp"
 #include "vast/string_synopsis.hpp"
 #include "vast/time_synopsis.hpp"
 
 namespace vast {
 
+namespace {
+
+/// Ports are counts with a low cardinality, for which we keep the exact set
+/// of values. All other counts get a min-max synopsis.
+synopsis_ptr make_count_synopsis(type x, const caf::settings&) {
+  if (x.name() == "port")
+    return std::make_unique<port_synopsis>(std::move(x));
+  return std::make_unique<numeric_synopsis<count>>(std::move(x));
+}
+
+} // namespace
+
 void factory_traits<synopsis>::initialize() {
   factory<synopsis>::add(address_type{}, make_address_synopsis<xxhash64>);
   factory<synopsis>::add<bool_type, bool_synopsis>();
+  factory<synopsis>::add(count_type{}, make_count_synopsis);
+  factory<synopsis>::add<duration_type, numeric_synopsis<duration>>();
+  factory<synopsis>::add<enumeration_type, enumeration_synopsis>();
+  factory<synopsis>::add<integer_type, numeric_synopsis<integer>>();
+  factory<synopsis>::add<real_type, numeric_synopsis<real>>();
   factory<synopsis>::add(string_type{}, make_string_synopsis<xxhash64>);
   factory<synopsis>::add<time_type, time_synopsis>();
 }
@@ -24,6 +24,7 @@
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/path.hpp"
+#include "vast/system/metrics.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/status_verbosity.hpp"
 #include "vast/table_slice.hpp"
@@ -172,6 +173,13 @@ struct accountant_state_impl {
     record(key, x.time_since_epoch(), ts);
   }
 
+  void record(const report& r, time ts = std::chrono::system_clock::now()) {
+    for (const auto& [key, value] : r) {
+      auto f = [&, key = key](const auto& x) { record(key, x, ts); };
+      caf::visit(f, value);
+    }
+  }
+
   void command_line_heartbeat() {
 #if VAST_LOG_LEVEL >= VAST_LOG_LEVEL_DEBUG
     if (accumulator.events > 0)
@@ -261,6 +269,9 @@ accountant(accountant_actor::stateful_pointer<accountant_state> self,
     },
     // done?
     [](const bool&) { return false; });
+  // Snapshots of the metrics registry are recorded on behalf of the
+  // accountant itself.
+  self->state->actor_map[self->id()] = accountant_state::name;
   VAST_DEBUG("{} animates heartbeat loop", self);
   self->delayed_send(self, overview_delay, atom::telemetry_v);
   return {
@@ -300,12 +311,7 @@ accountant(accountant_actor::stateful_pointer<accountant_state> self,
     [self](const report& r) {
       VAST_TRACE_SCOPE("{} received a report from {}", self,
                        self->current_sender());
-      time ts = std::chrono::system_clock::now();
-      for (const auto& [key, value] : r) {
-        auto f
-          = [&, key = key](const auto& x) { self->state->record(key, x, ts); };
-        caf::visit(f, value);
-      }
+      self->state->record(r);
     },
     [self](const performance_report& r) {
       VAST_TRACE_SCOPE("{} received a performance report from {}", self,
@@ -342,6 +348,7 @@ accountant(accountant_actor::stateful_pointer<accountant_state> self,
       return result;
     },
     [self](atom::telemetry) {
+      self->state->record(metrics_registry::instance().snapshot());
       self->state->command_line_heartbeat();
       self->delayed_send(self, overview_delay, atom::telemetry_v);
     },
@@ -64,6 +64,14 @@ command::opts_builder add_index_opts(command::opts_builder ob) {
   return std::move(ob)
     .add<size_t>("max-partition-size", "maximum number of events in a "
                                        "partition")
+    .add<size_t>("active-partitions", "number of concurrently active "
+                                      "partitions")
+    .add<std::string>("partition-sharding", "assignment of events to active "
+                                            "partitions (round-robin|layout|"
+                                            "homogeneous)")
+    .add<std::string>("active-partition-timeout", "time after which an "
+                                                  "active partition gets "
+                                                  "sealed")
     .add<size_t>("max-resident-partitions", "maximum number of in-memory "
                                             "partitions")
     .add<size_t>("max-taste-partitions", "maximum number of immediately "
@@ -84,7 +92,9 @@ auto make_count_command() {
     opts("?vast.count")
       .add<bool>("disable-taxonomies", "don't substitute taxonomy identifiers")
       .add<bool>("estimate,e", "estimate an upper bound by "
-                               "skipping candidate checks"));
+                               "skipping candidate checks")
+      .add<std::string>("distinct", "estimate the number of distinct values "
+                                    "of a field (requires --estimate)"));
 }
 
 auto make_dump_command() {
@@ -125,6 +135,13 @@ auto make_export_command() {
       .add<bool>("unified,u", "marks a query as unified")
       .add<bool>("disable-taxonomies", "don't substitute taxonomy identifiers")
       .add<size_t>("max-events,n", "maximum number of results")
+      .add<std::vector<std::string>>("fields", "restrict results to the given "
+                                               "fields")
+      .add<bool>("explain", "print a profile of the query execution to "
+                            "stderr")
+      .add<std::string>("priority", "priority class of the query: low, "
+                                    "normal, or high")
+      .add<std::string>("order", "sort results by timestamp: asc or desc")
       .add<std::string>("read,r", "path for reading the query")
       .add<std::string>("write,w", "path to write events to")
       .add<bool>("uds,d", "treat -w as UNIX domain socket to connect to"));
@@ -460,6 +477,7 @@ auto make_command_factory() {
     {"send", remote_command},
     {"spawn accountant", remote_command},
     {"spawn archive", remote_command},
+    {"spawn compactor", remote_command},
     {"spawn eraser", remote_command},
     {"spawn exporter", remote_command},
     {"spawn explorer", remote_command},
@@ -524,6 +542,17 @@ auto make_root_command(std::string_view path) {
         .add<std::string>("aging-frequency", "interval between two aging "
                                              "cycles")
         .add<std::string>("aging-query", "query for aging out obsolete data")
+        .add<std::string>("compaction-interval", "interval between two "
+                                                 "partition compaction cycles")
+        .add<std::string>("filesystem-backend", "the backend for file "
+                                                "operations (posix or "
+                                                "io_uring)")
+        .add<size_t>("uring-queue-depth", "number of submission queue "
+                                          "entries of the io_uring backend")
+        .add<bool>("enable-journal", "write imported events to a journal "
+                                     "before acknowledging them")
+        .add<size_t>("max-journal-file-size", "maximum size of ingest journal "
+                                              "files in MiB")
         .add<std::string>("shutdown-grace-period",
                           "time to wait until component shutdown "
                           "finishes cleanly before inducing a hard kill");
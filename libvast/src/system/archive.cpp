@@ -19,9 +19,11 @@
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
+#include "vast/detail/tracepoint.hpp"
 #include "vast/logger.hpp"
 #include "vast/segment_store.hpp"
 #include "vast/store.hpp"
+#include "vast/system/query_profile.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/status_verbosity.hpp"
 #include "vast/table_slice.hpp"
@@ -70,6 +72,15 @@ void archive_state::next_session() {
   it->second.pop();
 }
 
+void archive_state::notify_disk_usage() {
+  auto bytes = store->bytes();
+  if (disk_usage_listener && bytes != reported_bytes)
+    self->send(disk_usage_listener, atom::write_v,
+               static_cast<int64_t>(bytes)
+                 - static_cast<int64_t>(reported_bytes));
+  reported_bytes = bytes;
+}
+
 void archive_state::send_report() {
   if (measurement.events > 0) {
     auto r = performance_report{{{std::string{name}, measurement}}};
@@ -146,7 +157,9 @@ archive(archive_actor::stateful_pointer<archive_state> self, path dir,
         return;
       }
       // Extract the next slice.
+      auto start = stopwatch::now();
       auto slice = self->state.session->next();
+      auto elapsed = stopwatch::now() - start;
       if (!slice) {
         auto err = slice.error() ? std::move(slice.error())
                                  : caf::make_error(ec::no_error);
@@ -157,6 +170,16 @@ archive(archive_actor::stateful_pointer<archive_state> self, path dir,
         self->state.next_session();
         return;
       }
+      VAST_TRACEPOINT(archive_extract, slice->rows(),
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                        elapsed)
+                        .count());
+      query_profiler::instance().update(
+        requester->id(), [&](query_profile& p) {
+          ++p.slices_decoded;
+          p.rows_decoded += slice->rows();
+          p.archive_lookup += elapsed;
+        });
       // The slice may contain entries that are not selected by xs.
       for (auto& sub_slice : select(*slice, xs))
         self->send(requester, sub_slice);
@@ -184,6 +207,7 @@ archive(archive_actor::stateful_pointer<archive_state> self, path dir,
                 events += slice.rows();
             }
             t.stop(events);
+            self->state.notify_disk_usage();
           },
           [=](caf::unit_t&, const caf::error& err) {
             // We get an 'unreachable' error when the stream becomes unreachable
@@ -209,6 +233,11 @@ archive(archive_actor::stateful_pointer<archive_state> self, path dir,
       self->send(self->state.accountant, atom::announce_v, self->name());
       self->delayed_send(self, defs::telemetry_rate, atom::telemetry_v);
     },
+    [self](atom::subscribe, atom::write,
+           disk_usage_listener_actor& listener) {
+      self->state.disk_usage_listener = std::move(listener);
+      self->state.reported_bytes = self->state.store->bytes();
+    },
     [self](atom::exporter, const caf::actor& exporter) {
       auto sender_addr = self->current_sender()->address();
       self->state.active_exporters.insert(sender_addr);
@@ -230,8 +259,12 @@ archive(archive_actor::stateful_pointer<archive_state> self, path dir,
     [self](atom::erase, const ids& xs) {
       if (auto err = self->state.store->erase(xs))
         VAST_ERROR("{} failed to erase events: {}", self, render(err));
+      self->state.notify_disk_usage();
       return atom::done_v;
     },
+    [self](atom::persist, atom::id) -> id {
+      return self->state.store->watermark();
+    },
   };
 }
 
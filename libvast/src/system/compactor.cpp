@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/compactor.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/error.hpp"
+#include "vast/error.hpp"
+#include "vast/ids.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/status_verbosity.hpp"
+
+#include <caf/settings.hpp>
+#include <caf/typed_event_based_actor.hpp>
+
+namespace vast::system {
+
+void compactor_state::run() {
+  self->request(index, caf::infinite, atom::merge_v, atom::candidate_v)
+    .then(
+      [this](std::vector<uuid>& candidates, ids& xs) {
+        if (candidates.size() < 2) {
+          VAST_DEBUG("{} found no partitions to merge", self);
+          schedule();
+          return;
+        }
+        VAST_DEBUG("{} loads {} events of {} partitions", self, rank(xs),
+                   candidates.size());
+        partitions = std::move(candidates);
+        expected_events = rank(xs);
+        self->send(archive, std::move(xs),
+                   static_cast<archive_client_actor>(self));
+      },
+      [this](const caf::error& err) {
+        VAST_WARN("{} failed to retrieve partitions to merge: {}", self,
+                  render(err));
+        schedule();
+      });
+}
+
+void compactor_state::schedule() {
+  partitions.clear();
+  slices.clear();
+  expected_events = 0;
+  self->delayed_send(self, interval, atom::run_v);
+}
+
+compactor_actor::behavior_type
+compactor(compactor_actor::stateful_pointer<compactor_state> self,
+          duration interval, archive_actor archive, index_actor index) {
+  VAST_TRACE_SCOPE("{} {} {}", VAST_ARG(self), VAST_ARG(archive),
+                   VAST_ARG(index));
+  self->state.self = self;
+  self->state.interval = interval;
+  self->state.archive = std::move(archive);
+  self->state.index = std::move(index);
+  // The ARCHIVE only answers requests of registered clients.
+  self->send(self->state.archive, atom::exporter_v,
+             caf::actor_cast<caf::actor>(self));
+  self->delayed_send(self, interval, atom::run_v);
+  return {
+    [self](atom::run) {
+      self->state.run();
+    },
+    [self](table_slice& slice) {
+      self->state.slices.push_back(std::move(slice));
+    },
+    [self](atom::done, const caf::error& err) {
+      if (err && err != ec::no_error) {
+        VAST_WARN("{} failed to load events from the archive: {}", self,
+                  render(err));
+        self->state.schedule();
+        return;
+      }
+      auto rows = uint64_t{0};
+      for (const auto& slice : self->state.slices)
+        rows += slice.rows();
+      if (rows != self->state.expected_events) {
+        VAST_WARN("{} aborts merge after loading {} of {} events from the "
+                  "archive",
+                  self, rows, self->state.expected_events);
+        self->state.schedule();
+        return;
+      }
+      auto n = self->state.partitions.size();
+      self
+        ->request(self->state.index, caf::infinite, atom::merge_v,
+                  std::exchange(self->state.partitions, {}),
+                  std::exchange(self->state.slices, {}))
+        .then(
+          [=](const uuid& partition) {
+            VAST_VERBOSE("{} merged {} partitions into partition {}", self, n,
+                         partition);
+            self->state.merged_partitions += n;
+            self->state.schedule();
+          },
+          [=](const caf::error& err) {
+            VAST_WARN("{} failed to merge partitions: {}", self, render(err));
+            self->state.schedule();
+          });
+    },
+    [self](atom::status, status_verbosity) {
+      caf::settings result;
+      auto& compactor_status = caf::put_dictionary(result, "compactor");
+      caf::put(compactor_status, "merged-partitions",
+               self->state.merged_partitions);
+      caf::put(compactor_status, "merging", self->state.partitions.size());
+      return result;
+    },
+  };
+}
+
+} // namespace vast::system
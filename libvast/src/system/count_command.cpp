@@ -88,7 +88,13 @@ caf::message count_command(const invocation& inv, caf::actor_system& sys) {
     // Loop until false.
     (counting)
     // Message handlers.
-    ([&](uint64_t x) { result += x; }, [&](atom::done) { counting = false; });
+    ([&](uint64_t x) { result += x; }, [&](atom::done) { counting = false; },
+     [&](caf::error& e) {
+       err = std::move(e);
+       counting = false;
+     });
+  if (err)
+    return caf::make_message(std::move(err));
   std::cout << result << std::endl;
   return caf::none;
 }
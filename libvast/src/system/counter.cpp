@@ -15,6 +15,7 @@
 
 #include "vast/bitmap_algorithms.hpp"
 #include "vast/logger.hpp"
+#include "vast/system/query_scheduler.hpp"
 #include "vast/table_slice.hpp"
 
 #include <caf/event_based_actor.hpp>
@@ -26,14 +27,19 @@ counter_state::counter_state(caf::event_based_actor* self) : super(self) {
 }
 
 void counter_state::init(expression expr, index_actor index,
-                         archive_actor archive, bool skip_candidate_check) {
+                         archive_actor archive, bool skip_candidate_check,
+                         std::string distinct) {
   skip_candidate_check_ = skip_candidate_check;
+  distinct_ = std::move(distinct);
   expr_ = std::move(expr);
   archive_ = std::move(archive);
   // Transition from idle state when receiving 'run' and client handle.
   behaviors_[idle].assign([=](atom::run, caf::actor client) {
     client_ = std::move(client);
-    start(expr_, index);
+    if (distinct_.empty())
+      start(expr_, index, query_priority::normal);
+    else
+      estimate_distinct(index);
     // Stop immediately when losing the client.
     self_->monitor(client_);
     self_->set_down_handler([this](caf::down_msg& dm) {
@@ -41,6 +47,10 @@ void counter_state::init(expression expr, index_actor index,
         self_->quit(dm.reason);
     });
   });
+  // Estimates come straight from the sketches of the META INDEX, so there is
+  // nothing to check.
+  if (!distinct_.empty())
+    return;
   // Add additional message handlers if we need to perform candidate checks.
   if (skip_candidate_check_)
     return;
@@ -49,11 +59,11 @@ void counter_state::init(expression expr, index_actor index,
   behaviors_[collect_hits] = base.or_else(
     [this](table_slice slice) {
       // Construct a candidate checker if we don't have one for this type.
-      auto it = checkers_.find(slice.layout());
+      auto it = checkers_.find(slice.layout_id());
       if (it == checkers_.end()) {
         if (auto x = tailor(expr_, slice.layout())) {
-          std::tie(it, std::ignore) = checkers_.emplace(
-            vast::record_type{slice.layout()}, std::move(*x));
+          std::tie(it, std::ignore)
+            = checkers_.emplace(slice.layout_id(), std::move(*x));
         } else {
           VAST_ERROR("{} failed to tailor expression: {}", self_,
                      self_->system().render(x.error()));
@@ -104,11 +114,28 @@ void counter_state::process_end_of_hits() {
   self_->quit();
 }
 
+void counter_state::estimate_distinct(const index_actor& index) {
+  self_->request(index, caf::infinite, atom::distinct_v, expr_, distinct_)
+    .then(
+      [this](uint64_t estimate) {
+        self_->send(client_, estimate);
+        self_->send(client_, atom::done_v);
+        self_->quit();
+      },
+      [this](caf::error& err) {
+        VAST_ERROR("{} failed to estimate the distinct values of {}: {}",
+                   self_, distinct_, self_->system().render(err));
+        self_->send(client_, err);
+        self_->quit(std::move(err));
+      });
+}
+
 caf::behavior
 counter(caf::stateful_actor<counter_state>* self, expression expr,
-        index_actor index, archive_actor archive, bool skip_candidate_check) {
+        index_actor index, archive_actor archive, bool skip_candidate_check,
+        std::string distinct) {
   self->state.init(std::move(expr), std::move(index), std::move(archive),
-                   skip_candidate_check);
+                   skip_candidate_check, std::move(distinct));
   return self->state.behavior();
 }
 
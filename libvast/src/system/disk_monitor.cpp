@@ -2,31 +2,24 @@
 
 #include "vast/fwd.hpp"
 
-#include "vast/concept/parseable/from_string.hpp"
-#include "vast/concept/parseable/vast/uuid.hpp"
 #include "vast/directory.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/path.hpp"
 #include "vast/system/archive.hpp"
+#include "vast/system/status_verbosity.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/detail/scope_guard.hpp>
 #include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
-#include <sys/stat.h>
+#include <algorithm>
 
 namespace vast::system {
 
 namespace {
 
-struct partition_diskstate {
-  uuid id;
-  off_t filesize;
-  time_t mtime;
-};
-
 template <typename Fun>
 std::shared_ptr<caf::detail::scope_guard<Fun>> make_shared_guard(Fun f) {
   return std::make_shared<caf::detail::scope_guard<Fun>>(std::forward<Fun>(f));
@@ -47,6 +40,14 @@ disk_monitor(disk_monitor_actor::stateful_pointer<disk_monitor_state> self,
   self->state.index = index;
   self->state.dbdir = dbdir;
   self->state.scan_interval = scan_interval;
+  // We walk the database directory only once and rely on the INDEX and the
+  // ARCHIVE to report the files they write and remove afterwards.
+  self->state.size = recursive_size(dbdir);
+  VAST_VERBOSE("{} found db-directory of size {} bytes", self,
+               self->state.size);
+  auto listener = static_cast<disk_usage_listener_actor>(self);
+  self->send(self->state.index, atom::subscribe_v, atom::write_v, listener);
+  self->send(self->state.archive, atom::subscribe_v, atom::write_v, listener);
   self->send(self, atom::ping_v);
   return {
     [self](atom::ping) {
@@ -57,84 +58,116 @@ disk_monitor(disk_monitor_actor::stateful_pointer<disk_monitor_state> self,
                    self);
         return;
       }
-      // TODO: This is going to do one syscall per file in the database
-      // directory. This feels a bit wasteful, but in practice we didn't
-      // see noticeable overhead even on large-ish databases.
-      // Nonetheless, if this becomes relevant we should switch to using
-      // `inotify()` or similar to do real-time tracking of the db size.
-      auto size = recursive_size(self->state.dbdir);
-      VAST_VERBOSE("{} checks db-directory of size {} bytes", self, size);
-      if (size > self->state.high_water_mark && !self->state.purging) {
+      VAST_VERBOSE("{} checks db-directory of size {} bytes", self,
+                   self->state.size);
+      if (self->state.size > self->state.high_water_mark
+          && !self->state.purging) {
         self->state.purging = true;
         self->send(self, atom::erase_v);
       }
     },
+    [self](atom::write, int64_t bytes) {
+      if (bytes < 0)
+        self->state.size
+          -= std::min(self->state.size, static_cast<uint64_t>(-bytes));
+      else
+        self->state.size += static_cast<uint64_t>(bytes);
+    },
     [self](atom::erase) {
       // Make sure the `purging` state will be reset once all continuations
       // have finished or we encountered an error.
       auto shared_guard
         = make_shared_guard([=] { self->state.purging = false; });
-      directory index_dir = self->state.dbdir / "index";
-      // TODO(ch20006): Add some check on the overall structure on the db dir.
-      std::vector<partition_diskstate> partitions;
-      for (auto file : index_dir) {
-        auto partition = file.basename().str();
-        if (partition == "index.bin")
-          continue;
-        uuid id;
-        if (!parsers::uuid(partition, id)) {
-          VAST_VERBOSE("{} failed to find partition {}", self, partition);
-          continue;
-        }
-        // TODO: Wrap a more generic `stat()` using `vast::path`.
-        struct stat statbuf;
-        if (::stat(file.complete().str().c_str(), &statbuf) < 0)
-          continue;
-        partitions.push_back({id, statbuf.st_size, statbuf.st_mtime});
-      }
-      if (partitions.empty()) {
-        VAST_VERBOSE("{} failed to find any partitions to delete", self);
+      if (self->state.size <= self->state.low_water_mark)
         return;
-      }
-      VAST_DEBUG("{} found {} partitions on disk", self, partitions.size());
-      std::sort(partitions.begin(), partitions.end(),
-                [](const auto& lhs, const auto& rhs) {
-                  return lhs.mtime < rhs.mtime;
-                });
-      auto oldest = partitions.front();
-      VAST_VERBOSE("{} erases partition {} from index", self, oldest.id);
-      self->request(self->state.index, caf::infinite, atom::erase_v, oldest.id)
+      self
+        ->request(self->state.index, caf::infinite, atom::erase_v,
+                  atom::candidate_v)
         .then(
-          [=, sg = shared_guard](ids erased_ids) {
-            // TODO: It would be more natural if we could chain these futures,
-            // instead of nesting them.
-            VAST_VERBOSE("{} erases removed ids from archive", self);
-            self
-              ->request(self->state.archive, caf::infinite, atom::erase_v,
-                        erased_ids)
-              .then(
-                [=, sg = shared_guard](atom::done) {
-                  auto sz = recursive_size(self->state.dbdir);
-                  VAST_VERBOSE("{} erased ids from index; {} bytes "
-                               "left on disk",
-                               self, sz);
-                  if (sz > self->state.low_water_mark) {
-                    // Repeat until we're below the low water mark
-                    self->send(self, atom::erase_v);
-                  }
-                },
-                [=, sg = shared_guard](caf::error e) {
-                  VAST_WARN("{} failed to erase from archive: {}", self,
-                            render(e));
-                });
+          [=](std::vector<uuid>& partitions, std::vector<uint64_t>& sizes) {
+            if (self->state.size <= self->state.low_water_mark)
+              return;
+            if (partitions.empty()) {
+              VAST_VERBOSE("{} failed to find any partitions to delete", self);
+              return;
+            }
+            VAST_DEBUG("{} found {} partitions on disk", self,
+                       partitions.size());
+            // The archive grows along with the index, so we assume that
+            // erasing a partition frees a share of the database that is
+            // proportional to the size of the partition. This lets us erase
+            // all partitions we need to get below the low water mark in a
+            // single round trip. The INDEX orders the partitions by the time
+            // of their latest event, so we erase the oldest events first.
+            auto index_size = uint64_t{0};
+            for (auto size : sizes)
+              index_size += size;
+            auto excess = self->state.size - self->state.low_water_mark;
+            auto scale = static_cast<double>(self->state.size)
+                         / std::max(index_size, uint64_t{1});
+            auto oldest = std::vector<uuid>{};
+            auto estimate = 0.0;
+            for (size_t i = 0; i < partitions.size(); ++i) {
+              oldest.push_back(partitions[i]);
+              estimate += sizes[i] * scale;
+              if (estimate >= excess)
+                break;
+            }
+            VAST_VERBOSE("{} erases {} partitions from index", self,
+                         oldest.size());
+            struct erase_state {
+              ids erased;
+              size_t pending;
+            };
+            auto state = std::make_shared<erase_state>();
+            state->pending = oldest.size();
+            auto erase_from_archive = [=, sg = shared_guard] {
+              VAST_VERBOSE("{} erases removed ids from archive", self);
+              self
+                ->request(self->state.archive, caf::infinite, atom::erase_v,
+                          std::move(state->erased))
+                .then(
+                  [=, sg = sg](atom::done) {
+                    VAST_VERBOSE("{} erased ids from index; {} bytes "
+                                 "left on disk",
+                                 self, self->state.size);
+                    if (self->state.size > self->state.low_water_mark) {
+                      // Repeat until we're below the low water mark
+                      self->send(self, atom::erase_v);
+                    }
+                  },
+                  [=, sg = sg](caf::error e) {
+                    VAST_WARN("{} failed to erase from archive: {}", self,
+                              render(e));
+                  });
+            };
+            for (const auto& id : oldest) {
+              self
+                ->request(self->state.index, caf::infinite, atom::erase_v, id)
+                .then(
+                  [=](ids& erased_ids) {
+                    state->erased |= erased_ids;
+                    if (--state->pending == 0)
+                      erase_from_archive();
+                  },
+                  [=](caf::error e) {
+                    VAST_WARN("{} failed to erase from index: {}", self,
+                              render(e));
+                    if (--state->pending == 0)
+                      erase_from_archive();
+                  });
+            }
           },
           [=, sg = shared_guard](caf::error e) {
-            VAST_WARN("{} failed to erase from index: {}", self, render(e));
+            VAST_WARN("{} failed to find partitions to erase: {}", self,
+                      render(e));
           });
     },
-    [](atom::status, status_verbosity) {
-      // TODO: Return some useful information here.
-      return caf::settings{};
+    [self](atom::status, status_verbosity) {
+      caf::settings result;
+      caf::put(result, "db-size", self->state.size);
+      caf::put(result, "purging", self->state.purging);
+      return result;
     },
   };
 }
@@ -17,8 +17,10 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/error.hpp"
 #include "vast/expression.hpp"
 #include "vast/logger.hpp"
+#include "vast/system/query_scheduler.hpp"
 
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
@@ -52,8 +54,26 @@ void eraser_state::init(caf::timespan interval, std::string query,
       VAST_ERROR("{} failed to normalize and validate {}", self_, query_);
       return;
     }
-    self_->send(index_, std::move(*expr));
-    transition_to(await_query_id);
+    // Erase all partitions that lie entirely within the query first. This
+    // only requires looking at the partition synopses, so the subsequent
+    // query only needs to evaluate the partitions at the boundary. Aging runs
+    // in the background, so the query must not delay interactive queries.
+    self_
+      ->request(index_, caf::infinite, atom::erase_v, *expr)
+      .then(
+        [=](ids& erased) {
+          VAST_VERBOSE("{} erased {} events of whole partitions", self_,
+                       rank(erased));
+          hits_ |= erased;
+          self_->send(index_, std::move(*expr), query_priority::low);
+          transition_to(await_query_id);
+        },
+        [=](caf::error& err) {
+          VAST_WARN("{} failed to erase whole partitions: {}", self_,
+                    render(err));
+          self_->send(index_, std::move(*expr), query_priority::low);
+          transition_to(await_query_id);
+        });
   });
   // Trigger the delayed send message.
   transition_to(idle);
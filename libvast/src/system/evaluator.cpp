@@ -15,8 +15,13 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
+#include "vast/detail/tracepoint.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
+#include "vast/system/instrumentation.hpp"
+#include "vast/system/query_profile.hpp"
 
 #include <caf/behavior.hpp>
 #include <caf/event_based_actor.hpp>
@@ -124,6 +129,17 @@ void evaluator_state::handle_missing_result(const offset& position,
   decrement_pending();
 }
 
+void evaluator_state::profile_lookup(const offset& position, const ids& result,
+                                     duration latency) {
+  query_profiler::instance().update(client->id(), [&](query_profile& p) {
+    auto pred = at(expr, position);
+    auto& x = p.predicates[pred != nullptr ? to_string(*pred) : "<unknown>"];
+    ++x.lookups;
+    x.hits += rank(result);
+    x.latency += latency;
+  });
+}
+
 void evaluator_state::evaluate() {
   auto expr_hits = caf::visit(ids_evaluator{predicate_hits}, expr);
   VAST_DEBUG("{} got predicate_hits: {} expr_hits: {}", self, predicate_hits,
@@ -149,6 +165,11 @@ evaluator_state::hits_for(const offset& position) {
   return i != predicate_hits.end() ? &i->second : nullptr;
 }
 
+ids evaluate_hits(const expression& expr,
+                  const evaluator_state::predicate_hits_map& hits) {
+  return caf::visit(ids_evaluator{hits}, expr);
+}
+
 evaluator_actor::behavior_type
 evaluator(evaluator_actor::stateful_pointer<evaluator_state> self,
           expression expr, std::vector<evaluation_triple> eval) {
@@ -168,11 +189,21 @@ evaluator(evaluator_actor::stateful_pointer<evaluator_state> self,
         auto& curried_pred = std::get<1>(triple);
         auto& indexer = std::get<2>(triple);
         ++self->state.predicate_hits[pos].first;
+        auto start = stopwatch::now();
         self->request(indexer, caf::infinite, curried_pred)
-          .then([=](const ids& hits) { self->state.handle_result(pos, hits); },
-                [=](const caf::error& err) {
-                  self->state.handle_missing_result(pos, err);
-                });
+          .then(
+            [=](const ids& hits) {
+              auto latency = stopwatch::now() - start;
+              VAST_TRACEPOINT(
+                indexer_lookup, rank(hits),
+                std::chrono::duration_cast<std::chrono::microseconds>(latency)
+                  .count());
+              self->state.profile_lookup(pos, hits, latency);
+              self->state.handle_result(pos, hits);
+            },
+            [=](const caf::error& err) {
+              self->state.handle_missing_result(pos, err);
+            });
       }
       if (self->state.pending_responses == 0) {
         VAST_DEBUG("{} has nothing to evaluate for expression", self);
@@ -23,9 +23,15 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/detail/tracepoint.hpp"
 #include "vast/error.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
+#include "vast/system/instrumentation.hpp"
+#include "vast/system/query_order.hpp"
+#include "vast/system/query_profile.hpp"
+#include "vast/system/query_scheduler.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/status_verbosity.hpp"
@@ -35,6 +41,9 @@
 #include <caf/stream_slot.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace vast::system {
 
 namespace {
@@ -95,6 +104,14 @@ void report_statistics(exporter_actor::stateful_pointer<exporter_state> self) {
   }
 }
 
+void report_profile(exporter_actor::stateful_pointer<exporter_state> self) {
+  auto& st = self->state;
+  auto profile = query_profiler::instance().take(self->id());
+  profile.runtime = st.query.runtime;
+  if (st.statistics_subscriber)
+    self->anon_send(st.statistics_subscriber, std::move(profile));
+}
+
 void shutdown(exporter_actor::stateful_pointer<exporter_state> self,
               caf::error err) {
   VAST_DEBUG("{} initiates shutdown with error {}", self, render(err));
@@ -154,14 +171,161 @@ void request_more_hits(exporter_actor::stateful_pointer<exporter_state> self) {
   self->send(st.index, st.id, detail::narrow<uint32_t>(n));
 }
 
+/// Looks up the flat column indices of a layout that match the requested
+/// fields. A field matches a column if it is a suffix of the column's fully
+/// qualified name, e.g., `id.orig_h` matches `zeek.conn.id.orig_h`.
+const std::vector<size_t>&
+projection(exporter_actor::stateful_pointer<exporter_state> self,
+           const table_slice& slice) {
+  auto& st = self->state;
+  auto it = st.projections.find(slice.layout_id());
+  if (it != st.projections.end())
+    return it->second;
+  auto result = std::vector<size_t>{};
+  auto flat_layout = flatten(slice.layout());
+  for (size_t i = 0; i < flat_layout.fields.size(); ++i) {
+    auto fqn = flat_layout.name() + '.' + flat_layout.fields[i].name;
+    auto matches = [&](const std::string& field) {
+      return fqn == field
+             || (fqn.size() > field.size()
+                 && fqn[fqn.size() - field.size() - 1] == '.'
+                 && detail::ends_with(fqn, field));
+    };
+    if (std::any_of(st.fields.begin(), st.fields.end(), matches))
+      result.push_back(i);
+  }
+  VAST_DEBUG("{} projects {} onto {} of {} columns", self, flat_layout.name(),
+             result.size(), flat_layout.fields.size());
+  return st.projections.emplace(slice.layout_id(), std::move(result))
+    .first->second;
+}
+
+/// Appends the selected rows of a slice to the results for the SINK.
+void cache_results(exporter_actor::stateful_pointer<exporter_state> self,
+                   const table_slice& slice, const ids& selection,
+                   uint64_t selection_size) {
+  if (self->state.fields.empty()) {
+    self->state.query.cached += selection_size;
+    select(self->state.results, slice, selection);
+  } else {
+    // Project only after the candidate check so that the predicate can still
+    // access all columns. Only the requested columns of the selected rows get
+    // decoded; slices with none of the requested fields are dropped.
+    const auto& columns = projection(self, slice);
+    if (columns.empty())
+      return;
+    auto selected = std::vector<table_slice>{};
+    select(selected, slice, selection);
+    for (auto& x : selected) {
+      auto projected = project(x, columns);
+      if (projected.encoding() == table_slice_encoding::none) {
+        VAST_WARN("{} drops {} events that it failed to project", self,
+                  x.rows());
+        continue;
+      }
+      self->state.query.cached += projected.rows();
+      self->state.results.push_back(std::move(projected));
+    }
+  }
+}
+
+/// Looks up the flat index of the `timestamp` column of a layout.
+caf::optional<size_t>
+timestamp_column(exporter_actor::stateful_pointer<exporter_state> self,
+                 const table_slice& slice) {
+  auto& st = self->state;
+  auto it = st.timestamp_columns.find(slice.layout_id());
+  if (it != st.timestamp_columns.end())
+    return it->second;
+  auto result = caf::optional<size_t>{};
+  auto flat_layout = flatten(slice.layout());
+  for (size_t i = 0; i < flat_layout.fields.size(); ++i) {
+    const auto& t = flat_layout.fields[i].type;
+    if (t.name() == "timestamp" && caf::holds_alternative<time_type>(t)) {
+      result = i;
+      break;
+    }
+  }
+  if (!result)
+    VAST_WARN("{} drops {} events from the ordered results because they lack "
+              "a timestamp",
+              self, flat_layout.name());
+  return st.timestamp_columns.emplace(slice.layout_id(), result).first->second;
+}
+
+/// Checks whether a timestamp comes before another one in the order of the
+/// query results.
+bool precedes(query_order order, time lhs, time rhs) {
+  return order == query_order::ascending ? lhs < rhs : lhs > rhs;
+}
+
+/// Merges the selected rows of a slice into the sorted rows of a time-ordered
+/// query, keeping only as many rows as the client requested. Rows with a null
+/// timestamp do not qualify.
+void merge_ordered(exporter_actor::stateful_pointer<exporter_state> self,
+                   const table_slice& slice, const ids& selection) {
+  auto& st = self->state;
+  auto column = timestamp_column(self, slice);
+  if (!column)
+    return;
+  auto mid = st.ordered.size();
+  for (auto row : select(selection)) {
+    auto x = slice.at(row - slice.offset(), *column);
+    if (auto timestamp = caf::get_if<view<time>>(&x))
+      st.ordered.push_back({*timestamp, slice, row});
+  }
+  auto less = [&](const auto& lhs, const auto& rhs) {
+    return precedes(st.order, lhs.timestamp, rhs.timestamp);
+  };
+  std::stable_sort(st.ordered.begin() + mid, st.ordered.end(), less);
+  std::inplace_merge(st.ordered.begin(), st.ordered.begin() + mid,
+                     st.ordered.end(), less);
+  auto limit = st.query.requested;
+  if (limit > 0 && limit < st.ordered.size())
+    st.ordered.erase(st.ordered.begin() + limit, st.ordered.end());
+}
+
+/// Checks whether a time-ordered query has all of its results, i.e., whether
+/// none of the partitions that the INDEX did not evaluate yet can contribute.
+bool has_ordered_results(const exporter_state& st) {
+  auto limit = st.query.requested;
+  if (limit == 0 || limit == max_events || st.ordered.size() < limit)
+    return false;
+  if (st.query.received >= st.bounds.size())
+    return true;
+  auto next = st.bounds[st.query.received];
+  return !precedes(st.order, next, st.ordered.back().timestamp);
+}
+
+/// Hands the rows of a time-ordered query to the SINK in order.
+void ship_ordered(exporter_actor::stateful_pointer<exporter_state> self) {
+  auto& st = self->state;
+  VAST_DEBUG("{} relays {} ordered events", self, st.ordered.size());
+  auto first = st.ordered.begin();
+  while (first != st.ordered.end()) {
+    // Select consecutive rows of the same slice at once.
+    auto last = std::next(first);
+    while (last != st.ordered.end()
+           && last->slice.offset() == first->slice.offset()
+           && last->row == std::prev(last)->row + 1)
+      ++last;
+    auto selection = make_ids({{first->row, std::prev(last)->row + 1}});
+    cache_results(self, first->slice, selection,
+                  detail::narrow<uint64_t>(std::distance(first, last)));
+    first = last;
+  }
+  st.ordered.clear();
+  ship_results(self);
+}
+
 void handle_batch(exporter_actor::stateful_pointer<exporter_state> self,
                   table_slice slice) {
   VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
   VAST_DEBUG("{} got batch of {} events", self, slice.rows());
   // Construct a candidate checker if we don't have one for this type.
-  type t = slice.layout();
-  auto it = self->state.checkers.find(t);
+  auto it = self->state.checkers.find(slice.layout_id());
   if (it == self->state.checkers.end()) {
+    type t = slice.layout();
     auto x = tailor(self->state.expr, t);
     if (!x) {
       VAST_ERROR("{} failed to tailor expression: {}", self, render(x.error()));
@@ -171,19 +335,35 @@ void handle_batch(exporter_actor::stateful_pointer<exporter_state> self,
     }
     VAST_DEBUG("{} tailored AST to {}: {}", self, t, x);
     std::tie(it, std::ignore)
-      = self->state.checkers.emplace(type{slice.layout()}, std::move(*x));
+      = self->state.checkers.emplace(slice.layout_id(), std::move(*x));
   }
   auto& checker = it->second;
   // Perform candidate check, splitting the slice into subsets if needed.
   self->state.query.processed += slice.rows();
+  auto start = stopwatch::now();
   auto selection = evaluate(checker, slice);
   auto selection_size = rank(selection);
+  auto elapsed = stopwatch::now() - start;
+  VAST_TRACEPOINT(exporter_candidate_check, slice.rows(), selection_size,
+                  std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+                    .count());
+  if (has_explain_option(self->state.options))
+    query_profiler::instance().update(self->id(), [&](query_profile& p) {
+      p.rows_checked += slice.rows();
+      p.rows_selected += selection_size;
+      p.candidate_check += elapsed;
+    });
   if (selection_size == 0) {
     // No rows qualify.
     return;
   }
-  self->state.query.cached += selection_size;
-  select(self->state.results, slice, selection);
+  // Time-ordered queries hold back their results until no partition that the
+  // INDEX did not evaluate yet can contribute.
+  if (self->state.order != query_order::none) {
+    merge_ordered(self, slice, selection);
+    return;
+  }
+  cache_results(self, slice, selection, selection_size);
   // Ship slices to connected SINKs.
   ship_results(self);
 }
@@ -192,17 +372,28 @@ void handle_batch(exporter_actor::stateful_pointer<exporter_state> self,
 
 exporter_actor::behavior_type
 exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
-         query_options options) {
+         query_options options, std::vector<std::string> fields) {
   self->state.options = options;
+  self->state.order = to_query_order(options);
   self->state.expr = std::move(expr);
+  self->state.fields = std::move(fields);
   if (has_continuous_option(options))
     VAST_DEBUG("{} has continuous query option", self);
+  if (has_explain_option(options)) {
+    VAST_DEBUG("{} collects a query profile", self);
+    query_profiler::instance().enable(self->id());
+    self->attach_functor(
+      [id = self->id()] { query_profiler::instance().take(id); });
+  }
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received exit from {} with reason: {}", self, msg.source,
                msg.reason);
     auto& st = self->state;
-    if (msg.reason != caf::exit_reason::kill)
+    if (msg.reason != caf::exit_reason::kill) {
+      if (has_explain_option(st.options))
+        report_profile(self);
       report_statistics(self);
+    }
     // Sending 0 to the index means dropping further results.
     self->send<caf::message_priority::high>(st.index, st.id,
                                             static_cast<uint32_t>(0));
@@ -287,20 +478,38 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
       // communication for typed actors. Hence, we must actor_cast here.
       // Ideally, we would change that index handler to actually return the
       // desired value.
+      auto priority = query_priority::normal;
+      if (has_low_priority_option(self->state.options))
+        priority = query_priority::low;
+      else if (has_high_priority_option(self->state.options))
+        priority = query_priority::high;
+      auto handle_lookup = [=](const uuid& lookup, uint32_t partitions,
+                               uint32_t scheduled) {
+        VAST_VERBOSE("{} got lookup handle {}, scheduled {}/{} partitions",
+                     self, lookup, scheduled, partitions);
+        self->state.id = lookup;
+        if (partitions > 0) {
+          self->state.query.expected = partitions;
+          self->state.query.scheduled = scheduled;
+        } else {
+          shutdown(self);
+        }
+      };
+      auto index = caf::actor_cast<caf::actor>(self->state.index);
+      if (self->state.order == query_order::none) {
+        self->request(index, caf::infinite, self->state.expr, priority)
+          .then(handle_lookup,
+                [=](const caf::error& e) { shutdown(self, e); });
+        return;
+      }
       self
-        ->request(caf::actor_cast<caf::actor>(self->state.index), caf::infinite,
-                  self->state.expr)
+        ->request(index, caf::infinite, self->state.expr, priority,
+                  self->state.order)
         .then(
-          [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled) {
-            VAST_VERBOSE("{} got lookup handle {}, scheduled {}/{} partitions",
-                         self, lookup, scheduled, partitions);
-            self->state.id = lookup;
-            if (partitions > 0) {
-              self->state.query.expected = partitions;
-              self->state.query.scheduled = scheduled;
-            } else {
-              shutdown(self);
-            }
+          [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled,
+              std::vector<time>& bounds) {
+            self->state.bounds = std::move(bounds);
+            handle_lookup(lookup, partitions, scheduled);
           },
           [=](const caf::error& e) { shutdown(self, e); });
     },
@@ -408,6 +617,17 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
         = std::chrono::system_clock::now() - self->state.start;
       self->state.query.runtime = runtime;
       self->state.query.received += self->state.query.scheduled;
+      if (self->state.order != query_order::none
+          && self->state.query.received < self->state.query.expected
+          && has_ordered_results(self->state)) {
+        VAST_DEBUG("{} skips {} partitions that cannot contribute to the "
+                   "ordered results",
+                   self,
+                   self->state.query.expected - self->state.query.received);
+        ship_ordered(self);
+        shutdown(self);
+        return {};
+      }
       if (self->state.query.received < self->state.query.expected) {
         VAST_DEBUG("{} received hits from {}/{} partitions", self,
                    self->state.query.received, self->state.query.expected);
@@ -417,6 +637,8 @@ exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
                    self->state.query.expected, vast::to_string(runtime));
         if (self->state.accountant)
           self->send(self->state.accountant, "exporter.hits.runtime", runtime);
+        if (self->state.order != query_order::none)
+          ship_ordered(self);
         if (finished(self->state.query))
           shutdown(self);
       }
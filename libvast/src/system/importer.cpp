@@ -32,10 +32,12 @@
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
 
+#include <caf/actor_system_config.hpp>
 #include <caf/attach_continuous_stream_stage.hpp>
 #include <caf/config_value.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 namespace vast::system {
@@ -56,13 +58,31 @@ public:
     VAST_TRACE_SCOPE("{}", VAST_ARG(slices));
     uint64_t events = 0;
     auto t = timer::start(state.measurement_);
-    for (auto&& slice : std::exchange(slices, {})) {
+    for (auto& slice : slices) {
       VAST_ASSERT(slice.rows() <= static_cast<size_t>(state.available_ids()));
       auto rows = slice.rows();
       events += rows;
       slice.offset(state.next_id(rows));
-      out.push(std::move(slice));
+      if (state.journal)
+        state.journal->append(slice);
+    }
+    // Make the whole batch durable with a single sync before handing it
+    // downstream and acknowledging it to the sources.
+    // Without a durable journal we must not acknowledge the batch, so we
+    // shut down instead and let the sources retry against a new importer.
+    if (state.journal) {
+      if (auto err = state.journal->commit()) {
+        VAST_ERROR("{} failed to commit {} events to the ingest journal: {}",
+                   state.self, events, render(err));
+        slices.clear();
+        state.self->quit(std::move(err));
+        return;
+      }
+      if (state.journal->files() > 1)
+        state.truncate_journal();
     }
+    for (auto&& slice : std::exchange(slices, {}))
+      out.push(std::move(slice));
     t.stop(events);
   }
 
@@ -200,6 +220,12 @@ importer_state::status(status_verbosity v) const {
     auto& sources_status = put_list(importer_status, "sources");
     for (const auto& kv : inbound_descriptions)
       sources_status.emplace_back(kv.second);
+    if (journal) {
+      auto& journal_status = put_dictionary(importer_status, "journal");
+      caf::put(journal_status, "files", journal->files());
+      caf::put(journal_status, "size", journal->size());
+      caf::put(journal_status, "commits", journal->commits());
+    }
   }
   // General state such as open streams.
   if (v >= status_verbosity::debug)
@@ -239,6 +265,34 @@ importer_state::status(status_verbosity v) const {
   return rp;
 }
 
+void importer_state::truncate_journal() {
+  if (truncating_journal || !index || !archive)
+    return;
+  truncating_journal = true;
+  auto fail = [this](const caf::error& err) {
+    truncating_journal = false;
+    VAST_WARN("{} failed to retrieve a persistence watermark: {}", self,
+              render(err));
+  };
+  self->request(index, caf::infinite, atom::persist_v, atom::id_v)
+    .then(
+      [this, fail](id index_watermark) {
+        self->request(archive, caf::infinite, atom::persist_v, atom::id_v)
+          .then(
+            [this, index_watermark](id archive_watermark) {
+              truncating_journal = false;
+              auto watermark = std::min(index_watermark, archive_watermark);
+              VAST_DEBUG("{} truncates the ingest journal up to ID {}", self,
+                         watermark);
+              if (auto err = journal->truncate(watermark))
+                VAST_WARN("{} failed to truncate the ingest journal: {}", self,
+                          render(err));
+            },
+            fail);
+      },
+      fail);
+}
+
 void importer_state::send_report() {
   auto now = stopwatch::now();
   if (measurement_.events > 0) {
@@ -278,6 +332,21 @@ importer(importer_actor::stateful_pointer<importer_state> self, path dir,
     return importer_actor::behavior_type::make_empty_behavior();
   }
   namespace defs = defaults::system;
+  auto& config = content(self->system().config());
+  if (caf::get_or(config, "vast.enable-journal", false)) {
+    using namespace si_literals;
+    auto max_file_size = caf::get_or(config, "vast.max-journal-file-size",
+                                     defs::max_journal_file_size);
+    auto journal = ingest_journal::make(self->state.dir / "journal",
+                                        max_file_size * 1_Mi);
+    if (!journal) {
+      VAST_ERROR("{} failed to open the ingest journal: {}", self,
+                 render(journal.error()));
+      self->quit(journal.error());
+      return importer_actor::behavior_type::make_empty_behavior();
+    }
+    self->state.journal = std::move(*journal);
+  }
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     self->state.send_report();
     self->quit(msg.reason);
@@ -285,8 +354,10 @@ importer(importer_actor::stateful_pointer<importer_state> self, path dir,
   self->state.stage = make_importer_stage(self);
   if (type_registry)
     self->state.stage->add_outbound_path(type_registry);
-  if (archive)
+  if (archive) {
+    self->state.archive = archive;
     self->state.stage->add_outbound_path(archive);
+  }
   if (index) {
     self->state.index = std::move(index);
     self->state.stage->add_outbound_path(self->state.index);
@@ -299,6 +370,22 @@ importer(importer_actor::stateful_pointer<importer_state> self, path dir,
       }
     }
   }
+  // Replay the journaled table slices with their original IDs. ARCHIVE and
+  // INDEX skip the ones they persisted before the restart.
+  if (self->state.journal) {
+    auto slices = self->state.journal->replay();
+    if (!slices) {
+      VAST_ERROR("{} failed to replay the ingest journal: {}", self,
+                 render(slices.error()));
+      self->quit(slices.error());
+      return importer_actor::behavior_type::make_empty_behavior();
+    }
+    if (!slices->empty())
+      VAST_INFO("{} replays {} table slices from the ingest journal", self,
+                slices->size());
+    for (auto& slice : *slices)
+      self->state.stage->out().push(std::move(slice));
+  }
   return {
     // Register the ACCOUNTANT actor.
     [self](accountant_actor accountant) {
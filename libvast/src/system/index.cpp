@@ -17,6 +17,8 @@
 
 #include "vast/chunk.hpp"
 #include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
+#include "vast/concept/printable/std/chrono.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 #include "vast/concept/printable/vast/error.hpp"
@@ -31,6 +33,7 @@
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/detail/settings.hpp"
+#include "vast/detail/spawn_container_source.hpp"
 #include "vast/error.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/fbs/index.hpp"
@@ -43,8 +46,11 @@
 #include "vast/logger.hpp"
 #include "vast/partition_synopsis.hpp"
 #include "vast/system/evaluator.hpp"
+#include "vast/system/instrumentation.hpp"
 #include "vast/system/meta_index.hpp"
 #include "vast/system/partition.hpp"
+#include "vast/system/query_profile.hpp"
+#include "vast/system/query_result_cache.hpp"
 #include "vast/system/query_supervisor.hpp"
 #include "vast/system/shutdown.hpp"
 #include "vast/system/status_verbosity.hpp"
@@ -63,6 +69,8 @@
 #include <chrono>
 #include <ctime>
 #include <memory>
+#include <numeric>
+#include <tuple>
 #include <unistd.h>
 
 using namespace std::chrono;
@@ -142,8 +150,110 @@ extract_partition_synopsis(const vast::path& partition_path,
                   span{chunk_out->data(), chunk_out->size()});
 }
 
+struct flush_fan_in_state {
+  static inline const char* name = "flush-fan-in";
+  size_t remaining = 0;
+};
+
+/// Forwards a single 'flush' message to *listener* after receiving *n* of
+/// them, one from each active partition.
+flush_listener_actor::behavior_type
+flush_fan_in(flush_listener_actor::stateful_pointer<flush_fan_in_state> self,
+             size_t n, flush_listener_actor listener) {
+  VAST_ASSERT(n > 0);
+  self->state.remaining = n;
+  return {
+    [self, listener = std::move(listener)](atom::flush) {
+      if (--self->state.remaining > 0)
+        return;
+      self->send(listener, atom::flush_v);
+      self->quit();
+    },
+  };
+}
+
+/// Sorts the candidate partitions of a time-ordered query such that the
+/// partitions that may contain the first results come first.
+/// @param candidates The candidate partitions.
+/// @param first The earliest timestamp of each candidate partition.
+/// @param last The latest timestamp of each candidate partition.
+/// @param order The order of the query results.
+/// @returns For every sorted candidate, the bound that no result in it or in
+///          any later candidate precedes.
+std::vector<time>
+sort_by_time(std::vector<uuid>& candidates, const std::vector<time>& first,
+             const std::vector<time>& last, query_order order) {
+  VAST_ASSERT(order != query_order::none);
+  VAST_ASSERT(candidates.size() == first.size());
+  VAST_ASSERT(candidates.size() == last.size());
+  const auto& bounds = order == query_order::ascending ? first : last;
+  std::vector<size_t> permutation(candidates.size());
+  std::iota(permutation.begin(), permutation.end(), size_t{0});
+  std::stable_sort(permutation.begin(), permutation.end(),
+                   [&](size_t lhs, size_t rhs) {
+                     return order == query_order::ascending
+                              ? bounds[lhs] < bounds[rhs]
+                              : bounds[lhs] > bounds[rhs];
+                   });
+  std::vector<uuid> sorted;
+  std::vector<time> result;
+  sorted.reserve(candidates.size());
+  result.reserve(candidates.size());
+  for (auto i : permutation) {
+    sorted.push_back(candidates[i]);
+    result.push_back(bounds[i]);
+  }
+  candidates = std::move(sorted);
+  return result;
+}
+
+/// Returns how often to check for stale active partitions. Checking more often
+/// than the timeout bounds how long a partition can outlive it to a tenth of
+/// the timeout.
+duration seal_interval(duration active_partition_timeout) {
+  return active_partition_timeout / 10;
+}
+
 } // namespace
 
+caf::expected<partition_sharding> to_partition_sharding(std::string_view str) {
+  if (str == "round-robin")
+    return partition_sharding::round_robin;
+  if (str == "layout")
+    return partition_sharding::layout;
+  if (str == "homogeneous")
+    return partition_sharding::homogeneous;
+  return caf::make_error(ec::invalid_configuration,
+                         "invalid partition sharding policy",
+                         std::string{str});
+}
+
+size_t partition_shard::select(const table_slice& slice) const {
+  if (count <= 1)
+    return 0;
+  switch (sharding) {
+    case partition_sharding::round_robin:
+      VAST_ASSERT(slices != nullptr);
+      return *slices % count;
+    case partition_sharding::layout:
+      return std::hash<std::string>{}(slice.layout().name()) % count;
+    case partition_sharding::homogeneous:
+      // The INDEX assigns layouts to shards dynamically, so there is no way
+      // to select the shard from the table slice alone.
+      VAST_ASSERT(!"homogeneous sharding requires the index state");
+      break;
+  }
+  return 0;
+}
+
+bool partition_shard_selector::operator()(const partition_shard& filter,
+                                          const table_slice& slice) const {
+  if (filter.sharding == partition_sharding::homogeneous)
+    return std::binary_search(filter.layouts.begin(), filter.layouts.end(),
+                              slice.layout().name());
+  return filter.select(slice) == filter.index;
+}
+
 vast::path index_state::partition_path(const uuid& id) const {
   return dir / to_string(id);
 }
@@ -154,12 +264,12 @@ vast::path index_state::partition_synopsis_path(const uuid& id) const {
 
 partition_actor partition_factory::operator()(const uuid& id) const {
   // Load partition from disk.
-  VAST_ASSERT(std::find(state_.persisted_partitions.begin(),
-                        state_.persisted_partitions.end(), id)
-              != state_.persisted_partitions.end());
+  VAST_ASSERT(state_.persisted_partitions.count(id) != 0
+              || state_.retired_partitions.count(id) != 0);
   auto path = state_.partition_path(id);
   VAST_DEBUG("{} loads partition {} for path {}", state_.self, id, path);
-  return state_.self->spawn(passive_partition, id, filesystem_, path);
+  return state_.self->spawn(passive_partition, id, filesystem_, path,
+                            state_.result_cache);
 }
 
 filesystem_actor& partition_factory::filesystem() {
@@ -197,6 +307,20 @@ caf::error index_state::load_from_disk() {
     auto index_v0 = index->index_as_v0();
     auto partition_uuids = index_v0->partitions();
     VAST_ASSERT(partition_uuids);
+    // Merged partitions are retired before their files are removed, so a
+    // crash in between leaves them behind.
+    if (auto retired = index_v0->retired()) {
+      for (auto uuid_fb : *retired) {
+        VAST_ASSERT(uuid_fb);
+        vast::uuid partition_uuid;
+        unpack(*uuid_fb, partition_uuid);
+        VAST_DEBUG("{} removes retired partition {}", self, partition_uuid);
+        for (const auto& file : {partition_path(partition_uuid),
+                                 partition_synopsis_path(partition_uuid)})
+          if (exists(file) && !rm(file))
+            VAST_WARN("{} could not unlink {}", self, file);
+      }
+    }
     auto synopses = std::make_shared<std::map<uuid, partition_synopsis>>();
     for (auto uuid_fb : *partition_uuids) {
       VAST_ASSERT(uuid_fb);
@@ -230,6 +354,12 @@ caf::error index_state::load_from_disk() {
       if (auto error = unpack(*ps_flatbuffer->partition_synopsis_as_v0(), ps))
         return error;
       meta_index_bytes += ps.memusage();
+      if (auto size = file_size(part_dir))
+        partition_bytes[partition_uuid] = *size + chunk->size();
+      for (auto [first, last] : ps.id_ranges) {
+        persisted_ids.inject(first, last, partition_uuid);
+        ingested_end = std::max(ingested_end, last);
+      }
       persisted_partitions.insert(partition_uuid);
       synopses->emplace(std::move(partition_uuid), std::move(ps));
     }
@@ -273,20 +403,108 @@ caf::error index_state::load_from_disk() {
   return caf::none;
 }
 
-bool index_state::worker_available() {
-  return !idle_workers.empty();
-}
-
-std::optional<query_supervisor_actor> index_state::next_worker() {
-  if (!worker_available()) {
+void index_state::schedule_queries() {
+  while (!idle_workers.empty()) {
+    auto request = scheduler.pop();
+    if (!request)
+      break;
+    auto worker = std::move(idle_workers.back());
+    idle_workers.pop_back();
+    dispatch(std::move(worker), std::move(*request));
+  }
+  // Grow the pool for the requests that may run but lack a worker.
+  auto runnable = scheduler.runnable();
+  while (starting_workers < runnable && num_workers < max_workers)
+    spawn_worker();
+  if (runnable > starting_workers)
     VAST_VERBOSE("{} waits for query supervisors to become available to "
                  "delegate work; consider increasing 'vast.max-queries'",
                  self);
-    return std::nullopt;
+}
+
+void index_state::dispatch(query_supervisor_actor worker,
+                           query_request request) {
+  auto iter = pending.find(request.query_id);
+  if (iter == pending.end()) {
+    VAST_WARN("{} drops query for unknown query id {}", self,
+              request.query_id);
+    scheduler.release(request.priority);
+    self->send(request.client, atom::done_v);
+    idle_workers.push_back(std::move(worker));
+    return;
   }
-  auto result = std::move(idle_workers.back());
-  idle_workers.pop_back();
-  return result;
+  auto& lookup = iter->second;
+  // Get partition actors, spawning new ones if needed.
+  auto cached = ids{};
+  auto actors = collect_query_actors(lookup, request.num_partitions, cached);
+  // Report the hits from the result cache before scheduling the evaluation:
+  // the client receives them before the query supervisor can send its final
+  // done, because we enqueue them first.
+  if (any<1>(cached))
+    self->send(request.client, std::move(cached));
+  // Delegate to query supervisor (uses up this worker) and report
+  // query ID + some stats to the client.
+  VAST_DEBUG("{} schedules {} more partition(s) for {} priority query id {} "
+             "with {} partitions remaining",
+             self, actors.size(), to_string(request.priority),
+             request.query_id, lookup.partitions.size());
+  busy_workers.emplace(worker.id(), request.priority);
+  last_dispatch = std::chrono::system_clock::now();
+  self->send(worker, lookup.expression, std::move(actors),
+             std::move(request.client));
+  // Cleanup if we exhausted all candidates.
+  if (lookup.partitions.empty())
+    pending.erase(iter);
+}
+
+void index_state::spawn_worker() {
+  self->spawn(query_supervisor,
+              caf::actor_cast<query_supervisor_master_actor>(self));
+  ++num_workers;
+  ++starting_workers;
+}
+
+void index_state::release_worker(query_supervisor_actor worker) {
+  if (auto it = busy_workers.find(worker.id()); it != busy_workers.end()) {
+    scheduler.release(it->second);
+    busy_workers.erase(it);
+  } else {
+    VAST_ASSERT(starting_workers > 0);
+    --starting_workers;
+  }
+  idle_workers.push_back(std::move(worker));
+  schedule_queries();
+  // Shrink the pool only after the load stays low for a while, so that bursts
+  // of queries do not respawn the workers that the last burst left behind.
+  if (idle_workers.size() > defaults::system::idle_query_supervisors
+      && !shrink_scheduled) {
+    shrink_scheduled = true;
+    self->delayed_send(self, defaults::system::idle_query_supervisor_timeout,
+                       atom::internal_v, atom::worker_v);
+  }
+}
+
+void index_state::shrink_workers() {
+  shrink_scheduled = false;
+  if (idle_workers.size() <= defaults::system::idle_query_supervisors)
+    return;
+  auto idle = std::chrono::system_clock::now() - last_dispatch;
+  if (idle < defaults::system::idle_query_supervisor_timeout) {
+    shrink_scheduled = true;
+    self->delayed_send(self,
+                       defaults::system::idle_query_supervisor_timeout - idle,
+                       atom::internal_v, atom::worker_v);
+    return;
+  }
+  // Workers at the front of the pool idled the longest.
+  auto surplus = idle_workers.size() - defaults::system::idle_query_supervisors;
+  VAST_DEBUG("{} shuts down {} idle query supervisors", self, surplus);
+  for (size_t i = 0; i < surplus; ++i)
+    self->send_exit(idle_workers[i], caf::exit_reason::user_shutdown);
+  idle_workers.erase(idle_workers.begin(),
+                     idle_workers.begin()
+                       + detail::narrow_cast<std::ptrdiff_t>(surplus));
+  num_workers -= surplus;
 }
 
 void index_state::add_flush_listener(flush_listener_actor listener) {
@@ -305,37 +523,65 @@ void index_state::notify_flush_listeners() {
     return;
   VAST_DEBUG("{} sends 'flush' messages to {} listeners", self,
              flush_listeners.size());
+  auto num_active = std::count_if(
+    active_partitions.begin(), active_partitions.end(),
+    [](const auto& active) { return active.actor != nullptr; });
   for (auto& listener : flush_listeners) {
-    if (active_partition.actor)
-      self->send(active_partition.actor, atom::subscribe_v, atom::flush_v,
-                 listener);
-    else
+    if (num_active == 0) {
       self->send(listener, atom::flush_v);
+      continue;
+    }
+    // With multiple active partitions, the listener must only get notified
+    // once all of them flushed.
+    auto subscriber = num_active == 1
+                        ? listener
+                        : self->spawn(flush_fan_in,
+                                      detail::narrow_cast<size_t>(num_active),
+                                      listener);
+    for (auto& active : active_partitions)
+      if (active.actor)
+        self->send(active.actor, atom::subscribe_v, atom::flush_v, subscriber);
   }
   flush_listeners.clear();
 }
 
-void index_state::create_active_partition() {
+void index_state::add_partition_bytes(const uuid& id) {
+  auto bytes = uint64_t{0};
+  for (const auto& file : {partition_path(id), partition_synopsis_path(id)})
+    if (auto size = file_size(file))
+      bytes += *size;
+  partition_bytes[id] = bytes;
+  if (disk_usage_listener)
+    self->send(disk_usage_listener, atom::write_v,
+               static_cast<int64_t>(bytes));
+}
+
+void index_state::remove_partition_bytes(const uuid& id) {
+  auto node = partition_bytes.extract(id);
+  if (!node.empty() && disk_usage_listener)
+    self->send(disk_usage_listener, atom::write_v,
+               -static_cast<int64_t>(node.mapped()));
+}
+
+void index_state::create_active_partition(size_t shard) {
+  VAST_ASSERT(shard < active_partitions.size());
+  auto& active_partition = active_partitions[shard];
   auto id = uuid::random();
-  caf::settings index_opts;
-  index_opts["cardinality"] = partition_capacity;
-  // These options must be kept in sync with vast/address_synopsis.hpp and
-  // vast/string_synopsis.hpp respectively.
-  auto synopsis_options = caf::settings{};
-  put(synopsis_options, "max-partition-size", partition_capacity);
-  put(synopsis_options, "address-synopsis-fp-rate", meta_index_fp_rate);
-  put(synopsis_options, "string-synopsis-fp-rate", meta_index_fp_rate);
   active_partition.actor
-    = self->spawn(::vast::system::active_partition, id, filesystem, index_opts,
-                  synopsis_options);
+    = self->spawn(::vast::system::active_partition, id, filesystem,
+                  partition_index_options(), partition_synopsis_options());
   active_partition.stream_slot
     = stage->add_outbound_path(active_partition.actor);
+  stage->out().set_filter(active_partition.stream_slot, shard_filter(shard));
   active_partition.capacity = partition_capacity;
   active_partition.id = id;
-  VAST_DEBUG("{} created new partition {}", self, id);
+  active_partition.created = std::chrono::system_clock::now();
+  VAST_DEBUG("{} created new partition {} for shard {}", self, id, shard);
 }
 
-void index_state::decomission_active_partition() {
+void index_state::decomission_active_partition(size_t shard) {
+  VAST_ASSERT(shard < active_partitions.size());
+  auto& active_partition = active_partitions[shard];
   auto id = active_partition.id;
   auto actor = std::exchange(active_partition.actor, {});
   unpersisted[id] = actor;
@@ -364,7 +610,9 @@ void index_state::decomission_active_partition() {
               VAST_DEBUG("{} received ok for request to persist partition {}",
                          self, id);
               unpersisted.erase(id);
+              unpersisted_offsets.erase(id);
               persisted_partitions.insert(id);
+              add_partition_bytes(id);
             },
             [=](caf::error err) {
               VAST_DEBUG("{} received error for request to persist partition "
@@ -379,6 +627,158 @@ void index_state::decomission_active_partition() {
       });
 }
 
+bool index_state::is_active_partition(const uuid& id) const {
+  return std::any_of(active_partitions.begin(), active_partitions.end(),
+                     [&](const auto& active) {
+                       return active.actor != nullptr && active.id == id;
+                     });
+}
+
+caf::settings index_state::partition_index_options() const {
+  caf::settings result;
+  result["cardinality"] = partition_capacity;
+  return result;
+}
+
+caf::settings index_state::partition_synopsis_options() const {
+  // These options must be kept in sync with vast/address_synopsis.hpp and
+  // vast/string_synopsis.hpp respectively.
+  caf::settings result;
+  put(result, "max-partition-size", partition_capacity);
+  put(result, "address-synopsis-fp-rate", meta_index_fp_rate);
+  put(result, "string-synopsis-fp-rate", meta_index_fp_rate);
+  put(result, "hyperloglog-precision", hyperloglog_precision);
+  return result;
+}
+
+void index_state::remove_retired_partitions() {
+  auto is_pending = [&](const uuid& id) {
+    return std::any_of(pending.begin(), pending.end(), [&](const auto& kv) {
+      const auto& xs = kv.second.partitions;
+      return std::find(xs.begin(), xs.end(), id) != xs.end();
+    });
+  };
+  for (auto it = retired_partitions.begin();
+       it != retired_partitions.end();) {
+    if (is_pending(*it)) {
+      ++it;
+      continue;
+    }
+    VAST_DEBUG("{} removes retired partition {}", self, *it);
+    inmem_partitions.drop(*it);
+    if (result_cache)
+      result_cache->invalidate(*it);
+    // Partitions that are currently evaluating a query keep their mmapped
+    // files alive, so unlinking is safe.
+    if (!rm(partition_path(*it)))
+      VAST_WARN("{} could not unlink partition at {}", self,
+                partition_path(*it));
+    if (!rm(partition_synopsis_path(*it)))
+      VAST_WARN("{} could not unlink partition synopsis at {}", self,
+                partition_synopsis_path(*it));
+    remove_partition_bytes(*it);
+    it = retired_partitions.erase(it);
+  }
+}
+
+void index_state::finish_compaction() {
+  compacting = false;
+  compaction_inputs.clear();
+  compaction_cancelled = false;
+  for (auto& [partition, rp] : std::exchange(deferred_erasures, {}))
+    rp.delegate(static_cast<index_actor>(self), atom::erase_v, partition);
+}
+
+size_t index_state::shard_of(const table_slice& slice) {
+  if (sharding != partition_sharding::homogeneous)
+    return shard_filter(0).select(slice);
+  const auto& name = slice.layout().name();
+  if (auto it = layout_shards.find(name); it != layout_shards.end())
+    return it->second;
+  auto group = name;
+  if (auto it = layout_groups.find(name); it != layout_groups.end())
+    group = it->second;
+  auto [it, inserted]
+    = group_shards.try_emplace(std::move(group), active_partitions.size());
+  auto shard = it->second;
+  if (inserted) {
+    VAST_DEBUG("{} adds shard {} for layout group {}", self, shard, it->first);
+    active_partitions.emplace_back();
+  }
+  layout_shards.emplace(name, shard);
+  // An existing active partition of the group must accept the new layout
+  // from now on.
+  if (auto& active = active_partitions[shard]; active.actor)
+    stage->out().set_filter(active.stream_slot, shard_filter(shard));
+  return shard;
+}
+
+partition_shard index_state::shard_filter(size_t shard) const {
+  auto result = partition_shard{shard, active_partitions.size(), sharding};
+  if (sharding == partition_sharding::round_robin)
+    result.slices = round_robin_slices;
+  if (sharding == partition_sharding::homogeneous) {
+    for (const auto& [layout, layout_shard] : layout_shards)
+      if (layout_shard == shard)
+        result.layouts.push_back(layout);
+    std::sort(result.layouts.begin(), result.layouts.end());
+  }
+  return result;
+}
+
+void index_state::seal_stale_partitions() {
+  auto now = std::chrono::system_clock::now();
+  auto sealed = false;
+  // Iterate backwards, because removing a shard shifts all later shards.
+  for (auto shard = active_partitions.size(); shard-- > 0;) {
+    auto& active = active_partitions[shard];
+    if (!active.actor || now - active.created < active_partition_timeout)
+      continue;
+    VAST_VERBOSE("{} seals active partition {} after reaching the timeout of "
+                 "{}",
+                 self, active.id, to_string(active_partition_timeout));
+    decomission_active_partition(shard);
+    if (sharding == partition_sharding::homogeneous)
+      remove_shard(shard);
+    sealed = true;
+  }
+  if (sealed)
+    flush_to_disk();
+}
+
+void index_state::remove_shard(size_t shard) {
+  VAST_ASSERT(sharding == partition_sharding::homogeneous);
+  VAST_ASSERT(shard < active_partitions.size());
+  VAST_ASSERT(!active_partitions[shard].actor);
+  VAST_DEBUG("{} removes shard {}", self, shard);
+  active_partitions.erase(active_partitions.begin() + shard);
+  auto shift = [&](std::unordered_map<std::string, size_t>& shards) {
+    for (auto it = shards.begin(); it != shards.end();) {
+      if (it->second == shard) {
+        it = shards.erase(it);
+        continue;
+      }
+      if (it->second > shard)
+        --it->second;
+      ++it;
+    }
+  };
+  shift(layout_shards);
+  shift(group_shards);
+  // Homogeneous stream filters select by layout, but keep their positions in
+  // sync with the active partitions nonetheless.
+  for (auto i = shard; i < active_partitions.size(); ++i)
+    if (auto& active = active_partitions[i]; active.actor)
+      stage->out().set_filter(active.stream_slot, shard_filter(i));
+}
+
+id index_state::watermark() const {
+  auto result = ingested_end;
+  for (const auto& [_, offset] : unpersisted_offsets)
+    result = std::min(result, offset);
+  return result;
+}
+
 caf::typed_response_promise<caf::settings>
 index_state::status(status_verbosity v) const {
   using caf::put;
@@ -415,9 +815,18 @@ index_state::status(status_verbosity v) const {
     }
     put(index_status, "meta-index-bytes", meta_index_bytes);
     put(index_status, "num-active-partitions",
-        active_partition.actor == nullptr ? 0 : 1);
+        std::count_if(active_partitions.begin(), active_partitions.end(),
+                      [](const auto& active) {
+                        return active.actor != nullptr;
+                      }));
     put(index_status, "num-cached-partitions", inmem_partitions.size());
     put(index_status, "num-unpersisted-partitions", unpersisted.size());
+    put(index_status, "num-query-supervisors", num_workers);
+    put(index_status, "num-idle-query-supervisors", idle_workers.size());
+    scheduler.inspect_status(put_dictionary(index_status, "queries"));
+    if (result_cache)
+      result_cache->inspect_status(
+        put_dictionary(index_status, "result-cache"));
     auto& partitions = put_dictionary(index_status, "partitions");
     auto partition_status = [&](const uuid& id, const partition_actor& pa,
                                 caf::config_value::list& xs) {
@@ -451,9 +860,10 @@ index_state::status(status_verbosity v) const {
     };
     // Resident partitions.
     auto& active = caf::put_list(partitions, "active");
-    active.reserve(1);
-    if (active_partition.actor != nullptr)
-      partition_status(active_partition.id, active_partition.actor, active);
+    active.reserve(active_partitions.size());
+    for (const auto& active_partition : active_partitions)
+      if (active_partition.actor != nullptr)
+        partition_status(active_partition.id, active_partition.actor, active);
     auto& cached = put_list(partitions, "cached");
     cached.reserve(inmem_partitions.size());
     for (auto& [id, actor] : inmem_partitions)
@@ -472,32 +882,69 @@ index_state::status(status_verbosity v) const {
 
 std::vector<std::pair<uuid, partition_actor>>
 index_state::collect_query_actors(query_state& lookup,
-                                  uint32_t num_partitions) {
+                                  uint32_t num_partitions, ids& cached) {
   VAST_TRACE_SCOPE("{} {}", VAST_ARG(lookup), VAST_ARG(num_partitions));
   std::vector<std::pair<uuid, partition_actor>> result;
   if (num_partitions == 0 || lookup.partitions.empty())
     return result;
-  // Prefer partitions that are already available in RAM.
+  // Only passive partitions are immutable, so only their hits are cached.
+  auto key = result_cache ? to_string(lookup.expression) : std::string{};
+  auto is_passive = [&](const uuid& candidate) {
+    return persisted_partitions.count(candidate)
+           || retired_partitions.count(candidate);
+  };
+  auto is_cached = [&](const uuid& candidate) {
+    return result_cache && is_passive(candidate)
+           && result_cache->contains(candidate, key);
+  };
+  // Prefer partitions that are already available in RAM, unless the client
+  // relies on the order of the candidates.
   auto partition_is_loaded = [&](const uuid& candidate) {
-    return (active_partition.actor != nullptr
-            && active_partition.id == candidate)
-           || unpersisted.count(candidate)
-           || inmem_partitions.contains(candidate);
+    return is_active_partition(candidate) || unpersisted.count(candidate)
+           || inmem_partitions.contains(candidate) || is_cached(candidate);
   };
-  std::partition(lookup.partitions.begin(), lookup.partitions.end(),
-                 partition_is_loaded);
+  if (lookup.order == query_order::none)
+    std::partition(lookup.partitions.begin(), lookup.partitions.end(),
+                   partition_is_loaded);
+  // Ask the filesystem to read ahead the cold partitions we are about to load,
+  // as well as those that will most likely be part of the next batch for this
+  // query. This replaces many serial page faults in the passive partitions
+  // with a single batch of asynchronous readahead.
+  auto lookahead = std::min(lookup.partitions.size(),
+                            size_t{num_partitions} * 2);
+  std::vector<path> prefetch;
+  for (size_t i = 0; i < lookahead; ++i) {
+    const auto& candidate = lookup.partitions[i];
+    if (!partition_is_loaded(candidate) && is_passive(candidate))
+      prefetch.push_back(partition_path(candidate));
+  }
+  if (!prefetch.empty()) {
+    VAST_DEBUG("{} prefetches {} partitions", self, prefetch.size());
+    self
+      ->request(filesystem, caf::infinite, atom::prefetch_v,
+                std::move(prefetch))
+      .then([](atom::ok) {},
+            [=](const caf::error& err) {
+              VAST_DEBUG("{} failed to prefetch partitions: {}", self,
+                         render(err));
+            });
+  }
   // Helper function to spin up EVALUATOR actors for a single partition.
   auto spin_up = [&](const uuid& partition_id) -> partition_actor {
-    // We need to first check whether the ID is the active partition or one
+    // We need to first check whether the ID is an active partition or one
     // of our unpersisted ones. Only then can we dispatch to our LRU cache.
     partition_actor part;
-    if (active_partition.actor != nullptr
-        && active_partition.id == partition_id)
-      part = active_partition.actor;
+    auto active = std::find_if(active_partitions.begin(),
+                               active_partitions.end(), [&](const auto& x) {
+                                 return x.actor != nullptr
+                                        && x.id == partition_id;
+                               });
+    if (active != active_partitions.end())
+      part = active->actor;
     else if (auto it = unpersisted.find(partition_id); it != unpersisted.end())
       part = it->second;
-    else if (auto it = persisted_partitions.find(partition_id);
-             it != persisted_partitions.end())
+    else if (persisted_partitions.count(partition_id)
+             || retired_partitions.count(partition_id))
       part = inmem_partitions.get_or_load(partition_id);
     if (!part)
       VAST_ERROR("{} could not load partition {} that was part of a "
@@ -506,17 +953,27 @@ index_state::collect_query_actors(query_state& lookup,
     return part;
   };
   // Loop over the candidate set until we either successfully scheduled
-  // num_partitions partitions or run out of candidates.
+  // num_partitions partitions or run out of candidates. Partitions with
+  // cached hits count towards the limit, but need no evaluation.
   auto it = lookup.partitions.begin();
   auto last = lookup.partitions.end();
-  while (it != last && result.size() < num_partitions) {
+  size_t num_cached = 0;
+  while (it != last && result.size() + num_cached < num_partitions) {
     auto partition_id = *it++;
+    if (result_cache && is_passive(partition_id)) {
+      if (auto hits = result_cache->lookup(partition_id, key)) {
+        cached |= *hits;
+        ++num_cached;
+        continue;
+      }
+    }
     if (auto partition_actor = spin_up(partition_id))
       result.push_back(std::make_pair(partition_id, partition_actor));
   }
   lookup.partitions.erase(lookup.partitions.begin(), it);
-  VAST_DEBUG("{} launched {} partition actors to evaluate query", self,
-             result.size());
+  VAST_DEBUG("{} launched {} partition actors to evaluate query and "
+             "answered {} partitions from the result cache",
+             self, result.size(), num_cached);
   return result;
 }
 
@@ -548,6 +1005,14 @@ pack(flatbuffers::FlatBufferBuilder& builder, const index_state& state) {
       return uuid_fb.error();
   }
   auto partitions = builder.CreateVector(partition_offsets);
+  std::vector<flatbuffers::Offset<fbs::uuid::v0>> retired_offsets;
+  for (auto uuid : state.retired_partitions) {
+    if (auto uuid_fb = pack(builder, uuid))
+      retired_offsets.push_back(*uuid_fb);
+    else
+      return uuid_fb.error();
+  }
+  auto retired = builder.CreateVector(retired_offsets);
   std::vector<flatbuffers::Offset<fbs::layout_statistics::v0>> stats_offsets;
   for (auto& [name, layout_stats] : state.stats.layouts) {
     auto name_fb = builder.CreateString(name);
@@ -561,6 +1026,7 @@ pack(flatbuffers::FlatBufferBuilder& builder, const index_state& state) {
   fbs::index::v0Builder v0_builder(builder);
   v0_builder.add_partitions(partitions);
   v0_builder.add_stats(stats);
+  v0_builder.add_retired(retired);
   auto index_v0 = v0_builder.Finish();
   fbs::IndexBuilder index_builder(builder);
   index_builder.add_index_type(vast::fbs::index::Index::v0);
@@ -618,6 +1084,85 @@ index(index_actor::stateful_pointer<index_state> self,
   self->state.inmem_partitions.resize(max_inmem_partitions);
   self->state.meta_index_fp_rate = meta_index_fp_rate;
   self->state.meta_index_bytes = 0;
+  const auto& opts = content(self->system().config());
+  if (auto size = caf::get_or(opts, "vast.result-cache-size",
+                              defaults::system::result_cache_size);
+      size > 0)
+    self->state.result_cache = std::make_shared<query_result_cache>(size);
+  self->state.hyperloglog_precision
+    = caf::get_or(opts, "vast.hyperloglog-precision",
+                  defaults::system::hyperloglog_precision);
+  if (auto precision = self->state.hyperloglog_precision;
+      precision > 0
+      && (precision < hyperloglog::min_precision
+          || precision > hyperloglog::max_precision)) {
+    VAST_ERROR("{} got invalid vast.hyperloglog-precision {}; expected 0 or "
+               "a value between {} and {}",
+               self, precision, size_t{hyperloglog::min_precision},
+               size_t{hyperloglog::max_precision});
+    self->quit(caf::make_error(ec::invalid_configuration,
+                               "invalid vast.hyperloglog-precision"));
+    return index_actor::behavior_type::make_empty_behavior();
+  }
+  auto sharding = to_partition_sharding(
+    caf::get_or(opts, "vast.partition-sharding",
+                defaults::system::partition_sharding));
+  if (!sharding) {
+    VAST_ERROR("{} failed to parse vast.partition-sharding: {}", self,
+               render(sharding.error()));
+    self->quit(std::move(sharding.error()));
+    return index_actor::behavior_type::make_empty_behavior();
+  }
+  self->state.sharding = *sharding;
+  if (*sharding == partition_sharding::homogeneous) {
+    // Every layout group gets its own shard as soon as the first event of the
+    // group arrives.
+    if (auto groups = caf::get_if<caf::settings>(&opts, "vast.layout-groups")) {
+      for (const auto& [group, layouts] : *groups) {
+        auto xs = caf::get_if<caf::config_value::list>(&layouts);
+        if (!xs) {
+          VAST_ERROR("{} expects a list of layouts for layout group {}", self,
+                     group);
+          self->quit(caf::make_error(ec::invalid_configuration,
+                                     "invalid layout group", group));
+          return index_actor::behavior_type::make_empty_behavior();
+        }
+        for (const auto& x : *xs)
+          if (auto layout = caf::get_if<std::string>(&x))
+            self->state.layout_groups.insert_or_assign(*layout, group);
+      }
+    }
+    VAST_VERBOSE("{} fills separate partitions for every layout group", self);
+  } else {
+    auto active_partitions = caf::get_or(opts, "vast.active-partitions",
+                                         defaults::system::active_partitions);
+    if (active_partitions == 0) {
+      VAST_ERROR("{} requires at least one active partition", self);
+      self->quit(caf::make_error(ec::invalid_configuration,
+                                 "vast.active-partitions must be positive"));
+      return index_actor::behavior_type::make_empty_behavior();
+    }
+    self->state.active_partitions.resize(active_partitions);
+    if (active_partitions > 1)
+      VAST_VERBOSE("{} distributes events over {} active partitions", self,
+                   active_partitions);
+  }
+  // Only homogeneous sharding creates partitions for layouts that may arrive
+  // rarely, so the other policies seal by time only when configured to.
+  if (self->state.sharding == partition_sharding::homogeneous)
+    self->state.active_partition_timeout
+      = defaults::system::active_partition_timeout;
+  if (auto str = caf::get_if<std::string>(&opts, "vast.active-partition-"
+                                                 "timeout")) {
+    auto timeout = to<duration>(*str);
+    if (!timeout) {
+      VAST_ERROR("{} failed to parse vast.active-partition-timeout: {}", self,
+                 render(timeout.error()));
+      self->quit(std::move(timeout.error()));
+      return index_actor::behavior_type::make_empty_behavior();
+    }
+    self->state.active_partition_timeout = *timeout;
+  }
   // Read persistent state.
   if (auto err = self->state.load_from_disk()) {
     VAST_ERROR("{} failed to load index state from disk: {}", self,
@@ -634,19 +1179,37 @@ index(index_actor::stateful_pointer<index_state> self,
     },
     [self](caf::unit_t&, caf::downstream<table_slice>& out, table_slice x) {
       VAST_ASSERT(x.encoding() != table_slice_encoding::none);
+      // Table slices replayed from the ingest journal after a crash may
+      // already be part of a persisted partition.
+      if (self->state.persisted_ids.lookup(x.offset()) != nullptr) {
+        VAST_DEBUG("{} skips table slice with already persisted ID {}", self,
+                   x.offset());
+        return;
+      }
       auto&& layout = x.layout();
       self->state.stats.layouts[layout.name()].count += x.rows();
-      auto& active = self->state.active_partition;
+      self->state.last_ingest = std::chrono::system_clock::now();
+      auto shard = self->state.shard_of(x);
+      auto& active = self->state.active_partitions[shard];
       if (!active.actor) {
-        self->state.create_active_partition();
+        self->state.create_active_partition(shard);
       } else if (x.rows() > active.capacity) {
-        VAST_DEBUG("{} exceeds active capacity by {} rows", self,
-                   x.rows() - active.capacity);
-        self->state.decomission_active_partition();
+        VAST_DEBUG("{} exceeds capacity of active partition {} by {} rows",
+                   self, active.id, x.rows() - active.capacity);
+        self->state.decomission_active_partition(shard);
         self->state.flush_to_disk();
-        self->state.create_active_partition();
+        self->state.create_active_partition(shard);
       }
+      self->state.unpersisted_offsets.try_emplace(active.id, x.offset());
+      self->state.ingested_end
+        = std::max(self->state.ingested_end, x.offset() + x.rows());
       out.push(x);
+      // The stream filters select the round-robin shard from the counter, so
+      // we must hand the slice to the outbound paths before advancing it.
+      if (self->state.sharding == partition_sharding::round_robin) {
+        self->state.stage->out().fan_out_flush();
+        ++*self->state.round_robin_slices;
+      }
       if (active.capacity == self->state.partition_capacity
           && x.rows() > active.capacity) {
         VAST_WARN("{} got table slice with {} rows that exceeds the "
@@ -675,7 +1238,9 @@ index(index_actor::stateful_pointer<index_state> self,
         // importer.
         self->send_exit(self, err);
       }
-    });
+    },
+    caf::policy::arg<caf::broadcast_downstream_manager<
+      table_slice, partition_shard, partition_shard_selector>>{});
   self->set_exit_handler([self](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received EXIT from {} with reason: {}", self, msg.source,
                msg.reason);
@@ -684,9 +1249,11 @@ index(index_actor::stateful_pointer<index_state> self,
     self->state.stage->out().fan_out_flush();
     self->state.stage->out().close(); // closes outbound paths
     self->state.stage->out().force_emit_batches();
-    // Bring down active partition.
-    if (self->state.active_partition.actor)
-      self->state.decomission_active_partition();
+    // Bring down active partitions.
+    for (size_t shard = 0; shard < self->state.active_partitions.size();
+         ++shard)
+      if (self->state.active_partitions[shard].actor)
+        self->state.decomission_active_partition(shard);
     // Collect partitions for termination.
     // TODO: We must actor_cast to caf::actor here because 'shutdown' operates
     // on 'std::vector<caf::actor>' only. That should probably be generalized in
@@ -698,6 +1265,10 @@ index(index_actor::stateful_pointer<index_state> self,
     for ([[maybe_unused]] auto& [_, part] : self->state.inmem_partitions)
       partitions.push_back(caf::actor_cast<caf::actor>(part));
     self->state.flush_to_disk();
+    // No query continues after the INDEX exits, so all retired partitions can
+    // be removed.
+    self->state.pending.clear();
+    self->state.remove_retired_partitions();
     // Receiving an EXIT message does not need to coincide with the state being
     // destructed, so we explicitly clear the tables to release the references.
     self->state.unpersisted.clear();
@@ -706,10 +1277,151 @@ index(index_actor::stateful_pointer<index_state> self,
     VAST_DEBUG("{} brings down {} partitions", self, partitions.size());
     shutdown<policy::parallel>(self, std::move(partitions));
   });
-  // Launch workers for resolving queries.
-  for (size_t i = 0; i < num_workers; ++i)
-    self->spawn(query_supervisor,
-                caf::actor_cast<query_supervisor_master_actor>(self));
+  // Periodically seal active partitions that take too long to fill up, e.g.,
+  // for low-volume layouts with homogeneous sharding.
+  if (self->state.active_partition_timeout > duration::zero())
+    self->delayed_send(self,
+                       seal_interval(self->state.active_partition_timeout),
+                       atom::internal_v, atom::flush_v);
+  // Launch workers for resolving queries. The pool grows on demand up to
+  // the configured maximum.
+  self->state.max_workers = num_workers;
+  self->state.scheduler = query_scheduler{num_workers};
+  for (size_t i = 0;
+       i < std::min(num_workers, defaults::system::idle_query_supervisors); ++i)
+    self->state.spawn_worker();
+  // Admits a query and schedules the evaluation of its first partitions. For
+  // time-ordered queries, the INDEX schedules the candidate partitions by
+  // their time bounds and includes these bounds in its response, so that the
+  // client can stop early once no unvisited partition can contribute.
+  auto handle_query = [self](vast::expression expr, query_priority priority,
+                             query_order order) -> caf::result<void> {
+    if (!self->state.accept_queries) {
+      VAST_VERBOSE("{} delays query {} because it is still starting up", self,
+                   expr);
+      return caf::skip;
+    }
+    // Meta index lookups are cheap, so we admit every query here and only
+    // schedule the evaluation of its partitions by priority.
+    // Query handling
+    auto mid = self->current_message_id();
+    auto sender = self->current_sender();
+    auto client = caf::actor_cast<caf::actor>(sender);
+    // TODO: This is used in order to "respond" to the message and to still
+    // continue with the function afterwards. At some point this should be
+    // changed to a proper solution for that problem, e.g., streaming.
+    auto respond = [=](auto&&... xs) {
+      unsafe_response(self, sender, {}, mid.response_id(),
+                      std::forward<decltype(xs)>(xs)...);
+    };
+    // Convenience function for dropping out without producing hits.
+    // Makes sure that clients always receive a 'done' message.
+    auto no_result = [=] {
+      if (order == query_order::none)
+        respond(uuid::nil(), uint32_t{0}, uint32_t{0});
+      else
+        respond(uuid::nil(), uint32_t{0}, uint32_t{0}, std::vector<time>{});
+      caf::anon_send(client, atom::done_v);
+    };
+    // Sanity check.
+    if (!sender) {
+      VAST_WARN("{} ignores an anonymous query", self);
+      respond(caf::sec::invalid_argument);
+      return {};
+    }
+    std::vector<uuid> candidates;
+    for (const auto& active : self->state.active_partitions)
+      if (active.actor)
+        candidates.push_back(active.id);
+    for (const auto& [id, _] : self->state.unpersisted)
+      candidates.push_back(id);
+    auto rp = self->make_response_promise<void>();
+    auto start = stopwatch::now();
+    // Registers the query and schedules its first partitions. The bounds are
+    // empty unless the query is time-ordered.
+    auto admit = [=](std::vector<uuid> candidates,
+                     std::vector<time> bounds) mutable {
+      // Allows the client to query further results after initial taste.
+      auto query_id = uuid::random();
+      // Ensure the query id is unique.
+      while (self->state.pending.find(query_id) != self->state.pending.end()
+             || query_id == uuid::nil())
+        query_id = uuid::random();
+      auto total = candidates.size();
+      auto scheduled = detail::narrow<uint32_t>(
+        std::min(candidates.size(), self->state.taste_partitions));
+      query_profiler::instance().update(
+        client->id(), [&](query_profile& p) { p.id = query_id; });
+      auto lookup = query_state{query_id, expr, std::move(candidates),
+                                priority, order};
+      auto result = self->state.pending.emplace(query_id, std::move(lookup));
+      VAST_ASSERT(result.second);
+      if (order == query_order::none)
+        respond(query_id, detail::narrow<uint32_t>(total), scheduled);
+      else
+        respond(query_id, detail::narrow<uint32_t>(total), scheduled,
+                std::move(bounds));
+      rp.delegate(caf::actor_cast<caf::actor>(self), query_id, scheduled);
+    };
+    // Get all potentially matching partitions.
+    self->request(self->state.meta_index, caf::infinite, expr)
+      .then(
+        [=, candidates = std::move(candidates)](
+          std::vector<uuid> midx_candidates) mutable {
+          auto lookup_time = stopwatch::now() - start;
+          VAST_DEBUG("{} got initial candidates {} and from meta-index {}",
+                     self, candidates, midx_candidates);
+          candidates.insert(candidates.end(), midx_candidates.begin(),
+                            midx_candidates.end());
+          std::sort(candidates.begin(), candidates.end());
+          candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                           candidates.end());
+          query_profiler::instance().update(
+            client->id(), [&](query_profile& p) {
+              p.candidates = candidates.size();
+              p.meta_index_lookup = lookup_time;
+            });
+          if (candidates.empty()) {
+            VAST_DEBUG("{} returns without result: no partitions qualify",
+                       self);
+            no_result();
+            // TODO: When updating to CAF 0.18, remove the use of the
+            // untyped response promise and call deliver without arguments.
+            auto& untyped_rp = static_cast<caf::response_promise&>(rp);
+            untyped_rp.deliver(caf::unit);
+            return;
+          }
+          if (order == query_order::none) {
+            admit(std::move(candidates), {});
+            return;
+          }
+          // Fetch the time bounds of the candidates to schedule them in order.
+          self
+            ->request(self->state.meta_index, caf::infinite, atom::resolve_v,
+                      candidates)
+            .then(
+              [=, candidates = std::move(candidates)](
+                const std::vector<time>& first,
+                const std::vector<time>& last) mutable {
+                auto bounds = sort_by_time(candidates, first, last, order);
+                VAST_DEBUG("{} schedules {} candidates in {} order", self,
+                           candidates.size(), to_string(order));
+                admit(std::move(candidates), std::move(bounds));
+              },
+              [=](caf::error err) mutable {
+                VAST_ERROR("{} failed to receive time bounds from "
+                           "meta-index: {}",
+                           self, render(err));
+                rp.deliver(std::move(err));
+              });
+        },
+        [=](caf::error err) mutable {
+          VAST_ERROR("{} failed to receive candidates from meta-index: {}",
+                     self, render(err));
+          rp.deliver(std::move(err));
+        });
+    return rp;
+  };
   return {
     [self](atom::done, uuid partition_id) {
       VAST_DEBUG("{} queried partition {} successfully", self, partition_id);
@@ -726,91 +1438,18 @@ index(index_actor::stateful_pointer<index_state> self,
       VAST_WARN("{} adds flush listener", self);
       self->state.add_flush_listener(std::move(listener));
     },
-    [self](vast::expression expr) -> caf::result<void> {
-      if (!self->state.accept_queries) {
-        VAST_VERBOSE("{} delays query {} because it is still starting up", self,
-                     expr);
-        return caf::skip;
-      }
-      // TODO: This check is not required technically, but we use the query
-      // supervisor availability to rate-limit meta-index lookups. Do we
-      // really need this?
-      if (!self->state.worker_available())
-        return caf::skip;
-      // Query handling
-      auto mid = self->current_message_id();
-      auto sender = self->current_sender();
-      auto client = caf::actor_cast<caf::actor>(sender);
-      // TODO: This is used in order to "respond" to the message and to still
-      // continue with the function afterwards. At some point this should be
-      // changed to a proper solution for that problem, e.g., streaming.
-      auto respond = [=](auto&&... xs) {
-        unsafe_response(self, sender, {}, mid.response_id(),
-                        std::forward<decltype(xs)>(xs)...);
-      };
-      // Convenience function for dropping out without producing hits.
-      // Makes sure that clients always receive a 'done' message.
-      auto no_result = [=] {
-        respond(uuid::nil(), uint32_t{0}, uint32_t{0});
-        caf::anon_send(client, atom::done_v);
-      };
-      // Sanity check.
-      if (!sender) {
-        VAST_WARN("{} ignores an anonymous query", self);
-        respond(caf::sec::invalid_argument);
-        return {};
-      }
-      std::vector<uuid> candidates;
-      if (self->state.active_partition.actor)
-        candidates.push_back(self->state.active_partition.id);
-      for (const auto& [id, _] : self->state.unpersisted)
-        candidates.push_back(id);
-      auto rp = self->make_response_promise<void>();
-      // Get all potentially matching partitions.
-      self->request(self->state.meta_index, caf::infinite, expr)
-        .then(
-          [=, candidates = std::move(candidates)](
-            std::vector<uuid> midx_candidates) mutable {
-            VAST_DEBUG("{} got initial candidates {} and from meta-index {}",
-                       self, candidates, midx_candidates);
-            candidates.insert(candidates.end(), midx_candidates.begin(),
-                              midx_candidates.end());
-            std::sort(candidates.begin(), candidates.end());
-            candidates.erase(std::unique(candidates.begin(), candidates.end()),
-                             candidates.end());
-            if (candidates.empty()) {
-              VAST_DEBUG("{} returns without result: no partitions qualify",
-                         self);
-              no_result();
-              // TODO: When updating to CAF 0.18, remove the use of the
-              // untyped response promise and call deliver without arguments.
-              auto& untyped_rp = static_cast<caf::response_promise&>(rp);
-              untyped_rp.deliver(caf::unit);
-              return;
-            }
-            // Allows the client to query further results after initial taste.
-            auto query_id = uuid::random();
-            // Ensure the query id is unique.
-            while (self->state.pending.find(query_id)
-                     != self->state.pending.end()
-                   || query_id == uuid::nil())
-              query_id = uuid::random();
-            auto total = candidates.size();
-            auto scheduled = detail::narrow<uint32_t>(
-              std::min(candidates.size(), self->state.taste_partitions));
-            auto lookup = query_state{query_id, expr, std::move(candidates)};
-            auto result
-              = self->state.pending.emplace(query_id, std::move(lookup));
-            VAST_ASSERT(result.second);
-            respond(query_id, detail::narrow<uint32_t>(total), scheduled);
-            rp.delegate(caf::actor_cast<caf::actor>(self), query_id, scheduled);
-          },
-          [=](caf::error err) mutable {
-            VAST_ERROR("{} failed to receive candidates from meta-index: {}",
-                       self, render(err));
-            rp.deliver(std::move(err));
-          });
-      return rp;
+    [self](atom::subscribe, atom::write,
+           disk_usage_listener_actor& listener) {
+      VAST_DEBUG("{} adds disk usage listener", self);
+      self->state.disk_usage_listener = std::move(listener);
+    },
+    [handle_query](vast::expression expr,
+                   query_priority priority) -> caf::result<void> {
+      return handle_query(std::move(expr), priority, query_order::none);
+    },
+    [handle_query](vast::expression expr, query_priority priority,
+                   query_order order) -> caf::result<void> {
+      return handle_query(std::move(expr), priority, order);
     },
     [self](const uuid& query_id, uint32_t num_partitions) -> caf::result<void> {
       auto sender = self->current_sender();
@@ -825,6 +1464,7 @@ index(index_actor::stateful_pointer<index_state> self,
         VAST_DEBUG("{} drops remaining results for query id {}", self,
                    query_id);
         self->state.pending.erase(query_id);
+        self->state.scheduler.drop(query_id);
         return {};
       }
       auto iter = self->state.pending.find(query_id);
@@ -833,22 +1473,10 @@ index(index_actor::stateful_pointer<index_state> self,
         self->send(client, atom::done_v);
         return {};
       }
-      auto& query_state = iter->second;
-      auto worker = self->state.next_worker();
-      if (!worker)
-        return caf::skip;
-      // Get partition actors, spawning new ones if needed.
-      auto actors
-        = self->state.collect_query_actors(query_state, num_partitions);
-      // Delegate to query supervisor (uses up this worker) and report
-      // query ID + some stats to the client.
-      VAST_DEBUG("{} schedules {} more partition(s) for query id {}"
-                 "with {} partitions remaining",
-                 self, actors.size(), query_id, query_state.partitions.size());
-      self->send(*worker, query_state.expression, std::move(actors), client);
-      // Cleanup if we exhausted all candidates.
-      if (query_state.partitions.empty())
-        self->state.pending.erase(iter);
+      self->state.scheduler.push(query_request{query_id, num_partitions,
+                                               std::move(client),
+                                               iter->second.priority});
+      self->state.schedule_queries();
       return {};
     },
     [self](atom::erase, uuid partition_id) -> caf::result<ids> {
@@ -856,6 +1484,22 @@ index(index_actor::stateful_pointer<index_state> self,
       auto rp = self->make_response_promise<ids>();
       auto path = self->state.partition_path(partition_id);
       auto synopsis_path = self->state.partition_synopsis_path(partition_id);
+      // Compaction copies the events of its inputs into a new partition, which
+      // would resurrect the events of an input erased in the meantime. The
+      // erasure cancels the compaction instead, and waits for it to finish.
+      const auto& inputs = self->state.compaction_inputs;
+      if (std::find(inputs.begin(), inputs.end(), partition_id)
+          != inputs.end()) {
+        VAST_DEBUG("{} defers erasing partition {} until compaction finished",
+                   self, partition_id);
+        self->state.compaction_cancelled = true;
+        self->state.deferred_erasures.emplace_back(partition_id, rp);
+        return rp;
+      }
+      if (self->state.retired_partitions.count(partition_id)) {
+        rp.deliver(caf::make_error(ec::logic_error, "partition was merged"));
+        return rp;
+      }
       bool adjust_stats = true;
       if (!self->state.persisted_partitions.count(partition_id)) {
         if (!exists(path)) {
@@ -867,8 +1511,14 @@ index(index_actor::stateful_pointer<index_state> self,
         // through cleanly.
         adjust_stats = false;
       }
-      self->state.inmem_partitions.drop(partition_id);
-      self->state.persisted_partitions.erase(partition_id);
+      // The partition stays visible to queries until it is gone from disk,
+      // so that a failed erasure does not leave behind events that no query
+      // can find.
+      self->state.erasing_partitions.insert(partition_id);
+      auto deliver = [=](auto&& result) mutable {
+        self->state.erasing_partitions.erase(partition_id);
+        rp.deliver(std::forward<decltype(result)>(result));
+      };
       self->request(self->state.filesystem, caf::infinite, atom::mmap_v, path)
         .then(
           [=](chunk_ptr chunk) mutable {
@@ -876,46 +1526,288 @@ index(index_actor::stateful_pointer<index_state> self,
             // partition.
             auto partition = fbs::GetPartition(chunk->data());
             if (partition->partition_type() != fbs::partition::Partition::v0) {
-              rp.deliver(caf::make_error(ec::format_error, "unexpected "
-                                                           "format "
-                                                           "version"));
+              deliver(
+                caf::make_error(ec::format_error, "unexpected format version"));
               return;
             }
             vast::ids all_ids;
+            std::vector<std::pair<std::string, uint64_t>> stats;
             auto partition_v0 = partition->partition_as_v0();
             for (auto partition_stats : *partition_v0->type_ids()) {
               auto name = partition_stats->name();
               vast::ids ids;
               if (auto error
                   = fbs::deserialize_bytes(partition_stats->ids(), ids)) {
-                rp.deliver(
-                  caf::make_error(ec::format_error, "could not deserialize "
-                                                    "ids: "
-                                                      + render(error)));
+                deliver(caf::make_error(ec::format_error,
+                                        "could not deserialize ids: "
+                                          + render(error)));
                 return;
               }
               all_ids |= ids;
-              if (adjust_stats)
-                self->state.stats.layouts[name->str()].count -= rank(ids);
+              stats.emplace_back(name->str(), rank(ids));
             }
             // Note that mmap's will increase the reference count of a file,
             // so unlinking should not affect indexers that are currently
             // loaded and answering a query.
-            if (!rm(path))
-              VAST_WARN("{} could not unlink partition at {}", self, path);
+            if (!rm(path)) {
+              deliver(caf::make_error(ec::filesystem_error,
+                                      "could not unlink partition at",
+                                      path.str()));
+              return;
+            }
+            self->state.inmem_partitions.drop(partition_id);
+            self->state.persisted_partitions.erase(partition_id);
+            if (self->state.result_cache)
+              self->state.result_cache->invalidate(partition_id);
+            self->send(self->state.meta_index, atom::erase_v, partition_id);
+            if (adjust_stats)
+              for (auto& [name, count] : stats)
+                self->state.stats.layouts[name].count -= count;
             if (!rm(synopsis_path))
               VAST_WARN("{} could not unlink partition synopsis at", self,
                         path);
-            rp.deliver(std::move(all_ids));
+            self->state.remove_partition_bytes(partition_id);
+            deliver(std::move(all_ids));
+          },
+          [=](caf::error e) mutable { deliver(e); });
+      return rp;
+    },
+    [self](atom::erase, expression& expr) -> caf::result<ids> {
+      VAST_VERBOSE("{} erases partitions that lie entirely within {}", self,
+                   expr);
+      auto rp = self->make_response_promise<ids>();
+      self
+        ->request(self->state.meta_index, caf::infinite, atom::erase_v,
+                  std::move(expr))
+        .then(
+          [=](std::vector<uuid>& partitions) mutable {
+            if (partitions.empty()) {
+              rp.deliver(ids{});
+              return;
+            }
+            // Erase all covered partitions concurrently and collect their ids.
+            struct erase_state {
+              ids erased;
+              size_t pending;
+            };
+            auto state = std::make_shared<erase_state>();
+            state->pending = partitions.size();
+            auto handle = static_cast<index_actor>(self);
+            for (auto& partition : partitions) {
+              self
+                ->request(handle, caf::infinite, atom::erase_v,
+                          std::move(partition))
+                .then(
+                  [=](ids& erased) mutable {
+                    state->erased |= erased;
+                    if (--state->pending == 0)
+                      rp.deliver(std::move(state->erased));
+                  },
+                  [=](caf::error& err) mutable {
+                    VAST_WARN("{} failed to erase partition: {}", self,
+                              render(err));
+                    if (--state->pending == 0)
+                      rp.deliver(std::move(state->erased));
+                  });
+            }
+          },
+          [=](caf::error& err) mutable { rp.deliver(std::move(err)); });
+      return rp;
+    },
+    [self](atom::persist, atom::id) -> id {
+      return self->state.watermark();
+    },
+    [self](atom::erase, atom::candidate)
+      -> caf::result<std::vector<uuid>, std::vector<uint64_t>> {
+      auto rp = self->make_response_promise<std::vector<uuid>,
+                                            std::vector<uint64_t>>();
+      auto partitions
+        = std::vector<uuid>{self->state.persisted_partitions.begin(),
+                            self->state.persisted_partitions.end()};
+      // The time synopses in the META INDEX know the time range of every
+      // partition, which reflects the age of its events more accurately than
+      // the modification time of its file.
+      self
+        ->request(self->state.meta_index, caf::infinite, atom::resolve_v,
+                  partitions)
+        .then(
+          [=](std::vector<time>& first, std::vector<time>& last) mutable {
+            auto order = std::vector<size_t>(partitions.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+              return std::tie(last[x], first[x]) < std::tie(last[y], first[y]);
+            });
+            auto candidates = std::vector<uuid>{};
+            auto sizes = std::vector<uint64_t>{};
+            for (auto i : order) {
+              // Skip partitions that got erased in the meantime.
+              auto it = self->state.partition_bytes.find(partitions[i]);
+              if (it == self->state.partition_bytes.end()
+                  || self->state.persisted_partitions.count(partitions[i])
+                       == 0)
+                continue;
+              candidates.push_back(partitions[i]);
+              sizes.push_back(it->second);
+            }
+            rp.deliver(std::move(candidates), std::move(sizes));
+          },
+          [=](caf::error& err) mutable { rp.deliver(std::move(err)); });
+      return rp;
+    },
+    [self](atom::distinct, expression& expr,
+           std::string& field) -> caf::result<uint64_t> {
+      // Only the META INDEX knows the sketches, and it only ever sees the
+      // synopses of persisted partitions.
+      return self->delegate(self->state.meta_index, atom::distinct_v,
+                            std::move(expr), std::move(field));
+    },
+    [self](atom::internal, atom::flush) {
+      self->state.seal_stale_partitions();
+      self->delayed_send(self,
+                         seal_interval(self->state.active_partition_timeout),
+                         atom::internal_v, atom::flush_v);
+    },
+    [self](atom::internal, atom::worker) { self->state.shrink_workers(); },
+    [self](atom::merge,
+           atom::candidate) -> caf::result<std::vector<uuid>, ids> {
+      auto rp = self->make_response_promise<std::vector<uuid>, ids>();
+      self->state.remove_retired_partitions();
+      // Compaction must never compete with ingestion, so we only hand out
+      // candidates while no partition is being persisted and no table slices
+      // arrived for a while.
+      auto idle = std::chrono::system_clock::now() - self->state.last_ingest
+                  >= defaults::system::compaction_ingest_pause;
+      if (self->state.compacting || !self->state.unpersisted.empty()
+          || !idle) {
+        VAST_DEBUG("{} postpones compaction during ingestion", self);
+        rp.deliver(std::vector<uuid>{}, ids{});
+        return rp;
+      }
+      auto capacity = uint64_t{self->state.partition_capacity};
+      auto threshold = static_cast<uint64_t>(
+        capacity * defaults::system::compaction_threshold);
+      self
+        ->request(self->state.meta_index, caf::infinite, atom::merge_v,
+                  atom::candidate_v, threshold, capacity)
+        .then(
+          [=](std::vector<uuid>& partitions, ids& xs) mutable {
+            rp.deliver(std::move(partitions), std::move(xs));
+          },
+          [=](caf::error& err) mutable { rp.deliver(std::move(err)); });
+      return rp;
+    },
+    [self](atom::merge, std::vector<uuid>& partitions,
+           std::vector<table_slice>& slices) -> caf::result<uuid> {
+      auto rp = self->make_response_promise<uuid>();
+      auto is_mergeable = [self](const uuid& x) {
+        return self->state.persisted_partitions.count(x) != 0
+               && self->state.erasing_partitions.count(x) == 0;
+      };
+      if (self->state.compacting
+          || !std::all_of(partitions.begin(), partitions.end(),
+                          is_mergeable)) {
+        rp.deliver(caf::make_error(ec::invalid_argument,
+                                   "cannot merge unknown partitions"));
+        return rp;
+      }
+      if (slices.empty()) {
+        rp.deliver(caf::make_error(ec::invalid_argument,
+                                   "cannot merge empty partitions"));
+        return rp;
+      }
+      // The merged partition replaces its inputs, so events that went missing
+      // in the ARCHIVE would be lost for good.
+      auto expected = uint64_t{0};
+      for (const auto& [first, last, partition] : self->state.persisted_ids)
+        if (std::find(partitions.begin(), partitions.end(), partition)
+            != partitions.end())
+          expected += last - first;
+      auto actual = uint64_t{0};
+      for (const auto& slice : slices)
+        actual += slice.rows();
+      if (actual != expected) {
+        VAST_WARN("{} refuses to merge {} partitions with {} events from {} "
+                  "rebuilt events",
+                  self, partitions.size(), expected, actual);
+        rp.deliver(caf::make_error(ec::invalid_argument,
+                                   "rebuilt events do not match partitions"));
+        return rp;
+      }
+      self->state.compacting = true;
+      self->state.compaction_inputs = partitions;
+      auto id = uuid::random();
+      VAST_VERBOSE("{} merges {} partitions into partition {}", self,
+                   partitions.size(), id);
+      // The active partition requires its table slices in ID order.
+      std::sort(slices.begin(), slices.end(), [](const auto& x, const auto& y) {
+        return x.offset() < y.offset();
+      });
+      auto part = self->spawn(::vast::system::active_partition, id,
+                              self->state.filesystem,
+                              self->state.partition_index_options(),
+                              self->state.partition_synopsis_options());
+      detail::spawn_container_source(self->system(), std::move(slices), part);
+      self
+        ->request(part, caf::infinite, atom::persist_v,
+                  self->state.partition_path(id),
+                  self->state.partition_synopsis_path(id))
+        .then(
+          [=](std::shared_ptr<partition_synopsis>& ps) mutable {
+            // An erasure of an input while persisting would come back through
+            // the merged partition, so we discard it.
+            if (self->state.compaction_cancelled
+                || !std::all_of(partitions.begin(), partitions.end(),
+                                is_mergeable)) {
+              VAST_VERBOSE("{} discards merged partition {} because its "
+                           "inputs changed",
+                           self, id);
+              rm(self->state.partition_path(id));
+              rm(self->state.partition_synopsis_path(id));
+              self->state.finish_compaction();
+              rp.deliver(caf::make_error(ec::invalid_argument,
+                                         "merged partitions were erased"));
+              return;
+            }
+            auto id_ranges = ps->id_ranges;
+            self->state.meta_index_bytes += ps->memusage();
+            // The meta index swaps the synopses in a single step, so a query
+            // sees either the old partitions or the merged one.
+            self
+              ->request(self->state.meta_index, caf::infinite,
+                        atom::replace_v, partitions, id, std::move(ps))
+              .then(
+                [=](atom::ok) mutable {
+                  for (auto [first, last] : id_ranges) {
+                    self->state.persisted_ids.erase(first, last);
+                    self->state.persisted_ids.inject(first, last, id);
+                  }
+                  self->state.persisted_partitions.insert(id);
+                  self->state.add_partition_bytes(id);
+                  for (const auto& partition : partitions) {
+                    self->state.persisted_partitions.erase(partition);
+                    self->state.retired_partitions.insert(partition);
+                  }
+                  self->state.remove_retired_partitions();
+                  self->state.flush_to_disk();
+                  self->state.finish_compaction();
+                  rp.deliver(id);
+                },
+                [=](caf::error& err) mutable {
+                  self->state.finish_compaction();
+                  rp.deliver(std::move(err));
+                });
           },
-          [=](caf::error e) mutable { rp.deliver(e); });
+          [=](caf::error& err) mutable {
+            VAST_WARN("{} failed to persist merged partition {}: {}", self, id,
+                      render(err));
+            self->state.finish_compaction();
+            rp.deliver(std::move(err));
+          });
       return rp;
     },
     // -- query_supervisor_master_actor ----------------------------------------
     [self](atom::worker, query_supervisor_actor worker) {
-      if (!self->state.worker_available())
-        VAST_DEBUG("{} delegates work to query supervisors", self);
-      self->state.idle_workers.emplace_back(std::move(worker));
+      self->state.release_worker(std::move(worker));
     },
     // -- status_client_actor --------------------------------------------------
     [self](atom::status, status_verbosity v) { //
@@ -27,6 +27,7 @@
 #include "vast/path.hpp"
 #include "vast/system/accountant.hpp"
 #include "vast/system/instrumentation.hpp"
+#include "vast/system/metrics.hpp"
 #include "vast/system/report.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_column.hpp"
@@ -85,9 +86,19 @@ active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
           // implementation so we're keeping it for now.
           if (self->state.has_skip_attribute)
             return;
-          for (auto& column : columns)
+          // All indexers share their metrics, so that the registry does not
+          // grow with the number of indexers.
+          static auto& latency = metrics_registry::instance().make_histogram(
+            "indexer.append.latency");
+          static auto& rows
+            = metrics_registry::instance().make_counter("indexer.append.rows");
+          for (auto& column : columns) {
+            auto start = stopwatch::now();
             for (size_t i = 0; i < column.size(); ++i)
               self->state.idx->append(column[i], column.slice().offset() + i);
+            latency.add(stopwatch::now() - start);
+            rows.add(column.size());
+          }
         },
         [=](caf::unit_t&, const caf::error& err) {
           VAST_TRACE("indexer is closing stream");
@@ -137,28 +148,4 @@ active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
   };
 }
 
-indexer_actor::behavior_type
-passive_indexer(indexer_actor::stateful_pointer<indexer_state> self,
-                uuid partition_id, value_index_ptr idx) {
-  if (!idx) {
-    VAST_ERROR("{} got invalid value index pointer", self);
-    self->quit(caf::make_error(ec::end_of_input, "invalid value index "
-                                                 "pointer"));
-    return indexer_actor::behavior_type::make_empty_behavior();
-  }
-  self->state.name = "indexer-" + to_string(idx->type());
-  self->state.partition_id = partition_id;
-  self->state.idx = std::move(idx);
-  return {
-    [self](const curried_predicate& pred) {
-      VAST_DEBUG("{} got predicate: {}", self, pred);
-      VAST_ASSERT(self->state.idx);
-      auto& idx = *self->state.idx;
-      auto rep = to_internal(idx.type(), make_view(pred.rhs));
-      return idx.lookup(pred.op, rep);
-    },
-    [self](atom::shutdown) { self->quit(caf::exit_reason::user_shutdown); },
-  };
-}
-
 } // namespace vast::system
@@ -13,14 +13,17 @@
 
 #include "vast/system/meta_index.hpp"
 
+#include "vast/concept/printable/vast/expression.hpp"
 #include "vast/data.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/set_operations.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/detail/tracepoint.hpp"
+#include "vast/enumeration_synopsis.hpp"
 #include "vast/expression.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/logger.hpp"
+#include "vast/membership_set.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/system/instrumentation.hpp"
 #include "vast/table_slice.hpp"
@@ -29,6 +32,11 @@
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string_view>
 #include <type_traits>
 
 namespace vast::system {
@@ -119,6 +127,18 @@ std::vector<uuid> meta_index_state::lookup(const expression& expr) const {
       auto search = [&](auto match) {
         VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
         auto& rhs = caf::get<data>(x.rhs);
+        // Hash the elements of a bulk membership predicate once up front
+        // instead of once per partition and synopsis.
+        auto bulk = std::optional<membership_set>{};
+        if (auto xs = caf::get_if<list>(&rhs);
+            xs && x.op == relational_operator::in)
+          bulk.emplace(make_view(*xs));
+        auto probe = [&](const synopsis& syn, const vast::type& t) {
+          if (auto translated = translate_enumeration(t, rhs))
+            return syn.lookup(x.op, make_view(*translated));
+          return bulk ? syn.lookup_any(*bulk)
+                      : syn.lookup(x.op, make_view(rhs));
+        };
         result_type result;
         for (auto& [part_id, part_syn] : synopses) {
           for (auto& [field, syn] : part_syn.field_synopses_) {
@@ -127,7 +147,7 @@ std::vector<uuid> meta_index_state::lookup(const expression& expr) const {
               // We rely on having a field -> nullptr mapping here for the
               // fields that don't have their own synopsis.
               if (syn) {
-                auto opt = syn->lookup(x.op, make_view(rhs));
+                auto opt = probe(*syn, field.type);
                 if (!opt || *opt) {
                   VAST_TRACE("{} selects {} at predicate {}",
                              detail::pretty_type_name(this), part_id, x);
@@ -138,7 +158,7 @@ std::vector<uuid> meta_index_state::lookup(const expression& expr) const {
                 // for the type in general.
               } else if (auto it = part_syn.type_synopses_.find(cleaned_type);
                          it != part_syn.type_synopses_.end() && it->second) {
-                auto opt = it->second->lookup(x.op, make_view(rhs));
+                auto opt = probe(*it->second, cleaned_type);
                 if (!opt || *opt) {
                   VAST_TRACE("{} selects {} at predicate {}",
                              detail::pretty_type_name(this), part_id, x);
@@ -261,6 +281,194 @@ std::vector<uuid> meta_index_state::lookup(const expression& expr) const {
   return result;
 }
 
+std::vector<uuid> meta_index_state::covered(const expression& expr) const {
+  VAST_ASSERT(!caf::holds_alternative<caf::none_t>(expr));
+  using result_type = std::vector<uuid>;
+  // Checks for every layout in a partition whether the synopses prove that
+  // all of its events satisfy the predicate.
+  auto covers = [&](const partition_synopsis& ps, auto&& layout_covered) {
+    std::vector<std::string_view> layouts;
+    for (auto& [field, _] : ps.field_synopses_)
+      layouts.emplace_back(field.layout_name);
+    std::sort(layouts.begin(), layouts.end());
+    layouts.erase(std::unique(layouts.begin(), layouts.end()), layouts.end());
+    return !layouts.empty()
+           && std::all_of(layouts.begin(), layouts.end(), layout_covered);
+  };
+  auto f = detail::overload{
+    [&](const conjunction& x) -> result_type {
+      VAST_ASSERT(!x.empty());
+      auto i = x.begin();
+      auto result = covered(*i);
+      for (++i; i != x.end() && !result.empty(); ++i)
+        detail::inplace_intersect(result, covered(*i));
+      return result;
+    },
+    [&](const disjunction& x) -> result_type {
+      result_type result;
+      for (auto& op : x)
+        detail::inplace_unify(result, covered(op));
+      return result;
+    },
+    [&](const negation&) -> result_type {
+      return {};
+    },
+    [&](const predicate& x) -> result_type {
+      // All values of a field satisfy the predicate if the synopsis rules out
+      // any value satisfying the negated predicate. Because synopses never
+      // yield false negatives, this check never yields false positives.
+      // Synopses ignore null values, so fields that may contain any never
+      // cover a partition.
+      auto search = [&](auto match) {
+        auto& rhs = caf::get<data>(x.rhs);
+        auto op = negate(x.op);
+        result_type result;
+        for (auto& [part_id, part_syn] : synopses) {
+          if (!part_syn.tracks_nulls_)
+            continue;
+          auto layout_covered = [&](std::string_view layout) {
+            for (auto& [field, syn] : part_syn.field_synopses_) {
+              if (!syn || field.layout_name != layout || !match(field)
+                  || part_syn.null_fields_.count(field) > 0)
+                continue;
+              auto translated = translate_enumeration(field.type, rhs);
+              auto opt
+                = syn->lookup(op, make_view(translated ? *translated : rhs));
+              if (opt && !*opt)
+                return true;
+            }
+            return false;
+          };
+          if (covers(part_syn, layout_covered))
+            result.push_back(part_id);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+      };
+      auto extract_expr = detail::overload{
+        [&](const meta_extractor& lhs, const data& d) -> result_type {
+          if (lhs.kind != meta_extractor::type)
+            return {};
+          result_type result;
+          for (auto& [part_id, part_syn] : synopses) {
+            auto layout_covered = [&](std::string_view layout) {
+              return evaluate(data{std::string{layout}}, x.op, d);
+            };
+            if (covers(part_syn, layout_covered))
+              result.push_back(part_id);
+          }
+          std::sort(result.begin(), result.end());
+          return result;
+        },
+        [&](const field_extractor& lhs, const data&) -> result_type {
+          return search([&](auto& field) {
+            return detail::ends_with(field.fqn(), lhs.field);
+          });
+        },
+        [&](const type_extractor& lhs, const data&) -> result_type {
+          if (caf::holds_alternative<none_type>(lhs.type))
+            return search([&](auto& field) {
+              return field.type.name() == lhs.type.name();
+            });
+          return search([&](auto& field) {
+            return field.type == lhs.type && field.type.name().empty();
+          });
+        },
+        [&](const auto&, const auto&) -> result_type {
+          return {};
+        },
+      };
+      return caf::visit(extract_expr, x.lhs, x.rhs);
+    },
+    [&](caf::none_t) -> result_type {
+      VAST_ASSERT(!"invalid expression");
+      return {};
+    },
+  };
+  return caf::visit(f, expr);
+}
+
+std::pair<time, time>
+meta_index_state::time_bounds(const uuid& partition) const {
+  auto unbounded = std::pair{time::min(), time::max()};
+  auto it = synopses.find(partition);
+  if (it == synopses.end())
+    return unbounded;
+  auto result = std::pair{time::max(), time::min()};
+  auto found = false;
+  for (const auto& [field, syn] : it->second.field_synopses_) {
+    if (field.type.name() != "timestamp")
+      continue;
+    auto ts = dynamic_cast<const time_synopsis*>(syn.get());
+    if (!ts)
+      return unbounded;
+    result.first = std::min(result.first, ts->min());
+    result.second = std::max(result.second, ts->max());
+    found = true;
+  }
+  return found ? result : unbounded;
+}
+
+caf::optional<hyperloglog>
+meta_index_state::sketch(const std::vector<uuid>& partitions,
+                         std::string_view field) const {
+  caf::optional<hyperloglog> result;
+  for (const auto& partition : partitions) {
+    auto it = synopses.find(partition);
+    if (it == synopses.end())
+      continue;
+    auto sketch = it->second.sketch(field);
+    if (!sketch)
+      continue;
+    if (result)
+      result->merge(*sketch);
+    else
+      result = std::move(sketch);
+  }
+  return result;
+}
+
+std::vector<uuid>
+meta_index_state::compaction_candidates(uint64_t threshold,
+                                        uint64_t capacity) const {
+  // Group the small partitions by their layouts, ordered by their first ID.
+  std::map<std::vector<std::string_view>, std::vector<std::pair<id, uuid>>>
+    groups;
+  for (const auto& [partition, synopsis] : synopses) {
+    if (synopsis.events == 0 || synopsis.events > threshold)
+      continue;
+    std::vector<std::string_view> layouts;
+    for (const auto& [field, _] : synopsis.field_synopses_)
+      layouts.emplace_back(field.layout_name);
+    std::sort(layouts.begin(), layouts.end());
+    layouts.erase(std::unique(layouts.begin(), layouts.end()), layouts.end());
+    groups[std::move(layouts)].emplace_back(synopsis.offset, partition);
+  }
+  std::vector<uuid> result;
+  auto oldest = invalid_id;
+  for (auto& [_, partitions] : groups) {
+    if (partitions.size() < 2)
+      continue;
+    std::sort(partitions.begin(), partitions.end());
+    if (partitions.front().first >= oldest)
+      continue;
+    std::vector<uuid> run;
+    uint64_t events = 0;
+    for (const auto& [offset, partition] : partitions) {
+      auto n = synopses.at(partition).events;
+      if (events + n > capacity)
+        break;
+      events += n;
+      run.push_back(partition);
+    }
+    if (run.size() < 2)
+      continue;
+    oldest = partitions.front().first;
+    result = std::move(run);
+  }
+  return result;
+}
+
 meta_index_actor::behavior_type
 meta_index(meta_index_actor::stateful_pointer<meta_index_state> self) {
   self->state.self = self;
@@ -283,6 +491,75 @@ meta_index(meta_index_actor::stateful_pointer<meta_index_state> self) {
       VAST_TRACE_SCOPE("{} {}", self, VAST_ARG(expr));
       return self->state.lookup(expr);
     },
+    [=](atom::resolve, const std::vector<uuid>& partitions)
+      -> caf::result<std::vector<time>, std::vector<time>> {
+      VAST_TRACE_SCOPE("{} {}", self, VAST_ARG(partitions));
+      std::vector<time> first;
+      std::vector<time> last;
+      first.reserve(partitions.size());
+      last.reserve(partitions.size());
+      for (const auto& partition : partitions) {
+        auto [lower, upper] = self->state.time_bounds(partition);
+        first.push_back(lower);
+        last.push_back(upper);
+      }
+      return {std::move(first), std::move(last)};
+    },
+    [=](atom::distinct, const expression& expr,
+        const std::string& field) -> uint64_t {
+      VAST_TRACE_SCOPE("{} {} {}", self, VAST_ARG(expr), VAST_ARG(field));
+      auto start = system::stopwatch::now();
+      auto candidates = self->state.lookup(expr);
+      auto sketch = self->state.sketch(candidates, field);
+      auto result = sketch ? sketch->estimate() : uint64_t{0};
+      auto delta = std::chrono::duration_cast<std::chrono::microseconds>(
+        system::stopwatch::now() - start);
+      VAST_DEBUG("{} estimates {} distinct values of {} in {} candidates in "
+                 "{} microseconds",
+                 self, result, field, candidates.size(), delta.count());
+      return result;
+    },
+    [=](atom::erase, uuid partition) -> atom::ok {
+      VAST_TRACE_SCOPE("{} {}", self, VAST_ARG(partition));
+      self->state.erase(partition);
+      return atom::ok_v;
+    },
+    [=](atom::erase, expression expr) -> std::vector<uuid> {
+      VAST_TRACE_SCOPE("{} {}", self, VAST_ARG(expr));
+      // The synopses stay until the INDEX erased the partitions one by one,
+      // because a partition that fails to erase must remain queryable.
+      auto result = self->state.covered(expr);
+      VAST_VERBOSE("{} found {} partitions that lie entirely within {}", self,
+                   result.size(), expr);
+      return result;
+    },
+    [=](atom::merge, atom::candidate, uint64_t threshold,
+        uint64_t capacity) -> caf::result<std::vector<uuid>, ids> {
+      VAST_TRACE_SCOPE("{} {} {}", self, VAST_ARG(threshold),
+                       VAST_ARG(capacity));
+      auto partitions = self->state.compaction_candidates(threshold, capacity);
+      std::vector<std::pair<id, id>> ranges;
+      for (const auto& partition : partitions) {
+        const auto& id_ranges = self->state.at(partition).id_ranges;
+        ranges.insert(ranges.end(), id_ranges.begin(), id_ranges.end());
+      }
+      std::sort(ranges.begin(), ranges.end());
+      ids result;
+      for (auto [first, last] : ranges) {
+        result.append_bits(false, first - result.size());
+        result.append_bits(true, last - first);
+      }
+      return {std::move(partitions), std::move(result)};
+    },
+    [=](atom::replace, const std::vector<uuid>& partitions, uuid partition,
+        std::shared_ptr<partition_synopsis>& synopsis) -> atom::ok {
+      VAST_TRACE_SCOPE("{} {} {}", self, VAST_ARG(partitions),
+                       VAST_ARG(partition));
+      for (const auto& x : partitions)
+        self->state.erase(x);
+      self->state.merge(partition, std::move(*synopsis));
+      return atom::ok_v;
+    },
   };
 }
 
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/metrics.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vast::system {
+
+size_t metric_shard() noexcept {
+  static std::atomic<size_t> next = 0;
+  thread_local size_t shard
+    = next.fetch_add(1, std::memory_order_relaxed) % metric_shards;
+  return shard;
+}
+
+uint64_t counter_metric::value() const noexcept {
+  uint64_t result = 0;
+  for (auto& s : shards_)
+    result += s.value.load(std::memory_order_relaxed);
+  return result;
+}
+
+uint64_t histogram_metric::snapshot::quantile(double q) const noexcept {
+  VAST_ASSERT(count > 0);
+  auto rank = static_cast<uint64_t>(std::ceil(q * count));
+  rank = std::clamp(rank, uint64_t{1}, count);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return upper_bound(i);
+  }
+  return upper_bound(num_buckets - 1);
+}
+
+size_t histogram_metric::bucket(uint64_t x) noexcept {
+  if (x < sub_buckets)
+    return x;
+  // The sub-bucket is given by the bits right after the most significant one.
+  auto msb = 63 - __builtin_clzll(x);
+  auto shift = msb - sub_bucket_bits;
+  auto sub = (x >> shift) & (sub_buckets - 1);
+  return ((shift + 1) << sub_bucket_bits) + sub;
+}
+
+uint64_t histogram_metric::upper_bound(size_t i) noexcept {
+  if (i < sub_buckets)
+    return i;
+  auto shift = (i >> sub_bucket_bits) - 1;
+  auto sub = i & (sub_buckets - 1);
+  // Wraps around to the maximum value for the very last bucket.
+  return ((sub_buckets + sub + 1) << shift) - 1;
+}
+
+histogram_metric::snapshot histogram_metric::take() noexcept {
+  snapshot result;
+  for (auto& s : shards_) {
+    for (size_t i = 0; i < num_buckets; ++i) {
+      auto n = s.buckets[i].exchange(0, std::memory_order_relaxed);
+      result.buckets[i] += n;
+      result.count += n;
+    }
+    result.sum += s.sum.exchange(0, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+metrics_registry& metrics_registry::instance() noexcept {
+  static metrics_registry registry;
+  return registry;
+}
+
+namespace {
+
+template <class Metric>
+Metric& get_or_make(std::map<std::string, std::unique_ptr<Metric>>& xs,
+                    const std::string& name) {
+  auto& x = xs[name];
+  if (!x)
+    x = std::make_unique<Metric>();
+  return *x;
+}
+
+} // namespace
+
+counter_metric& metrics_registry::make_counter(const std::string& name) {
+  auto lock = std::unique_lock{mutex_};
+  return get_or_make(counters_, name);
+}
+
+gauge_metric& metrics_registry::make_gauge(const std::string& name) {
+  auto lock = std::unique_lock{mutex_};
+  return get_or_make(gauges_, name);
+}
+
+histogram_metric& metrics_registry::make_histogram(const std::string& name) {
+  auto lock = std::unique_lock{mutex_};
+  return get_or_make(histograms_, name);
+}
+
+report metrics_registry::snapshot() {
+  auto lock = std::unique_lock{mutex_};
+  report result;
+  result.reserve(counters_.size() + gauges_.size() + 5 * histograms_.size());
+  for (auto& [name, x] : counters_)
+    result.push_back({name, x->value()});
+  for (auto& [name, x] : gauges_)
+    result.push_back({name, x->value()});
+  for (auto& [name, x] : histograms_) {
+    // Taking the snapshot resets the histogram, so every report summarizes
+    // the values of a single interval only.
+    auto s = x->take();
+    if (s.count == 0)
+      continue;
+    auto ns = [](uint64_t n) {
+      return duration{static_cast<duration::rep>(n)};
+    };
+    result.push_back({name + ".count", s.count});
+    result.push_back({name + ".mean", ns(s.sum / s.count)});
+    result.push_back({name + ".p50", ns(s.quantile(0.5))});
+    result.push_back({name + ".p99", ns(s.quantile(0.99))});
+    result.push_back({name + ".max", ns(s.quantile(1.0))});
+  }
+  return result;
+}
+
+} // namespace vast::system
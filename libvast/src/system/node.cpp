@@ -43,6 +43,7 @@
 #include "vast/system/spawn_archive.hpp"
 #include "vast/system/spawn_arguments.hpp"
 #include "vast/system/spawn_counter.hpp"
+#include "vast/system/spawn_compactor.hpp"
 #include "vast/system/spawn_disk_monitor.hpp"
 #include "vast/system/spawn_eraser.hpp"
 #include "vast/system/spawn_explorer.hpp"
@@ -56,6 +57,7 @@
 #include "vast/system/spawn_source.hpp"
 #include "vast/system/spawn_type_registry.hpp"
 #include "vast/system/terminate.hpp"
+#include "vast/system/uring_filesystem.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/taxonomies.hpp"
 
@@ -98,8 +100,8 @@ bool is_singleton(std::string_view type) {
   // refactoring will be much easier once the NODE itself is a typed actor, so
   // let's hold off until then.
   const char* singletons[]
-    = {"accountant", "archive", "eraser",       "filesystem",
-       "importer",   "index",   "type-registry"};
+    = {"accountant", "archive",  "compactor", "eraser",
+       "filesystem", "importer", "index",     "type-registry"};
   auto pred = [&](const char* x) { return x == type; };
   return std::any_of(std::begin(singletons), std::end(singletons), pred);
 }
@@ -348,6 +350,7 @@ auto make_component_factory() {
   return node_state::named_component_factory {
     {"spawn accountant", lift_component_factory<spawn_accountant>()},
       {"spawn archive", lift_component_factory<spawn_archive>()},
+      {"spawn compactor", lift_component_factory<spawn_compactor>()},
       {"spawn counter", lift_component_factory<spawn_counter>()},
       {"spawn disk_monitor", lift_component_factory<spawn_disk_monitor>()},
       {"spawn eraser", lift_component_factory<spawn_eraser>()},
@@ -397,6 +400,7 @@ auto make_command_factory() {
     {"send", send_command},
     {"spawn accountant", node_state::spawn_command},
     {"spawn archive", node_state::spawn_command},
+    {"spawn compactor", node_state::spawn_command},
     {"spawn counter", node_state::spawn_command},
     {"spawn disk_monitor", node_state::spawn_command},
     {"spawn eraser", node_state::spawn_command},
@@ -530,8 +534,31 @@ node(node_actor::stateful_pointer<node_state> self, std::string name, path dir,
   node_state::component_factory = make_component_factory();
   node_state::command_factory = make_command_factory();
   // Initialize the file system with the node directory as root.
-  auto fs = self->spawn<caf::linked + caf::detached>(posix_filesystem,
-                                                     self->state.dir);
+  auto backend = caf::get_or(content(self->system().config()),
+                             "vast.filesystem-backend",
+                             std::string{defaults::system::filesystem_backend});
+  auto fs = filesystem_actor{};
+  if (backend == "io_uring") {
+#if VAST_ENABLE_URING
+    auto queue_depth = caf::get_or(content(self->system().config()),
+                                   "vast.uring-queue-depth",
+                                   defaults::system::uring_queue_depth);
+    if (has_uring())
+      fs = caf::actor_cast<filesystem_actor>(
+        self->spawn<caf::linked + caf::detached>(uring_filesystem,
+                                                 self->state.dir,
+                                                 queue_depth));
+#endif // VAST_ENABLE_URING
+    if (!fs)
+      VAST_WARN("{} falls back to the POSIX filesystem backend because "
+                "io_uring is unavailable",
+                self);
+  } else if (backend != "posix") {
+    VAST_WARN("{} ignores unknown filesystem backend {}", self, backend);
+  }
+  if (!fs)
+    fs = self->spawn<caf::linked + caf::detached>(posix_filesystem,
+                                                  self->state.dir);
   self->state.registry.add(caf::actor_cast<caf::actor>(fs), "filesystem");
   // Remove monitored components.
   self->set_down_handler([=](const caf::down_msg& msg) {
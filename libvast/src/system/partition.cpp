@@ -26,6 +26,7 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
 #include "vast/detail/settings.hpp"
+#include "vast/detail/tracepoint.hpp"
 #include "vast/expression.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/fbs/partition.hpp"
@@ -36,6 +37,8 @@
 #include "vast/qualified_record_field.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/system/indexer.hpp"
+#include "vast/system/query_profile.hpp"
+#include "vast/system/query_result_cache.hpp"
 #include "vast/system/shutdown.hpp"
 #include "vast/system/status_verbosity.hpp"
 #include "vast/system/terminate.hpp"
@@ -44,8 +47,10 @@
 #include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index.hpp"
+#include "vast/view.hpp"
 
 #include <caf/attach_continuous_stream_stage.hpp>
+#include <caf/binary_deserializer.hpp>
 #include <caf/broadcast_downstream_manager.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/error.hpp>
@@ -54,6 +59,7 @@
 #include <flatbuffers/base.h> // FLATBUFFERS_MAX_BUFFER_SIZE
 #include <flatbuffers/flatbuffers.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace vast::system {
@@ -78,26 +84,34 @@ void active_partition_state::notify_flush_listeners() {
   flush_listeners.clear();
 }
 
-/// Gets the INDEXER at a certain position.
-indexer_actor passive_partition_state::indexer_at(size_t position) const {
-  VAST_ASSERT(position < indexers.size());
-  auto& indexer = indexers[position];
-  // Deserialize the value index and spawn a passive_indexer lazily when it is
-  // requested for the first time.
-  if (!indexer) {
+/// Gets the value index at a certain position.
+const value_index* passive_partition_state::index_at(size_t position) const {
+  VAST_ASSERT(position < indexes.size());
+  auto& idx = indexes[position];
+  // Deserialize the value index lazily when it is requested for the first
+  // time, and ask the operating system to page in the relevant part of the
+  // partition chunk ahead of time.
+  if (!idx) {
     auto qualified_index = flatbuffer->indexes()->Get(position);
     auto index = qualified_index->index();
     auto data = index->data();
-    value_index_ptr state_ptr;
-    if (auto error = fbs::deserialize_bytes(data, state_ptr)) {
-      VAST_ERROR("{} failed to deserialize indexer at {} with error: "
-                 "{}",
-                 self, position, render(error));
-      return {};
+    auto offset = static_cast<size_t>(
+      reinterpret_cast<const std::byte*>(data->data())
+      - partition_chunk->data());
+    auto index_chunk = partition_chunk->slice(offset, data->size());
+    if (auto err = index_chunk->prefetch())
+      VAST_DEBUG("{} failed to prefetch value index at {}: {}", self,
+                 position, render(err));
+    caf::binary_deserializer source{
+      nullptr, reinterpret_cast<const char*>(index_chunk->data()),
+      index_chunk->size()};
+    if (auto err = source(idx)) {
+      VAST_ERROR("{} failed to deserialize value index at {}: {}", self,
+                 position, render(err));
+      idx = nullptr;
     }
-    indexer = self->spawn(passive_indexer, id, std::move(state_ptr));
   }
-  return indexer;
+  return idx.get();
 }
 
 namespace {
@@ -123,16 +137,17 @@ fetch_indexer(const PartitionState& state, const data_extractor& dx,
   return {};
 }
 
-/// Retrieves an INDEXER for a predicate with a data extractor.
-/// @param dx The extractor.
-/// @param op The operator (only used to precompute ids for type queries.
+/// Computes the IDs of all rows that match a predicate with a meta extractor.
+/// @param ex The extractor.
+/// @param op The operator.
 /// @param x The literal side of the predicate.
+/// @returns The matching IDs, or `caf::none` for unsupported predicates.
 /// @relates active_partition_state
 /// @relates passive_partition_state
 template <typename PartitionState>
-indexer_actor
-fetch_indexer(const PartitionState& state, const meta_extractor& ex,
-              relational_operator op, const data& x) {
+caf::optional<ids>
+lookup_meta(const PartitionState& state, const meta_extractor& ex,
+            relational_operator op, const data& x) {
   VAST_TRACE_SCOPE("{} {} {}", VAST_ARG(ex), VAST_ARG(op), VAST_ARG(x));
   ids row_ids;
   if (ex.kind == meta_extractor::type) {
@@ -148,7 +163,7 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
       VAST_WARN("{} #field meta queries only support string "
                 "comparisons",
                 state.self);
-      return {};
+      return caf::none;
     }
     auto neg = is_negated(op);
     for (const auto& field : record_type::each{state.combined_layout}) {
@@ -172,11 +187,27 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
     }
   } else {
     VAST_WARN("{} got unsupported attribute: {}", state.self, ex.kind);
-    return {};
+    return caf::none;
   }
+  return row_ids;
+}
+
+/// Retrieves an INDEXER for a predicate with a meta extractor.
+/// @param ex The extractor.
+/// @param op The operator (only used to precompute ids for type queries.
+/// @param x The literal side of the predicate.
+/// @relates active_partition_state
+template <typename PartitionState>
+indexer_actor
+fetch_indexer(const PartitionState& state, const meta_extractor& ex,
+              relational_operator op, const data& x) {
+  auto row_ids = lookup_meta(state, ex, op, x);
+  if (!row_ids)
+    return {};
   // TODO: Spawning a one-shot actor is quite expensive. Maybe the
   //       partition could instead maintain this actor lazily.
-  return state.self->spawn([row_ids]() -> indexer_actor::behavior_type {
+  return state.self->spawn([row_ids = std::move(*row_ids)]()
+                             -> indexer_actor::behavior_type {
     return {
       [=](const curried_predicate&) { return row_ids; },
       [](atom::shutdown) {
@@ -186,9 +217,32 @@ fetch_indexer(const PartitionState& state, const meta_extractor& ex,
   });
 }
 
+/// Checks whether the zone maps of a partition allow for hits of the predicate
+/// at a position in an expression. Predicates nested in a negation are never
+/// skipped, because the evaluation of the negation needs their hits.
+/// @param zone_maps The zone maps of the partition.
+/// @param expr The expression.
+/// @param position The position of the predicate in *expr*.
+/// @returns `false` if no table slice can contain hits of the predicate.
+bool may_have_hits(const std::vector<zone_map>& zone_maps,
+                   const expression& expr, const offset& position) {
+  if (zone_maps.empty())
+    return true;
+  auto prefix = offset{};
+  for (auto i : position) {
+    if (auto x = at(expr, prefix); x && caf::holds_alternative<negation>(*x))
+      return true;
+    prefix.push_back(i);
+  }
+  auto pred = at(expr, position);
+  if (pred == nullptr)
+    return true;
+  return std::any_of(zone_maps.begin(), zone_maps.end(),
+                     [&](const auto& zm) { return may_match(zm, *pred); });
+}
+
 /// Returns all INDEXERs that are involved in evaluating the expression.
 /// @relates active_partition_state
-/// @relates passive_partition_state
 template <typename PartitionState>
 std::vector<evaluation_triple>
 evaluate(const PartitionState& state, const expression& expr) {
@@ -197,6 +251,9 @@ evaluate(const PartitionState& state, const expression& expr) {
   // partitions layout.
   auto resolved = resolve(expr, state.combined_layout);
   for (auto& kvp : resolved) {
+    // Skip predicates that cannot have hits in any of the table slices.
+    if (!may_have_hits(state.zone_maps, expr, kvp.first))
+      continue;
     // For each fitted predicate, look up the corresponding INDEXER
     // according to the specified type of extractor.
     auto& pred = kvp.second;
@@ -223,8 +280,108 @@ evaluate(const PartitionState& state, const expression& expr) {
   return result;
 }
 
+/// Evaluates an expression against the value indexes of a passive partition
+/// in the current thread. The value indexes of a passive partition are
+/// immutable, so unlike for active partitions there is no need to spawn an
+/// EVALUATOR and to message INDEXER actors.
+/// @param client The client of the query, for profiling only.
+/// @returns The hits of the expression and whether all lookups succeeded.
+/// @relates passive_partition_state
+std::pair<ids, bool>
+evaluate_in_thread(const passive_partition_state& state,
+                   const expression& expr,
+                   const partition_client_actor& client) {
+  auto hits = evaluator_state::predicate_hits_map{};
+  auto complete = true;
+  for (auto& kvp : resolve(expr, state.combined_layout)) {
+    auto& position = kvp.first;
+    auto& pred = kvp.second;
+    // Skip predicates that cannot have hits in any of the table slices, which
+    // also spares us deserializing their value indexes.
+    if (!may_have_hits(state.zone_maps, expr, position))
+      continue;
+    auto lookup_data = [&](const data_extractor& dx,
+                           const data& x) -> caf::optional<ids> {
+      auto index = dx.offset.empty()
+                     ? caf::optional<size_t>{}
+                     : state.combined_layout.flat_index_at(dx.offset);
+      if (!index) {
+        VAST_WARN("{} got invalid offset for the combined layout {}",
+                  state.self, state.combined_layout);
+        return caf::none;
+      }
+      auto idx = state.index_at(*index);
+      if (!idx) {
+        complete = false;
+        return caf::none;
+      }
+      auto result
+        = idx->lookup(pred.op, to_internal(idx->type(), make_view(x)));
+      if (!result) {
+        VAST_WARN("{} failed to look up predicate at position {}: {}",
+                  state.self, position, render(result.error()));
+        complete = false;
+        return caf::none;
+      }
+      return std::move(*result);
+    };
+    auto v = detail::overload{
+      [&](const meta_extractor& ex, const data& x) {
+        return lookup_meta(state, ex, pred.op, x);
+      },
+      [&](const data_extractor& dx, const data& x) {
+        return lookup_data(dx, x);
+      },
+      [](const auto&, const auto&) {
+        return caf::optional<ids>{}; // clang-format fix
+      },
+    };
+    auto start = stopwatch::now();
+    auto result = caf::visit(v, pred.lhs, pred.rhs);
+    if (!result)
+      continue;
+    auto latency = stopwatch::now() - start;
+    VAST_TRACEPOINT(
+      indexer_lookup, rank(*result),
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    query_profiler::instance().update(client->id(), [&](query_profile& p) {
+      auto original = at(expr, position);
+      auto key = original != nullptr ? to_string(*original) : "<unknown>";
+      auto& x = p.predicates[key];
+      ++x.lookups;
+      x.hits += rank(*result);
+      x.latency += latency;
+    });
+    hits[position].second |= *result;
+  }
+  return {evaluate_hits(expr, hits), complete};
+}
+
+/// Accounts for the evaluation of a query in the profile of its client.
+/// @param client The client of the query.
+/// @param bytes The size of the partition on disk, or 0 if it is active.
+void profile_evaluation(const partition_client_actor& client, size_t bytes) {
+  query_profiler::instance().update(client->id(), [&](query_profile& p) {
+    ++p.partitions_evaluated;
+    p.bytes_mapped += bytes;
+  });
+}
+
 } // namespace
 
+caf::optional<ids>
+select_slices(const std::vector<zone_map>& zone_maps, const expression& expr) {
+  // Partitions without zone maps were written by older versions, so we cannot
+  // rule out any of their slices.
+  if (zone_maps.empty())
+    return caf::none;
+  auto result = ids{};
+  for (const auto& zm : zone_maps)
+    if (may_match(zm, expr))
+      result |= make_ids({{zm.offset, zm.offset + zm.events}});
+  return result;
+}
+
 bool partition_selector::operator()(const qualified_record_field& filter,
                                     const table_slice_column& column) const {
   return filter == column.field();
@@ -278,6 +435,15 @@ pack(flatbuffers::FlatBufferBuilder& builder, const active_partition_state& x) {
   auto maybe_ps = pack(builder, *x.synopsis);
   if (!maybe_ps)
     return maybe_ps.error();
+  std::vector<flatbuffers::Offset<fbs::zone_map::v0>> zms;
+  zms.reserve(x.zone_maps.size());
+  for (const auto& zm : x.zone_maps) {
+    auto maybe_zm = pack(builder, zm);
+    if (!maybe_zm)
+      return maybe_zm.error();
+    zms.push_back(*maybe_zm);
+  }
+  auto zone_maps = builder.CreateVector(zms);
   fbs::partition::v0Builder v0_builder(builder);
   v0_builder.add_uuid(*uuid);
   v0_builder.add_offset(x.offset);
@@ -286,6 +452,7 @@ pack(flatbuffers::FlatBufferBuilder& builder, const active_partition_state& x) {
   v0_builder.add_partition_synopsis(*maybe_ps);
   v0_builder.add_combined_layout(*combined_layout);
   v0_builder.add_type_ids(type_ids);
+  v0_builder.add_zone_maps(zone_maps);
   auto partition_v0 = v0_builder.Finish();
   fbs::PartitionBuilder partition_builder(builder);
   partition_builder.add_partition_type(fbs::partition::Partition::v0);
@@ -345,7 +512,7 @@ unpack(const fbs::partition::v0& partition, passive_partition_state& state) {
   // We only create dummy entries here, since the positions of the `indexers`
   // vector must be the same as in `combined_layout`. The actual indexers are
   // deserialized and spawned lazily on demand.
-  state.indexers.resize(indexes->size());
+  state.indexes.resize(indexes->size());
   VAST_DEBUG("{} found {} indexers for partition {}", state.self,
              indexes->size(), state.id);
   auto type_ids = partition.type_ids();
@@ -357,6 +524,12 @@ unpack(const fbs::partition::v0& partition, passive_partition_state& state) {
     if (auto error = fbs::deserialize_bytes(ids_data, ids))
       return error;
   }
+  if (auto zone_maps = partition.zone_maps()) {
+    state.zone_maps.resize(zone_maps->size());
+    for (size_t i = 0; i < zone_maps->size(); ++i)
+      if (auto error = unpack(*zone_maps->Get(i), state.zone_maps[i]))
+        return error;
+  }
   VAST_DEBUG("{} restored {} type-to-ids mapping for partition {}", state.self,
              state.type_ids.size(), state.id);
   return caf::none;
@@ -367,7 +540,13 @@ caf::error unpack(const fbs::partition::v0& x, partition_synopsis& ps) {
     return caf::make_error(ec::format_error, "missing partition synopsis");
   if (!x.type_ids())
     return caf::make_error(ec::format_error, "missing type_ids");
-  return unpack(*x.partition_synopsis(), ps);
+  if (auto err = unpack(*x.partition_synopsis(), ps))
+    return err;
+  ps.offset = x.offset();
+  ps.events = x.events();
+  if (ps.id_ranges.empty() && ps.events > 0)
+    ps.id_ranges.emplace_back(ps.offset, ps.offset + ps.events);
+  return caf::none;
 }
 
 active_partition_actor::behavior_type active_partition(
@@ -410,6 +589,8 @@ active_partition_actor::behavior_type active_partition(
       self->state.offset = std::min(x.offset(), self->state.offset);
       self->state.events += x.rows();
       self->state.synopsis->add(x, self->state.synopsis_opts);
+      self->state.zone_maps.push_back(
+        make_zone_map(x, self->state.synopsis_opts));
       size_t col = 0;
       VAST_ASSERT(!layout.fields.empty());
       for (auto& field : layout.fields) {
@@ -417,7 +598,13 @@ active_partition_actor::behavior_type active_partition(
         auto& idx = self->state.indexers[qf];
         if (!idx) {
           self->state.combined_layout.fields.push_back(as_record_field(qf));
-          idx = self->spawn(active_indexer, field.type, index_opts);
+          auto opts = index_opts;
+          // Index timestamps with the delta-encoded time index. Value indexes
+          // persist their options, which allows for telling apart time
+          // indexes from the range-coded bitmap indexes of older partitions.
+          if (caf::holds_alternative<time_type>(field.type))
+            opts["time-index"] = "delta";
+          idx = self->spawn(active_indexer, field.type, std::move(opts));
           auto slot = self->state.stage->add_outbound_path(idx);
           self->state.stage->out().set_filter(slot, qf);
           VAST_DEBUG("{} spawned new indexer for field {} at slot {}", self,
@@ -632,8 +819,10 @@ active_partition_actor::behavior_type active_partition(
     },
     [self](const expression& expr,
            partition_client_actor client) -> caf::result<atom::done> {
-      // TODO: We should do a candidate check using `self->state.synopsis` and
-      // return early if that doesn't yield any results.
+      profile_evaluation(client, 0);
+      if (auto slices = select_slices(self->state.zone_maps, expr);
+          slices && !any<1>(*slices))
+        return atom::done_v;
       auto triples = evaluate(self->state, expr);
       if (triples.empty())
         return atom::done_v;
@@ -695,38 +884,18 @@ active_partition_actor::behavior_type active_partition(
 
 partition_actor::behavior_type passive_partition(
   partition_actor::stateful_pointer<passive_partition_state> self, uuid id,
-  filesystem_actor filesystem, class path path) {
+  filesystem_actor filesystem, class path path,
+  std::shared_ptr<query_result_cache> cache) {
   self->state.self = self;
+  self->state.cache = std::move(cache);
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     VAST_DEBUG("{} received EXIT from {} with reason: {}", self, msg.source,
                msg.reason);
     // Receiving an EXIT message does not need to coincide with the state
     // being destructed, so we explicitly clear the vector to release the
-    // references.
-    // TODO: We must actor_cast to caf::actor here because 'terminate'
-    // operates on 'std::vector<caf::actor>' only. That should probably be
-    // generalized in the future.
-    auto indexers = std::vector<caf::actor>{};
-    indexers.reserve(self->state.indexers.size());
-    for (auto&& indexer : std::exchange(self->state.indexers, {}))
-      indexers.push_back(caf::actor_cast<caf::actor>(std::move(indexer)));
-    if (msg.reason != caf::exit_reason::user_shutdown) {
-      self->quit(msg.reason);
-      return;
-    }
-    // When the shutdown was requested by the user (as opposed to the partition
-    // just dropping out of the LRU cache), pro-actively remove the indexers.
-    terminate<policy::parallel>(self, std::move(indexers))
-      .then(
-        [=](atom::done) {
-          VAST_DEBUG("{} shut down all indexers successfully", self);
-          self->quit();
-        },
-        [=](const caf::error& err) {
-          VAST_ERROR("{} failed to shut down all indexers: {}", self,
-                     render(err));
-          self->quit(err);
-        });
+    // value indexes.
+    self->state.indexes.clear();
+    self->quit(msg.reason);
   });
   // We send a "read" to the fs actor and upon receiving the result deserialize
   // the flatbuffer and switch to the "normal" partition behavior for responding
@@ -762,6 +931,7 @@ partition_actor::behavior_type passive_partition(
           self->quit();
           return;
         }
+        VAST_TRACEPOINT(partition_load, chunk->size());
         auto partition_v0 = partition->partition_as_v0();
         self->state.partition_chunk = chunk;
         self->state.flatbuffer = partition_v0;
@@ -774,6 +944,13 @@ partition_actor::behavior_type passive_partition(
           VAST_WARN("{} encountered partition id mismatch: restored {}"
                     "from disk, expected {}",
                     self, self->state.id, id);
+        // Every partition gets loaded only once, so we attribute the load to
+        // the query that triggered it.
+        if (!self->state.deferred_evaluations.empty()) {
+          auto& client = std::get<1>(self->state.deferred_evaluations.front());
+          query_profiler::instance().update(
+            client->id(), [](query_profile& p) { ++p.partitions_loaded; });
+        }
         // Delegate all deferred evaluations now that we have the partition chunk.
         VAST_DEBUG("{} delegates {} deferred evaluations", self,
                    self->state.deferred_evaluations.size());
@@ -799,32 +976,36 @@ partition_actor::behavior_type passive_partition(
     [self](const expression& expr,
            partition_client_actor client) -> caf::result<atom::done> {
       VAST_TRACE_SCOPE("{} {}", self, VAST_ARG(expr));
-      if (!self->state.partition_chunk)
+      if (!self->state.partition_chunk) {
         return std::get<2>(self->state.deferred_evaluations.emplace_back(
           expr, client, self->make_response_promise<atom::done>()));
+      }
       // We can safely assert that if we have the partition chunk already, all
       // deferred evaluations were taken care of.
       VAST_ASSERT(self->state.deferred_evaluations.empty());
-      auto triples = evaluate(self->state, expr);
-      if (triples.empty())
+      profile_evaluation(client, self->state.partition_chunk->size());
+      auto& cache = self->state.cache;
+      if (auto slices = select_slices(self->state.zone_maps, expr);
+          slices && !any<1>(*slices)) {
+        if (cache)
+          cache->insert(self->state.id, to_string(expr), ids{});
         return atom::done_v;
-      auto eval = self->spawn(evaluator, expr, triples);
-      return self->delegate(eval, client);
+      }
+      auto [hits, complete] = evaluate_in_thread(self->state, expr, client);
+      if (cache && complete)
+        cache->insert(self->state.id, to_string(expr), hits);
+      if (any<1>(hits))
+        self->send(client, std::move(hits));
+      return atom::done_v;
     },
     [self](atom::status,
            status_verbosity /*v*/) -> caf::config_value::dictionary {
       caf::settings result;
       caf::put(result, "size", self->state.partition_chunk->size());
       size_t mem_indexers = 0;
-      for (size_t i = 0; i < self->state.indexers.size(); ++i) {
-        if (self->state.indexers[i])
-          mem_indexers += sizeof(indexer_state)
-                          + self->state.flatbuffer->indexes()
-                              ->Get(i)
-                              ->index()
-                              ->data()
-                              ->size();
-      }
+      for (const auto& idx : self->state.indexes)
+        if (idx)
+          mem_indexers += idx->memusage();
       caf::put(result, "memory-usage-indexers", mem_indexers);
       auto x = self->state.partition_chunk->incore();
       if (!x) {
@@ -36,17 +36,18 @@ namespace {
 /// Returns the field that shall be used to extract values from for
 /// the pivot membership query.
 caf::optional<record_field>
-common_field(const pivoter_state& st, const record_type& indicator) {
-  auto f = st.cache.find(indicator);
+common_field(const pivoter_state& st, const table_slice& slice) {
+  auto f = st.cache.find(slice.layout_id());
   if (f != st.cache.end())
     return f->second;
+  const auto& indicator = slice.layout();
     // TODO: This algorithm can be enabled once we have a live updated
     //       type registry. (Switch the type of target to record_type.)
 #if 0
   for (auto& t : target.fields) {
     for (auto& i : indicator.fields) {
       if (t.name == i.name) {
-        st.cache.insert({indicator, i});
+        st.cache.insert({slice.layout_id(), i});
         return i;
       }
     }
@@ -64,12 +65,12 @@ common_field(const pivoter_state& st, const record_type& indicator) {
     edge = "community_id";
   for (auto& i : indicator.fields) {
     if (i.name == edge) {
-      st.cache.insert({indicator, i});
+      st.cache.insert({slice.layout_id(), i});
       return i;
     }
   }
 #endif
-  st.cache.insert({indicator, caf::none});
+  st.cache.insert({slice.layout_id(), caf::none});
   VAST_WARN("{} got slice without shared column: {}", st.self,
             indicator.name());
   return caf::none;
@@ -104,7 +105,7 @@ caf::behavior pivoter(caf::stateful_actor<pivoter_state>* self, node_actor node,
   return {
     [=](vast::table_slice slice) {
       auto& st = self->state;
-      auto pivot_field = common_field(st, slice.layout());
+      auto pivot_field = common_field(st, slice);
       if (!pivot_field)
         return;
       VAST_DEBUG("{} uses {} to extract {} events", self, *pivot_field,
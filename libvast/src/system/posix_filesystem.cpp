@@ -15,8 +15,10 @@
 
 #include "vast/chunk.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
 #include "vast/io/read.hpp"
 #include "vast/io/save.hpp"
+#include "vast/system/prefetch.hpp"
 #include "vast/system/status_verbosity.hpp"
 
 #include <caf/config_value.hpp>
@@ -68,6 +70,15 @@ filesystem_actor::behavior_type posix_filesystem(
         return nullptr;
       }
     },
+    [self](atom::prefetch,
+           const std::vector<path>& filenames) -> caf::result<atom::ok> {
+      auto paths = std::vector<path>{};
+      paths.reserve(filenames.size());
+      for (const auto& filename : filenames)
+        paths.push_back(filename.is_absolute() ? filename
+                                               : self->state.root / filename);
+      return prefetch_detached(self, std::move(paths));
+    },
     [self](atom::status, status_verbosity v) {
       auto result = caf::settings{};
       if (v >= status_verbosity::info)
@@ -83,6 +94,7 @@ filesystem_actor::behavior_type posix_filesystem(
         add_stats("writes", self->state.stats.writes);
         add_stats("reads", self->state.stats.reads);
         add_stats("mmaps", self->state.stats.mmaps);
+        add_stats("prefetches", self->state.stats.prefetches);
       }
       return result;
     },
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/prefetch.hpp"
+
+#include "vast/config.hpp"
+#include "vast/error.hpp"
+
+#include <caf/event_based_actor.hpp>
+
+#if VAST_LINUX || VAST_BSD
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace vast::system {
+
+caf::expected<filesystem_statistics::ops>
+prefetch_files(const std::vector<path>& filenames) {
+#if VAST_LINUX || VAST_BSD
+  auto result = filesystem_statistics::ops{};
+  for (const auto& filename : filenames) {
+    auto fd = ::open(filename.str().c_str(), O_RDONLY);
+    if (fd == -1) {
+      ++result.failed;
+      continue;
+    }
+    if (::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0) {
+      ++result.successful;
+      if (auto size = file_size(filename))
+        result.bytes += *size;
+    } else {
+      ++result.failed;
+    }
+    ::close(fd);
+  }
+  return result;
+#else
+  // Without posix_fadvise(2) there is nothing to prefetch with, and we must
+  // not count the files as prefetched.
+  static_cast<void>(filenames);
+  return caf::make_error(ec::unimplemented,
+                         "prefetching requires posix_fadvise(2)");
+#endif
+}
+
+caf::behavior prefetcher(caf::event_based_actor* self) {
+  return {
+    [self](atom::prefetch, const std::vector<path>& filenames)
+      -> caf::result<uint64_t, uint64_t, uint64_t> {
+      self->quit();
+      auto stats = prefetch_files(filenames);
+      if (!stats)
+        return stats.error();
+      return {stats->successful, stats->failed, stats->bytes};
+    },
+  };
+}
+
+} // namespace vast::system
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/query_order.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/error.hpp"
+
+#include <string>
+
+namespace vast::system {
+
+caf::expected<query_order> to_query_order(std::string_view str) {
+  if (str == "asc")
+    return query_order::ascending;
+  if (str == "desc")
+    return query_order::descending;
+  return caf::make_error(ec::invalid_configuration, "invalid query order",
+                         std::string{str});
+}
+
+query_order to_query_order(query_options opts) {
+  if (has_ascending_option(opts))
+    return query_order::ascending;
+  if (has_descending_option(opts))
+    return query_order::descending;
+  return query_order::none;
+}
+
+const char* to_string(query_order x) {
+  switch (x) {
+    case query_order::none:
+      return "none";
+    case query_order::ascending:
+      return "asc";
+    case query_order::descending:
+      return "desc";
+  }
+  return "invalid";
+}
+
+} // namespace vast::system
@@ -18,6 +18,7 @@
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
+#include "vast/system/query_scheduler.hpp"
 
 #include <caf/event_based_actor.hpp>
 #include <caf/skip.hpp>
@@ -36,7 +37,7 @@ query_processor::query_processor(caf::event_based_actor* self)
   behaviors_[idle].assign(
     // Our default init state simply waits for a query to execute.
     [=](expression& expr, const index_actor& index) {
-      start(std::move(expr), index);
+      start(std::move(expr), index, query_priority::normal);
     });
   behaviors_[await_query_id].assign(
     // Received from the INDEX after sending the query when leaving `idle`.
@@ -68,9 +69,10 @@ query_processor::~query_processor() {
 
 // -- convenience functions ----------------------------------------------------
 
-void query_processor::start(expression expr, index_actor index) {
+void query_processor::start(expression expr, index_actor index,
+                            query_priority priority) {
   index_ = std::move(index);
-  self_->send(index_, std::move(expr));
+  self_->send(index_, std::move(expr), priority);
   transition_to(await_query_id);
 }
 
@@ -0,0 +1,83 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/query_profile.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/data.hpp"
+
+namespace vast::system {
+
+bool convert(const query_profile& x, data& y) {
+  record predicates;
+  for (const auto& [name, p] : x.predicates)
+    predicates.emplace(name, record{
+                               {"lookups", p.lookups},
+                               {"hits", p.hits},
+                               {"latency", p.latency},
+                             });
+  y = record{
+    {"id", to_string(x.id)},
+    {"runtime", x.runtime},
+    {"meta-index",
+     record{
+       {"candidates", x.candidates},
+       {"lookup", x.meta_index_lookup},
+     }},
+    {"partitions",
+     record{
+       {"evaluated", x.partitions_evaluated},
+       {"loaded", x.partitions_loaded},
+       {"bytes-mapped", x.bytes_mapped},
+     }},
+    {"predicates", std::move(predicates)},
+    {"archive",
+     record{
+       {"slices", x.slices_decoded},
+       {"rows", x.rows_decoded},
+       {"lookup", x.archive_lookup},
+     }},
+    {"exporter",
+     record{
+       {"checked", x.rows_checked},
+       {"selected", x.rows_selected},
+       {"candidate-check", x.candidate_check},
+     }},
+  };
+  return true;
+}
+
+query_profiler& query_profiler::instance() noexcept {
+  static query_profiler profiler;
+  return profiler;
+}
+
+void query_profiler::enable(caf::actor_id client) {
+  auto lock = std::unique_lock{mutex_};
+  if (profiles_.emplace(client, query_profile{}).second)
+    active_.fetch_add(1, std::memory_order_relaxed);
+}
+
+query_profile query_profiler::take(caf::actor_id client) {
+  auto lock = std::unique_lock{mutex_};
+  auto it = profiles_.find(client);
+  if (it == profiles_.end())
+    return {};
+  auto result = std::move(it->second);
+  profiles_.erase(it);
+  active_.fetch_sub(1, std::memory_order_relaxed);
+  return result;
+}
+
+} // namespace vast::system
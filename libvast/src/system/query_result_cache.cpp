@@ -0,0 +1,98 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/query_result_cache.hpp"
+
+#include <caf/settings.hpp>
+
+namespace vast::system {
+
+query_result_cache::query_result_cache(size_t capacity) : capacity_{capacity} {
+  // nop
+}
+
+std::optional<ids>
+query_result_cache::lookup(const uuid& partition, const std::string& expr) {
+  auto lock = std::unique_lock{mutex_};
+  auto it = index_.find(key_type{partition, expr});
+  if (it == index_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->hits;
+}
+
+bool query_result_cache::contains(const uuid& partition,
+                                  const std::string& expr) const {
+  auto lock = std::unique_lock{mutex_};
+  return index_.count(key_type{partition, expr}) > 0;
+}
+
+void query_result_cache::insert(const uuid& partition, std::string expr,
+                                ids hits) {
+  auto usage = sizeof(entry) + expr.size() + hits.memusage();
+  if (usage > capacity_)
+    return;
+  auto lock = std::unique_lock{mutex_};
+  auto key = key_type{partition, std::move(expr)};
+  if (auto it = index_.find(key); it != index_.end())
+    erase(it->second);
+  entries_.push_front(entry{key, std::move(hits), usage});
+  index_.emplace(std::move(key), entries_.begin());
+  memusage_ += usage;
+  evict();
+}
+
+void query_result_cache::invalidate(const uuid& partition) {
+  auto lock = std::unique_lock{mutex_};
+  auto first = index_.lower_bound(key_type{partition, std::string{}});
+  while (first != index_.end() && first->first.first == partition) {
+    auto it = first->second;
+    ++first;
+    erase(it);
+  }
+}
+
+size_t query_result_cache::size() const {
+  auto lock = std::unique_lock{mutex_};
+  return entries_.size();
+}
+
+size_t query_result_cache::memusage() const {
+  auto lock = std::unique_lock{mutex_};
+  return memusage_;
+}
+
+void query_result_cache::inspect_status(caf::settings& xs) const {
+  auto lock = std::unique_lock{mutex_};
+  caf::put(xs, "entries", entries_.size());
+  caf::put(xs, "memory-usage", memusage_);
+  caf::put(xs, "capacity", capacity_);
+  caf::put(xs, "hits", hits_);
+  caf::put(xs, "misses", misses_);
+}
+
+void query_result_cache::evict() {
+  while (memusage_ > capacity_ && !entries_.empty())
+    erase(std::prev(entries_.end()));
+}
+
+void query_result_cache::erase(entry_list::iterator it) {
+  memusage_ -= it->memusage;
+  index_.erase(it->key);
+  entries_.erase(it);
+}
+
+} // namespace vast::system
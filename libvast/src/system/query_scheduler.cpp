@@ -0,0 +1,131 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/query_scheduler.hpp"
+
+#include "vast/fwd.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+
+#include <caf/settings.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+namespace vast::system {
+
+caf::expected<query_priority> to_query_priority(std::string_view str) {
+  if (str == "low")
+    return query_priority::low;
+  if (str == "normal")
+    return query_priority::normal;
+  if (str == "high")
+    return query_priority::high;
+  return caf::make_error(ec::invalid_configuration, "invalid query priority",
+                         std::string{str});
+}
+
+const char* to_string(query_priority x) {
+  switch (x) {
+    case query_priority::low:
+      return "low";
+    case query_priority::normal:
+      return "normal";
+    case query_priority::high:
+      return "high";
+  }
+  return "invalid";
+}
+
+query_scheduler::query_scheduler(size_t max_workers)
+  : max_workers_{std::max(max_workers, size_t{1})},
+    limits_{std::max(max_workers_ / 2, size_t{1}),
+            std::max(max_workers_ - 1, size_t{1}), max_workers_} {
+  // nop
+}
+
+void query_scheduler::push(query_request request) {
+  queues_[static_cast<size_t>(request.priority)].push_back(std::move(request));
+}
+
+std::optional<query_request> query_scheduler::pop() {
+  for (auto i = num_classes; i-- > 0;) {
+    if (queues_[i].empty() || !may_run(running_, i))
+      continue;
+    auto result = std::move(queues_[i].front());
+    queues_[i].pop_front();
+    ++running_[i];
+    return result;
+  }
+  return std::nullopt;
+}
+
+void query_scheduler::release(query_priority priority) {
+  auto i = static_cast<size_t>(priority);
+  VAST_ASSERT(running_[i] > 0);
+  --running_[i];
+}
+
+void query_scheduler::drop(const uuid& query_id) {
+  for (auto& queue : queues_)
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [&](const query_request& x) {
+                                 return x.query_id == query_id;
+                               }),
+                queue.end());
+}
+
+size_t query_scheduler::queued() const {
+  return std::accumulate(
+    queues_.begin(), queues_.end(), size_t{0},
+    [](size_t acc, const auto& queue) { return acc + queue.size(); });
+}
+
+size_t query_scheduler::running() const {
+  return std::accumulate(running_.begin(), running_.end(), size_t{0});
+}
+
+size_t query_scheduler::runnable() const {
+  auto running = running_;
+  size_t result = 0;
+  for (auto i = num_classes; i-- > 0;)
+    for (size_t j = 0; j < queues_[i].size() && may_run(running, i); ++j) {
+      ++running[i];
+      ++result;
+    }
+  return result;
+}
+
+bool query_scheduler::may_run(const std::array<size_t, num_classes>& running,
+                              size_t i) const {
+  // The limit of a class covers the requests of all lower classes as well,
+  // so that lower classes cannot occupy the workers reserved for higher ones.
+  auto below = std::accumulate(running.begin(), running.begin() + i + 1,
+                               size_t{0});
+  auto total = std::accumulate(running.begin(), running.end(), size_t{0});
+  return below < limits_[i] && total < max_workers_;
+}
+
+void query_scheduler::inspect_status(caf::settings& xs) const {
+  for (size_t i = 0; i < num_classes; ++i) {
+    auto& x
+      = caf::put_dictionary(xs, to_string(static_cast<query_priority>(i)));
+    caf::put(x, "queued", queues_[i].size());
+    caf::put(x, "running", running_[i]);
+    caf::put(x, "limit", limits_[i]);
+  }
+}
+
+} // namespace vast::system
@@ -17,6 +17,7 @@
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
+#include "vast/data.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/error.hpp"
@@ -25,6 +26,7 @@
 #include "vast/scope_linked.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/node_control.hpp"
+#include "vast/system/query_profile.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/system/read_query.hpp"
 #include "vast/system/report.hpp"
@@ -158,6 +160,15 @@ sink_command(const invocation& inv, caf::actor_system& sys, caf::actor snk) {
         }
 #endif
       },
+      [&](const query_profile& profile) {
+        // The profile goes to stderr so that it does not interfere with the
+        // query results on stdout.
+        if (auto json = to_json(to_data(profile)))
+          std::cerr << *json << std::endl;
+        else
+          VAST_WARN("{} failed to render the query profile: {}",
+                    detail::pretty_type_name(inv.full_name), json.error());
+      },
       [&]([[maybe_unused]] std::string name,
           [[maybe_unused]] query_status query) {
 #if VAST_LOG_LEVEL >= VAST_LOG_LEVEL_INFO
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/spawn_compactor.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/compactor.hpp"
+#include "vast/system/node.hpp"
+#include "vast/system/spawn_arguments.hpp"
+
+#include <caf/settings.hpp>
+
+namespace vast::system {
+
+caf::expected<caf::actor>
+spawn_compactor(node_actor::stateful_pointer<node_state> self,
+                spawn_arguments& args) {
+  VAST_TRACE_SCOPE("{} {}", VAST_ARG(self), VAST_ARG(args));
+  // Parse options.
+  duration compaction_interval = defaults::system::compaction_interval;
+  if (auto str = caf::get_if<std::string>(&args.inv.options, "vast.compaction-"
+                                                             "interval")) {
+    auto parsed = to<duration>(*str);
+    if (!parsed)
+      return parsed.error();
+    compaction_interval = *parsed;
+  }
+  if (compaction_interval == duration::zero()) {
+    VAST_VERBOSE("{} has no compaction-interval and skips starting the "
+                 "compactor",
+                 self);
+    return ec::no_error;
+  }
+  // Ensure component dependencies.
+  auto [index, archive]
+    = self->state.registry.find<index_actor, archive_actor>();
+  if (!index)
+    return caf::make_error(ec::missing_component, "index");
+  if (!archive)
+    return caf::make_error(ec::missing_component, "archive");
+  // Spawn the compactor.
+  auto handle = self->spawn(compactor, compaction_interval, archive, index);
+  VAST_VERBOSE("{} spawned a compactor", self);
+  return caf::actor_cast<caf::actor>(handle);
+}
+
+} // namespace vast::system
@@ -46,7 +46,13 @@ spawn_counter(node_actor::stateful_pointer<node_state> self,
   if (!archive)
     return caf::make_error(ec::missing_component, "archive");
   auto estimate = caf::get_or(args.inv.options, "vast.count.estimate", false);
-  auto handle = self->spawn(counter, *expr, index, archive, estimate);
+  auto distinct
+    = caf::get_or(args.inv.options, "vast.count.distinct", std::string{});
+  if (!distinct.empty() && !estimate)
+    return caf::make_error(ec::invalid_configuration,
+                           "counting distinct values requires --estimate");
+  auto handle = self->spawn(counter, *expr, index, archive, estimate,
+                            std::move(distinct));
   VAST_VERBOSE("{} spawned a counter for {}", self, to_string(*expr));
   return handle;
 }
@@ -16,10 +16,13 @@
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/defaults.hpp"
+#include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/exporter.hpp"
 #include "vast/system/node.hpp"
+#include "vast/system/query_order.hpp"
+#include "vast/system/query_scheduler.hpp"
 #include "vast/system/spawn_arguments.hpp"
 
 #include <caf/actor.hpp>
@@ -28,6 +31,9 @@
 #include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <string>
+#include <vector>
+
 namespace vast::system {
 
 caf::expected<caf::actor>
@@ -47,7 +53,35 @@ spawn_exporter(node_actor::stateful_pointer<node_state> self,
   // Default to historical if no options provided.
   if (query_opts == no_query_options)
     query_opts = historical;
-  auto handle = self->spawn(exporter, *expr, query_opts);
+  if (get_or(args.inv.options, "vast.export.explain", false))
+    query_opts = query_opts + explain;
+  if (auto str = caf::get_if<std::string>(&args.inv.options,
+                                          "vast.export.priority")) {
+    auto priority = to_query_priority(*str);
+    if (!priority)
+      return priority.error();
+    if (*priority == query_priority::low)
+      query_opts = query_opts + low_priority;
+    else if (*priority == query_priority::high)
+      query_opts = query_opts + high_priority;
+  }
+  if (auto str
+      = caf::get_if<std::string>(&args.inv.options, "vast.export.order")) {
+    auto order = to_query_order(*str);
+    if (!order)
+      return order.error();
+    if (has_continuous_option(query_opts))
+      return caf::make_error(ec::invalid_configuration,
+                             "continuous queries cannot be ordered");
+    if (*order == query_order::ascending)
+      query_opts = query_opts + ascending;
+    else if (*order == query_order::descending)
+      query_opts = query_opts + descending;
+  }
+  // Parse the fields to project results onto.
+  auto fields = get_or(args.inv.options, "vast.export.fields",
+                       std::vector<std::string>{});
+  auto handle = self->spawn(exporter, *expr, query_opts, std::move(fields));
   VAST_VERBOSE("{} spawned an exporter for {}", self, to_string(*expr));
   // Wire the exporter to all components.
   auto [accountant, importer, archive, index]
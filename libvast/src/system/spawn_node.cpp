@@ -98,8 +98,9 @@ spawn_node(caf::scoped_actor& self, const caf::settings& opts) {
         });
     return result;
   };
-  std::list components = {"type-registry", "archive", "index",
-                          "importer",      "eraser",  "disk_monitor"};
+  std::list components
+    = {"type-registry", "archive",      "index",    "importer",
+       "eraser",        "disk_monitor", "compactor"};
   if (accounting)
     components.push_front("accountant");
   for (auto& c : components) {
@@ -0,0 +1,567 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/system/uring_filesystem.hpp"
+
+#include "vast/chunk.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/prefetch.hpp"
+#include "vast/system/status_verbosity.hpp"
+
+#include <caf/config_value.hpp>
+#include <caf/dictionary.hpp>
+#include <caf/result.hpp>
+#include <caf/send.hpp>
+#include <caf/settings.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if VAST_ENABLE_URING
+#  include <fcntl.h>
+#  include <liburing.h>
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#endif // VAST_ENABLE_URING
+
+namespace vast::system {
+
+void latency_histogram::add(duration latency) noexcept {
+  auto us
+    = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  size_t bucket = 0;
+  while (bucket + 1 < num_buckets && (int64_t{1} << bucket) <= us)
+    ++bucket;
+  ++buckets[bucket];
+}
+
+bool has_uring() noexcept {
+#if VAST_ENABLE_URING
+  io_uring ring;
+  if (io_uring_queue_init(1, &ring, 0) != 0)
+    return false;
+  io_uring_queue_exit(&ring);
+  return true;
+#else
+  return false;
+#endif // VAST_ENABLE_URING
+}
+
+#if VAST_ENABLE_URING
+
+namespace {
+
+/// The alignment that O_DIRECT requires for buffers, offsets, and sizes.
+constexpr size_t direct_io_alignment = 4'096;
+
+struct free_deleter {
+  void operator()(std::byte* ptr) const noexcept {
+    std::free(ptr);
+  }
+};
+
+} // namespace
+
+struct uring_filesystem_state::ring {
+  ~ring() noexcept {
+    if (notifier.joinable()) {
+      stopping = true;
+      auto value = uint64_t{1};
+      [[maybe_unused]] auto n = ::write(event_fd, &value, sizeof(value));
+      notifier.join();
+    }
+    exit();
+    if (event_fd != -1)
+      ::close(event_fd);
+  }
+
+  /// Sets up the ring and registers `event_fd` to signal its completions.
+  /// @returns 0 on success, or a negated `errno` value on failure.
+  int init(size_t queue_depth) noexcept {
+    if (event_fd == -1) {
+      event_fd = ::eventfd(0, EFD_CLOEXEC);
+      if (event_fd == -1)
+        return -errno;
+    }
+    if (auto result = io_uring_queue_init(queue_depth, &handle, 0); result < 0)
+      return result;
+    initialized = true;
+    return io_uring_register_eventfd(&handle, event_fd);
+  }
+
+  /// Tears down the ring, but keeps `event_fd` for a subsequent `init`.
+  void exit() noexcept {
+    if (initialized)
+      io_uring_queue_exit(&handle);
+    initialized = false;
+  }
+
+  io_uring handle;
+
+  /// Whether `handle` refers to a set up ring.
+  bool initialized = false;
+
+  /// The eventfd that the kernel signals whenever a submission completes.
+  int event_fd = -1;
+
+  /// Blocks on `event_fd` and tells the actor to reap completions.
+  std::thread notifier;
+
+  /// Tells the notifier to stop.
+  std::atomic<bool> stopping = false;
+};
+
+struct uring_filesystem_state::operation {
+  ~operation() noexcept {
+    if (fd != -1)
+      ::close(fd);
+  }
+
+  /// @returns The memory that the operation reads into or writes from.
+  std::byte* data() const noexcept {
+    if (buffer)
+      return buffer.get();
+    return const_cast<std::byte*>(input->data());
+  }
+
+  /// Whether the operation is a write.
+  bool is_write = false;
+
+  /// Whether the file was opened with O_DIRECT.
+  bool direct = false;
+
+  /// The path the operation refers to.
+  path filename;
+
+  /// The file descriptor; for writes, it refers to a temporary file that
+  /// replaces `filename` when the operation succeeds.
+  int fd = -1;
+
+  /// The number of bytes to read or write.
+  size_t size = 0;
+
+  /// The number of submissions that did not complete yet.
+  size_t outstanding = 0;
+
+  /// The first error that occurred.
+  caf::error error;
+
+  /// The time at which the request arrived.
+  std::chrono::steady_clock::time_point start;
+
+  /// The data to write if the operation writes through the page cache.
+  chunk_ptr input;
+
+  /// The destination of reads, or an aligned copy of the data for writes that
+  /// bypass the page cache.
+  std::unique_ptr<std::byte, free_deleter> buffer;
+
+  /// The response promise for a write.
+  caf::typed_response_promise<atom::ok> write_promise;
+
+  /// The response promise for a read.
+  caf::typed_response_promise<chunk_ptr> read_promise;
+};
+
+uring_filesystem_state::uring_filesystem_state() = default;
+
+uring_filesystem_state::~uring_filesystem_state() noexcept {
+  // Tear down the ring before releasing the buffers of pending operations so
+  // that the kernel does not access freed memory.
+  uring.reset();
+}
+
+namespace {
+
+using self_pointer
+  = uring_filesystem_actor::stateful_pointer<uring_filesystem_state>;
+
+void finish(self_pointer self, uint64_t id);
+
+/// Moves as many submissions from the backlog into the ring as fit, and
+/// submits them to the kernel.
+void submit(self_pointer self) {
+  auto& st = self->state;
+  auto* ring = &st.uring->handle;
+  auto submitted = size_t{0};
+  while (!st.backlog.empty() && st.in_flight.size() < st.queue_depth) {
+    auto* sqe = io_uring_get_sqe(ring);
+    if (!sqe)
+      break;
+    auto sub = st.backlog.front();
+    st.backlog.pop_front();
+    auto& op = *st.operations.at(sub.operation);
+    auto* data = op.data() + sub.offset;
+    if (op.is_write)
+      io_uring_prep_write(sqe, op.fd, data, sub.size, sub.offset);
+    else
+      io_uring_prep_read(sqe, op.fd, data, sub.size, sub.offset);
+    auto id = st.next_submission++;
+    sqe->user_data = id;
+    st.in_flight.emplace(id, sub);
+    ++submitted;
+  }
+  st.max_in_flight = std::max(st.max_in_flight, st.in_flight.size());
+  if (submitted == 0)
+    return;
+  auto result = io_uring_submit(ring);
+  if (result >= 0)
+    return;
+  VAST_WARN("{} failed to submit {} operations: {}", self, submitted,
+            std::strerror(-result));
+  // We cannot tell which of the queued entries the kernel picked up, so we
+  // fail all submissions in flight and continue with a fresh ring. This way no
+  // completion can arrive for a buffer that we released already. The
+  // operations of the failed submissions cannot succeed anymore, so we fail
+  // their remaining submissions in the backlog as well.
+  st.uring->exit();
+  auto finished = std::vector<uint64_t>{};
+  auto fail = [&](const uring_filesystem_state::submission& sub) {
+    auto& op = *st.operations.at(sub.operation);
+    if (!op.error)
+      op.error = caf::make_error(ec::filesystem_error,
+                                 "failed to submit operation",
+                                 op.filename.str(), std::strerror(-result));
+    if (--op.outstanding == 0)
+      finished.push_back(sub.operation);
+  };
+  for (auto& [_, sub] : st.in_flight)
+    fail(sub);
+  st.in_flight.clear();
+  for (auto& sub : st.backlog)
+    fail(sub);
+  st.backlog.clear();
+  for (auto id : finished)
+    finish(self, id);
+  if (auto err = st.uring->init(st.queue_depth); err < 0) {
+    VAST_ERROR("{} failed to set up io_uring: {}", self, std::strerror(-err));
+    st.uring.reset();
+    self->quit(caf::make_error(ec::system_error, "failed to set up io_uring",
+                               std::strerror(-err)));
+  }
+}
+
+/// Delivers the result of a completed operation.
+void finish(self_pointer self, uint64_t id) {
+  auto& st = self->state;
+  auto node = st.operations.extract(id);
+  VAST_ASSERT(!node.empty());
+  auto& op = *node.mapped();
+  auto latency = std::chrono::duration_cast<duration>(
+    std::chrono::steady_clock::now() - op.start);
+  if (op.is_write) {
+    auto tmp = op.filename + ".tmp";
+    // Writes that bypass the page cache are padded to the alignment, so we
+    // need to cut off the padding again.
+    if (!op.error && op.direct && ::ftruncate(op.fd, op.size) != 0)
+      op.error = caf::make_error(ec::filesystem_error,
+                                 "failed in ftruncate(2):",
+                                 std::strerror(errno));
+    ::close(op.fd);
+    op.fd = -1;
+    if (!op.error
+        && std::rename(tmp.str().c_str(), op.filename.str().c_str()) != 0)
+      op.error = caf::make_error(ec::filesystem_error,
+                                 "failed in rename(2):", std::strerror(errno));
+    if (op.error) {
+      rm(tmp);
+      ++st.stats.writes.failed;
+      op.write_promise.deliver(std::move(op.error));
+      return;
+    }
+    ++st.stats.writes.successful;
+    st.stats.writes.bytes += op.size;
+    st.write_latencies.add(latency);
+    op.write_promise.deliver(atom::ok_v);
+    return;
+  }
+  if (op.error) {
+    ++st.stats.reads.failed;
+    op.read_promise.deliver(std::move(op.error));
+    return;
+  }
+  ++st.stats.reads.successful;
+  st.stats.reads.bytes += op.size;
+  st.read_latencies.add(latency);
+  auto buffer = op.buffer.release();
+  op.read_promise.deliver(chunk::make(
+    buffer, op.size, [buffer]() noexcept { std::free(buffer); }));
+}
+
+/// Processes all completed submissions without blocking.
+void reap(self_pointer self) {
+  auto& st = self->state;
+  auto* ring = &st.uring->handle;
+  io_uring_cqe* cqe = nullptr;
+  auto head = unsigned{0};
+  auto count = unsigned{0};
+  auto finished = std::vector<uint64_t>{};
+  io_uring_for_each_cqe(ring, head, cqe) {
+    ++count;
+    auto it = st.in_flight.find(cqe->user_data);
+    VAST_ASSERT(it != st.in_flight.end());
+    auto sub = it->second;
+    st.in_flight.erase(it);
+    auto& op = *st.operations.at(sub.operation);
+    if (cqe->res < 0) {
+      if (!op.error)
+        op.error = caf::make_error(
+          ec::filesystem_error,
+          op.is_write ? "failed to write" : "failed to read",
+          op.filename.str(), std::strerror(-cqe->res));
+    } else if (cqe->res == 0 && sub.size > 0) {
+      if (!op.error)
+        op.error = caf::make_error(ec::filesystem_error,
+                                   "unexpected end of file", op.filename.str());
+    } else if (static_cast<uint64_t>(cqe->res) < sub.size) {
+      // Resubmit the remainder of a short read or write.
+      auto n = static_cast<uint64_t>(cqe->res);
+      // O_DIRECT requires aligned offsets and sizes, which the remainder of
+      // a short write may lack. We write it through the page cache instead.
+      if (op.direct && n % direct_io_alignment != 0 && !op.error) {
+        auto flags = ::fcntl(op.fd, F_GETFL);
+        if (flags == -1 || ::fcntl(op.fd, F_SETFL, flags & ~O_DIRECT) == -1)
+          op.error = caf::make_error(ec::filesystem_error,
+                                     "failed in fcntl(2):",
+                                     std::strerror(errno));
+      }
+      if (!op.error) {
+        st.backlog.push_front({sub.operation, sub.offset + n, sub.size - n});
+        ++op.outstanding;
+      }
+    }
+    if (--op.outstanding == 0)
+      finished.push_back(sub.operation);
+  }
+  io_uring_cq_advance(ring, count);
+  for (auto id : finished)
+    finish(self, id);
+}
+
+/// Splits an operation into submissions and schedules them.
+void enqueue(self_pointer self,
+             std::unique_ptr<uring_filesystem_state::operation> op,
+             uint64_t length) {
+  auto& st = self->state;
+  auto id = st.next_operation++;
+  auto block_size = uint64_t{defaults::system::uring_block_size};
+  for (uint64_t offset = 0; offset < length; offset += block_size) {
+    st.backlog.push_back({id, offset, std::min(block_size, length - offset)});
+    ++op->outstanding;
+  }
+  auto outstanding = op->outstanding;
+  st.operations.emplace(id, std::move(op));
+  if (outstanding == 0) {
+    finish(self, id);
+    return;
+  }
+  submit(self);
+}
+
+} // namespace
+
+uring_filesystem_actor::behavior_type uring_filesystem(
+  uring_filesystem_actor::stateful_pointer<uring_filesystem_state> self,
+  path root, size_t queue_depth) {
+  self->state.root = root;
+  self->state.queue_depth = queue_depth;
+  auto ring = std::make_unique<uring_filesystem_state::ring>();
+  if (auto result = ring->init(queue_depth); result < 0) {
+    VAST_ERROR("{} failed to set up io_uring: {}", self,
+               std::strerror(-result));
+    self->quit(caf::make_error(ec::system_error, "failed to set up io_uring",
+                               std::strerror(-result)));
+    return uring_filesystem_actor::behavior_type::make_empty_behavior();
+  }
+  // Instead of polling the completion queue, a dedicated thread waits for the
+  // kernel to signal completions and wakes up the actor. It only holds a weak
+  // reference so that it does not keep the actor alive.
+  auto notify = [ring = ring.get(), weak = caf::weak_actor_ptr{self->ctrl()}] {
+    auto value = uint64_t{0};
+    while (::read(ring->event_fd, &value, sizeof(value)) == sizeof(value)
+           || errno == EINTR) {
+      if (ring->stopping)
+        return;
+      auto strong = weak.lock();
+      if (!strong)
+        return;
+      caf::anon_send(caf::actor_cast<uring_filesystem_actor>(strong),
+                     atom::internal_v, atom::resume_v);
+    }
+  };
+  ring->notifier = std::thread{std::move(notify)};
+  self->state.uring = std::move(ring);
+  return {
+    [self](atom::write, const path& filename,
+           chunk_ptr chk) -> caf::result<atom::ok> {
+      VAST_ASSERT(chk != nullptr);
+      auto path
+        = filename.is_absolute() ? filename : self->state.root / filename;
+      if (!exists(path.parent()))
+        if (auto err = mkdir(path.parent())) {
+          ++self->state.stats.writes.failed;
+          return err;
+        }
+      auto op = std::make_unique<uring_filesystem_state::operation>();
+      op->is_write = true;
+      op->filename = path;
+      op->size = chk->size();
+      op->start = std::chrono::steady_clock::now();
+      // We write to a temporary file first and rename it when all writes
+      // completed, just like `io::save`.
+      auto tmp = path + ".tmp";
+      auto flags = O_CREAT | O_WRONLY | O_TRUNC;
+      if (op->size >= defaults::system::uring_direct_io_threshold) {
+        op->fd = ::open(tmp.str().c_str(), flags | O_DIRECT, 0644);
+        op->direct = op->fd != -1;
+      }
+      // Not all filesystems support O_DIRECT, so we fall back to writing
+      // through the page cache.
+      if (op->fd == -1)
+        op->fd = ::open(tmp.str().c_str(), flags, 0644);
+      if (op->fd == -1) {
+        ++self->state.stats.writes.failed;
+        return caf::make_error(ec::filesystem_error, "failed in open(2):",
+                               std::strerror(errno));
+      }
+      auto length = uint64_t{op->size};
+      if (op->direct) {
+        length = (length + direct_io_alignment - 1) / direct_io_alignment
+                 * direct_io_alignment;
+        void* ptr = nullptr;
+        if (::posix_memalign(&ptr, direct_io_alignment, length) != 0) {
+          ++self->state.stats.writes.failed;
+          return caf::make_error(ec::system_error, "failed to allocate "
+                                                   "aligned buffer");
+        }
+        op->buffer.reset(static_cast<std::byte*>(ptr));
+        std::memcpy(ptr, chk->data(), op->size);
+        std::memset(op->buffer.get() + op->size, 0, length - op->size);
+      } else {
+        op->input = std::move(chk);
+      }
+      op->write_promise = self->make_response_promise<atom::ok>();
+      auto rp = op->write_promise;
+      enqueue(self, std::move(op), length);
+      return rp;
+    },
+    [self](atom::read, const path& filename) -> caf::result<chunk_ptr> {
+      auto path
+        = filename.is_absolute() ? filename : self->state.root / filename;
+      auto size = file_size(path);
+      if (!size) {
+        ++self->state.stats.reads.failed;
+        return size.error();
+      }
+      auto op = std::make_unique<uring_filesystem_state::operation>();
+      op->filename = path;
+      op->size = *size;
+      op->start = std::chrono::steady_clock::now();
+      op->fd = ::open(path.str().c_str(), O_RDONLY);
+      if (op->fd == -1) {
+        ++self->state.stats.reads.failed;
+        return caf::make_error(ec::filesystem_error, "failed in open(2):",
+                               std::strerror(errno));
+      }
+      op->buffer.reset(
+        static_cast<std::byte*>(std::malloc(std::max(op->size, size_t{1}))));
+      if (!op->buffer) {
+        ++self->state.stats.reads.failed;
+        return caf::make_error(ec::system_error, "failed to allocate buffer");
+      }
+      op->read_promise = self->make_response_promise<chunk_ptr>();
+      auto rp = op->read_promise;
+      auto length = uint64_t{op->size};
+      enqueue(self, std::move(op), length);
+      return rp;
+    },
+    [self](atom::mmap, const path& filename) -> caf::result<chunk_ptr> {
+      auto path
+        = filename.is_absolute() ? filename : self->state.root / filename;
+      if (auto chk = chunk::mmap(path)) {
+        ++self->state.stats.mmaps.successful;
+        self->state.stats.mmaps.bytes += chk->size();
+        return chk;
+      } else {
+        ++self->state.stats.mmaps.failed;
+        return nullptr;
+      }
+    },
+    [self](atom::prefetch,
+           const std::vector<path>& filenames) -> caf::result<atom::ok> {
+      auto paths = std::vector<path>{};
+      paths.reserve(filenames.size());
+      for (const auto& filename : filenames)
+        paths.push_back(filename.is_absolute() ? filename
+                                               : self->state.root / filename);
+      return prefetch_detached(self, std::move(paths));
+    },
+    [self](atom::internal, atom::resume) {
+      if (!self->state.uring)
+        return;
+      reap(self);
+      submit(self);
+    },
+    [self](atom::status, status_verbosity v) {
+      auto result = caf::settings{};
+      if (v >= status_verbosity::info)
+        caf::put(result, "filesystem.type", "io_uring");
+      if (v >= status_verbosity::detailed) {
+        caf::put(result, "filesystem.queue.depth", self->state.queue_depth);
+        caf::put(result, "filesystem.queue.in-flight",
+                 self->state.in_flight.size());
+        caf::put(result, "filesystem.queue.max-in-flight",
+                 self->state.max_in_flight);
+        caf::put(result, "filesystem.queue.backlog",
+                 self->state.backlog.size());
+      }
+      if (v >= status_verbosity::debug) {
+        auto& ops = put_dictionary(result, "filesystem.operations");
+        auto add_stats = [&](auto& name, auto& stats) {
+          auto& dict = put_dictionary(ops, name);
+          caf::put(dict, "successful", stats.successful);
+          caf::put(dict, "failed", stats.failed);
+          caf::put(dict, "bytes", stats.bytes);
+        };
+        add_stats("writes", self->state.stats.writes);
+        add_stats("reads", self->state.stats.reads);
+        add_stats("mmaps", self->state.stats.mmaps);
+        add_stats("prefetches", self->state.stats.prefetches);
+        // Bucket i of a histogram counts the operations that took less than
+        // 2^i microseconds; the last bucket counts all slower operations.
+        auto& latencies = put_dictionary(result, "filesystem.latencies");
+        auto add_histogram = [&](auto& name, const latency_histogram& x) {
+          auto& list = put_list(latencies, name);
+          for (auto count : x.buckets)
+            list.emplace_back(static_cast<caf::config_value::integer>(count));
+        };
+        add_histogram("writes", self->state.write_latencies);
+        add_histogram("reads", self->state.read_latencies);
+      }
+      return result;
+    },
+  };
+}
+
+#endif // VAST_ENABLE_URING
+
+} // namespace vast::system
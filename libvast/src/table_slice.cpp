@@ -16,6 +16,7 @@
 #include "vast/chunk.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/error.hpp"
@@ -30,9 +31,14 @@
 #include "vast/value_index.hpp"
 
 #include <cstddef>
+#include <memory>
+#include <vector>
 
 #if VAST_ENABLE_ARROW
 #  include "vast/arrow_table_slice.hpp"
+#  include "vast/arrow_table_slice_builder.hpp"
+
+#  include <arrow/api.h>
 #endif // VAST_ENABLE_ARROW
 
 namespace vast {
@@ -136,6 +142,77 @@ state([[maybe_unused]] Slice&& encoded, State&& state) noexcept {
   }
 }
 
+/// Extracts the columns of a table slice for a columnar append.
+/// @param slice The table slice to extract the columns from.
+/// @param flat_layout The flattened layout of *slice*.
+/// @param buffers Owns the values that the returned columns point to.
+/// @returns The columns, or an empty vector if a column has a type without a
+/// column view or contains null values.
+/// @note Integer, count, and real columns of Arrow-encoded slices alias the
+/// buffers of the record batch. All other columns, and all columns of
+/// row-oriented encodings, are copied cell by cell.
+std::vector<table_slice_builder::column_view>
+extract_columns(const table_slice& slice, const record_type& flat_layout,
+                std::vector<std::shared_ptr<void>>& buffers) {
+  std::vector<table_slice_builder::column_view> result;
+  result.reserve(flat_layout.fields.size());
+#if VAST_ENABLE_ARROW
+  auto batch = slice.encoding() == table_slice_encoding::arrow
+                 ? as_record_batch(slice)
+                 : std::shared_ptr<arrow::RecordBatch>{};
+  if (batch)
+    buffers.push_back(batch);
+#endif // VAST_ENABLE_ARROW
+  for (size_t column = 0; column < flat_layout.fields.size(); ++column) {
+    const auto& t = flat_layout.fields[column].type;
+    auto extract = [&](auto tag) {
+      using value_type = decltype(tag);
+      auto values = std::shared_ptr<value_type[]>{new value_type[slice.rows()]};
+      for (size_t row = 0; row < slice.rows(); ++row) {
+        auto x = slice.at(row, column, t);
+        auto ptr = caf::get_if<value_type>(&x);
+        if (!ptr)
+          return false;
+        values[row] = *ptr;
+      }
+      result.emplace_back(span<const value_type>{values.get(), slice.rows()});
+      buffers.push_back(std::move(values));
+      return true;
+    };
+    auto extract_numeric = [&](auto tag) {
+#if VAST_ENABLE_ARROW
+      using value_type = decltype(tag);
+      using arrow_type = typename arrow::CTypeTraits<value_type>::ArrowType;
+      using array_type = arrow::NumericArray<arrow_type>;
+      auto array = batch ? batch->column(column) : nullptr;
+      if (array && array->type_id() == arrow_type::type_id) {
+        const auto& arr = static_cast<const array_type&>(*array);
+        if (arr.null_count() > 0)
+          return false;
+        result.emplace_back(span<const value_type>{
+          arr.raw_values(), detail::narrow_cast<size_t>(arr.length())});
+        return true;
+      }
+#endif // VAST_ENABLE_ARROW
+      return extract(tag);
+    };
+    auto f = detail::overload{
+      [&](const bool_type&) { return extract(bool{}); },
+      [&](const integer_type&) { return extract_numeric(integer{}); },
+      [&](const count_type&) { return extract_numeric(count{}); },
+      [&](const real_type&) { return extract_numeric(real{}); },
+      [&](const duration_type&) { return extract(duration{}); },
+      [&](const time_type&) { return extract(time{}); },
+      [&](const string_type&) { return extract(std::string_view{}); },
+      [&](const address_type&) { return extract(address{}); },
+      [&](const auto&) { return false; },
+    };
+    if (!caf::visit(f, t))
+      return {};
+  }
+  return result;
+}
+
 } // namespace
 
 // -- constructors, destructors, and assignment operators ----------------------
@@ -164,7 +241,7 @@ table_slice::table_slice(chunk_ptr&& chunk, enum verify verify) noexcept
 }
 
 table_slice::table_slice(chunk_ptr&& chunk, enum verify verify,
-                         record_type layout) noexcept
+                         const record_type& layout) noexcept
   : chunk_{verified_or_none(std::move(chunk), verify)} {
   if (chunk_ && chunk_->unique()) {
     ++num_instances_;
@@ -173,7 +250,7 @@ table_slice::table_slice(chunk_ptr&& chunk, enum verify verify,
       [&](const auto& encoded) noexcept {
         auto& state_ptr = state(encoded, state_);
         auto state = std::make_unique<std::decay_t<decltype(*state_ptr)>>(
-          encoded, std::move(layout));
+          encoded, layout);
         state_ptr = state.get();
         chunk_->add_deletion_step(
           [state = std::move(state)]() noexcept { --num_instances_; });
@@ -199,13 +276,19 @@ table_slice::table_slice(const fbs::FlatTableSlice& flat_slice,
 }
 
 table_slice::table_slice(const table_slice& other) noexcept
-  : chunk_{other.chunk_}, offset_{other.offset_}, state_{other.state_} {
+  : chunk_{other.chunk_},
+    offset_{other.offset_},
+    view_begin_{other.view_begin_},
+    view_end_{other.view_end_},
+    state_{other.state_} {
   // nop
 }
 
 table_slice& table_slice::operator=(const table_slice& rhs) noexcept {
   chunk_ = rhs.chunk_;
   offset_ = rhs.offset_;
+  view_begin_ = rhs.view_begin_;
+  view_end_ = rhs.view_end_;
   state_ = rhs.state_;
   return *this;
 }
@@ -213,6 +296,8 @@ table_slice& table_slice::operator=(const table_slice& rhs) noexcept {
 table_slice::table_slice(table_slice&& other) noexcept
   : chunk_{std::exchange(other.chunk_, {})},
     offset_{std::exchange(other.offset_, invalid_id)},
+    view_begin_{std::exchange(other.view_begin_, 0)},
+    view_end_{std::exchange(other.view_end_, 0)},
     state_{std::exchange(other.state_, {})} {
   // nop
 }
@@ -220,6 +305,8 @@ table_slice::table_slice(table_slice&& other) noexcept
 table_slice& table_slice::operator=(table_slice&& rhs) noexcept {
   chunk_ = std::exchange(rhs.chunk_, {});
   offset_ = std::exchange(rhs.offset_, invalid_id);
+  view_begin_ = std::exchange(rhs.view_begin_, 0);
+  view_end_ = std::exchange(rhs.view_end_, 0);
   state_ = std::exchange(rhs.state_, {});
   return *this;
 }
@@ -232,8 +319,9 @@ table_slice::~table_slice() noexcept {
 
 // TODO: Dispatch to optimized implementations if the encodings are the same.
 bool operator==(const table_slice& lhs, const table_slice& rhs) noexcept {
-  // Check whether the slices point to the same chunk of data.
-  if (lhs.chunk_ == rhs.chunk_)
+  // Check whether the slices point to the same rows of the same chunk.
+  if (lhs.chunk_ == rhs.chunk_ && lhs.view_begin_ == rhs.view_begin_
+      && lhs.view_end_ == rhs.view_end_)
     return true;
   // Check whether the slices have different sizes or layouts.
   if (lhs.rows() != rhs.rows() || lhs.columns() != rhs.columns()
@@ -278,7 +366,37 @@ const record_type& table_slice::layout() const noexcept {
   return *visit(f, as_flatbuffer(chunk_));
 }
 
+bool table_slice::embeds_layout() const noexcept {
+  auto f = detail::overload{
+    []() noexcept { return false; },
+    [](const auto& encoded) noexcept {
+      return encoded.layout() != nullptr && encoded.layout()->size() > 0;
+    },
+  };
+  return visit(f, as_flatbuffer(chunk_));
+}
+
+layout_fingerprint table_slice::layout_id() const noexcept {
+  auto f = detail::overload{
+    []() noexcept { return layout_fingerprint{}; },
+    [&](const auto& encoded) noexcept {
+      return state(encoded, state_)->layout_id();
+    },
+  };
+  return visit(f, as_flatbuffer(chunk_));
+}
+
 table_slice::size_type table_slice::rows() const noexcept {
+  if (is_view())
+    return view_end_ - view_begin_;
+  return parent_rows();
+}
+
+bool table_slice::is_view() const noexcept {
+  return view_end_ != 0;
+}
+
+table_slice::size_type table_slice::parent_rows() const noexcept {
   auto f = detail::overload{
     []() noexcept { return size_type{}; },
     [&](const auto& encoded) noexcept {
@@ -315,6 +433,14 @@ int table_slice::instances() noexcept {
 void table_slice::append_column_to_index(table_slice::size_type column,
                                          value_index& index) const {
   VAST_ASSERT(offset() != invalid_id);
+  if (is_view()) {
+    // The encoding-specific implementations append all rows of the underlying
+    // table, so we fall back to appending the rows of the view one by one.
+    const auto& t = layout().at(*layout().offset_from_index(column))->type;
+    for (size_type row = 0; row < rows(); ++row)
+      index.append(at(row, column, t), offset() + row);
+    return;
+  }
   auto f = detail::overload{
     []() noexcept {
       die("cannot append column of invalid table slice to index");
@@ -336,7 +462,7 @@ data_view table_slice::at(table_slice::size_type row,
       die("cannot access data of invalid table slice");
     },
     [&](const auto& encoded) noexcept {
-      return state(encoded, state_)->at(row, column);
+      return state(encoded, state_)->at(view_begin_ + row, column);
     },
   };
   return visit(f, as_flatbuffer(chunk_));
@@ -351,7 +477,7 @@ data_view table_slice::at(table_slice::size_type row,
       die("cannot access data of invalid table slice");
     },
     [&](const auto& encoded) noexcept {
-      return state(encoded, state_)->at(row, column, t);
+      return state(encoded, state_)->at(view_begin_ + row, column, t);
     },
   };
   return visit(f, as_flatbuffer(chunk_));
@@ -377,6 +503,9 @@ std::shared_ptr<arrow::RecordBatch> as_record_batch(const table_slice& slice) {
         // returned record batch is valid, and capturing the batch ensures that
         // guarantee for the underlying Arrow Buffer object.
         auto batch = state(encoded, slice.state_)->record_batch();
+        // Views map to a zero-copy slice of the record batch.
+        if (slice.is_view())
+          batch = batch->Slice(slice.view_begin_, slice.rows());
         const auto data = batch.get();
         auto result = std::shared_ptr<arrow::RecordBatch>{
           data,
@@ -418,13 +547,24 @@ rebuild(table_slice slice, enum table_slice_encoding encoding) noexcept {
                                                           slice.layout());
         if (!builder)
           return table_slice{};
+        builder->reserve(slice.rows());
         auto flat_layout = flatten(slice.layout());
-        for (table_slice::size_type row = 0; row < slice.rows(); ++row)
-          for (table_slice::size_type column = 0;
-               column < flat_layout.fields.size(); ++column)
-            if (!builder->add(
-                  slice.at(row, column, flat_layout.fields[column].type)))
-              return {};
+        // Prefer appending whole columns, which the Arrow builder copies
+        // without going through data views. Null values and types without a
+        // column view require adding the rows one by one.
+        std::vector<std::shared_ptr<void>> buffers;
+        if (auto columns = extract_columns(slice, flat_layout, buffers);
+            !columns.empty()) {
+          if (!builder->append_columns(columns))
+            return {};
+        } else {
+          for (table_slice::size_type row = 0; row < slice.rows(); ++row)
+            for (table_slice::size_type column = 0;
+                 column < flat_layout.fields.size(); ++column)
+              if (!builder->add(
+                    slice.at(row, column, flat_layout.fields[column].type)))
+                return {};
+        }
         auto result = builder->finish();
         result.offset(slice.offset());
         return result;
@@ -448,74 +588,118 @@ void select(std::vector<table_slice>& result, const table_slice& slice,
     result.emplace_back(slice);
     return;
   }
-  // Get the desired encoding, and the already serialized layout.
-  auto f = detail::overload{
-    []() noexcept -> std::pair<table_slice_encoding, span<const std::byte>> {
-      die("cannot select from an invalid table slice");
-    },
-    [&](const auto& encoded) noexcept {
-      return std::pair{
-        builder_id(state(encoded, slice.state_)->encoding),
-        span{reinterpret_cast<const std::byte*>(encoded.layout()->data()),
-             encoded.layout()->size()}};
-    },
+  // Create a view for every run of consecutive IDs. The views share the chunk
+  // of the slice, so no data is copied.
+  auto push_view = [&](id first, id last) {
+    auto view = slice;
+    view.view_begin_ = slice.view_begin_ + (first - slice.offset());
+    view.view_end_ = view.view_begin_ + (last - first);
+    view.offset_ = first;
+    result.emplace_back(std::move(view));
   };
-  table_slice_encoding implementation_id;
-  span<const std::byte> serialized_layout = {};
-  std::tie(implementation_id, serialized_layout)
-    = visit(f, as_flatbuffer(slice.chunk_));
-  // Start slicing and dicing.
-  auto builder
-    = factory<table_slice_builder>::make(implementation_id, slice.layout());
+  auto first_id = invalid_id;
+  auto last_id = invalid_id;
+  for (auto id : select(intersection)) {
+    VAST_ASSERT(id >= slice.offset());
+    VAST_ASSERT(id - slice.offset() < slice.rows());
+    // Finish last view when hitting non-consecutive IDs.
+    if (first_id == invalid_id) {
+      first_id = id;
+    } else if (last_id + 1 != id) {
+      push_view(first_id, last_id + 1);
+      first_id = id;
+    }
+    last_id = id;
+  }
+  push_view(first_id, last_id + 1);
+}
+
+std::vector<table_slice>
+select(const table_slice& slice, const ids& selection) {
+  std::vector<table_slice> result;
+  select(result, slice, selection);
+  return result;
+}
+
+table_slice materialize(const table_slice& slice) {
+  if (!slice.is_view())
+    return slice;
+  auto builder = factory<table_slice_builder>::make(
+    builder_id(slice.encoding()), slice.layout());
   if (builder == nullptr) {
     VAST_ERROR("{} failed to get a table slice builder for {}", __func__,
-               implementation_id);
-    return;
+               slice.encoding());
+    return {};
   }
-  id last_offset = slice.offset();
-  auto push_slice = [&] {
-    if (builder->rows() == 0)
-      return;
-    auto new_slice = builder->finish(serialized_layout);
-    if (new_slice.encoding() == table_slice_encoding::none) {
-      VAST_WARN("{} got an empty slice", __func__);
-      return;
-    }
-    new_slice.offset(last_offset);
-    result.emplace_back(std::move(new_slice));
-  };
+  builder->reserve(slice.rows());
   auto flat_layout = flatten(slice.layout());
-  auto last_id = last_offset - 1;
-  for (auto id : select(intersection)) {
-    // Finish last slice when hitting non-consecutive IDs.
-    if (last_id + 1 != id) {
-      push_slice();
-      last_offset = id;
-      last_id = id;
-    } else {
-      ++last_id;
-    }
-    VAST_ASSERT(id >= slice.offset());
-    auto row = id - slice.offset();
-    VAST_ASSERT(row < slice.rows());
+  for (table_slice::size_type row = 0; row < slice.rows(); ++row) {
     for (size_t column = 0; column < flat_layout.fields.size(); ++column) {
       auto cell_value = slice.at(row, column, flat_layout.fields[column].type);
       if (!builder->add(cell_value)) {
         VAST_ERROR("{} failed to add data at column {} in row {} to the "
                    "builder: {}",
                    __func__, column, row, cell_value);
-        return;
+        return {};
       }
     }
   }
-  push_slice();
+  auto result = builder->finish();
+  result.offset(slice.offset());
+  return result;
 }
 
-std::vector<table_slice>
-select(const table_slice& slice, const ids& selection) {
-  std::vector<table_slice> result;
-  select(result, slice, selection);
-  return result;
+flatbuffers::Offset<flatbuffers::Vector<uint8_t>>
+pack_without_layout(flatbuffers::FlatBufferBuilder& builder,
+                    const table_slice& slice) {
+  VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
+  // Copying the encoded data of a view would copy all rows of its parent.
+  if (slice.is_view())
+    return pack_without_layout(builder, materialize(slice));
+  if (!slice.embeds_layout())
+    return fbs::pack_bytes(builder, slice);
+  // We build the nested buffer in place rather than in a separate builder, so
+  // that the encoded data gets copied only once. The tables of the nested
+  // buffer must not share vtables with the rest of the enclosing buffer.
+  builder.DedupVtables(false);
+  auto nested_begin = builder.GetSize();
+  auto f = detail::overload{
+    []() noexcept -> flatbuffers::Offset<fbs::TableSlice> {
+      die("cannot strip the layout of an invalid table slice");
+    },
+    [&](const fbs::table_slice::msgpack::v0& encoded) noexcept {
+      auto offset_table_buffer = builder.CreateVector(
+        encoded.offset_table()->data(), encoded.offset_table()->size());
+      auto data_buffer = builder.CreateVector(encoded.data()->data(),
+                                              encoded.data()->size());
+      auto msgpack_table_slice_buffer = fbs::table_slice::msgpack::Createv0(
+        builder, 0, offset_table_buffer, data_buffer, slice.layout_id());
+      return fbs::CreateTableSlice(builder,
+                                   fbs::table_slice::TableSlice::msgpack_v0,
+                                   msgpack_table_slice_buffer.Union());
+    },
+    [&](const fbs::table_slice::arrow::v0& encoded) noexcept {
+      auto schema_buffer = builder.CreateVector(encoded.schema()->data(),
+                                                encoded.schema()->size());
+      auto record_batch_buffer = builder.CreateVector(
+        encoded.record_batch()->data(), encoded.record_batch()->size());
+      auto arrow_table_slice_buffer = fbs::table_slice::arrow::Createv0(
+        builder, 0, schema_buffer, record_batch_buffer, slice.layout_id());
+      return fbs::CreateTableSlice(builder,
+                                   fbs::table_slice::TableSlice::arrow_v0,
+                                   arrow_table_slice_buffer.Union());
+    },
+  };
+  auto root = visit(f, as_flatbuffer(slice.chunk_));
+  // Finish the nested buffer the same way FlatBufferBuilder::Finish does, and
+  // turn it into a byte vector by prepending its size. The alignment of the
+  // root offset guarantees that the size needs no padding.
+  builder.PreAlign(sizeof(flatbuffers::uoffset_t),
+                   sizeof(flatbuffers::largest_scalar_t));
+  builder.PushElement(builder.ReferTo(root.o));
+  auto nested_size = builder.GetSize() - nested_begin;
+  return builder.PushElement(
+    detail::narrow_cast<flatbuffers::uoffset_t>(nested_size));
 }
 
 table_slice truncate(const table_slice& slice, size_t num_rows) {
@@ -548,6 +732,68 @@ split(const table_slice& slice, size_t partition_point) {
   return {std::move(xs.front()), std::move(xs.back())};
 }
 
+table_slice project(const table_slice& slice,
+                    const std::vector<size_t>& columns) {
+  VAST_ASSERT(slice.encoding() != table_slice_encoding::none);
+  VAST_ASSERT(!columns.empty());
+  auto flat_layout = flatten(slice.layout());
+  auto fields = std::vector<record_field>{};
+  fields.reserve(columns.size());
+  for (auto column : columns) {
+    VAST_ASSERT(column < flat_layout.fields.size());
+    fields.push_back(flat_layout.fields[column]);
+  }
+  auto layout = record_type{std::move(fields)};
+  layout.name(flat_layout.name());
+#if VAST_ENABLE_ARROW
+  if (slice.encoding() == table_slice_encoding::arrow) {
+    // Arrow stores every column separately, so we can pick the requested
+    // columns from the record batch without touching the values.
+    auto batch = as_record_batch(slice);
+    auto schema_fields = std::vector<std::shared_ptr<arrow::Field>>{};
+    auto arrays = std::vector<std::shared_ptr<arrow::Array>>{};
+    schema_fields.reserve(columns.size());
+    arrays.reserve(columns.size());
+    for (auto column : columns) {
+      auto index = detail::narrow_cast<int>(column);
+      schema_fields.push_back(batch->schema()->field(index));
+      arrays.push_back(batch->column(index));
+    }
+    auto projected
+      = arrow::RecordBatch::Make(arrow::schema(std::move(schema_fields)),
+                                 batch->num_rows(), std::move(arrays));
+    auto result = arrow_table_slice_builder::create(projected, layout);
+    result.offset(slice.offset());
+    return result;
+  }
+#endif // VAST_ENABLE_ARROW
+  auto builder = factory<table_slice_builder>::make(
+    builder_id(slice.encoding()), std::move(layout));
+  if (builder == nullptr) {
+    VAST_ERROR("{} failed to get a table slice builder for {}", __func__,
+               slice.encoding());
+    return {};
+  }
+  builder->reserve(slice.rows());
+  // Only the requested columns get decoded.
+  const auto& projected_layout = builder->layout();
+  for (table_slice::size_type row = 0; row < slice.rows(); ++row) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      auto cell_value
+        = slice.at(row, columns[i], projected_layout.fields[i].type);
+      if (!builder->add(cell_value)) {
+        VAST_ERROR("{} failed to add data at column {} in row {} to the "
+                   "builder: {}",
+                   __func__, columns[i], row, cell_value);
+        return {};
+      }
+    }
+  }
+  auto result = builder->finish();
+  result.offset(slice.offset());
+  return result;
+}
+
 uint64_t rows(const std::vector<table_slice>& slices) {
   auto result = uint64_t{0};
   for (auto& slice : slices)
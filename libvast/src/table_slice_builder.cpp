@@ -13,10 +13,15 @@
 
 #include "vast/table_slice_builder.hpp"
 
+#include "vast/as_bytes.hpp"
 #include "vast/data.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/die.hpp"
+#include "vast/error.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/type.hpp"
 
+#include <caf/binary_serializer.hpp>
 #include <caf/make_counted.hpp>
 
 #include <algorithm>
@@ -27,7 +32,10 @@ namespace vast {
 
 table_slice_builder::table_slice_builder(record_type layout) noexcept
   : layout_(std::move(layout)) {
-  // nop
+  caf::binary_serializer sink{nullptr, serialized_layout_};
+  if (auto err = sink(layout_))
+    die("failed to serialize layout: " + render(err));
+  layout_id_ = fingerprint(as_bytes(serialized_layout_));
 }
 
 table_slice_builder::~table_slice_builder() noexcept {
@@ -50,6 +58,17 @@ bool table_slice_builder::recursive_add(const data& x, const type& t) {
   return caf::visit(f, x, t);
 }
 
+bool table_slice_builder::append_columns(span<const column_view> columns) {
+  if (columns.empty() || columns.size() != this->columns())
+    return false;
+  auto size = [](const auto& values) { return values.size(); };
+  for (size_t i = 0; i < columns.size(); ++i)
+    if (!is_compatible(i, columns[i])
+        || caf::visit(size, columns[i]) != caf::visit(size, columns[0]))
+      return false;
+  return append_columns_impl(columns);
+}
+
 size_t table_slice_builder::columns() const noexcept {
   return layout_.num_leaves();
 }
@@ -58,10 +77,49 @@ const record_type& table_slice_builder::layout() const noexcept {
   return layout_;
 }
 
+span<const std::byte> table_slice_builder::serialized_layout() const noexcept {
+  return as_bytes(serialized_layout_);
+}
+
+layout_fingerprint table_slice_builder::layout_id() const noexcept {
+  return layout_id_;
+}
+
 void table_slice_builder::reserve([[maybe_unused]] size_t num_rows) {
   // nop
 }
 
+// -- implementation utilities -------------------------------------------------
+
+bool table_slice_builder::append_columns_impl(
+  span<const column_view> columns) {
+  auto rows
+    = caf::visit([](const auto& values) { return values.size(); }, columns[0]);
+  for (size_t row = 0; row < rows; ++row)
+    for (const auto& column : columns)
+      if (!caf::visit(
+            [&](const auto& values) { return add_impl(make_view(values[row])); },
+            column))
+        return false;
+  return true;
+}
+
+bool table_slice_builder::is_compatible(size_t column,
+                                        const column_view& xs) const {
+  if (column >= columns())
+    return false;
+  auto offset = layout_.offset_from_index(column);
+  VAST_ASSERT(offset);
+  auto field = layout_.at(*offset);
+  VAST_ASSERT(field);
+  return caf::visit(
+    [&](const auto& values) {
+      using value_type = typename std::decay_t<decltype(values)>::value_type;
+      return vast::type_check(field->type, data_view{make_view(value_type{})});
+    },
+    xs);
+}
+
 // -- intrusive_ptr facade -----------------------------------------------------
 
 void intrusive_ptr_add_ref(const table_slice_builder* ptr) {
@@ -25,6 +25,7 @@
 #include "vast/index/list_index.hpp"
 #include "vast/index/string_index.hpp"
 #include "vast/index/subnet_index.hpp"
+#include "vast/index/time_index.hpp"
 #include "vast/logger.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index.hpp"
@@ -144,6 +145,16 @@ auto add_arithmetic_index_factory() {
   return add_value_index_factory<T, arithmetic_index<concrete_data>>();
 }
 
+value_index_ptr make_time_index(type x, caf::settings opts) {
+  // Indexes that were persisted before the introduction of the time index do
+  // not carry the option, so we must keep constructing range-coded bitmap
+  // indexes for them.
+  auto kind = caf::get_if<caf::config_value::string>(&opts, "time-index");
+  if (kind && *kind == "delta")
+    return std::make_unique<time_index>(std::move(x), std::move(opts));
+  return make<arithmetic_index<time>>(std::move(x), std::move(opts));
+}
+
 } // namespace <anonymous>
 
 void factory_traits<value_index>::initialize() {
@@ -152,7 +163,7 @@ void factory_traits<value_index>::initialize() {
   add_arithmetic_index_factory<count_type>();
   add_arithmetic_index_factory<real_type>();
   add_arithmetic_index_factory<duration_type>();
-  add_arithmetic_index_factory<time_type>();
+  factory<value_index>::add(time_type{}, make_time_index);
   add_value_index_factory<enumeration_type, enumeration_index>();
   add_value_index_factory<address_type, address_index>();
   add_value_index_factory<subnet_type, subnet_index>();
@@ -0,0 +1,200 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/zone_map.hpp"
+
+#include "vast/data.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/enumeration_synopsis.hpp"
+#include "vast/error.hpp"
+#include "vast/expression.hpp"
+#include "vast/fbs/utils.hpp"
+#include "vast/synopsis_factory.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/settings.hpp>
+
+#include <vector>
+
+namespace vast {
+
+namespace {
+
+/// Checks whether a column gets a synopsis in a zone map. Address and string
+/// columns would need a Bloom filter per slice, which costs more than it
+/// saves.
+bool has_zone_map_synopsis(const type& t) {
+  return !has_skip_attribute(t) && !caf::holds_alternative<address_type>(t)
+         && !caf::holds_alternative<string_type>(t);
+}
+
+} // namespace
+
+caf::expected<flatbuffers::Offset<fbs::zone_map::v0>>
+pack(flatbuffers::FlatBufferBuilder& builder, const zone_map& x) {
+  std::vector<flatbuffers::Offset<fbs::synopsis::v0>> synopses;
+  std::vector<bool> has_nulls;
+  synopses.reserve(x.field_synopses.size());
+  has_nulls.reserve(x.field_synopses.size());
+  for (auto& [fqf, synopsis] : x.field_synopses) {
+    auto maybe_synopsis = pack(builder, synopsis, fqf);
+    if (!maybe_synopsis)
+      return maybe_synopsis.error();
+    synopses.push_back(*maybe_synopsis);
+    has_nulls.push_back(x.fields_with_nulls.count(fqf) > 0);
+  }
+  auto synopses_vector = builder.CreateVector(synopses);
+  auto has_nulls_vector = builder.CreateVector(has_nulls);
+  fbs::zone_map::v0Builder zm_builder(builder);
+  zm_builder.add_offset(x.offset);
+  zm_builder.add_events(x.events);
+  zm_builder.add_synopses(synopses_vector);
+  zm_builder.add_has_nulls(has_nulls_vector);
+  return zm_builder.Finish();
+}
+
+caf::error unpack(const fbs::zone_map::v0& x, zone_map& y) {
+  if (!x.synopses())
+    return caf::make_error(ec::format_error, "missing synopses");
+  auto has_nulls = x.has_nulls();
+  if (has_nulls && has_nulls->size() != x.synopses()->size())
+    return caf::make_error(ec::format_error, "null flags and synopses differ "
+                                             "in size");
+  y.offset = x.offset();
+  y.events = x.events();
+  y.field_synopses.clear();
+  y.fields_with_nulls.clear();
+  for (flatbuffers::uoffset_t i = 0; i < x.synopses()->size(); ++i) {
+    auto synopsis = x.synopses()->Get(i);
+    if (!synopsis)
+      return caf::make_error(ec::format_error, "synopsis is null");
+    qualified_record_field qf;
+    if (auto error
+        = fbs::deserialize_bytes(synopsis->qualified_record_field(), qf))
+      return error;
+    synopsis_ptr ptr;
+    if (auto error = unpack(*synopsis, ptr))
+      return error;
+    // Zone maps written before we tracked null values may have them in any
+    // field.
+    if (!has_nulls || has_nulls->Get(i))
+      y.fields_with_nulls.insert(qf);
+    y.field_synopses[std::move(qf)] = std::move(ptr);
+  }
+  return caf::none;
+}
+
+zone_map make_zone_map(const table_slice& slice,
+                       const caf::settings& synopsis_options) {
+  auto result = zone_map{};
+  result.offset = slice.offset();
+  result.events = slice.rows();
+  auto& layout = slice.layout();
+  auto each = record_type::each(layout);
+  auto field_it = each.begin();
+  for (size_t col = 0; col < slice.columns(); ++col, ++field_it) {
+    auto& type = field_it->type();
+    auto key = qualified_record_field{layout.name(), *field_it};
+    auto& syn = result.field_synopses[key];
+    if (!has_zone_map_synopsis(type))
+      continue;
+    syn = factory<synopsis>::make(type, synopsis_options);
+    if (!syn)
+      continue;
+    auto has_nulls = false;
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      auto view = slice.at(row, col, type);
+      if (caf::holds_alternative<caf::none_t>(view))
+        has_nulls = true;
+      else
+        syn->add(std::move(view));
+    }
+    if (has_nulls)
+      result.fields_with_nulls.insert(std::move(key));
+  }
+  return result;
+}
+
+bool may_match(const zone_map& zm, const expression& expr) {
+  auto f = detail::overload{
+    [&](const conjunction& x) {
+      for (auto& op : x)
+        if (!may_match(zm, op))
+          return false;
+      return true;
+    },
+    [&](const disjunction& x) {
+      for (auto& op : x)
+        if (may_match(zm, op))
+          return true;
+      return false;
+    },
+    [&](const negation&) {
+      // Synopses may return false positives, so we cannot negate them.
+      return true;
+    },
+    [&](const predicate& x) {
+      // Mirrors the predicate lookup of the META INDEX for a single partition
+      // synopsis, except that columns without a synopsis always match.
+      auto search = [&](auto match) {
+        auto& rhs = caf::get<data>(x.rhs);
+        for (auto& [field, syn] : zm.field_synopses) {
+          if (!match(field))
+            continue;
+          if (!syn)
+            return true;
+          if (is_negated(x.op) && zm.fields_with_nulls.count(field) > 0)
+            return true;
+          auto translated = translate_enumeration(field.type, rhs);
+          auto result
+            = syn->lookup(x.op, make_view(translated ? *translated : rhs));
+          if (!result || *result)
+            return true;
+        }
+        return false;
+      };
+      auto g = detail::overload{
+        [&](const meta_extractor& lhs, const data& d) {
+          if (lhs.kind != meta_extractor::type)
+            return true;
+          for (auto& [field, _] : zm.field_synopses)
+            if (evaluate(data{field.layout_name}, x.op, d))
+              return true;
+          return false;
+        },
+        [&](const field_extractor& lhs, const data&) {
+          return search([&](const qualified_record_field& field) {
+            return detail::ends_with(field.fqn(), lhs.field);
+          });
+        },
+        [&](const type_extractor& lhs, const data&) {
+          if (caf::holds_alternative<none_type>(lhs.type))
+            return search([&](const qualified_record_field& field) {
+              return field.type.name() == lhs.type.name();
+            });
+          return search([&](const qualified_record_field& field) {
+            return field.type == lhs.type && field.type.name().empty();
+          });
+        },
+        [&](const auto&, const auto&) { return true; },
+      };
+      return caf::visit(g, x.lhs, x.rhs);
+    },
+    [&](caf::none_t) { return true; },
+  };
+  return caf::visit(f, expr);
+}
+
+} // namespace vast
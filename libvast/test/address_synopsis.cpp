@@ -24,6 +24,8 @@
 #include "vast/concept/hashable/xxhash.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/address.hpp"
+#include "vast/membership_set.hpp"
+#include "vast/qualified_record_field.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/synopsis_factory.hpp"
@@ -114,4 +116,56 @@ TEST(updated params after shrinking) {
   CHECK(!r2);
 }
 
+TEST(blocked bloom filter by default) {
+  opts["max-partition-size"] = 1_Mi;
+  auto ptr = factory<synopsis>::make(address_type{}, opts);
+  REQUIRE_NOT_EQUAL(ptr, nullptr);
+  CHECK(has_blocked_parameters(ptr->type()));
+  ptr->add(to_addr_view("192.168.0.1"));
+  MESSAGE("flatbuffer roundtrip");
+  flatbuffers::FlatBufferBuilder builder;
+  auto field = qualified_record_field{"zeek.conn", {"id.orig_h", address_type{}}};
+  auto offset = unbox(pack(builder, ptr, field));
+  builder.Finish(offset);
+  auto fb = flatbuffers::GetRoot<fbs::synopsis::v0>(builder.GetBufferPointer());
+  REQUIRE_NOT_EQUAL(fb->bloom_filter_synopsis(), nullptr);
+  synopsis_ptr unpacked;
+  REQUIRE_EQUAL(unpack(*fb, unpacked), caf::none);
+  REQUIRE_NOT_EQUAL(unpacked, nullptr);
+  CHECK_EQUAL(*unpacked, *ptr);
+  MESSAGE("legacy Bloom filter parameters");
+  auto t = address_type{}.attributes({{"synopsis", "bloomfilter(1000,0.1)"}});
+  auto legacy = factory<synopsis>::make(t, opts);
+  REQUIRE_NOT_EQUAL(legacy, nullptr);
+  CHECK(!has_blocked_parameters(legacy->type()));
+  CHECK_ROUNDTRIP_DEREF(std::move(legacy));
+}
+
+TEST(bulk membership) {
+  opts["max-partition-size"] = 1_Mi;
+  auto plain = factory<synopsis>::make(address_type{}, opts);
+  opts["buffer-input-data"] = true;
+  auto buffered = factory<synopsis>::make(address_type{}, opts);
+  REQUIRE_NOT_EQUAL(plain, nullptr);
+  REQUIRE_NOT_EQUAL(buffered, nullptr);
+  for (auto& ptr : {plain.get(), buffered.get()}) {
+    ptr->add(to_addr_view("192.168.0.1"));
+    ptr->add(to_addr_view("10.0.0.1"));
+  }
+  auto hit = list{unbox(to<address>("172.16.0.1")),
+                  unbox(to<address>("10.0.0.1")),
+                  unbox(to<address>("172.16.0.1"))};
+  auto miss = list{unbox(to<address>("172.16.0.1")),
+                   unbox(to<address>("255.255.255.255"))};
+  auto hits = membership_set{make_view(hit)};
+  auto misses = membership_set{make_view(miss)};
+  CHECK_EQUAL(hits.size(), 2u);
+  for (auto& ptr : {plain.get(), buffered.get()}) {
+    CHECK(unbox(ptr->lookup_any(hits)));
+    CHECK(!unbox(ptr->lookup_any(misses)));
+    CHECK(unbox(ptr->lookup(relational_operator::in, make_view(hit))));
+    CHECK(!unbox(ptr->lookup(relational_operator::in, make_view(miss))));
+  }
+}
+
 FIXTURE_SCOPE_END()
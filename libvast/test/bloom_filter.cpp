@@ -17,6 +17,7 @@
 
 #include "vast/test/test.hpp"
 
+#include "vast/blocked_bloom_filter.hpp"
 #include "vast/bloom_filter_parameters.hpp"
 #include "vast/concept/hashable/hash_append.hpp"
 #include "vast/concept/hashable/xxhash.hpp"
@@ -215,3 +216,33 @@ TEST(bloom filter - simple hasher and partitioning) {
   REQUIRE_EQUAL(err, caf::none);
   CHECK(x == y);
 }
+
+TEST(blocked bloom filter) {
+  bloom_filter_parameters xs;
+  xs.n = 10_k;
+  xs.p = 0.01;
+  auto x = unbox(make_blocked_bloom_filter<xxhash64>(xs));
+  CHECK_EQUAL(x.size() % blocked_bloom_filter<xxhash64>::bits_per_block, 0u);
+  for (integer i = 0; i < 10'000; ++i)
+    x.add(i);
+  for (integer i = 0; i < 10'000; ++i)
+    if (!x.lookup(i))
+      FAIL("false negative for " << i);
+  MESSAGE("false-positive rate");
+  size_t false_positives = 0;
+  for (integer i = 10'000; i < 110'000; ++i)
+    false_positives += x.lookup(i);
+  CHECK_LESS(false_positives, 2'000u);
+  MESSAGE("batched lookup");
+  auto hit
+    = std::vector<uint64_t>{x.digest(integer{-1}), x.digest(integer{42})};
+  auto miss = std::vector<uint64_t>{x.digest(integer{-1})};
+  CHECK(x.lookup_any_digest(hit));
+  CHECK_EQUAL(x.lookup_any_digest(miss), x.lookup(integer{-1}));
+  MESSAGE("persistence");
+  std::vector<char> buf;
+  REQUIRE_EQUAL(detail::serialize(buf, x), caf::none);
+  blocked_bloom_filter<xxhash64> y;
+  REQUIRE_EQUAL(detail::deserialize(buf, y), caf::none);
+  CHECK(x == y);
+}
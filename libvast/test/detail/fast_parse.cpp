@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE fast_parse
+
+#include "vast/test/test.hpp"
+
+#include "vast/detail/fast_parse.hpp"
+
+#include "vast/concept/parseable/core.hpp"
+#include "vast/concept/parseable/numeric.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
+
+#include <string_view>
+
+using namespace vast;
+using namespace vast::detail;
+using namespace std::string_view_literals;
+
+namespace {
+
+// Checks that a kernel either declines the input or agrees with the generic
+// parser, and returns whether the kernel handled the input.
+template <class T, class Kernel, class Parser>
+bool agrees(std::string_view str, Kernel kernel, const Parser& p) {
+  T fast;
+  T slow;
+  auto generic = p(str, slow);
+  if (!kernel(str, fast))
+    return false;
+  REQUIRE(generic);
+  CHECK_EQUAL(fast, slow);
+  return true;
+}
+
+} // namespace
+
+TEST(integral kernels) {
+  auto u64 = [](auto str, count& x) { return fast_parse_count(str, x); };
+  auto i64 = [](auto str, integer& x) { return fast_parse_integer(str, x); };
+  CHECK(agrees<count>("0"sv, u64, parsers::u64));
+  CHECK(agrees<count>("4711"sv, u64, parsers::u64));
+  CHECK(agrees<count>("1234567890123456789"sv, u64, parsers::u64));
+  CHECK(!agrees<count>(""sv, u64, parsers::u64));
+  CHECK(!agrees<count>("+42"sv, u64, parsers::u64));
+  CHECK(!agrees<count>("42x"sv, u64, parsers::u64));
+  CHECK(agrees<integer>("-42"sv, i64, parsers::i64));
+  CHECK(agrees<integer>("+42"sv, i64, parsers::i64));
+  CHECK(agrees<integer>("-0"sv, i64, parsers::i64));
+  CHECK(!agrees<integer>("-"sv, i64, parsers::i64));
+}
+
+TEST(real kernel) {
+  auto real = [](auto str, vast::real& x) { return fast_parse_real(str, x); };
+  auto real_opt_dot = [](auto str, vast::real& x) {
+    return fast_parse_real(str, x, false);
+  };
+  CHECK(agrees<vast::real>("0.1"sv, real, parsers::real));
+  CHECK(agrees<vast::real>("-1.25"sv, real, parsers::real));
+  CHECK(agrees<vast::real>("1258531221.486539"sv, real, parsers::real));
+  CHECK(agrees<vast::real>(".5"sv, real, parsers::real));
+  CHECK(agrees<vast::real>("5."sv, real, parsers::real));
+  CHECK(!agrees<vast::real>("5"sv, real, parsers::real));
+  CHECK(!agrees<vast::real>("."sv, real, parsers::real));
+  CHECK(!agrees<vast::real>("1.2.3"sv, real, parsers::real));
+  CHECK(agrees<vast::real>("5"sv, real_opt_dot, parsers::real_opt_dot));
+  CHECK(agrees<vast::real>("-3.000001"sv, real_opt_dot,
+                           parsers::real_opt_dot));
+}
+
+TEST(time kernels) {
+  auto ymdhms = [](auto str, time& x) { return fast_parse_ymdhms(str, x); };
+  CHECK(agrees<time>("2011-08-12T14:59:11.994970Z"sv, ymdhms,
+                     parsers::ymdhms));
+  CHECK(agrees<time>("2011-08-12 14:59:11"sv, ymdhms, parsers::ymdhms));
+  CHECK(agrees<time>("2011-08-12+14:59:11.5"sv, ymdhms, parsers::ymdhms));
+  CHECK(!agrees<time>("2011-08-12"sv, ymdhms, parsers::ymdhms));
+  CHECK(!agrees<time>("2011-08-12T14:59:11+01:00"sv, ymdhms,
+                      parsers::ymdhms));
+  CHECK(!agrees<time>("2011-13-12T14:59:11"sv, ymdhms, parsers::ymdhms));
+  duration d;
+  REQUIRE(fast_parse_seconds("1258531221.486539", d));
+  auto x = std::chrono::duration_cast<duration>(
+    double_seconds{1258531221.486539});
+  CHECK_EQUAL(d, x);
+}
+
+TEST(address kernel) {
+  auto addr = [](auto str, address& x) { return fast_parse_address(str, x); };
+  CHECK(agrees<address>("192.168.0.1"sv, addr, parsers::addr));
+  CHECK(agrees<address>("255.255.255.255"sv, addr, parsers::addr));
+  CHECK(agrees<address>("fe80::219:e3ff:fee7:5d16"sv, addr, parsers::addr));
+  CHECK(agrees<address>("::1"sv, addr, parsers::addr));
+  CHECK(!agrees<address>("256.0.0.1"sv, addr, parsers::addr));
+  CHECK(!agrees<address>("1.2.3"sv, addr, parsers::addr));
+  CHECK(!agrees<address>("::ffff:1.2.3.4"sv, addr, parsers::addr));
+}
@@ -57,9 +57,9 @@ TEST(uuid roundtrip) {
 
 TEST(index roundtrip) {
   vast::system::index_state state(/*self = */ nullptr);
-  // The active partition is not supposed to appear in the
+  // Active partitions are not supposed to appear in the
   // created flatbuffer
-  state.active_partition.id = vast::uuid::random();
+  state.active_partitions.emplace_back().id = vast::uuid::random();
   // Both unpersisted and persisted partitions should show up in the created
   // flatbuffer.
   state.unpersisted[vast::uuid::random()] = nullptr;
@@ -222,8 +222,9 @@ TEST(full partition roundtrip) {
   self->send_exit(partition, caf::exit_reason::user_shutdown);
   // Spawn a read-only partition from this chunk and try to query the data we
   // added. We make two queries, one "#type"-query and one "normal" query
+  auto cache = std::shared_ptr<vast::system::query_result_cache>{};
   auto readonly_partition = sys.spawn(vast::system::passive_partition,
-                                      partition_uuid, fs, persist_path);
+                                      partition_uuid, fs, persist_path, cache);
   REQUIRE(readonly_partition);
   run();
   // A minimal `partition_client_actor`that stores the results in a local
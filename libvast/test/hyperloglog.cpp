@@ -0,0 +1,115 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE hyperloglog
+
+#include "vast/hyperloglog.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/concept/hashable/uhash.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+using namespace vast;
+
+namespace {
+
+uint64_t digest(uint64_t x) {
+  return uhash<xxhash64>{}(x);
+}
+
+// Checks whether the estimate lies within three standard errors of the true
+// cardinality.
+bool within_bounds(const hyperloglog& x, uint64_t n) {
+  auto error = 1.04 / std::sqrt(std::ldexp(1.0, x.precision()));
+  auto delta = std::fabs(static_cast<double>(x.estimate()) - n);
+  return delta <= 3 * error * n;
+}
+
+} // namespace
+
+TEST(empty) {
+  hyperloglog x{10};
+  CHECK_EQUAL(x.precision(), 10u);
+  CHECK_EQUAL(x.estimate(), 0u);
+}
+
+TEST(estimate) {
+  hyperloglog x{10};
+  for (uint64_t i = 0; i < 10'000; ++i)
+    x.add(digest(i));
+  CHECK(within_bounds(x, 10'000));
+  MESSAGE("duplicates do not change the sketch");
+  auto y = x;
+  for (uint64_t i = 0; i < 10'000; ++i)
+    y.add(digest(i));
+  CHECK_EQUAL(x, y);
+  MESSAGE("small cardinalities use linear counting");
+  hyperloglog z{10};
+  for (uint64_t i = 0; i < 42; ++i)
+    z.add(digest(i));
+  CHECK(within_bounds(z, 42));
+}
+
+TEST(merge) {
+  hyperloglog x{12};
+  hyperloglog y{12};
+  hyperloglog xy{12};
+  for (uint64_t i = 0; i < 6'000; ++i) {
+    x.add(digest(i));
+    xy.add(digest(i));
+  }
+  for (uint64_t i = 4'000; i < 10'000; ++i) {
+    y.add(digest(i));
+    xy.add(digest(i));
+  }
+  x.merge(y);
+  CHECK_EQUAL(x, xy);
+  CHECK(within_bounds(x, 10'000));
+}
+
+TEST(fold) {
+  hyperloglog x{14};
+  hyperloglog y{8};
+  for (uint64_t i = 0; i < 5'000; ++i) {
+    x.add(digest(i));
+    y.add(digest(i));
+  }
+  MESSAGE("folding equals adding at the lower precision");
+  auto folded = x;
+  folded.fold(8);
+  CHECK_EQUAL(folded, y);
+  MESSAGE("merging sketches of different precision folds");
+  hyperloglog z{8};
+  z.merge(x);
+  CHECK_EQUAL(z, y);
+  x.merge(hyperloglog{8});
+  CHECK_EQUAL(x, y);
+}
+
+TEST(flatbuffer roundtrip) {
+  hyperloglog x{6};
+  for (uint64_t i = 0; i < 1'000; ++i)
+    x.add(digest(i));
+  flatbuffers::FlatBufferBuilder builder;
+  auto offset = unbox(pack(builder, x));
+  builder.Finish(offset);
+  auto fb
+    = flatbuffers::GetRoot<fbs::hyperloglog::v0>(builder.GetBufferPointer());
+  hyperloglog y;
+  REQUIRE_EQUAL(unpack(*fb, y), caf::none);
+  CHECK_EQUAL(x, y);
+}
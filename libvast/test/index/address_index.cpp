@@ -105,6 +105,23 @@ TEST(address) {
               str);
 }
 
+TEST(address bulk membership) {
+  address_index idx{address_type{}};
+  auto addrs = std::vector<std::string>{"192.168.0.1", "10.0.0.1", "::1",
+                                        "192.168.0.2", "10.0.0.1", "fe80::1"};
+  for (auto& addr : addrs)
+    REQUIRE(idx.append(make_data_view(unbox(to<address>(addr)))));
+  auto xs = list{};
+  for (auto addr : {"10.0.0.1", "192.168.0.2", "192.168.1.2", "::1", "::2",
+                    "10.0.0.1"})
+    xs.push_back(unbox(to<address>(addr)));
+  auto in = unbox(idx.lookup(relational_operator::in, make_data_view(xs)));
+  CHECK_EQUAL(to_string(in), "011110");
+  auto not_in
+    = unbox(idx.lookup(relational_operator::not_in, make_data_view(xs)));
+  CHECK_EQUAL(to_string(not_in), "100001");
+}
+
 FIXTURE_SCOPE(value_index_tests, fixtures::events)
 
 // This test uncovered a regression that ocurred when computing the rank of a
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#define SUITE value_index
+
+#include "vast/index/time_index.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/detail/deserialize.hpp"
+#include "vast/detail/serialize.hpp"
+#include "vast/index/arithmetic_index.hpp"
+#include "vast/value_index_factory.hpp"
+
+#include <caf/test/dsl.hpp>
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    factory<value_index>::initialize();
+  }
+
+  static vast::time at(duration x) {
+    return vast::time{} + x;
+  }
+
+  std::string lookup(const value_index& idx, relational_operator op,
+                     duration x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(at(x)))));
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(time_index_tests, fixture)
+
+TEST(time index - sorted) {
+  time_index idx{time_type{}};
+  for (auto x : {1s, 2s, 2s, 3s, 5s, 8s})
+    REQUIRE(idx.append(make_data_view(at(x))));
+  CHECK_EQUAL(lookup(idx, relational_operator::equal, 2s), "011000");
+  CHECK_EQUAL(lookup(idx, relational_operator::not_equal, 2s), "100111");
+  CHECK_EQUAL(lookup(idx, relational_operator::less, 3s), "111000");
+  CHECK_EQUAL(lookup(idx, relational_operator::less_equal, 3s), "111100");
+  CHECK_EQUAL(lookup(idx, relational_operator::greater, 3s), "000011");
+  CHECK_EQUAL(lookup(idx, relational_operator::greater_equal, 3s), "000111");
+  CHECK_EQUAL(lookup(idx, relational_operator::equal, 4s), "000000");
+  CHECK_EQUAL(lookup(idx, relational_operator::less, 0s), "000000");
+  CHECK_EQUAL(lookup(idx, relational_operator::greater, 0s), "111111");
+}
+
+TEST(time index - unsorted with gaps) {
+  time_index idx{time_type{}};
+  REQUIRE(idx.append(make_data_view(at(3s))));
+  REQUIRE(idx.append(make_data_view(at(1s))));
+  REQUIRE(idx.append(make_data_view(caf::none)));
+  REQUIRE(idx.append(make_data_view(at(2s)), 5));
+  REQUIRE(idx.append(make_data_view(at(7s))));
+  CHECK_EQUAL(lookup(idx, relational_operator::equal, 1s), "0100000");
+  CHECK_EQUAL(lookup(idx, relational_operator::less, 3s), "0100010");
+  CHECK_EQUAL(lookup(idx, relational_operator::greater_equal, 3s), "1000001");
+  CHECK_EQUAL(lookup(idx, relational_operator::not_equal, 2s), "1110001");
+}
+
+TEST(time index - many blocks) {
+  time_index idx{time_type{}};
+  // A sorted stream spanning multiple blocks, followed by a late arrival.
+  auto n = time_index::block_size * 10 + 3;
+  for (size_t i = 0; i < n; ++i)
+    REQUIRE(idx.append(make_data_view(at(std::chrono::milliseconds(i)))));
+  auto expected = std::string(600, '0') + std::string(n - 600, '1');
+  CHECK_EQUAL(lookup(idx, relational_operator::greater_equal, 600ms), expected);
+  REQUIRE(idx.append(make_data_view(at(42ms))));
+  expected = std::string(100, '1') + std::string(n - 100, '0') + "1";
+  CHECK_EQUAL(lookup(idx, relational_operator::less, 100ms), expected);
+  expected = std::string(n + 1, '0');
+  expected[42] = '1';
+  expected[n] = '1';
+  CHECK_EQUAL(lookup(idx, relational_operator::equal, 42ms), expected);
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(detail::serialize(buf, idx), caf::none);
+  time_index idx2{time_type{}};
+  REQUIRE_EQUAL(detail::deserialize(buf, idx2), caf::none);
+  CHECK_EQUAL(lookup(idx2, relational_operator::equal, 42ms), expected);
+}
+
+TEST(time index - factory) {
+  auto opts = caf::settings{};
+  auto legacy = factory<value_index>::make(time_type{}, opts);
+  CHECK(dynamic_cast<arithmetic_index<vast::time>*>(legacy.get()) != nullptr);
+  opts["time-index"] = "delta";
+  auto idx = factory<value_index>::make(time_type{}, opts);
+  CHECK(dynamic_cast<time_index*>(idx.get()) != nullptr);
+}
+
+FIXTURE_SCOPE_END()
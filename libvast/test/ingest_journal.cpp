@@ -0,0 +1,112 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#define SUITE ingest_journal
+
+#include "vast/ingest_journal.hpp"
+
+#include "vast/test/fixtures/events.hpp"
+#include "vast/test/fixtures/filesystem.hpp"
+#include "vast/test/test.hpp"
+
+#include "vast/path.hpp"
+#include "vast/si_literals.hpp"
+#include "vast/table_slice.hpp"
+
+#include <fstream>
+
+using namespace vast;
+using namespace binary_byte_literals;
+
+namespace {
+
+struct fixture : fixtures::events, fixtures::filesystem {
+  fixture() {
+    journal_dir = directory / "journal";
+  }
+
+  ingest_journal_ptr open(size_t max_file_size = 1_MiB) {
+    return unbox(ingest_journal::make(journal_dir, max_file_size));
+  }
+
+  path journal_dir;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(ingest_journal_tests, fixture)
+
+TEST(append and replay) {
+  {
+    auto journal = open();
+    CHECK_EQUAL(unbox(journal->replay()).size(), 0u);
+    for (auto& slice : zeek_conn_log)
+      journal->append(slice);
+    CHECK_GREATER(journal->pending(), 0u);
+    CHECK_EQUAL(journal->commit(), caf::none);
+    CHECK_EQUAL(journal->pending(), 0u);
+    CHECK_EQUAL(journal->commits(), 1u);
+    CHECK_EQUAL(journal->files(), 1u);
+  }
+  auto journal = open();
+  auto slices = unbox(journal->replay());
+  REQUIRE_EQUAL(slices.size(), zeek_conn_log.size());
+  for (size_t i = 0; i < slices.size(); ++i) {
+    CHECK_EQUAL(slices[i], zeek_conn_log[i]);
+    CHECK_EQUAL(slices[i].offset(), zeek_conn_log[i].offset());
+  }
+}
+
+TEST(torn tail) {
+  {
+    auto journal = open();
+    for (auto& slice : zeek_conn_log)
+      journal->append(slice);
+    REQUIRE_EQUAL(journal->commit(), caf::none);
+  }
+  auto filename = journal_dir / (std::to_string(zeek_conn_log[0].offset())
+                                 + ".journal");
+  REQUIRE(exists(filename));
+  auto size = unbox(file_size(filename));
+  {
+    // Simulate a crash in the middle of writing a record.
+    std::ofstream out{filename.str(), std::ios::app | std::ios::binary};
+    out << "torn record";
+  }
+  auto journal = open();
+  auto slices = unbox(journal->replay());
+  CHECK_EQUAL(slices.size(), zeek_conn_log.size());
+  CHECK_EQUAL(unbox(file_size(filename)), size);
+  CHECK_EQUAL(journal->size(), size);
+}
+
+TEST(truncate) {
+  // A tiny maximum file size makes every commit start a new file.
+  auto journal = open(1);
+  for (auto& slice : zeek_conn_log) {
+    journal->append(slice);
+    REQUIRE_EQUAL(journal->commit(), caf::none);
+  }
+  REQUIRE_EQUAL(journal->files(), 3u);
+  auto end_of_first = zeek_conn_log[0].offset() + zeek_conn_log[0].rows();
+  CHECK_EQUAL(journal->truncate(end_of_first - 1), caf::none);
+  CHECK_EQUAL(journal->files(), 3u);
+  CHECK_EQUAL(journal->truncate(end_of_first), caf::none);
+  CHECK_EQUAL(journal->files(), 2u);
+  // The file that the journal currently appends to stays.
+  CHECK_EQUAL(journal->truncate(max_id), caf::none);
+  CHECK_EQUAL(journal->files(), 1u);
+}
+
+FIXTURE_SCOPE_END()
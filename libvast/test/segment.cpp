@@ -60,4 +60,29 @@ TEST(serialization) {
   CHECK_EQUAL(x.num_slices(), y->num_slices());
 }
 
+TEST(layout dictionary) {
+  segment_builder builder{1024};
+  size_t slice_bytes = 0;
+  for (auto& slice : zeek_conn_log) {
+    slice_bytes += as_bytes(slice).size();
+    REQUIRE(!builder.add(slice));
+  }
+  auto x = builder.finish();
+  MESSAGE("slices do not embed their layouts");
+  CHECK_LESS(x.chunk()->size(), slice_bytes);
+  auto slices = unbox(x.lookup(make_ids({{0, 24}})));
+  REQUIRE_EQUAL(slices.size(), 3u);
+  for (size_t i = 0; i < slices.size(); ++i) {
+    CHECK_LESS(as_bytes(slices[i]).size(), as_bytes(zeek_conn_log[i]).size());
+    CHECK_EQUAL(slices[i].layout_id(), zeek_conn_log[i].layout_id());
+    CHECK_EQUAL(slices[i], zeek_conn_log[i]);
+  }
+  MESSAGE("serialized slices carry their layout");
+  std::vector<char> buf;
+  REQUIRE_EQUAL(detail::serialize(buf, slices[0]), caf::none);
+  table_slice y;
+  REQUIRE_EQUAL(detail::deserialize(buf, y), caf::none);
+  CHECK_EQUAL(y, slices[0]);
+}
+
 FIXTURE_SCOPE_END()
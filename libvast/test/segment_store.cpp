@@ -142,6 +142,7 @@ TEST(flushing empty store - no op) {
   store->flush();
   CHECK_EQUAL(store->dirty(), false);
   CHECK_EQUAL(segment_files().size(), 0u);
+  CHECK_EQUAL(store->bytes(), 0u);
 }
 
 TEST(flushing filled store) {
@@ -154,6 +155,8 @@ TEST(flushing filled store) {
   std::vector expected_files{path{"vast-unit-test"} / "segments" / "segments"
                              / to_string(active)};
   CHECK_EQUAL(segment_files(), expected_files);
+  CHECK_EQUAL(store->bytes(),
+              unbox(file_size(segment_path / to_string(active))));
 }
 
 TEST(querying empty segment store) {
@@ -226,8 +229,10 @@ TEST(erase cached segment) {
 TEST(erase persisted segment) {
   put_cold(zeek_conn_log);
   CHECK_EQUAL(segment_files().size(), 1u);
+  CHECK_NOT_EQUAL(store->bytes(), 0u);
   erase(everything);
   CHECK_EQUAL(get(everything).size(), 0u);
+  CHECK_EQUAL(store->bytes(), 0u);
   store = nullptr;
   CHECK_EQUAL(segment_files().size(), 0u);
 }
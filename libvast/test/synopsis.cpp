@@ -23,6 +23,9 @@
 #include <caf/binary_serializer.hpp>
 
 #include "vast/bool_synopsis.hpp"
+#include "vast/enumeration_synopsis.hpp"
+#include "vast/port_synopsis.hpp"
+#include "vast/qualified_record_field.hpp"
 #include "vast/synopsis_factory.hpp"
 #include "vast/time_synopsis.hpp"
 
@@ -50,24 +53,24 @@ TEST(min-max synopsis) {
   verify(zero, {N, N, N, N, N, N, F, T, F, F, T, T});
   MESSAGE("[4,7] op 4");
   time four = epoch + 4s;
-  verify(four, {N, N, N, N, N, N, T, F, F, T, T, T});
+  verify(four, {N, N, N, N, N, N, T, T, F, T, T, T});
   MESSAGE("[4,7] op 6");
   time six = epoch + 6s;
-  verify(six, {N, N, N, N, N, N, T, F, T, T, T, T});
+  verify(six, {N, N, N, N, N, N, T, T, T, T, T, T});
   MESSAGE("[4,7] op 7");
   time seven = epoch + 7s;
-  verify(seven, {N, N, N, N, N, N, T, F, T, T, F, T});
+  verify(seven, {N, N, N, N, N, N, T, T, T, T, F, T});
   MESSAGE("[4,7] op 9");
   time nine = epoch + 9s;
   verify(nine, {N, N, N, N, N, N, F, T, T, T, F, F});
   MESSAGE("[4,7] op [0, 4]");
   auto zero_four = data{list{zero, four}};
   auto zero_four_view = make_view(zero_four);
-  verify(zero_four_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(zero_four_view, {N, N, T, T, N, N, N, N, N, N, N, N});
   MESSAGE("[4,7] op [7, 9]");
   auto seven_nine = data{list{seven, nine}};
   auto seven_nine_view = make_view(seven_nine);
-  verify(seven_nine_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(seven_nine_view, {N, N, T, T, N, N, N, N, N, N, N, N});
   MESSAGE("[4,7] op [0, 9]");
   auto zero_nine = data{list{zero, nine}};
   auto zero_nine_view = make_view(zero_nine);
@@ -79,7 +82,94 @@ TEST(min-max synopsis) {
   MESSAGE("[4,7] op [count{5}, 7]");
   auto heterogeneous = data{list{c, seven}};
   auto heterogeneous_view = make_view(heterogeneous);
-  verify(heterogeneous_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+  verify(heterogeneous_view, {N, N, T, T, N, N, N, N, N, N, N, N});
+  MESSAGE("[4,4] op 4");
+  auto y = factory<synopsis>::make(time_type{}, caf::settings{});
+  y->add(four);
+  verify = verifier{y.get()};
+  verify(four, {N, N, N, N, N, N, T, F, F, T, F, T});
+  verify(zero_four_view, {N, N, T, F, N, N, N, N, N, N, N, N});
+}
+
+TEST(numeric synopses) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  MESSAGE("count");
+  auto x = factory<synopsis>::make(count_type{}, caf::settings{});
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  x->add(count{4});
+  x->add(count{7});
+  auto verify = verifier{x.get()};
+  verify(count{0}, {N, N, N, N, N, N, F, T, F, F, T, T});
+  verify(count{5}, {N, N, N, N, N, N, T, T, T, T, T, T});
+  verify(count{9}, {N, N, N, N, N, N, F, T, T, T, F, F});
+  verify(integer{5}, {N, N, N, N, N, N, N, N, N, N, N, N});
+  MESSAGE("integer");
+  x = factory<synopsis>::make(integer_type{}, caf::settings{});
+  x->add(integer{-3});
+  verify = verifier{x.get()};
+  verify(integer{-4}, {N, N, N, N, N, N, F, T, F, F, T, T});
+  verify(integer{-3}, {N, N, N, N, N, N, T, F, F, T, F, T});
+  MESSAGE("real");
+  x = factory<synopsis>::make(real_type{}, caf::settings{});
+  x->add(real{0.5});
+  x->add(real{1.5});
+  verify = verifier{x.get()};
+  verify(real{1.0}, {N, N, N, N, N, N, T, T, T, T, T, T});
+  verify(real{2.0}, {N, N, N, N, N, N, F, T, T, T, F, F});
+  MESSAGE("duration");
+  x = factory<synopsis>::make(duration_type{}, caf::settings{});
+  x->add(duration{1s});
+  x->add(duration{1h});
+  verify = verifier{x.get()};
+  verify(duration{2h}, {N, N, N, N, N, N, F, T, T, T, F, F});
+  verify(duration{1min}, {N, N, N, N, N, N, T, T, T, T, T, T});
+}
+
+TEST(port synopsis) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  auto x = factory<synopsis>::make(count_type{}.name("port"), caf::settings{});
+  REQUIRE_NOT_EQUAL(dynamic_cast<port_synopsis*>(x.get()), nullptr);
+  x->add(count{53});
+  x->add(count{443});
+  x->add(count{80});
+  auto verify = verifier{x.get()};
+  MESSAGE("{53,80,443} op 80");
+  verify(count{80}, {N, N, N, N, N, N, T, T, T, T, T, T});
+  MESSAGE("{53,80,443} op 8080");
+  verify(count{8080}, {N, N, N, N, N, N, F, T, T, T, F, F});
+  MESSAGE("{53,80,443} op 100");
+  verify(count{100}, {N, N, N, N, N, N, F, T, T, T, T, T});
+  MESSAGE("{53,80,443} op [22, 443]");
+  auto ports = data{list{count{22}, count{443}}};
+  verify(make_view(ports), {N, N, T, T, N, N, N, N, N, N, N, N});
+  MESSAGE("{53,80,443} op [53, 80, 443]");
+  ports = data{list{count{53}, count{80}, count{443}}};
+  verify(make_view(ports), {N, N, T, F, N, N, N, N, N, N, N, N});
+  MESSAGE("degrade to min-max");
+  for (count i = 1000; i < 1000 + port_synopsis::max_values; ++i)
+    x->add(i);
+  auto& px = static_cast<port_synopsis&>(*x);
+  CHECK(px.values() == nullptr);
+  verify(count{100}, {N, N, N, N, N, N, T, T, T, T, T, T});
+}
+
+TEST(enumeration synopsis) {
+  using namespace nft;
+  factory<synopsis>::initialize();
+  auto t = enumeration_type{{"foo", "bar", "baz"}};
+  auto x = factory<synopsis>::make(t, caf::settings{});
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  x->add(enumeration{1});
+  auto verify = verifier{x.get()};
+  verify(enumeration{0}, {N, N, N, N, N, N, F, T, N, N, N, N});
+  verify(enumeration{1}, {N, N, N, N, N, N, T, F, N, N, N, N});
+  auto xs = data{list{enumeration{0}, enumeration{2}}};
+  verify(make_view(xs), {N, N, F, T, N, N, N, N, N, N, N, N});
+  x->add(enumeration{2});
+  verify(enumeration{1}, {N, N, N, N, N, N, T, T, N, N, N, N});
+  verify(make_view(xs), {N, N, T, T, N, N, N, N, N, N, N, N});
 }
 
 FIXTURE_SCOPE(synopsis_tests, fixtures::deterministic_actor_system)
@@ -89,6 +179,41 @@ TEST(serialization) {
   CHECK_ROUNDTRIP(synopsis_ptr{});
   CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(bool_type{}, caf::settings{}));
   CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(time_type{}, caf::settings{}));
+  CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(count_type{}, caf::settings{}));
+  CHECK_ROUNDTRIP_DEREF(
+    factory<synopsis>::make(duration_type{}, caf::settings{}));
+  CHECK_ROUNDTRIP_DEREF(
+    factory<synopsis>::make(count_type{}.name("port"), caf::settings{}));
+  CHECK_ROUNDTRIP_DEREF(factory<synopsis>::make(
+    enumeration_type{{"foo", "bar"}}, caf::settings{}));
+}
+
+TEST(flatbuffers) {
+  factory<synopsis>::initialize();
+  auto roundtrip = [](synopsis_ptr x) {
+    auto fqf = qualified_record_field{};
+    flatbuffers::FlatBufferBuilder builder;
+    auto offset = unbox(pack(builder, x, fqf));
+    builder.Finish(offset);
+    auto fb = flatbuffers::GetRoot<fbs::synopsis::v0>(
+      builder.GetBufferPointer());
+    synopsis_ptr y;
+    REQUIRE_EQUAL(unpack(*fb, y), caf::none);
+    REQUIRE_NOT_EQUAL(y, nullptr);
+    CHECK(*x == *y);
+  };
+  auto x = factory<synopsis>::make(count_type{}, caf::settings{});
+  x->add(count{42});
+  roundtrip(std::move(x));
+  x = factory<synopsis>::make(real_type{}, caf::settings{});
+  x->add(real{4.2});
+  roundtrip(std::move(x));
+  x = factory<synopsis>::make(count_type{}.name("port"), caf::settings{});
+  x->add(count{443});
+  roundtrip(std::move(x));
+  x = factory<synopsis>::make(enumeration_type{}, caf::settings{});
+  x->add(enumeration{200});
+  roundtrip(std::move(x));
 }
 
 FIXTURE_SCOPE_END()
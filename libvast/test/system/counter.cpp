@@ -91,7 +91,7 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     if (index == nullptr)
       FAIL("cannot start AUT without INDEX");
     aut = sys.spawn(counter, unbox(to<expression>(query)), index, archive,
-                    skip_candidate_check);
+                    skip_candidate_check, std::string{});
     run();
     anon_send(aut, atom::run_v, client);
     sched.run_once();
@@ -111,7 +111,7 @@ TEST(count IP point query without candidate check) {
   MESSAGE("spawn the COUNTER for query ':addr == 192.168.1.104'");
   spawn_aut(":addr == 192.168.1.104", true);
   // Once started, the COUNTER reaches out to the INDEX.
-  expect((expression), from(aut).to(index));
+  expect((expression, system::query_priority), from(aut).to(index));
   run();
   // The magic number 133 was computed via:
   // bro-cut < libvast_test/artifacts/logs/zeek/conn.log
@@ -127,7 +127,7 @@ TEST(count IP point query with candidate check) {
   MESSAGE("spawn the COUNTER for query ':addr == 192.168.1.104'");
   spawn_aut(":addr == 192.168.1.104", false);
   // Once started, the COUNTER reaches out to the INDEX.
-  expect((expression), from(aut).to(index));
+  expect((expression, system::query_priority), from(aut).to(index));
   run();
   // The magic number 105 was computed via:
   // bro-cut < libvast_test/artifacts/logs/zeek/conn.log
@@ -18,6 +18,7 @@
 #include "vast/fwd.hpp"
 
 #include "vast/test/fixtures/actor_system_and_events.hpp"
+#include "vast/test/fixtures/mock_index.hpp"
 #include "vast/test/test.hpp"
 
 #include "vast/concept/parseable/to.hpp"
@@ -32,11 +33,14 @@
 #include "vast/system/archive.hpp"
 #include "vast/system/index.hpp"
 #include "vast/system/posix_filesystem.hpp"
+#include "vast/system/query_scheduler.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/typed_event_based_actor.hpp>
 
+#include <memory>
+
 using namespace std::literals::chrono_literals;
 using namespace vast;
 
@@ -55,54 +59,36 @@ T take_one(std::vector<T>& xs) {
   return result;
 }
 
-struct mock_index_state {
-  static inline constexpr auto name = "mock-index";
-
-  std::vector<ids> deltas;
-};
-
-system::index_actor::behavior_type
-mock_index(system::index_actor::stateful_pointer<mock_index_state> self) {
-  return {
-    [=](atom::worker, system::query_supervisor_actor) {
-      FAIL("no mock implementation available");
-    },
-    [=](atom::done, uuid) { FAIL("no mock implementation available"); },
-    [=](caf::stream<table_slice>) -> caf::inbound_stream_slot<table_slice> {
-      FAIL("no mock implementation available");
-    },
-    [=](system::accountant_actor) { FAIL("no mock implementation available"); },
-    [=](atom::status,
-        system::status_verbosity) -> caf::config_value::dictionary {
-      FAIL("no mock implementation available");
-    },
-    [=](atom::subscribe, atom::flush, system::flush_listener_actor) {
-      FAIL("no mock implementation available");
-    },
-    [=](expression&) {
-      auto& deltas = self->state.deltas;
-      deltas = std::vector<ids>{
-        make_ids({1, 3, 5}),    make_ids({7, 9, 11}),  make_ids({13, 15, 17}),
-        make_ids({2, 4, 6}),    make_ids({8, 10, 12}), make_ids({14, 16, 18}),
-        make_ids({19, 20, 21}),
-      };
-      auto query_id = unbox(to<uuid>(uuid_str));
-      auto anon_self = caf::actor_cast<caf::event_based_actor*>(self);
-      auto hdl = caf::actor_cast<caf::actor>(self->current_sender());
-      anon_self->send(hdl, query_id, uint32_t{7}, uint32_t{3});
-      for (size_t i = 0; i < taste_count; ++i)
-        anon_self->send(hdl, take_one(deltas));
-      anon_self->send(hdl, atom::done_v);
-    },
-    [=](const uuid&, uint32_t n) {
-      auto anon_self = caf::actor_cast<caf::event_based_actor*>(self);
-      auto hdl = caf::actor_cast<caf::actor>(self->current_sender());
-      for (size_t i = 0; i < n; ++i)
-        anon_self->send(hdl, take_one(self->state.deltas));
-      anon_self->send(hdl, atom::done_v);
-    },
-    [=](atom::erase, uuid) -> ids { FAIL("no mock implementation available"); },
+/// Makes the mock INDEX answer a query with 21 hits in 7 chunks, and erase
+/// no partitions.
+fixtures::mock_index_handlers mock_index_handlers() {
+  auto deltas = std::make_shared<std::vector<ids>>();
+  auto result = fixtures::mock_index_handlers{};
+  result.query = [=](caf::event_based_actor* self, const caf::actor& client,
+                     expression&, system::query_priority priority) {
+    CHECK_EQUAL(priority, system::query_priority::low);
+    *deltas = std::vector<ids>{
+      make_ids({1, 3, 5}),    make_ids({7, 9, 11}),  make_ids({13, 15, 17}),
+      make_ids({2, 4, 6}),    make_ids({8, 10, 12}), make_ids({14, 16, 18}),
+      make_ids({19, 20, 21}),
+    };
+    auto query_id = unbox(to<uuid>(uuid_str));
+    self->send(client, query_id, uint32_t{7}, uint32_t{3});
+    for (size_t i = 0; i < taste_count; ++i)
+      self->send(client, take_one(*deltas));
+    self->send(client, atom::done_v);
+  };
+  result.more_hits = [=](caf::event_based_actor* self,
+                         const caf::actor& client, const uuid&, uint32_t n) {
+    for (size_t i = 0; i < n; ++i)
+      self->send(client, take_one(*deltas));
+    self->send(client, atom::done_v);
+  };
+  result.erase = [](expression&) {
+    // Pretend that no partition lies entirely within the query.
+    return ids{};
   };
+  return result;
 }
 
 struct mock_archive_state {
@@ -120,6 +106,9 @@ mock_archive(system::archive_actor::stateful_pointer<mock_archive_state> self) {
       FAIL("no mock implementation available");
     },
     [=](system::accountant_actor) { FAIL("no mock implementation available"); },
+    [=](atom::subscribe, atom::write, system::disk_usage_listener_actor) {
+      FAIL("no mock implementation available");
+    },
     [=](ids, system::archive_client_actor) {
       FAIL("no mock implementation available");
     },
@@ -135,6 +124,9 @@ mock_archive(system::archive_actor::stateful_pointer<mock_archive_state> self) {
       self->state.hits = hits;
       return atom::done_v;
     },
+    [=](atom::persist, atom::id) -> id {
+      FAIL("no mock implementation available");
+    },
   };
 }
 
@@ -168,11 +160,13 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
 FIXTURE_SCOPE(eraser_tests, fixture)
 
 TEST(eraser on mock INDEX) {
-  index = sys.spawn(mock_index);
+  index = sys.spawn(fixtures::mock_index, mock_index_handlers());
   spawn_aut();
   sched.trigger_timeouts();
   expect((atom::run), from(aut).to(aut));
-  expect((expression), from(aut).to(index));
+  expect((atom::erase, expression), from(aut).to(index));
+  expect((ids), from(index).to(aut));
+  expect((expression, system::query_priority), from(aut).to(index));
   expect((uuid, uint32_t, uint32_t),
          from(index).to(aut).with(query_id, 7u, 3u));
   expect((ids), from(_).to(aut));
@@ -211,7 +205,11 @@ TEST(eraser on actual INDEX with Zeek conn logs) {
   spawn_aut(":addr == 192.168.1.104");
   sched.trigger_timeouts();
   expect((atom::run), from(aut).to(aut));
-  expect((expression), from(aut).to(index));
+  expect((atom::erase, expression), from(aut).to(index));
+  expect((atom::erase, expression), from(index).to(index_state.meta_index));
+  expect((std::vector<uuid>), from(index_state.meta_index).to(index));
+  expect((ids), from(index).to(aut));
+  expect((expression, system::query_priority), from(aut).to(index));
   expect((expression), from(index).to(index_state.meta_index));
   expect((std::vector<uuid>), from(index_state.meta_index).to(index));
   expect((uuid, uint32_t, uint32_t), from(index).to(aut).with(_, 4u, 3u));
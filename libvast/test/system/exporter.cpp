@@ -27,9 +27,13 @@
 #include "vast/system/importer.hpp"
 #include "vast/system/index.hpp"
 #include "vast/system/posix_filesystem.hpp"
+#include "vast/system/query_profile.hpp"
 #include "vast/system/type_registry.hpp"
 #include "vast/table_slice.hpp"
 
+#include <algorithm>
+#include <functional>
+
 using namespace vast;
 
 using std::string;
@@ -61,8 +65,8 @@ struct fixture : fixture_base {
   void spawn_index() {
     auto fs = self->spawn(system::posix_filesystem, directory);
     auto indexdir = directory / "index";
-    index = self->spawn(system::index, fs, indexdir, 10000, 5, 5, 1, indexdir,
-                        0.01);
+    index = self->spawn(system::index, fs, indexdir, partition_capacity, 5,
+                        taste_partitions, 1, indexdir, 0.01);
   }
 
   void spawn_archive() {
@@ -76,7 +80,7 @@ struct fixture : fixture_base {
   }
 
   void spawn_exporter(query_options opts) {
-    exporter = self->spawn(system::exporter, expr, opts);
+    exporter = self->spawn(system::exporter, expr, opts, fields);
   }
 
   void importer_setup() {
@@ -125,6 +129,34 @@ struct fixture : fixture_base {
     return result;
   }
 
+  // Runs a time-ordered historical query that asks for *limit* results, and
+  // returns the results and the profile of the query.
+  auto run_ordered(query_options opts, uint64_t limit) {
+    spawn_exporter(historical + opts + explain);
+    send(exporter, atom::statistics_v, caf::actor_cast<caf::actor>(self));
+    send(exporter, archive);
+    send(exporter, index);
+    send(exporter, atom::sink_v, self);
+    send(exporter, atom::run_v);
+    send(exporter, atom::extract_v, limit);
+    run();
+    auto results = fetch_results();
+    MESSAGE("the exporter terminates once it shipped all ordered results");
+    auto profile = system::query_profile{};
+    self->receive([&](system::query_profile& x) { profile = std::move(x); },
+                  caf::after(0ms) >> [] { FAIL("missing query profile"); });
+    return std::pair{std::move(results), std::move(profile)};
+  }
+
+  // Extracts the values of the `ts` column.
+  static std::vector<vast::time>
+  timestamps(const std::vector<table_slice>& slices) {
+    auto result = std::vector<vast::time>{};
+    for (auto& row : make_data(slices))
+      result.push_back(caf::get<vast::time>(row[0]));
+    return result;
+  }
+
   void verify(const std::vector<table_slice>& results) {
     auto xs = make_data(results);
     REQUIRE_EQUAL(xs.size(), 5u);
@@ -139,6 +171,9 @@ struct fixture : fixture_base {
   system::importer_actor importer;
   system::exporter_actor exporter;
   expression expr;
+  std::vector<std::string> fields;
+  size_t partition_capacity = 10000;
+  size_t taste_partitions = 5;
 };
 
 } // namespace
@@ -158,6 +193,110 @@ TEST(historical query without importer) {
   verify(fetch_results());
 }
 
+TEST(historical query with explain option) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, index, archive);
+  run();
+  MESSAGE("spawn exporter for historical query with a profile");
+  spawn_exporter(historical + explain);
+  send(exporter, atom::statistics_v, caf::actor_cast<caf::actor>(self));
+  send(exporter, archive);
+  send(exporter, index);
+  send(exporter, atom::sink_v, self);
+  send(exporter, atom::run_v);
+  send(exporter, atom::extract_v);
+  run();
+  verify(fetch_results());
+  self->send_exit(exporter, caf::exit_reason::user_shutdown);
+  run();
+  MESSAGE("the exporter reports the profile when it terminates");
+  auto profile = system::query_profile{};
+  self->receive([&](system::query_profile& x) { profile = std::move(x); },
+                caf::after(0ms) >> [] { FAIL("missing query profile"); });
+  CHECK_NOT_EQUAL(profile.id, uuid::nil());
+  CHECK_GREATER(profile.candidates, 0u);
+  CHECK_GREATER(profile.partitions_evaluated, 0u);
+  CHECK(!profile.predicates.empty());
+  CHECK_GREATER(profile.slices_decoded, 0u);
+  CHECK_GREATER_EQUAL(profile.rows_decoded, profile.rows_checked);
+  CHECK_EQUAL(profile.rows_selected, 5u);
+}
+
+TEST(historical query with fields) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, index, archive);
+  run();
+  MESSAGE("project the results onto the requested fields");
+  fields = {"uid", "service"};
+  exporter_setup(historical);
+  auto results = fetch_results();
+  CHECK_EQUAL(rows(results), 5u);
+  for (auto& slice : results) {
+    CHECK(slice.encoding() != table_slice_encoding::none);
+    CHECK_EQUAL(slice.columns(), 2u);
+  }
+  for (auto& x : make_data(results))
+    CHECK_EQUAL(x[1], "dns");
+  self->send_exit(exporter, caf::exit_reason::user_shutdown);
+  run();
+  MESSAGE("drop the results if no column matches the requested fields");
+  fields = {"nonexistent"};
+  exporter_setup(historical);
+  CHECK_EQUAL(rows(fetch_results()), 0u);
+}
+
+TEST(historical query in ascending order) {
+  MESSAGE("spawn an index with one partition per slice");
+  partition_capacity = slice_size;
+  taste_partitions = 1;
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, index, archive);
+  run();
+  MESSAGE("fetch the five earliest events");
+  expr = unbox(to<expression>("#type == \"zeek.conn\""));
+  auto [results, profile] = run_ordered(ascending, 5);
+  auto expected = timestamps(zeek_conn_log);
+  std::sort(expected.begin(), expected.end());
+  expected.resize(5);
+  CHECK_EQUAL(timestamps(results), expected);
+  MESSAGE("the active partition has open bounds and cannot stop the query");
+  CHECK_EQUAL(profile.candidates, 3u);
+  CHECK_EQUAL(profile.partitions_evaluated, 3u);
+}
+
+TEST(historical query in descending order) {
+  MESSAGE("spawn an index with one partition per slice");
+  partition_capacity = slice_size;
+  taste_partitions = 1;
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log, index, archive);
+  run();
+  MESSAGE("fetch the three latest events");
+  expr = unbox(to<expression>("#type == \"zeek.conn\""));
+  auto [results, profile] = run_ordered(descending, 3);
+  auto expected = timestamps(zeek_conn_log);
+  std::sort(expected.begin(), expected.end(), std::greater<>{});
+  expected.resize(3);
+  CHECK_EQUAL(timestamps(results), expected);
+  MESSAGE("the query stops early since no persisted partition can contribute");
+  CHECK_EQUAL(profile.candidates, 3u);
+  CHECK_EQUAL(profile.partitions_evaluated, 1u);
+}
+
 TEST(historical query with importer) {
   MESSAGE("prepare importer");
   importer_setup();
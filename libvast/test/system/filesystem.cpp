@@ -17,11 +17,16 @@
 #include "vast/test/test.hpp"
 
 #include "vast/chunk.hpp"
+#include "vast/config.hpp"
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
 #include "vast/io/read.hpp"
 #include "vast/io/write.hpp"
 #include "vast/system/posix_filesystem.hpp"
 #include "vast/system/status_verbosity.hpp"
+#include "vast/system/uring_filesystem.hpp"
 
+#include <chrono>
 #include <cstddef>
 #include <fstream>
 
@@ -92,6 +97,41 @@ TEST(mmap) {
       [&](const caf::error& err) { FAIL(err); });
 }
 
+TEST(prefetch) {
+  MESSAGE("create file");
+  auto foo = "foo"s;
+  auto filename = directory / foo;
+  auto bytes = span<const char>{foo.data(), foo.size()};
+  auto err = io::write(filename, as_bytes(bytes));
+  REQUIRE(err == caf::none);
+  MESSAGE("prefetch existing and missing files via actor");
+  auto files = std::vector<path>{path{foo}, path{"not-there"}};
+#if VAST_LINUX || VAST_BSD
+  self->request(filesystem, caf::infinite, atom::prefetch_v, files)
+    .receive(
+      [&](atom::ok) {
+        // all good
+      },
+      [&](const caf::error& err) { FAIL(err); });
+  self
+    ->request(filesystem, caf::infinite, atom::status_v,
+              status_verbosity::debug)
+    .receive(
+      [&](const caf::dictionary<caf::config_value>& status) {
+        auto failed = caf::get<uint64_t>(
+          status, "filesystem.operations.prefetches.failed");
+        CHECK_EQUAL(failed, 1u);
+      },
+      [&](const caf::error& err) { FAIL(err); });
+#else
+  self->request(filesystem, caf::infinite, atom::prefetch_v, files)
+    .receive([&](atom::ok) { FAIL("prefetching should be unimplemented"); },
+             [&](const caf::error& err) {
+               CHECK_EQUAL(err, ec::unimplemented);
+             });
+#endif
+}
+
 TEST(status) {
   MESSAGE("create file");
   self->request(filesystem, caf::infinite, atom::read_v, path{"not-there"})
@@ -113,3 +153,79 @@ TEST(status) {
 }
 
 FIXTURE_SCOPE_END()
+
+TEST(latency histogram) {
+  using namespace std::chrono_literals;
+  latency_histogram x;
+  x.add(0us);
+  x.add(1us);
+  x.add(3us);
+  x.add(1h);
+  CHECK_EQUAL(x.buckets[0], 1u);
+  CHECK_EQUAL(x.buckets[1], 1u);
+  CHECK_EQUAL(x.buckets[2], 1u);
+  CHECK_EQUAL(x.buckets.back(), 1u);
+}
+
+#if VAST_ENABLE_URING
+
+namespace {
+
+struct uring_fixture : fixtures::deterministic_actor_system {
+  uring_fixture() {
+    REQUIRE(has_uring());
+    filesystem = caf::actor_cast<filesystem_actor>(
+      self->spawn<caf::detached>(uring_filesystem, directory, 8));
+  }
+
+  filesystem_actor filesystem;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(uring_filesystem_tests, uring_fixture)
+
+TEST(uring roundtrip) {
+  // Exceed both the block size and the threshold for direct I/O, and make
+  // sure the size is not a multiple of the alignment.
+  auto size = defaults::system::uring_direct_io_threshold + 42;
+  auto xs = std::vector<char>(size);
+  for (size_t i = 0; i < xs.size(); ++i)
+    xs[i] = static_cast<char>(i % 251);
+  auto chk = chunk::copy(xs);
+  MESSAGE("write file via actor");
+  self->request(filesystem, caf::infinite, atom::write_v, path{"foo"}, chk)
+    .receive([&](atom::ok) {}, [&](const caf::error& err) { FAIL(err); });
+  CHECK_EQUAL(unbox(file_size(directory / "foo")), size);
+  MESSAGE("read file via actor");
+  self->request(filesystem, caf::infinite, atom::read_v, path{"foo"})
+    .receive(
+      [&](const chunk_ptr& result) {
+        CHECK_EQUAL(as_bytes(result), as_bytes(chk));
+      },
+      [&](const caf::error& err) { FAIL(err); });
+  MESSAGE("read missing file via actor");
+  self->request(filesystem, caf::infinite, atom::read_v, path{"not-there"})
+    .receive([&](const chunk_ptr&) { FAIL("should not receive chunk"); },
+             [&](const caf::error&) {
+               // expected
+             });
+  self
+    ->request(filesystem, caf::infinite, atom::status_v,
+              status_verbosity::debug)
+    .receive(
+      [&](const caf::dictionary<caf::config_value>& status) {
+        CHECK_EQUAL(caf::get<uint64_t>(status,
+                                       "filesystem.operations.writes."
+                                       "successful"),
+                    1u);
+        CHECK_EQUAL(
+          caf::get<uint64_t>(status, "filesystem.operations.reads.failed"),
+          1u);
+      },
+      [&](const caf::error& err) { FAIL(err); });
+}
+
+FIXTURE_SCOPE_END()
+
+#endif // VAST_ENABLE_URING
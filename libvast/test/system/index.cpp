@@ -24,11 +24,15 @@
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/printable/std/chrono.hpp"
 #include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
+#include "vast/defaults.hpp"
 #include "vast/detail/spawn_container_source.hpp"
 #include "vast/detail/spawn_generator_source.hpp"
 #include "vast/ids.hpp"
+#include "vast/path.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/posix_filesystem.hpp"
+#include "vast/system/query_result_cache.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_builder.hpp"
 
@@ -65,7 +69,8 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
   }
 
   auto query(std::string_view expr) {
-    self->send(index, unbox(to<expression>(expr)));
+    self->send(index, unbox(to<expression>(expr)),
+               system::query_priority::normal);
     run();
     std::tuple<uuid, uint32_t, uint32_t> result;
     self->receive(
@@ -172,6 +177,32 @@ TEST(iterable integer query result) {
   CHECK_EQUAL(result, expected_result);
 }
 
+TEST(cached query result) {
+  auto partitions = taste_count + 1;
+  MESSAGE("fill first " << partitions << " partitions");
+  auto slices = rebase(first_n(alternating_integers, partitions));
+  auto src = detail::spawn_container_source(sys, slices, index);
+  run();
+  REQUIRE(state().result_cache);
+  REQUIRE_EQUAL(state().persisted_partitions.size(), taste_count);
+  auto expr = ":int == 1";
+  auto key = to_string(unbox(to<expression>(expr)));
+  MESSAGE("query half of the values");
+  auto [query_id, hits, scheduled] = query(expr);
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(rank(result), rows(slices) / 2);
+  MESSAGE("passive partitions cache their hits, active partitions do not");
+  for (const auto& id : state().persisted_partitions)
+    CHECK(state().result_cache->contains(id, key));
+  for (const auto& active : state().active_partitions)
+    CHECK(!state().result_cache->contains(active.id, key));
+  MESSAGE("the same query yields the same hits again");
+  auto [cached_query_id, cached_hits, cached_scheduled] = query(expr);
+  auto cached_result
+    = receive_result(cached_query_id, cached_hits, cached_scheduled);
+  CHECK_EQUAL(cached_result, result);
+}
+
 TEST(iterable zeek conn log query result) {
   MESSAGE("ingest conn.log slices");
   detail::spawn_container_source(sys, zeek_conn_log, index);
@@ -217,4 +248,169 @@ TEST(iterable zeek conn log query result) {
   }
 }
 
+TEST(compaction) {
+  MESSAGE("persist " << taste_count - 1 << " small partitions");
+  auto slices = rebase(first_n(alternating_integers, taste_count));
+  detail::spawn_container_source(sys, slices, index);
+  run();
+  auto inputs = std::vector<uuid>{state().persisted_partitions.begin(),
+                                  state().persisted_partitions.end()};
+  REQUIRE_EQUAL(inputs.size(), taste_count - 1);
+  auto merge = [&](std::vector<table_slice> xs) {
+    return self->request(index, caf::infinite, atom::merge_v, inputs,
+                         std::move(xs));
+  };
+  auto input_slices = first_n(slices, taste_count - 1);
+  MESSAGE("merging fails when events are missing");
+  auto incomplete = merge(first_n(slices, taste_count - 2));
+  run();
+  incomplete.receive([](const uuid&) { FAIL("merged incomplete events"); },
+                     [](const caf::error&) { /* nop */ });
+  CHECK_EQUAL(state().persisted_partitions.size(), taste_count - 1);
+  CHECK(!state().compacting);
+  MESSAGE("merge the persisted partitions");
+  auto rp = merge(input_slices);
+  run();
+  auto merged = uuid::nil();
+  rp.receive([&](uuid& id) { merged = id; },
+             [](caf::error& err) { FAIL(render(err)); });
+  CHECK_EQUAL(state().persisted_partitions.size(), 1u);
+  CHECK_EQUAL(state().persisted_partitions.count(merged), 1u);
+  MESSAGE("unreferenced inputs get removed right away");
+  CHECK(state().retired_partitions.empty());
+  for (const auto& input : inputs)
+    CHECK(!exists(state().partition_path(input)));
+  CHECK(!state().compacting);
+  MESSAGE("queries find all events in the merged partition");
+  auto [query_id, hits, scheduled] = query(":int == 1");
+  CHECK_EQUAL(hits, 2u);
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(rank(result), rows(slices) / 2);
+  MESSAGE("erasing a merged partition fails");
+  auto erased = self->request(index, caf::infinite, atom::erase_v, inputs[0]);
+  run();
+  erased.receive([](const ids&) { FAIL("erased a retired partition"); },
+                 [](const caf::error&) { /* nop */ });
+}
+
+TEST(erasure during compaction) {
+  auto slices = rebase(first_n(alternating_integers, taste_count));
+  detail::spawn_container_source(sys, slices, index);
+  run();
+  auto inputs = std::vector<uuid>{state().persisted_partitions.begin(),
+                                  state().persisted_partitions.end()};
+  REQUIRE_EQUAL(inputs.size(), taste_count - 1);
+  MESSAGE("erase an input while merging");
+  auto merged = self->request(index, caf::infinite, atom::merge_v, inputs,
+                              first_n(slices, taste_count - 1));
+  auto erased = self->request(index, caf::infinite, atom::erase_v, inputs[0]);
+  run();
+  merged.receive([](const uuid&) { FAIL("merge must be discarded"); },
+                 [](const caf::error&) { /* nop */ });
+  erased.receive([&](const ids& xs) { CHECK_EQUAL(rank(xs), slice_size); },
+                 [](const caf::error& err) { FAIL(render(err)); });
+  MESSAGE("the other inputs remain untouched");
+  CHECK(!state().compacting);
+  CHECK_EQUAL(state().persisted_partitions.size(), taste_count - 2);
+  CHECK_EQUAL(state().persisted_partitions.count(inputs[0]), 0u);
+  CHECK(state().retired_partitions.empty());
+  auto [query_id, hits, scheduled] = query(":int == 1");
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(rank(result), (rows(slices) - slice_size) / 2);
+}
+
+TEST(partition shard selection) {
+  const auto& conn = zeek_conn_log[0];
+  const auto& dns = zeek_dns_log[0];
+  system::partition_shard_selector select;
+  MESSAGE("assign consecutive slices to the round-robin shards in turn");
+  auto slices = std::make_shared<size_t>(0);
+  auto first = system::partition_shard{
+    0, 2, system::partition_sharding::round_robin, {}, slices};
+  auto second = system::partition_shard{
+    1, 2, system::partition_sharding::round_robin, {}, slices};
+  for (const auto& x : {conn, conn, dns}) {
+    CHECK_EQUAL(select(first, x), *slices % 2 == 0);
+    CHECK_EQUAL(select(second, x), *slices % 2 == 1);
+    ++*slices;
+  }
+  MESSAGE("assign layouts to homogeneous shards");
+  auto filter = system::partition_shard{
+    0, 1, system::partition_sharding::homogeneous, {conn.layout().name()}};
+  CHECK(select(filter, conn));
+  CHECK(!select(filter, dns));
+  CHECK(system::to_partition_sharding("homogeneous")
+        == system::partition_sharding::homogeneous);
+  CHECK(!system::to_partition_sharding("random"));
+}
+
+TEST(round-robin sharding) {
+  constexpr size_t shards = 2;
+  constexpr size_t slices_per_shard = 2;
+  MESSAGE("replace the INDEX with one that has " << shards
+                                                 << " active partitions");
+  anon_send_exit(index, caf::exit_reason::user_shutdown);
+  run();
+  caf::put(cfg.content, "vast.active-partitions",
+           caf::config_value::integer{shards});
+  auto fs = self->spawn(system::posix_filesystem, directory);
+  auto dir = directory / "sharded";
+  index = self->spawn(system::index, fs, dir, slice_size * slices_per_shard,
+                      in_mem_partitions, taste_count, num_query_supervisors,
+                      dir, meta_index_fp_rate);
+  run();
+  REQUIRE_EQUAL(state().active_partitions.size(), shards);
+  MESSAGE("ingest " << shards * slices_per_shard << " slices");
+  auto slices
+    = rebase(first_n(alternating_integers, shards * slices_per_shard));
+  auto src = detail::spawn_container_source(sys, slices, index);
+  run();
+  MESSAGE("every shard fills its active partition with its share of slices");
+  CHECK(state().persisted_partitions.empty());
+  for (const auto& active : state().active_partitions) {
+    CHECK(active.actor);
+    CHECK_EQUAL(active.capacity, 0u);
+  }
+  MESSAGE("queries find the hits of all shards");
+  auto [query_id, hits, scheduled] = query(":int == 1");
+  CHECK_EQUAL(hits, shards);
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(rank(result), rows(slices) / 2);
+}
+
+TEST(homogeneous sharding) {
+  MESSAGE("replace the INDEX with one that uses homogeneous sharding");
+  anon_send_exit(index, caf::exit_reason::user_shutdown);
+  run();
+  caf::put(cfg.content, "vast.partition-sharding", "homogeneous");
+  auto fs = self->spawn(system::posix_filesystem, directory);
+  auto dir = directory / "homogeneous";
+  index = self->spawn(system::index, fs, dir, 10 * slice_size,
+                      in_mem_partitions, taste_count, num_query_supervisors,
+                      dir, meta_index_fp_rate);
+  run();
+  CHECK_EQUAL(state().active_partition_timeout,
+              duration{defaults::system::active_partition_timeout});
+  MESSAGE("ingest slices of two layouts");
+  auto slices = rebase({zeek_conn_log[0], zeek_dns_log[0], zeek_dns_log[0]});
+  detail::spawn_container_source(sys, first_n(slices, 2), index);
+  run();
+  REQUIRE_EQUAL(state().active_partitions.size(), 2u);
+  CHECK_EQUAL(state().layout_shards.size(), 2u);
+  MESSAGE("sealing stale partitions removes their shards");
+  state().active_partition_timeout = duration{1};
+  state().seal_stale_partitions();
+  run();
+  CHECK(state().active_partitions.empty());
+  CHECK(state().layout_shards.empty());
+  CHECK(state().group_shards.empty());
+  CHECK_EQUAL(state().persisted_partitions.size(), 2u);
+  MESSAGE("a layout gets a new shard once it arrives again");
+  detail::spawn_container_source(sys, std::vector{slices[2]}, index);
+  run();
+  REQUIRE_EQUAL(state().active_partitions.size(), 1u);
+  CHECK(state().active_partitions[0].actor);
+  CHECK_EQUAL(state().layout_shards.at(zeek_dns_log[0].layout().name()), 0u);
+}
+
 FIXTURE_SCOPE_END()
@@ -49,10 +49,30 @@ vast::time get_timestamp(caf::optional<data_view> element) {
 partition_synopsis make_partition_synopsis(const vast::table_slice& ts) {
   auto result = partition_synopsis{};
   auto synopsis_opts = caf::settings{};
+  // Sketches are disabled by default.
+  caf::put(synopsis_opts, "hyperloglog-precision", size_t{10});
   result.add(ts, synopsis_opts);
   return result;
 }
 
+// Builds a slice with 20 events whose ports start at *first* and whose
+// contents alternate between two strings.
+table_slice make_sketchy_slice(count first, id offset) {
+  auto layout = record_type{{"timestamp", time_type{}.name("timestamp")},
+                            {"port", count_type{}.name("port")},
+                            {"content", string_type{}}}
+                  .name("sketchy");
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, layout);
+  for (count i = 0; i < 20; ++i)
+    CHECK(builder->add(make_data_view(epoch + std::chrono::seconds(i)),
+                       make_data_view(first + i % 10),
+                       make_data_view(i % 2 == 0 ? "foo" : "bar")));
+  auto slice = builder->finish();
+  slice.offset(offset);
+  return slice;
+}
+
 // Builds a chain of events that are 1s apart, where consecutive chunks of
 // num_events_per_type events have the same type.
 struct generator {
@@ -191,6 +211,23 @@ struct fixture : public fixtures::deterministic_actor_system_and_events {
     return lookup(meta_idx, expr);
   }
 
+  auto covered(std::string_view expr) {
+    std::vector<uuid> result;
+    auto rp = self->request(meta_idx, caf::infinite, atom::erase_v,
+                            unbox(to<expression>(expr)));
+    run();
+    rp.receive(
+      [&](std::vector<uuid> covered) { result = std::move(covered); },
+      [=](caf::error e) { FAIL(render(e)); });
+    return result;
+  }
+
+  void erase(const vast::uuid& id) {
+    auto rp = self->request(meta_idx, caf::infinite, atom::erase_v, id);
+    run();
+    rp.receive([=](atom::ok) {}, [=](const caf::error& e) { FAIL(render(e)); });
+  }
+
   void merge(meta_index_actor& meta_idx, const vast::uuid& id,
              std::shared_ptr<partition_synopsis> ps) {
     auto rp = self->request(meta_idx, caf::infinite, atom::merge_v, id, ps);
@@ -248,6 +285,94 @@ TEST(attribute extractor - type) {
   CHECK_EQUAL(lookup("#type !~ /x/"), ids);
 }
 
+TEST(erasing covered partitions) {
+  MESSAGE("partitions that lie partially within the query remain");
+  CHECK_EQUAL(covered(":timestamp < 1970-01-01+00:00:10.0"), empty());
+  CHECK_EQUAL(
+    covered("#type == \"foo\" && :timestamp < 1970-01-01+00:01:00.0"),
+    slice(0));
+  MESSAGE("covered partitions remain candidates until erased");
+  CHECK_EQUAL(timestamp_type_query("00:00:10"), slice(0));
+  erase(ids[0]);
+  CHECK_EQUAL(timestamp_type_query("00:00:10"), empty());
+  CHECK_EQUAL(covered(":timestamp < 1970-01-01+00:01:00.0"), slice(1));
+  erase(ids[1]);
+  CHECK_EQUAL(lookup(":timestamp < 1970-01-01+00:01:00.0"), slice(2));
+  MESSAGE("negations never cover a partition");
+  CHECK_EQUAL(covered("! (:timestamp < 1970-01-01+00:01:00.0)"), empty());
+  CHECK_EQUAL(covered("#type == \"foo\" || #type == \"foobar\""),
+              slice(2, 4));
+  MESSAGE("null values never satisfy a predicate");
+  generator g{"foo", 1000};
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, g.layout);
+  CHECK(builder->add(make_data_view(epoch)));
+  CHECK(builder->add(make_data_view("foo")));
+  CHECK(builder->add(make_data_view(caf::none)));
+  CHECK(builder->add(make_data_view("foo")));
+  auto slice_with_nulls = builder->finish();
+  slice_with_nulls.offset(1000);
+  merge(meta_idx, uuid::random(),
+        std::make_shared<partition_synopsis>(
+          make_partition_synopsis(slice_with_nulls)));
+  CHECK_EQUAL(covered(":timestamp < 1970-01-02+00:00:00.0"), slice(2, 4));
+}
+
+TEST(compaction candidates) {
+  auto candidates = [&](uint64_t threshold, uint64_t capacity) {
+    std::pair<std::vector<uuid>, vast::ids> result;
+    auto rp = self->request(meta_idx, caf::infinite, atom::merge_v,
+                            atom::candidate_v, threshold, capacity);
+    run();
+    rp.receive(
+      [&](std::vector<uuid>& partitions, vast::ids& xs) {
+        result = {std::move(partitions), std::move(xs)};
+      },
+      [=](caf::error e) { FAIL(render(e)); });
+    return result;
+  };
+  MESSAGE("only partitions below the threshold qualify");
+  CHECK_EQUAL(candidates(10, 100).first, empty());
+  MESSAGE("merged partitions must not exceed the capacity");
+  CHECK_EQUAL(candidates(25, 40).first, empty());
+  MESSAGE("the oldest partitions with the same layouts get merged");
+  auto [partitions, xs] = candidates(25, 100);
+  CHECK_EQUAL(partitions, (std::vector<uuid>{ids[0], ids[2]}));
+  CHECK_EQUAL(rank(xs), 50u);
+  CHECK(xs.size() == 75);
+  MESSAGE("replacing partitions swaps their synopses");
+  auto merged = uuid::random();
+  auto ps = std::make_shared<partition_synopsis>();
+  *ps = make_partition_synopsis(generator{"foo", 0}(25));
+  auto rp = self->request(meta_idx, caf::infinite, atom::replace_v,
+                          partitions, merged, ps);
+  run();
+  rp.receive([=](atom::ok) {}, [=](const caf::error& e) { FAIL(render(e)); });
+  CHECK_EQUAL(timestamp_type_query("00:00:10"), std::vector<uuid>{merged});
+  CHECK_EQUAL(lookup("#type == \"foo\""), std::vector<uuid>{merged});
+}
+
+TEST(time bounds) {
+  auto unknown = uuid::random();
+  auto rp = self->request(meta_idx, caf::infinite, atom::resolve_v,
+                          std::vector<uuid>{ids[2], ids[0], unknown});
+  run();
+  rp.receive(
+    [&](const std::vector<vast::time>& first,
+        const std::vector<vast::time>& last) {
+      REQUIRE_EQUAL(first.size(), 3u);
+      REQUIRE_EQUAL(last.size(), 3u);
+      CHECK_EQUAL(first[0], epoch + 50s);
+      CHECK_EQUAL(last[0], epoch + 74s);
+      CHECK_EQUAL(first[1], epoch);
+      CHECK_EQUAL(last[1], epoch + 24s);
+      MESSAGE("unknown partitions have open bounds");
+      CHECK_EQUAL(first[2], vast::time::min());
+      CHECK_EQUAL(last[2], vast::time::max());
+    },
+    [=](const caf::error& e) { FAIL(render(e)); });
+}
+
 TEST(meta index with bool synopsis) {
   MESSAGE("generate slice data and add it to the meta index");
   // FIXME: do we have to replace the meta index from the fixture with a new
@@ -297,4 +422,108 @@ TEST(meta index with bool synopsis) {
   CHECK_EQUAL(lookup_("y != T"), none);
 }
 
+TEST(meta index with enumeration and count synopses) {
+  MESSAGE("generate slice data and add it to the meta index");
+  auto meta_idx = self->spawn(meta_index);
+  auto layout = record_type{{"e", enumeration_type{{"foo", "bar"}}},
+                            {"n", count_type{}}}
+                  .name("test");
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, layout);
+  REQUIRE(builder);
+  CHECK(builder->add(make_data_view(enumeration{0}), make_data_view(count{10})));
+  auto slice = builder->finish();
+  REQUIRE(slice.encoding() != table_slice_encoding::none);
+  auto id1 = uuid::random();
+  merge(meta_idx, id1,
+        std::make_shared<partition_synopsis>(make_partition_synopsis(slice)));
+  CHECK(
+    builder->add(make_data_view(enumeration{1}), make_data_view(count{100})));
+  slice = builder->finish();
+  REQUIRE(slice.encoding() != table_slice_encoding::none);
+  auto id2 = uuid::random();
+  merge(meta_idx, id2,
+        std::make_shared<partition_synopsis>(make_partition_synopsis(slice)));
+  auto lookup_ = [&](std::string_view expr) { return lookup(meta_idx, expr); };
+  auto expected1 = std::vector<uuid>{id1};
+  auto expected2 = std::vector<uuid>{id2};
+  auto none = std::vector<uuid>{};
+  MESSAGE("enumeration values are looked up by name");
+  CHECK_EQUAL(lookup_("e == \"foo\""), expected1);
+  CHECK_EQUAL(lookup_("e == \"bar\""), expected2);
+  CHECK_EQUAL(lookup_("e != \"bar\""), expected1);
+  MESSAGE("counts prune by range");
+  CHECK_EQUAL(lookup_("n < 50"), expected1);
+  CHECK_EQUAL(lookup_("n > 50"), expected2);
+  CHECK_EQUAL(lookup_("n == 70"), none);
+}
+
+TEST(partition synopsis sketches) {
+  auto ps = make_partition_synopsis(make_sketchy_slice(0, 0));
+  MESSAGE("only integer, count, address, subnet, and string columns get a "
+          "sketch");
+  CHECK_EQUAL(ps.field_sketches_.size(), 2u);
+  CHECK(!ps.sketch("timestamp"));
+  auto ports = ps.sketch("port");
+  REQUIRE(ports);
+  CHECK_GREATER_EQUAL(ports->estimate(), 9u);
+  CHECK_LESS_EQUAL(ports->estimate(), 11u);
+  auto contents = ps.sketch("sketchy.content");
+  REQUIRE(contents);
+  CHECK_EQUAL(contents->estimate(), 2u);
+  MESSAGE("fields match at the boundaries of field names only");
+  CHECK(!ps.sketch("ort"));
+  MESSAGE("sketches are disabled by default");
+  auto opts = caf::settings{};
+  auto unsketched = partition_synopsis{};
+  unsketched.add(make_sketchy_slice(0, 0), opts);
+  CHECK(unsketched.field_sketches_.empty());
+}
+
+TEST(partition synopsis sketches serialization) {
+  auto ps = make_partition_synopsis(make_sketchy_slice(0, 0));
+  flatbuffers::FlatBufferBuilder builder;
+  auto offset = unbox(pack(builder, ps));
+  builder.Finish(offset);
+  auto fb = flatbuffers::GetRoot<fbs::partition_synopsis::v0>(
+    builder.GetBufferPointer());
+  REQUIRE(fb);
+  auto recovered = partition_synopsis{};
+  REQUIRE_EQUAL(unpack(*fb, recovered), caf::none);
+  REQUIRE_EQUAL(recovered.field_sketches_.size(), ps.field_sketches_.size());
+  for (auto& [field, sketch] : ps.field_sketches_) {
+    auto it = recovered.field_sketches_.find(field);
+    REQUIRE(it != recovered.field_sketches_.end());
+    CHECK_EQUAL(it->second, sketch);
+  }
+}
+
+TEST(distinct values) {
+  merge(meta_idx, uuid::random(),
+        std::make_shared<partition_synopsis>(
+          make_partition_synopsis(make_sketchy_slice(0, 1000))));
+  merge(meta_idx, uuid::random(),
+        std::make_shared<partition_synopsis>(
+          make_partition_synopsis(make_sketchy_slice(5, 2000))));
+  auto distinct = [&](std::string_view expr, std::string field) {
+    auto result = uint64_t{0};
+    auto rp = self->request(meta_idx, caf::infinite, atom::distinct_v,
+                            unbox(to<expression>(expr)), std::move(field));
+    run();
+    rp.receive([&](uint64_t x) { result = x; },
+               [=](const caf::error& e) { FAIL(render(e)); });
+    return result;
+  };
+  MESSAGE("the sketches of all candidates get merged");
+  auto ports = distinct("#type == \"sketchy\"", "port");
+  CHECK_GREATER_EQUAL(ports, 14u);
+  CHECK_LESS_EQUAL(ports, 16u);
+  CHECK_EQUAL(distinct("#type == \"sketchy\"", "content"), 2u);
+  MESSAGE("the candidates of the other layouts all contain the same string");
+  CHECK_EQUAL(distinct("#type == \"foo\"", "content"), 1u);
+  MESSAGE("fields without sketches have no estimate");
+  CHECK_EQUAL(distinct("#type == \"sketchy\"", "timestamp"), 0u);
+  CHECK_EQUAL(distinct("#type == \"sketchy\"", "nonexistent"), 0u);
+}
+
 FIXTURE_SCOPE_END()
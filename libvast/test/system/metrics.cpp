@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE metrics
+
+#include "vast/system/metrics.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <caf/variant.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace vast;
+using namespace vast::system;
+using namespace std::chrono_literals;
+
+namespace {
+
+template <class T>
+T get(const report& r, const std::string& key) {
+  auto i = std::find_if(r.begin(), r.end(),
+                        [&](const data_point& x) { return x.key == key; });
+  REQUIRE(i != r.end());
+  return caf::get<T>(i->value);
+}
+
+} // namespace
+
+TEST(counter across threads) {
+  counter_metric x;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      for (size_t j = 0; j < 1000; ++j)
+        x.add();
+    });
+  for (auto& t : threads)
+    t.join();
+  CHECK_EQUAL(x.value(), 4000u);
+}
+
+TEST(histogram buckets) {
+  using hist = histogram_metric;
+  for (uint64_t x : {0ull, 1ull, 7ull, 8ull, 9ull, 1000ull, 123456789ull}) {
+    auto i = hist::bucket(x);
+    CHECK_LESS_EQUAL(x, hist::upper_bound(i));
+    if (i > 0)
+      CHECK_LESS(hist::upper_bound(i - 1), x);
+  }
+  CHECK_EQUAL(hist::bucket(~0ull), hist::num_buckets - 1);
+  CHECK_EQUAL(hist::upper_bound(hist::num_buckets - 1), ~0ull);
+}
+
+TEST(histogram quantiles) {
+  histogram_metric x;
+  for (uint64_t i = 1; i <= 1000; ++i)
+    x.add(i);
+  auto s = x.take();
+  CHECK_EQUAL(s.count, 1000u);
+  CHECK_EQUAL(s.sum, 500500u);
+  // The bucket boundaries overestimate by at most an eighth.
+  auto p50 = s.quantile(0.5);
+  CHECK_GREATER_EQUAL(p50, 500u);
+  CHECK_LESS_EQUAL(p50, 500u + 500u / 8);
+  CHECK_GREATER_EQUAL(s.quantile(1.0), 1000u);
+  MESSAGE("taking a snapshot resets the histogram");
+  CHECK_EQUAL(x.take().count, 0u);
+}
+
+TEST(registry snapshot) {
+  metrics_registry registry;
+  auto& c = registry.make_counter("foo.events");
+  CHECK_EQUAL(&c, &registry.make_counter("foo.events"));
+  c.add(42);
+  registry.make_gauge("foo.pending").set(-3);
+  registry.make_histogram("foo.latency").add(10us);
+  auto r = registry.snapshot();
+  CHECK_EQUAL(get<uint64_t>(r, "foo.events"), 42u);
+  CHECK_EQUAL(get<int64_t>(r, "foo.pending"), -3);
+  CHECK_EQUAL(get<uint64_t>(r, "foo.latency.count"), 1u);
+  CHECK_GREATER_EQUAL(get<duration>(r, "foo.latency.max"), 10us);
+  MESSAGE("idle histograms do not show up in the report");
+  r = registry.snapshot();
+  CHECK_EQUAL(r.size(), 2u);
+  CHECK_EQUAL(get<uint64_t>(r, "foo.events"), 42u);
+}
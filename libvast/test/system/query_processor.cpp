@@ -18,6 +18,7 @@
 #include "vast/fwd.hpp"
 
 #include "vast/test/fixtures/actor_system.hpp"
+#include "vast/test/fixtures/mock_index.hpp"
 #include "vast/test/test.hpp"
 
 #include "vast/concept/parseable/to.hpp"
@@ -35,40 +36,18 @@ constexpr std::string_view uuid_str = "423b45a1-c217-4f99-ba43-9e3fc3285cd3";
 
 constexpr std::string_view query_str = ":timestamp < 1 week ago";
 
-struct mock_index_state {
-  static inline constexpr const char* name = "mock-index";
-};
-
-system::index_actor::behavior_type
-mock_index(system::index_actor::stateful_pointer<mock_index_state> self) {
-  return {
-    [=](atom::worker, system::query_supervisor_actor) {
-      FAIL("no mock implementation available");
-    },
-    [=](atom::done, uuid) { FAIL("no mock implementation available"); },
-    [=](caf::stream<table_slice>) -> caf::inbound_stream_slot<table_slice> {
-      FAIL("no mock implementation available");
-    },
-    [=](system::accountant_actor) { FAIL("no mock implementation available"); },
-    [=](atom::status,
-        system::status_verbosity) -> caf::config_value::dictionary {
-      FAIL("no mock implementation available");
-    },
-    [=](atom::subscribe, atom::flush, system::flush_listener_actor) {
-      FAIL("no mock implementation available");
-    },
-    [=](expression&) {
-      auto query_id = unbox(to<uuid>(uuid_str));
-      auto anon_self = caf::actor_cast<caf::event_based_actor*>(self);
-      auto hdl = caf::actor_cast<caf::actor>(self->current_sender());
-      anon_self->send(hdl, query_id, uint32_t{3}, uint32_t(7));
-      anon_self->send(hdl, make_ids({1, 2, 4}));
-      anon_self->send(hdl, make_ids({3, 5}));
-      anon_self->send(hdl, atom::done_v);
-    },
-    [=](const uuid&, uint32_t) { FAIL("no mock implementation available"); },
-    [=](atom::erase, uuid) -> ids { FAIL("no mock implementation available"); },
+/// Makes the mock INDEX answer a query with 5 hits in 2 chunks.
+fixtures::mock_index_handlers mock_index_handlers() {
+  auto result = fixtures::mock_index_handlers{};
+  result.query = [](caf::event_based_actor* self, const caf::actor& client,
+                    expression&, system::query_priority) {
+    auto query_id = unbox(to<uuid>(uuid_str));
+    self->send(client, query_id, uint32_t{3}, uint32_t(7));
+    self->send(client, make_ids({1, 2, 4}));
+    self->send(client, make_ids({3, 5}));
+    self->send(client, atom::done_v);
   };
+  return result;
 }
 
 class mock_processor : public system::query_processor {
@@ -94,7 +73,7 @@ public:
 
 struct fixture : fixtures::deterministic_actor_system {
   fixture() : query_id(unbox(to<uuid>(uuid_str))) {
-    index = sys.spawn(mock_index);
+    index = sys.spawn(fixtures::mock_index, mock_index_handlers());
     aut = sys.spawn([=](caf::stateful_actor<mock_processor>* self) {
       return self->state.behavior();
     });
@@ -122,7 +101,7 @@ TEST(state transitions) {
   };
   self->send(aut, unbox(to<expression>(query_str)), index);
   expect((expression, system::index_actor), from(self).to(aut));
-  expect((expression), from(aut).to(index));
+  expect((expression, system::query_priority), from(aut).to(index));
   expect((uuid, uint32_t, uint32_t), from(index).to(aut));
   expect((ids), from(index).to(aut));
   expect((ids), from(index).to(aut));
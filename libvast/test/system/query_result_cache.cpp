@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE query_result_cache
+
+#include "vast/system/query_result_cache.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/ids.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/settings.hpp>
+
+using namespace vast;
+using namespace vast::system;
+
+TEST(lookup) {
+  query_result_cache cache{1'024 * 1'024};
+  auto id = uuid::random();
+  CHECK(!cache.lookup(id, "x == 42"));
+  cache.insert(id, "x == 42", make_ids({{10, 12}}));
+  CHECK(cache.contains(id, "x == 42"));
+  CHECK(!cache.contains(id, "x == 43"));
+  CHECK(!cache.contains(uuid::random(), "x == 42"));
+  CHECK_EQUAL(unbox(cache.lookup(id, "x == 42")), make_ids({{10, 12}}));
+  MESSAGE("inserting again replaces the hits");
+  cache.insert(id, "x == 42", make_ids({{20, 22}}));
+  CHECK_EQUAL(cache.size(), 1u);
+  CHECK_EQUAL(unbox(cache.lookup(id, "x == 42")), make_ids({{20, 22}}));
+  caf::settings status;
+  cache.inspect_status(status);
+  CHECK_EQUAL(caf::get_or(status, "hits", uint64_t{0}), 2u);
+  CHECK_EQUAL(caf::get_or(status, "misses", uint64_t{0}), 1u);
+}
+
+TEST(invalidation) {
+  query_result_cache cache{1'024 * 1'024};
+  auto x = uuid::random();
+  auto y = uuid::random();
+  cache.insert(x, "a == 1", make_ids({{0, 1}}));
+  cache.insert(x, "b == 2", make_ids({{1, 2}}));
+  cache.insert(y, "a == 1", make_ids({{2, 3}}));
+  REQUIRE_EQUAL(cache.size(), 3u);
+  cache.invalidate(x);
+  CHECK_EQUAL(cache.size(), 1u);
+  CHECK(!cache.contains(x, "a == 1"));
+  CHECK(!cache.contains(x, "b == 2"));
+  CHECK(cache.contains(y, "a == 1"));
+}
+
+TEST(least recently used eviction) {
+  auto id = uuid::random();
+  auto entry_size = [&] {
+    query_result_cache probe{1'024 * 1'024};
+    probe.insert(id, "a", make_ids({{0, 1}}));
+    return probe.memusage();
+  }();
+  query_result_cache cache{2 * entry_size};
+  cache.insert(id, "a", make_ids({{0, 1}}));
+  cache.insert(id, "b", make_ids({{0, 1}}));
+  MESSAGE("accessing a makes b the least recently used entry");
+  CHECK(cache.lookup(id, "a"));
+  cache.insert(id, "c", make_ids({{0, 1}}));
+  CHECK_EQUAL(cache.size(), 2u);
+  CHECK(cache.contains(id, "a"));
+  CHECK(!cache.contains(id, "b"));
+  CHECK(cache.contains(id, "c"));
+  CHECK_LESS_EQUAL(cache.memusage(), 2 * entry_size);
+  MESSAGE("entries that exceed the capacity are never cached");
+  query_result_cache tiny{1};
+  tiny.insert(id, "a", make_ids({{0, 1}}));
+  CHECK_EQUAL(tiny.size(), 0u);
+}
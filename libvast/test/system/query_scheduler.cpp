@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE query_scheduler
+
+#include "vast/system/query_scheduler.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/uuid.hpp"
+
+#include <vector>
+
+using namespace vast;
+using namespace vast::system;
+
+namespace {
+
+query_request make_request(const uuid& id, query_priority priority) {
+  return query_request{id, 1, index_client_actor{}, priority};
+}
+
+uuid pop(query_scheduler& scheduler) {
+  auto request = scheduler.pop();
+  REQUIRE(request);
+  return request->query_id;
+}
+
+} // namespace
+
+TEST(priority order) {
+  query_scheduler scheduler{10};
+  auto low = uuid::random();
+  auto normal = uuid::random();
+  auto high = uuid::random();
+  scheduler.push(make_request(low, query_priority::low));
+  scheduler.push(make_request(normal, query_priority::normal));
+  scheduler.push(make_request(high, query_priority::high));
+  CHECK_EQUAL(scheduler.queued(), 3u);
+  CHECK_EQUAL(scheduler.runnable(), 3u);
+  CHECK_EQUAL(pop(scheduler), high);
+  CHECK_EQUAL(pop(scheduler), normal);
+  CHECK_EQUAL(pop(scheduler), low);
+  CHECK(!scheduler.pop());
+  CHECK_EQUAL(scheduler.running(), 3u);
+}
+
+TEST(arrival order within a class) {
+  query_scheduler scheduler{10};
+  auto xs = std::vector<uuid>{uuid::random(), uuid::random(), uuid::random()};
+  for (auto& id : xs)
+    scheduler.push(make_request(id, query_priority::normal));
+  for (auto& id : xs)
+    CHECK_EQUAL(pop(scheduler), id);
+}
+
+TEST(class limits) {
+  query_scheduler scheduler{4};
+  for (size_t i = 0; i < 4; ++i)
+    scheduler.push(make_request(uuid::random(), query_priority::low));
+  MESSAGE("low priority requests occupy at most half of the workers");
+  CHECK_EQUAL(scheduler.runnable(), 2u);
+  CHECK(scheduler.pop());
+  CHECK(scheduler.pop());
+  CHECK(!scheduler.pop());
+  MESSAGE("normal priority requests leave one worker for high priority");
+  for (size_t i = 0; i < 2; ++i)
+    scheduler.push(make_request(uuid::random(), query_priority::normal));
+  CHECK(scheduler.pop());
+  CHECK(!scheduler.pop());
+  auto high = uuid::random();
+  scheduler.push(make_request(high, query_priority::high));
+  CHECK_EQUAL(pop(scheduler), high);
+  CHECK_EQUAL(scheduler.running(), 4u);
+  CHECK_EQUAL(scheduler.runnable(), 0u);
+  MESSAGE("finished requests free their worker");
+  scheduler.release(query_priority::low);
+  CHECK(scheduler.pop());
+  CHECK_EQUAL(scheduler.queued(), 2u);
+}
+
+TEST(drop) {
+  query_scheduler scheduler{1};
+  auto x = uuid::random();
+  auto y = uuid::random();
+  scheduler.push(make_request(x, query_priority::normal));
+  scheduler.push(make_request(y, query_priority::normal));
+  scheduler.push(make_request(x, query_priority::normal));
+  scheduler.drop(x);
+  CHECK_EQUAL(scheduler.queued(), 1u);
+  CHECK_EQUAL(pop(scheduler), y);
+}
+
+TEST(parsing) {
+  CHECK_EQUAL(unbox(to_query_priority("low")), query_priority::low);
+  CHECK_EQUAL(unbox(to_query_priority("high")), query_priority::high);
+  CHECK(!to_query_priority("urgent"));
+}
@@ -20,8 +20,13 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/defaults.hpp"
+#include "vast/detail/deserialize.hpp"
+#include "vast/detail/serialize.hpp"
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
+#include "vast/layout_interner.hpp"
+#include "vast/table_slice_builder_factory.hpp"
 #include "vast/table_slice_column.hpp"
 #include "vast/table_slice_row.hpp"
 
@@ -30,6 +35,7 @@
 
 using namespace vast;
 using namespace std::string_literals;
+using namespace std::string_view_literals;
 
 FIXTURE_SCOPE(table_slice_tests, fixtures::table_slices)
 
@@ -83,6 +89,34 @@ TEST(row view) {
   }
 }
 
+TEST(layout fingerprints) {
+  REQUIRE_GREATER(zeek_conn_log.size(), 1u);
+  auto& x = zeek_conn_log[0];
+  auto& y = zeek_conn_log[1];
+  auto& z = zeek_dns_log[0];
+  CHECK_NOT_EQUAL(x.layout_id(), 0u);
+  CHECK_EQUAL(x.layout_id(), y.layout_id());
+  CHECK_NOT_EQUAL(x.layout_id(), z.layout_id());
+  MESSAGE("slices with the same layout share the interned layout");
+  CHECK_EQUAL(&x.layout(), &y.layout());
+  auto xs = select(zeek_conn_log_full[0], make_ids({{0, 10}}));
+  REQUIRE_EQUAL(xs.size(), 1u);
+  CHECK_EQUAL(xs[0].layout_id(), zeek_conn_log_full[0].layout_id());
+  CHECK_EQUAL(&xs[0].layout(), &zeek_conn_log_full[0].layout());
+  MESSAGE("colliding fingerprints do not alias different layouts");
+  auto& interner = layout_interner::instance();
+  auto collision = interner.intern(z.layout_id(), x.layout());
+  REQUIRE(collision);
+  CHECK_EQUAL(*collision, x.layout());
+  CHECK_NOT_EQUAL(collision.get(), &z.layout());
+  std::vector<char> serialized_layout;
+  REQUIRE_EQUAL(detail::serialize(serialized_layout, x.layout()), caf::none);
+  collision = interner.intern(z.layout_id(), as_bytes(serialized_layout));
+  REQUIRE(collision);
+  CHECK_EQUAL(*collision, x.layout());
+  CHECK_EQUAL(interner.find(z.layout_id()).get(), &z.layout());
+}
+
 TEST(select all) {
   auto sut = zeek_conn_log_full[0];
   sut.offset(100);
@@ -145,6 +179,105 @@ TEST(select suffix) {
   CHECK_EQUAL(make_data(xs[0]), make_data(sut, 50, 50));
 }
 
+TEST(select views) {
+  auto sut = zeek_conn_log_full[0];
+  sut.offset(100);
+  auto xs = select(sut, make_ids({{110, 120}, {170, 180}}));
+  REQUIRE_EQUAL(xs.size(), 2u);
+  MESSAGE("selections share the data of their parent");
+  CHECK_EQUAL(as_bytes(xs[0]).data(), as_bytes(sut).data());
+  MESSAGE("selections of selections refer to the right rows");
+  auto ys = select(xs[1], make_ids({{175, 177}}));
+  REQUIRE_EQUAL(ys.size(), 1u);
+  CHECK_EQUAL(ys[0].offset(), 175u);
+  CHECK_EQUAL(make_data(ys[0]), make_data(sut, 75, 2));
+  MESSAGE("materialized selections own exactly their rows");
+  auto materialized = materialize(xs[0]);
+  CHECK_NOT_EQUAL(as_bytes(materialized).data(), as_bytes(sut).data());
+  CHECK_LESS(as_bytes(materialized).size(), as_bytes(sut).size());
+  CHECK_EQUAL(materialized.offset(), 110u);
+  CHECK_EQUAL(materialized, xs[0]);
+  MESSAGE("selections survive serialization");
+  std::vector<char> buf;
+  REQUIRE_EQUAL(detail::serialize(buf, xs[1]), caf::none);
+  table_slice deserialized;
+  REQUIRE_EQUAL(detail::deserialize(buf, deserialized), caf::none);
+  CHECK_EQUAL(deserialized.rows(), 10u);
+  CHECK_EQUAL(make_data(deserialized), make_data(sut, 70, 10));
+}
+
+TEST(project) {
+  auto sut = zeek_conn_log[0];
+  sut.offset(100);
+  auto flat_layout = flatten(sut.layout());
+  auto columns = std::vector<size_t>{2, 0};
+  auto projected = project(sut, columns);
+  CHECK_EQUAL(projected.encoding(), sut.encoding());
+  CHECK_EQUAL(projected.offset(), 100u);
+  REQUIRE_EQUAL(projected.rows(), sut.rows());
+  REQUIRE_EQUAL(projected.columns(), 2u);
+  CHECK_EQUAL(projected.layout().name(), sut.layout().name());
+  CHECK_EQUAL(projected.layout().fields[0], flat_layout.fields[2]);
+  CHECK_EQUAL(projected.layout().fields[1], flat_layout.fields[0]);
+  for (size_t row = 0; row < sut.rows(); ++row) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const auto& type = flat_layout.fields[columns[i]].type;
+      CHECK_EQUAL(projected.at(row, i, type), sut.at(row, columns[i], type));
+    }
+  }
+}
+
+TEST(columnar append) {
+  using column_view = table_slice_builder::column_view;
+  auto layout = record_type{{"c", count_type{}},
+                            {"s", string_type{}},
+                            {"t", time_type{}}}
+                  .name("columnar");
+  auto counts = std::vector<count>{1, 2, 3};
+  auto strings = std::vector<std::string_view>{"foo", "bar", "baz"};
+  auto times = std::vector<vast::time>(3);
+  auto columns = std::vector<column_view>{
+    span<const count>{counts}, span<const std::string_view>{strings},
+    span<const vast::time>{times}};
+  for (auto encoding :
+       {table_slice_encoding::msgpack, defaults::import::table_slice_type}) {
+    auto builder = factory<table_slice_builder>::make(encoding, layout);
+    REQUIRE(builder);
+    CHECK(builder->append_columns(columns));
+    CHECK_EQUAL(builder->rows(), 3u);
+    MESSAGE("columnar and row-wise appends can follow each other");
+    CHECK(builder->add(count{4}, "qux"sv, vast::time{}));
+    MESSAGE("invalid batches leave the builder untouched");
+    auto swapped = columns;
+    std::swap(swapped[0], swapped[1]);
+    CHECK(!builder->append_columns(swapped));
+    auto ragged = columns;
+    ragged[2] = span<const vast::time>{times.data(), 2};
+    CHECK(!builder->append_columns(ragged));
+    auto truncated = span<const column_view>{columns.data(), 2};
+    CHECK(!builder->append_columns(truncated));
+    CHECK_EQUAL(builder->rows(), 4u);
+    auto slice = builder->finish();
+    REQUIRE_EQUAL(slice.rows(), 4u);
+    CHECK_EQUAL(slice.at(1, 0, count_type{}), make_data_view(count{2}));
+    CHECK_EQUAL(slice.at(2, 1, string_type{}), make_data_view("baz"sv));
+    CHECK_EQUAL(slice.at(3, 0, count_type{}), make_data_view(count{4}));
+  }
+  MESSAGE("rebuilding appends whole columns");
+  auto builder
+    = factory<table_slice_builder>::make(table_slice_encoding::msgpack, layout);
+  REQUIRE(builder->append_columns(columns));
+  auto slice = builder->finish();
+  auto copy = rebuild(slice, defaults::import::table_slice_type);
+  CHECK_EQUAL(copy.encoding(), defaults::import::table_slice_type);
+  CHECK_EQUAL(copy, slice);
+  MESSAGE("rebuilding views of Arrow slices reads their column buffers");
+  auto view = truncate(copy, 2);
+  auto back = rebuild(view, table_slice_encoding::msgpack);
+  CHECK_EQUAL(back.encoding(), table_slice_encoding::msgpack);
+  CHECK_EQUAL(back, truncate(slice, 2));
+}
+
 TEST(truncate) {
   auto sut = zeek_conn_log[0];
   REQUIRE_EQUAL(sut.rows(), 8u);
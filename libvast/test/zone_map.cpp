@@ -0,0 +1,140 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#define SUITE zone_map
+
+#include "vast/zone_map.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/defaults.hpp"
+#include "vast/synopsis_factory.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_builder_factory.hpp"
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    factory<synopsis>::initialize();
+    factory<table_slice_builder>::initialize();
+    layout = record_type{{"ts", time_type{}.name("timestamp")},
+                         {"x", count_type{}},
+                         {"s", string_type{}}}
+               .name("zone");
+  }
+
+  // Builds a slice whose counts start at *first* and whose strings are all
+  // equal to *str*.
+  table_slice make_slice(count first, std::string_view str) {
+    auto builder = factory<table_slice_builder>::make(
+      defaults::import::table_slice_type, layout);
+    for (count i = first; i < first + 10; ++i) {
+      CHECK(builder->add(make_data_view(vast::time{} + std::chrono::seconds(i)),
+                         make_data_view(i), make_data_view(str)));
+    }
+    return builder->finish();
+  }
+
+  bool check(const zone_map& zm, std::string_view str) {
+    auto expr = unbox(to<expression>(str));
+    return may_match(zm, expr);
+  }
+
+  record_type layout;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(zone_map_tests, fixture)
+
+TEST(zone map predicates) {
+  auto zm = make_zone_map(make_slice(10, "foo"), caf::settings{});
+  CHECK_EQUAL(zm.events, 10u);
+  CHECK(check(zm, "x == 15"));
+  CHECK(!check(zm, "x == 20"));
+  CHECK(!check(zm, "x < 10"));
+  CHECK(check(zm, ":count >= 19"));
+  CHECK(!check(zm, ":count > 19"));
+  // Zone maps have no synopses for strings, so they cannot rule them out.
+  CHECK(check(zm, "s == \"foo\""));
+  CHECK(check(zm, "s == \"bar\""));
+  CHECK(!check(zm, "y == 15"));
+  CHECK(check(zm, "#type == \"zone\""));
+  CHECK(!check(zm, "#type == \"other\""));
+}
+
+TEST(zone map null values) {
+  auto builder = factory<table_slice_builder>::make(
+    defaults::import::table_slice_type, layout);
+  for (count i = 0; i < 10; ++i) {
+    auto x = i % 2 == 0 ? make_data_view(count{42}) : make_data_view(caf::none);
+    CHECK(builder->add(make_data_view(vast::time{} + std::chrono::seconds(i)),
+                       x, make_data_view("foo")));
+  }
+  auto zm = make_zone_map(builder->finish(), caf::settings{});
+  CHECK_EQUAL(zm.fields_with_nulls.size(), 1u);
+  CHECK(check(zm, "x == 42"));
+  CHECK(!check(zm, "x == 43"));
+  MESSAGE("null values satisfy negated predicates");
+  CHECK(check(zm, "x != 42"));
+  CHECK(check(zm, "x !in [42]"));
+  CHECK(!check(zm, "x > 42"));
+}
+
+TEST(zone map connectives) {
+  auto zm = make_zone_map(make_slice(10, "foo"), caf::settings{});
+  CHECK(!check(zm, "x == 20 && s == \"foo\""));
+  CHECK(check(zm, "x == 15 && s == \"foo\""));
+  CHECK(check(zm, "x == 20 || s == \"foo\""));
+  CHECK(!check(zm, "x == 20 || x < 10"));
+  CHECK(check(zm, "! (x == 15)"));
+}
+
+TEST(zone map synopses) {
+  auto zm = make_zone_map(make_slice(10, "foo"), caf::settings{});
+  REQUIRE_EQUAL(zm.field_synopses.size(), 3u);
+  for (auto& [field, syn] : zm.field_synopses) {
+    if (field.field_name == "s")
+      CHECK(syn == nullptr);
+    else
+      CHECK(syn != nullptr);
+  }
+}
+
+TEST(zone map serialization) {
+  auto zm = make_zone_map(make_slice(10, "foo"), caf::settings{});
+  zm.offset = 42;
+  flatbuffers::FlatBufferBuilder builder;
+  auto offset = unbox(pack(builder, zm));
+  builder.Finish(offset);
+  auto fb = flatbuffers::GetRoot<fbs::zone_map::v0>(builder.GetBufferPointer());
+  REQUIRE(fb);
+  auto recovered = zone_map{};
+  REQUIRE_EQUAL(unpack(*fb, recovered), caf::none);
+  CHECK_EQUAL(recovered.offset, 42u);
+  CHECK_EQUAL(recovered.events, 10u);
+  CHECK_EQUAL(recovered.field_synopses.size(), 3u);
+  CHECK(check(recovered, "x == 15"));
+  CHECK(!check(recovered, "x == 20"));
+  CHECK(!check(recovered, "ts > 2000-01-01"));
+  CHECK(recovered.fields_with_nulls.empty());
+}
+
+FIXTURE_SCOPE_END()
@@ -34,12 +34,16 @@ synopsis_ptr
 make_address_synopsis(vast::type type, bloom_filter_parameters params,
                       std::vector<size_t> seeds = {});
 
-/// A synopsis for IP addresses.
 template <class HashFunction>
+synopsis_ptr
+make_blocked_address_synopsis(vast::type type, bloom_filter_parameters params);
+
+/// A synopsis for IP addresses.
+template <class HashFunction, class BloomFilter = bloom_filter<HashFunction>>
 class address_synopsis final
-  : public bloom_filter_synopsis<address, HashFunction> {
+  : public bloom_filter_synopsis<address, HashFunction, BloomFilter> {
 public:
-  using super = bloom_filter_synopsis<address, HashFunction>;
+  using super = bloom_filter_synopsis<address, HashFunction, BloomFilter>;
 
   /// Constructs an IP address synopsis from an `address_type` and a Bloom
   /// filter.
@@ -57,14 +61,18 @@ public:
   }
 };
 
+/// A IP address synopsis backed by a blocked Bloom filter.
+template <class HashFunction>
+using blocked_address_synopsis
+  = address_synopsis<HashFunction, blocked_bloom_filter<HashFunction>>;
+
 /// @relates buffered_synopsis_traits
 template <>
 struct buffered_synopsis_traits<vast::address> {
   template <typename HashFunction>
-  static synopsis_ptr make(vast::type type, bloom_filter_parameters p,
-                           std::vector<size_t> seeds = {}) {
-    return make_address_synopsis<HashFunction>(std::move(type), std::move(p),
-                                               std::move(seeds));
+  static synopsis_ptr make(vast::type type, bloom_filter_parameters p) {
+    return make_blocked_address_synopsis<HashFunction>(std::move(type),
+                                                       std::move(p));
   }
 
   // Estimate the size in bytes for an unordered_set of T.
@@ -100,6 +108,27 @@ make_address_synopsis(vast::type type, bloom_filter_parameters params,
   return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
 }
 
+/// Factory to construct an IP address synopsis backed by a blocked Bloom
+/// filter.
+/// @tparam HashFunction The hash function to use for the Bloom filter.
+/// @param type A type instance carrying an `address_type`.
+/// @param params The Bloom filter parameters.
+/// @returns A type-erased pointer to a synopsis.
+/// @pre `caf::holds_alternative<address_type>(type)`.
+/// @relates address_synopsis
+template <class HashFunction>
+synopsis_ptr
+make_blocked_address_synopsis(vast::type type, bloom_filter_parameters params) {
+  VAST_ASSERT(caf::holds_alternative<address_type>(type));
+  auto x = make_blocked_bloom_filter<HashFunction>(params);
+  if (!x) {
+    VAST_WARN("{} failed to construct blocked Bloom filter", __func__);
+    return nullptr;
+  }
+  using synopsis_type = blocked_address_synopsis<HashFunction>;
+  return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+}
+
 /// Factory to construct a buffered IP address synopsis.
 /// @tparam HashFunction The hash function to use for the Bloom filter.
 /// @param type A type instance carrying an `address_type`.
@@ -128,8 +157,14 @@ synopsis_ptr make_buffered_address_synopsis(vast::type type,
 template <class HashFunction>
 synopsis_ptr make_address_synopsis(vast::type type, const caf::settings& opts) {
   VAST_ASSERT(caf::holds_alternative<address_type>(type));
-  if (auto xs = parse_parameters(type))
+  if (auto xs = parse_parameters(type)) {
+    // Types annotated by older versions of VAST describe a standard Bloom
+    // filter; we keep reading them as such.
+    if (has_blocked_parameters(type))
+      return make_blocked_address_synopsis<HashFunction>(std::move(type),
+                                                        std::move(*xs));
     return make_address_synopsis<HashFunction>(std::move(type), std::move(*xs));
+  }
   // If no explicit Bloom filter parameters were attached to the type, we try
   // to use the maximum partition size of the index as upper bound for the
   // expected number of events.
@@ -143,15 +178,15 @@ synopsis_ptr make_address_synopsis(vast::type type, const caf::settings& opts) {
   params.n = *max_part_size;
   params.p = caf::get_or(opts, "address-synopsis-fp-rate",
                          defaults::system::address_synopsis_fp_rate);
-  auto annotated_type = annotate_parameters(type, params);
+  auto annotated_type = annotate_blocked_parameters(type, params);
   // Create either a a buffered_address_synopsis or a plain address synopsis
   // depending on the callers preference.
   auto buffered = caf::get_or(opts, "buffer-input-data", false);
   auto result
     = buffered
         ? make_buffered_address_synopsis<HashFunction>(std::move(type), params)
-        : make_address_synopsis<HashFunction>(std::move(annotated_type),
-                                              params);
+        : make_blocked_address_synopsis<HashFunction>(
+          std::move(annotated_type), params);
   if (!result)
     VAST_ERROR("{} failed to evaluate Bloom filter parameters: {} {}", __func__,
                params.n, params.p);
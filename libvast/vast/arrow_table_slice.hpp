@@ -14,6 +14,7 @@
 #pragma once
 
 #include "vast/fwd.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/table_slice.hpp"
 
 #include <caf/meta/type_name.hpp>
@@ -30,8 +31,11 @@ struct arrow_table_slice_state;
 
 template <>
 struct arrow_table_slice_state<fbs::table_slice::arrow::v0> {
-  /// The deserialized table layout.
-  record_type layout;
+  /// The interned table layout.
+  std::shared_ptr<const record_type> layout;
+
+  /// The fingerprint of the table layout.
+  layout_fingerprint layout_id;
 
   /// The deserialized Arrow Record Batch.
   std::shared_ptr<arrow::RecordBatch> record_batch;
@@ -52,7 +56,8 @@ public:
   /// a known layout.
   /// @param slice The encoding-specific FlatBuffers table.
   /// @param layout The table layout.
-  arrow_table_slice(const FlatBuffer& slice, record_type layout) noexcept;
+  arrow_table_slice(const FlatBuffer& slice,
+                    const record_type& layout) noexcept;
 
   /// Destroys a Arrow-encoded table slice.
   ~arrow_table_slice() noexcept;
@@ -70,6 +75,9 @@ public:
   /// @returns The table layout.
   const record_type& layout() const noexcept;
 
+  /// @returns The fingerprint of the table layout.
+  layout_fingerprint layout_id() const noexcept;
+
   /// @returns The number of rows in the slice.
   table_slice::size_type rows() const noexcept;
 
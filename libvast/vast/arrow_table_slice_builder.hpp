@@ -40,6 +40,18 @@ public:
     /// @returns `true` on success.
     virtual bool add(data_view x) = 0;
 
+    /// Reserves memory for adding a column of values in bulk.
+    /// @param xs The values to add.
+    /// @returns `true` on success.
+    /// @note The default implementation does not support bulk appends.
+    virtual bool reserve(const column_view& xs);
+
+    /// Adds a column of values to the column builder in bulk.
+    /// @param xs The values to add.
+    /// @returns `true` on success.
+    /// @pre `reserve(xs)`
+    virtual bool append(const column_view& xs);
+
     /// @returns An Arrow array from the accumulated calls to add.
     [[nodiscard]] virtual std::shared_ptr<arrow::Array> finish() = 0;
 
@@ -63,6 +75,18 @@ public:
   static table_slice_builder_ptr
   make(record_type layout, size_t initial_buffer_size = default_buffer_size);
 
+  /// Constructs an Arrow-encoded table slice from an existing record batch
+  /// without copying its values through column builders.
+  /// @param record_batch The record batch to encode.
+  /// @param layout The flat layout that corresponds to the schema of
+  /// *record_batch*.
+  /// @param initial_buffer_size The initial size of the FlatBuffers buffer.
+  /// @returns The table slice that wraps *record_batch*.
+  static table_slice
+  create(const std::shared_ptr<arrow::RecordBatch>& record_batch,
+         const record_type& layout,
+         size_t initial_buffer_size = default_buffer_size);
+
   /// Destroys an Arrow table slice builder.
   ~arrow_table_slice_builder() noexcept override;
 
@@ -99,6 +123,15 @@ private:
   /// @returns `true` on success.
   bool add_impl(data_view x) override;
 
+  /// Appends a columnar batch directly to the Arrow column builders.
+  /// @param columns The values of the columns.
+  /// @returns `true` on success.
+  bool append_columns_impl(span<const column_view> columns) override;
+
+  /// Encodes a record batch into a table slice.
+  table_slice finish(span<const std::byte> serialized_layout,
+                     const arrow::RecordBatch& record_batch);
+
   /// Current column index.
   size_t column_ = 0;
 
@@ -54,6 +54,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_atoms, caf::id_block::vast_types::end)
   VAST_ADD_ATOM(data, "data")
   VAST_ADD_ATOM(disable, "disable")
   VAST_ADD_ATOM(disconnect, "disconnect")
+  VAST_ADD_ATOM(distinct, "distinct")
   VAST_ADD_ATOM(done, "done")
   VAST_ADD_ATOM(election, "election")
   VAST_ADD_ATOM(empty, "empty")
@@ -80,6 +81,7 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_atoms, caf::id_block::vast_types::end)
   VAST_ADD_ATOM(persist, "persist")
   VAST_ADD_ATOM(ping, "ping")
   VAST_ADD_ATOM(pong, "pong")
+  VAST_ADD_ATOM(prefetch, "prefetch")
   VAST_ADD_ATOM(progress, "progress")
   VAST_ADD_ATOM(prompt, "prompt")
   VAST_ADD_ATOM(provision, "provision")
@@ -0,0 +1,258 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/bloom_filter_parameters.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/operators.hpp"
+#include "vast/hasher.hpp"
+#include "vast/span.hpp"
+
+#include <caf/meta/load_callback.hpp>
+#include <caf/meta/type_name.hpp>
+#include <caf/optional.hpp>
+#include <caf/sec.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace vast {
+
+/// A split-block Bloom filter for probabilistic set membership. Unlike
+/// `bloom_filter`, which spreads the *k* probe bits of an element over the
+/// entire bit vector, this filter maps every element to a single block of 256
+/// bits and sets exactly one bit in each of the 8 words of that block. A
+/// lookup thus touches a single cache line, and the 8 probes within a block
+/// are independent of each other so that the compiler can evaluate them in
+/// parallel with SIMD instructions.
+/// @tparam HashFunction The hash function to compute the 64-bit digests of
+///                      the elements with.
+template <class HashFunction>
+class blocked_bloom_filter
+  : detail::equality_comparable<blocked_bloom_filter<HashFunction>> {
+public:
+  using hash_function = HashFunction;
+  using digest_type = uint64_t;
+  using word_type = uint32_t;
+
+  /// The number of words per block.
+  static constexpr size_t words_per_block = 8;
+
+  /// The number of bits per block.
+  static constexpr size_t bits_per_block
+    = words_per_block * sizeof(word_type) * CHAR_BIT;
+
+  /// Constructs an empty blocked Bloom filter.
+  /// @param num_blocks The number of blocks in the filter.
+  /// @param seed The seed of the hash function.
+  explicit blocked_bloom_filter(size_t num_blocks = 0, size_t seed = 0)
+    : seed_{seed}, words_(num_blocks * words_per_block) {
+    VAST_ASSERT(num_blocks <= std::numeric_limits<uint32_t>::max());
+  }
+
+  /// Constructs a blocked Bloom filter from existing words.
+  /// @param words The bits of the filter.
+  /// @param seed The seed of the hash function.
+  /// @pre `words.size() % words_per_block == 0`
+  blocked_bloom_filter(std::vector<word_type> words, size_t seed)
+    : seed_{seed}, words_{std::move(words)} {
+    VAST_ASSERT(words_.size() % words_per_block == 0);
+  }
+
+  /// Adds an element to the filter.
+  /// @param x The element to add.
+  template <class T>
+  void add(const T& x) {
+    add_digest(digest(x));
+  }
+
+  /// Tests whether an element exists in the filter.
+  /// @param x The element to test.
+  /// @returns `false` if the *x* is not in the set and `true` if *x* may exist
+  ///          according to the false-positive probability of the filter.
+  template <class T>
+  bool lookup(const T& x) const {
+    return lookup_digest(digest(x));
+  }
+
+  /// Computes the digest that the filter derives the probe bits of an element
+  /// from.
+  /// @param x The element to hash.
+  template <class T>
+  digest_type digest(const T& x) const {
+    return detail::seeded_hash<hash_function>{seed_}(x);
+  }
+
+  /// Adds an element to the filter, given its digest.
+  /// @param x The digest of the element as returned by `digest`.
+  void add_digest(digest_type x) {
+    VAST_ASSERT(!words_.empty());
+    word_type mask[words_per_block];
+    make_mask(x, mask);
+    auto block = words_.data() + block_offset(x);
+    for (size_t i = 0; i < words_per_block; ++i)
+      block[i] |= mask[i];
+  }
+
+  /// Tests whether an element exists in the filter, given its digest.
+  /// @param x The digest of the element as returned by `digest`.
+  /// @returns The same result as `lookup` for the element that produced *x*.
+  bool lookup_digest(digest_type x) const {
+    if (words_.empty())
+      return false;
+    return probe(words_.data() + block_offset(x), x);
+  }
+
+  /// Tests whether any of a batch of elements exists in the filter, given
+  /// their digests. The blocks of a batch are located before any of them gets
+  /// probed, so that the memory accesses of successive probes are independent
+  /// of each other and can overlap.
+  /// @param xs The digests of the elements as returned by `digest`.
+  /// @returns `true` if any of the elements may exist in the filter.
+  bool lookup_any_digest(span<const digest_type> xs) const {
+    if (words_.empty())
+      return false;
+    constexpr size_t batch_size = 16;
+    const word_type* blocks[batch_size];
+    for (size_t first = 0; first < xs.size(); first += batch_size) {
+      auto n = std::min(batch_size, xs.size() - first);
+      for (size_t i = 0; i < n; ++i)
+        blocks[i] = words_.data() + block_offset(xs[first + i]);
+      for (size_t i = 0; i < n; ++i)
+        if (probe(blocks[i], xs[first + i]))
+          return true;
+    }
+    return false;
+  }
+
+  /// @returns The seed of the hash function.
+  size_t seed() const {
+    return seed_;
+  }
+
+  /// @returns The bits of the filter, in blocks of `words_per_block` words.
+  const std::vector<word_type>& words() const {
+    return words_;
+  }
+
+  /// @returns The number of blocks in the filter.
+  size_t num_blocks() const {
+    return words_.size() / words_per_block;
+  }
+
+  /// @returns The number of bits in the filter.
+  size_t size() const {
+    return words_.size() * sizeof(word_type) * CHAR_BIT;
+  }
+
+  /// @returns An estimate for amount of memory (in bytes) used by this filter.
+  size_t memusage() const {
+    return sizeof(blocked_bloom_filter) + words_.capacity() * sizeof(word_type);
+  }
+
+  // -- concepts --------------------------------------------------------------
+
+  friend bool
+  operator==(const blocked_bloom_filter& x, const blocked_bloom_filter& y) {
+    return x.seed_ == y.seed_ && x.words_ == y.words_;
+  }
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, blocked_bloom_filter& x) {
+    auto load_callback = caf::meta::load_callback([&]() -> caf::error {
+      if (x.words_.size() % words_per_block != 0)
+        return caf::sec::invalid_argument;
+      x.words_.shrink_to_fit();
+      return caf::none;
+    });
+    return f(caf::meta::type_name("blocked_bloom_filter"), x.seed_, x.words_,
+             std::move(load_callback));
+  }
+
+private:
+  /// Selects a block with the upper 32 bits of a digest, using a
+  /// multiplication instead of the more expensive modulo operation.
+  size_t block_offset(digest_type x) const {
+    auto block = ((x >> 32) * num_blocks()) >> 32;
+    return static_cast<size_t>(block) * words_per_block;
+  }
+
+  /// Derives one bit per word from the lower 32 bits of a digest.
+  static void make_mask(digest_type x, word_type (&mask)[words_per_block]) {
+    // These odd constants stem from the Parquet specification of split-block
+    // Bloom filters.
+    constexpr word_type salt[words_per_block] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    };
+    auto key = static_cast<word_type>(x);
+    for (size_t i = 0; i < words_per_block; ++i)
+      mask[i] = word_type{1} << ((key * salt[i]) >> 27);
+  }
+
+  /// Checks whether a block contains all bits of a digest. The loop has no
+  /// early exit on purpose, which allows for vectorizing it.
+  static bool probe(const word_type* block, digest_type x) {
+    word_type mask[words_per_block];
+    make_mask(x, mask);
+    word_type missing = 0;
+    for (size_t i = 0; i < words_per_block; ++i)
+      missing |= mask[i] & ~block[i];
+    return missing == 0;
+  }
+
+  size_t seed_;
+  std::vector<word_type> words_;
+};
+
+/// Constructs a blocked Bloom filter for a given set of parameters. The
+/// filter gets sized such that it meets the false-positive probability *p*
+/// for *n* elements, if both are given; otherwise it contains at least *m*
+/// bits. The number of hash functions *k* is always 8.
+/// @tparam HashFunction The hash function to use.
+/// @param xs The Bloom filter parameters.
+/// @param seed The seed for the hash function.
+/// @relates blocked_bloom_filter bloom_filter_parameters
+template <class HashFunction>
+caf::optional<blocked_bloom_filter<HashFunction>>
+make_blocked_bloom_filter(const bloom_filter_parameters& xs, size_t seed = 0) {
+  using result_type = blocked_bloom_filter<HashFunction>;
+  auto num_blocks = size_t{0};
+  if (xs.n && xs.p) {
+    if (*xs.n == 0 || *xs.p <= 0.0 || *xs.p >= 1.0)
+      return caf::none;
+    // Every word of a block acts as a partition of a Bloom filter with k = 8
+    // that receives one bit per element: p = (1 - e^(-n / (32 * blocks)))^8.
+    auto bits_per_word = static_cast<double>(
+      sizeof(typename result_type::word_type) * CHAR_BIT);
+    auto x = std::log1p(-std::pow(*xs.p, 1.0 / result_type::words_per_block));
+    num_blocks = static_cast<size_t>(
+      std::ceil(-static_cast<double>(*xs.n) / (bits_per_word * x)));
+  } else if (xs.m) {
+    num_blocks = (*xs.m + result_type::bits_per_block - 1)
+                 / result_type::bits_per_block;
+  } else {
+    return caf::none;
+  }
+  if (num_blocks == 0 || num_blocks > std::numeric_limits<uint32_t>::max())
+    return caf::none;
+  return result_type{num_blocks, seed};
+}
+
+} // namespace vast
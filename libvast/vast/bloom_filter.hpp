@@ -90,6 +90,29 @@ public:
     return true;
   }
 
+  /// Test whether an element exists in the Bloom filter, given the two base
+  /// digests that a `double_hasher` derives all *k* digests from. This allows
+  /// for hashing an element once and probing many filters with the result.
+  /// @param d1 The digest of the hash function seeded with the first seed.
+  /// @param d2 The digest of the hash function seeded with the second seed.
+  /// @returns The same result as `lookup(x)` for the element *x* that
+  ///          produced *d1* and *d2*.
+  /// @pre The hasher is a `double_hasher` whose seeds produced *d1* and *d2*.
+  template <class Digest>
+  bool lookup_digests(Digest d1, Digest d2) const {
+    static_assert(std::is_same_v<hasher_type, double_hasher<hash_function>>,
+                  "probing with base digests requires double hashing");
+    for (size_t i = 0; i < hasher_.size(); ++i)
+      if (!bits_[position(i, d1 + i * d2)])
+        return false;
+    return true;
+  }
+
+  /// @returns The hasher of the Bloom filter.
+  const hasher_type& hasher() const {
+    return hasher_;
+  }
+
   /// @returns The number of cells in the underlying bit vector.
   size_t size() const {
     return bits_.size();
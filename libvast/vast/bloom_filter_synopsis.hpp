@@ -13,7 +13,9 @@
 
 #pragma once
 
+#include "vast/blocked_bloom_filter.hpp"
 #include "vast/bloom_filter.hpp"
+#include "vast/membership_set.hpp"
 
 #include <caf/deserializer.hpp>
 #include <caf/optional.hpp>
@@ -22,14 +24,24 @@
 #include <vast/synopsis.hpp>
 #include <vast/type.hpp>
 
+#include <type_traits>
+#include <vector>
+
 namespace vast {
 
 /// A Bloom filter synopsis.
-template <class T, class HashFunction>
+/// @tparam T The type of the elements.
+/// @tparam HashFunction The hash function of the Bloom filter.
+/// @tparam BloomFilter The Bloom filter, either a `bloom_filter` or a
+///                     `blocked_bloom_filter`.
+template <class T, class HashFunction,
+          class BloomFilter = bloom_filter<HashFunction>>
 class bloom_filter_synopsis : public synopsis {
 public:
-  using bloom_filter_type = bloom_filter<HashFunction>;
-  using hasher_type = typename bloom_filter_type::hasher_type;
+  using bloom_filter_type = BloomFilter;
+
+  static constexpr bool is_blocked
+    = std::is_same_v<bloom_filter_type, blocked_bloom_filter<HashFunction>>;
 
   bloom_filter_synopsis(vast::type x, bloom_filter_type bf)
     : synopsis{std::move(x)}, bloom_filter_{std::move(bf)} {
@@ -59,6 +71,41 @@ public:
     }
   }
 
+  caf::optional<bool> lookup_any(const membership_set& xs) const override {
+    // Probe with the precomputed digests if the Bloom filter would derive its
+    // digests from the same hash functions; otherwise we must hash again.
+    constexpr bool has_precomputed_digests
+      = (std::is_same_v<T, std::string> || std::is_same_v<T, address>)
+        && std::is_same_v<HashFunction, membership_set::hash_function>;
+    if constexpr (has_precomputed_digests && is_blocked) {
+      // A blocked Bloom filter needs only the first digest, and probes the
+      // whole batch at once.
+      if (bloom_filter_.seed() == membership_set::seed1) {
+        auto& values = xs.values();
+        auto& digests = xs.digests();
+        auto batch = std::vector<typename bloom_filter_type::digest_type>{};
+        batch.reserve(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+          if (caf::holds_alternative<T>(values[i]))
+            batch.push_back(digests[i].h1);
+        return bloom_filter_.lookup_any_digest(batch);
+      }
+    } else if constexpr (has_precomputed_digests && uses_double_hashing()) {
+      auto seeds = bloom_filter_.hasher().seeds();
+      if (seeds.first == membership_set::seed1
+          && seeds.second == membership_set::seed2) {
+        auto& values = xs.values();
+        auto& digests = xs.digests();
+        for (size_t i = 0; i < values.size(); ++i)
+          if (caf::holds_alternative<T>(values[i])
+              && bloom_filter_.lookup_digests(digests[i].h1, digests[i].h2))
+            return true;
+        return false;
+      }
+    }
+    return synopsis::lookup_any(xs);
+  }
+
   bool equals(const synopsis& other) const noexcept override {
     if (typeid(other) != typeid(bloom_filter_synopsis))
       return false;
@@ -70,6 +117,11 @@ public:
     return bloom_filter_.memusage();
   }
 
+  /// @returns The underlying Bloom filter.
+  const bloom_filter_type& filter() const {
+    return bloom_filter_;
+  }
+
   caf::error serialize(caf::serializer& sink) const override {
     return sink(bloom_filter_);
   }
@@ -79,7 +131,16 @@ public:
   }
 
 protected:
-  bloom_filter<HashFunction> bloom_filter_;
+  bloom_filter_type bloom_filter_;
+
+private:
+  static constexpr bool uses_double_hashing() {
+    if constexpr (is_blocked)
+      return false;
+    else
+      return std::is_same_v<typename bloom_filter_type::hasher_type,
+                            double_hasher<HashFunction>>;
+  }
 };
 
 // Because VAST deserializes a synopsis with empty options and
@@ -91,8 +152,22 @@ protected:
 ///          attribute. Note that all previous attributes are discarded.
 type annotate_parameters(type type, const bloom_filter_parameters& params);
 
+/// Creates a new type annotation for a blocked Bloom filter from a set of
+/// Bloom filter parameters.
+/// @returns The provided type with a new `#synopsis=blocked_bloomfilter(n,p)`
+///          attribute. Note that all previous attributes are discarded.
+type annotate_blocked_parameters(type type,
+                                 const bloom_filter_parameters& params);
+
+/// Checks whether the Bloom filter parameters of a type describe a blocked
+/// Bloom filter, i.e., whether the type has an attribute of the form
+/// `#synopsis=blocked_bloomfilter(n,p)`.
+/// @param x The type whose attributes to check.
+/// @relates bloom_filter_synopsis
+bool has_blocked_parameters(const type& x);
+
 /// Parses Bloom filter parameters from type attributes of the form
-/// `#synopsis=bloom_filter(n,p)`.
+/// `#synopsis=bloom_filter(n,p)` or `#synopsis=blocked_bloomfilter(n,p)`.
 /// @param x The type whose attributes to parse.
 /// @returns The parsed and evaluated Bloom filter parameters.
 /// @relates bloom_filter_synopsis
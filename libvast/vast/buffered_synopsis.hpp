@@ -15,6 +15,7 @@
 
 #include "vast/bloom_filter_parameters.hpp"
 #include "vast/bloom_filter_synopsis.hpp"
+#include "vast/membership_set.hpp"
 #include "vast/synopsis.hpp"
 
 #include <vast/error.hpp>
@@ -24,11 +25,9 @@ namespace vast {
 // TODO: Turn this into a concept when we support C++20.
 template <typename T>
 struct buffered_synopsis_traits {
-  // Create a new bloom filter synopsis from the given parameters
+  // Create a new blocked bloom filter synopsis from the given parameters
   template <typename HashFunction>
-  static synopsis_ptr make(vast::type type, bloom_filter_parameters p,
-                           std::vector<size_t> seeds = {})
-    = delete;
+  static synopsis_ptr make(vast::type type, bloom_filter_parameters p) = delete;
 
   // Estimate the size in bytes for an unordered_set of T.
   static size_t memusage(const std::unordered_set<T>&) = delete;
@@ -58,7 +57,7 @@ public:
     params.p = p_;
     params.n = next_power_of_two;
     VAST_DEBUG("shrinks buffered synopsis to {} elements", params.n);
-    auto type = annotate_parameters(this->type(), params);
+    auto type = annotate_blocked_parameters(this->type(), params);
     // TODO: If we can get rid completely of the `address_synopsis` and
     // `string_synopsis` types, we could also call the correct constructor here.
     auto shrunk_synopsis
@@ -102,6 +101,15 @@ public:
     }
   }
 
+  caf::optional<bool> lookup_any(const membership_set& xs) const override {
+    // The elements of the set are already materialized, so we can probe the
+    // buffered data directly without materializing the views of a list.
+    for (auto& x : xs.values())
+      if (auto y = caf::get_if<T>(&x); y && data_.count(*y))
+        return true;
+    return false;
+  }
+
   caf::error serialize(caf::serializer&) const override {
     return caf::make_error(ec::logic_error, "attempted to serialize a "
                                             "buffered_string_synopsis; did you "
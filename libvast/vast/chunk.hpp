@@ -130,6 +130,11 @@ public:
   ///          i.e. how much of the chunk is "paged-in".
   caf::expected<chunk::size_type> incore() const noexcept;
 
+  /// Advises the operating system that the chunk will be accessed in the near
+  /// future, allowing it to page in the underlying memory asynchronously.
+  /// @returns An error if the advice could not be given.
+  caf::error prefetch() const noexcept;
+
   /// @returns A pointer to the first byte in the chunk.
   iterator begin() const noexcept;
 
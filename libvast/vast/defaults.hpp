@@ -248,24 +248,75 @@ constexpr caf::timespan aging_frequency = std::chrono::hours{24};
 /// Interval between two disk scanning cycles.
 constexpr std::chrono::seconds disk_scan_interval = std::chrono::minutes{1};
 
+/// Interval between two compaction cycles.
+constexpr caf::timespan compaction_interval = std::chrono::minutes{10};
+
+/// Partitions with at most this fraction of the maximum partition size are
+/// subject to compaction.
+constexpr double compaction_threshold = 0.25;
+
+/// Time without new table slices after which the INDEX considers ingestion
+/// idle enough for compaction.
+constexpr std::chrono::seconds compaction_ingest_pause
+  = std::chrono::seconds{5};
+
+/// The backend of the FILESYSTEM actor; either "posix" or "io_uring".
+constexpr std::string_view filesystem_backend = "posix";
+
+/// Number of submission queue entries of the io_uring FILESYSTEM backend.
+constexpr size_t uring_queue_depth = 64;
+
+/// Size of the individual reads and writes that the io_uring FILESYSTEM
+/// backend submits for a single request.
+constexpr size_t uring_block_size = 1'048'576; // 1_Mi
+
+/// Minimum size of a write for which the io_uring FILESYSTEM backend bypasses
+/// the page cache with O_DIRECT.
+constexpr size_t uring_direct_io_threshold = 16 * 1'024 * 1'024; // 16_Mi
+
 /// Maximum number of events per INDEX partition.
 constexpr size_t max_partition_size = 1'048'576; // 1_Mi
 
+/// Number of concurrently active INDEX partitions.
+constexpr size_t active_partitions = 1;
+
+/// Policy for distributing table slices over the active INDEX partitions.
+constexpr const char* partition_sharding = "round-robin";
+
+/// Time after which the INDEX seals an active partition that is not full.
+/// Applies only to homogeneous sharding unless configured explicitly.
+constexpr std::chrono::seconds active_partition_timeout = std::chrono::hours{1};
+
 /// Maximum number of in-memory INDEX partitions.
 constexpr size_t max_in_mem_partitions = 10;
 
+/// Maximum memory usage of the INDEX query result cache in bytes. A value of
+/// zero disables the cache.
+constexpr size_t result_cache_size = 64 * 1'024 * 1'024; // 64_Mi
+
 /// Number of immediately scheduled INDEX partitions.
 constexpr size_t taste_partitions = 5;
 
 /// Maximum number of concurrent INDEX queries.
 constexpr size_t num_query_supervisors = 10;
 
+/// Number of idle query supervisors that the INDEX keeps for new queries.
+constexpr size_t idle_query_supervisors = 2;
+
+/// Time without dispatched query requests after which the INDEX shuts down
+/// the idle query supervisors beyond `idle_query_supervisors`.
+constexpr std::chrono::seconds idle_query_supervisor_timeout
+  = std::chrono::minutes{1};
+
 /// Number of cached ARCHIVE segments.
 constexpr size_t segments = 10;
 
 /// Maximum size of ARCHIVE segments in MiB.
 constexpr size_t max_segment_size = 1'024;
 
+/// Maximum size of the files of the IMPORTER's ingest journal in MiB.
+constexpr size_t max_journal_file_size = 64;
+
 /// Number of initial IDs to request in the IMPORTER.
 constexpr size_t initially_requested_ids = 128;
 
@@ -297,6 +348,11 @@ constexpr double address_synopsis_fp_rate = 0.01;
 /// The allowed false positive rate for a string_synopsis.
 constexpr double string_synopsis_fp_rate = 0.01;
 
+/// The precision of the HyperLogLog sketches that estimate the number of
+/// distinct values per field and partition. Every sketch takes 2^precision
+/// bytes. A value of zero disables the sketches.
+constexpr size_t hyperloglog_precision = 0;
+
 } // namespace system
 
 } // namespace vast::defaults
@@ -0,0 +1,55 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include <string_view>
+
+namespace vast::detail {
+
+// The fast-path kernels below parse an entire field of the most common input
+// formats without the overhead of the parser combinators. Each kernel returns
+// `false` if the field is not in the format it supports, in which case the
+// caller must fall back to the corresponding generic parser. A kernel that
+// succeeds produces the exact same value as the generic parser.
+
+/// Parses an unsigned decimal integer, like `parsers::u64`.
+bool fast_parse_count(std::string_view x, count& result) noexcept;
+
+/// Parses a signed decimal integer, like `parsers::i64`.
+bool fast_parse_integer(std::string_view x, integer& result) noexcept;
+
+/// Parses a decimal real number, like `parsers::real` or
+/// `parsers::real_opt_dot`.
+/// @param require_dot Whether the number must contain a decimal point.
+bool fast_parse_real(std::string_view x, real& result,
+                     bool require_dot = true) noexcept;
+
+/// Parses fractional seconds, like `parsers::real` followed by a conversion
+/// from double-precision seconds. This is how Zeek logs render timestamps
+/// and intervals.
+bool fast_parse_seconds(std::string_view x, duration& result) noexcept;
+
+/// Parses an ISO 8601 timestamp of the form `YYYY-MM-DDTHH:MM:SS[.f][Z]`,
+/// like `parsers::ymdhms`. The date and time may also be separated by a space
+/// or `+`.
+bool fast_parse_ymdhms(std::string_view x, time& result) noexcept;
+
+/// Parses an IPv4 address in dotted-quad notation or an IPv6 address, like
+/// `parsers::addr`. IPv6 addresses with an embedded IPv4 address are left to
+/// the generic parser.
+bool fast_parse_address(std::string_view x, address& result) noexcept;
+
+} // namespace vast::detail
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/synopsis.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <optional>
+
+namespace vast {
+
+/// A synopsis for an [enumeration type](@ref enumeration_type) that records
+/// the set of values in a bitmask.
+class enumeration_synopsis final : public synopsis {
+public:
+  /// The number of distinct values of an enumeration.
+  static constexpr size_t capacity = 256;
+
+  /// The bitmask in blocks of 64 bits, as stored in the flatbuffer.
+  using words_type = std::array<uint64_t, capacity / 64>;
+
+  explicit enumeration_synopsis(vast::type x);
+
+  explicit enumeration_synopsis(const words_type& words);
+
+  void add(data_view x) override;
+
+  /// @note The RHS must consist of the numeric values of the enumeration. The
+  /// META INDEX translates the names of enumeration values before the lookup.
+  caf::optional<bool>
+  lookup(relational_operator op, data_view rhs) const override;
+
+  bool equals(const synopsis& other) const noexcept override;
+
+  size_t memusage() const override;
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  const std::bitset<capacity>& values() const noexcept;
+
+  words_type words() const noexcept;
+
+private:
+  std::bitset<capacity> values_;
+};
+
+/// Enumeration columns hold the index of a value in the enumeration type, but
+/// predicates refer to the values by name. Translates the names on the RHS of
+/// a predicate into indexes for looking up the synopsis of such a column.
+/// @returns the translated RHS, or `std::nullopt` if *t* is not an
+/// enumeration type.
+std::optional<data> translate_enumeration(const type& t, const data& rhs);
+
+} // namespace vast
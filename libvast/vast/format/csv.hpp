@@ -13,7 +13,6 @@
 
 #pragma once
 
-#include "vast/concept/parseable/core/rule.hpp"
 #include "vast/concept/printable/core.hpp"
 #include "vast/concept/printable/numeric.hpp"
 #include "vast/concept/printable/string.hpp"
@@ -21,6 +20,7 @@
 #include "vast/config.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/line_range.hpp"
+#include "vast/format/field_parser.hpp"
 #include "vast/format/ostream_writer.hpp"
 #include "vast/format/single_layout_reader.hpp"
 #include "vast/schema.hpp"
@@ -57,8 +57,7 @@ private:
 class reader final : public single_layout_reader {
 public:
   using super = single_layout_reader;
-  using iterator_type = std::string::const_iterator;
-  using parser_type = type_erased_parser<iterator_type>;
+  using iterator_type = field_parser::iterator_type;
 
   /// Constructs a CSV reader.
   /// @param options Additional options.
@@ -87,13 +86,16 @@ private:
   };
   caf::optional<record_type> make_layout(const std::vector<std::string>& names);
 
-  caf::expected<parser_type> read_header(std::string_view line);
+  caf::error read_header(std::string_view line);
+
+  bool parse_line(std::string_view line);
 
   std::unique_ptr<std::istream> input_;
   std::unique_ptr<detail::line_range> lines_;
   vast::schema schema_;
   std::vector<rec_table> records;
-  caf::optional<parser_type> parser_;
+  std::vector<field_parser> parsers_;
+  std::vector<data> row_;
   options opt_;
   mutable size_t num_lines_ = 0;
   mutable size_t num_invalid_lines_ = 0;
@@ -0,0 +1,94 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/concept/parseable/core/rule.hpp"
+#include "vast/data.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vast::format {
+
+/// Parses the fields of line-based formats, such as CSV and Zeek TSV. The
+/// parser inspects the field type once on construction and then handles the
+/// common scalar types with the specialized kernels from
+/// `vast/detail/fast_parse.hpp` instead of going through a type-erased
+/// parser for every field. Input that the kernels do not support goes
+/// through a generic fallback rule with identical results.
+class field_parser {
+public:
+  using iterator_type = std::string_view::const_iterator;
+  using rule_type = rule<iterator_type, data>;
+
+  /// The format whose field syntax the parser follows.
+  enum class dialect {
+    csv,  ///< Timestamps in ISO 8601, verbatim strings, optional fields.
+    zeek, ///< Timestamps in fractional seconds, byte-escaped strings.
+  };
+
+  field_parser() = default;
+
+  /// Constructs a field parser.
+  /// @param t The type of the field.
+  /// @param d The dialect of the field.
+  /// @param fallback The generic parser for the field.
+  field_parser(const type& t, dialect d, rule_type fallback);
+
+  /// Parses an entire field.
+  /// @param field The field to parse.
+  /// @param x The parsed data.
+  /// @returns `true` on success.
+  bool parse(std::string_view field, data& x) const;
+
+  /// Parses a field at the beginning of a CSV line. A field that fails to
+  /// parse yields `caf::none`, except for enumerations.
+  /// @param input The remainder of the line, which the function advances
+  ///              to the end of the field.
+  /// @param separator The field separator.
+  /// @param x The parsed data.
+  /// @returns `true` on success.
+  bool parse_prefix(std::string_view& input, char separator, data& x) const;
+
+private:
+  enum class kind {
+    fallback,
+    boolean,
+    integer,
+    count,
+    real,
+    scaled_duration,
+    seconds,
+    unix_time,
+    ymdhms,
+    string,
+    escaped_string,
+    pattern,
+    enumeration,
+    address,
+  };
+
+  // Returns `false` if the field is not in the format of the kernel.
+  bool parse_fast(std::string_view field, data& x) const;
+
+  kind kind_ = kind::fallback;
+  duration (*scale_)(double) = nullptr;
+  std::vector<std::string> enumeration_;
+  rule_type fallback_;
+};
+
+} // namespace vast::format
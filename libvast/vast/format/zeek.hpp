@@ -22,6 +22,7 @@
 #include "vast/defaults.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/format/field_parser.hpp"
 #include "vast/format/ostream_writer.hpp"
 #include "vast/format/reader.hpp"
 #include "vast/format/single_layout_reader.hpp"
@@ -249,7 +250,7 @@ private:
   type type_;
   record_type layout_;
   caf::optional<size_t> proto_field_;
-  std::vector<rule<iterator_type, data>> parsers_;
+  std::vector<field_parser> parsers_;
 };
 
 /// A Zeek writer.
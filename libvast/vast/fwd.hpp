@@ -74,7 +74,9 @@ class command;
 class data;
 class ewah_bitstream;
 class expression;
+class ingest_journal;
 class json;
+class membership_set;
 class msgpack_table_slice_builder;
 class path;
 class pattern;
@@ -255,10 +257,13 @@ struct data_point;
 struct measurement;
 struct node_state;
 struct performance_sample;
+struct query_profile;
 struct query_status;
 struct query_status;
 struct spawn_arguments;
 
+enum class query_order : uint8_t;
+enum class query_priority : uint8_t;
 enum class status_verbosity;
 
 using performance_report = std::vector<performance_sample>;
@@ -308,15 +313,21 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_types, caf::first_custom_type_id)
   VAST_ADD_TYPE_ID((vast::detail::stable_map<vast::data, vast::data>) )
 
   VAST_ADD_TYPE_ID((vast::system::performance_report))
+  VAST_ADD_TYPE_ID((vast::system::query_order))
+  VAST_ADD_TYPE_ID((vast::system::query_priority))
+  VAST_ADD_TYPE_ID((vast::system::query_profile))
   VAST_ADD_TYPE_ID((vast::system::query_status))
   VAST_ADD_TYPE_ID((vast::system::report))
   VAST_ADD_TYPE_ID((vast::system::status_verbosity))
 
   VAST_ADD_TYPE_ID((std::pair<std::string, vast::data>) )
   VAST_ADD_TYPE_ID((std::vector<uint32_t>) )
+  VAST_ADD_TYPE_ID((std::vector<uint64_t>) )
   VAST_ADD_TYPE_ID((std::vector<std::string>) )
+  VAST_ADD_TYPE_ID((std::vector<vast::path>) )
   VAST_ADD_TYPE_ID((std::vector<vast::table_slice>) )
   VAST_ADD_TYPE_ID((std::vector<vast::table_slice_column>) )
+  VAST_ADD_TYPE_ID((std::vector<vast::time>) )
   VAST_ADD_TYPE_ID((std::vector<vast::uuid>) )
 
   VAST_ADD_TYPE_ID((caf::stream<vast::table_slice>) )
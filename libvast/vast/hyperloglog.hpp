@@ -0,0 +1,96 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/detail/operators.hpp"
+#include "vast/fbs/synopsis.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/meta/type_name.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vast {
+
+/// A HyperLogLog sketch that estimates the number of distinct elements in a
+/// multiset. The relative standard error of the estimate is about
+/// `1.04 / sqrt(2^p)` for a precision *p*. Sketches are mergeable: the merge of
+/// two sketches is the sketch of the union of their elements.
+class hyperloglog : detail::equality_comparable<hyperloglog> {
+public:
+  /// The smallest supported precision.
+  static constexpr uint8_t min_precision = 4;
+
+  /// The largest supported precision.
+  static constexpr uint8_t max_precision = 16;
+
+  /// Constructs an empty sketch.
+  /// @param precision The number of hash bits that select a register. The
+  ///        sketch consists of `2^precision` registers of one byte each.
+  /// @pre `min_precision <= precision && precision <= max_precision`
+  explicit hyperloglog(uint8_t precision = min_precision);
+
+  /// Adds an element to the sketch.
+  /// @param digest The 64-bit hash digest of the element.
+  void add(uint64_t digest);
+
+  /// Merges another sketch into this one. If the precisions differ, the
+  /// result has the smaller precision of the two.
+  /// @param other The sketch to merge.
+  void merge(const hyperloglog& other);
+
+  /// Reduces the precision of the sketch. The result equals a sketch of the
+  /// same elements that had the smaller precision from the start.
+  /// @param precision The new precision.
+  /// @pre `min_precision <= precision && precision <= this->precision()`
+  void fold(uint8_t precision);
+
+  /// @returns The estimated number of distinct elements.
+  uint64_t estimate() const;
+
+  /// @returns The number of hash bits that select a register.
+  uint8_t precision() const noexcept;
+
+  /// @returns A best-effort estimate of the memory usage in bytes.
+  size_t memusage() const;
+
+  friend bool operator==(const hyperloglog& x, const hyperloglog& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, hyperloglog& x) {
+    return f(caf::meta::type_name("vast.hyperloglog"), x.precision_,
+             x.registers_);
+  }
+
+  // -- flatbuffer -------------------------------------------------------------
+
+  friend caf::expected<flatbuffers::Offset<fbs::hyperloglog::v0>>
+  pack(flatbuffers::FlatBufferBuilder& builder, const hyperloglog& x);
+
+  friend caf::error unpack(const fbs::hyperloglog::v0& x, hyperloglog& y);
+
+private:
+  uint8_t precision_;
+
+  /// For every register, the largest position of the first set bit in the
+  /// remaining hash bits of the elements that map to it, or 0 if none does.
+  std::vector<uint8_t> registers_;
+};
+
+} // namespace vast
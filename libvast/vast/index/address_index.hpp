@@ -50,6 +50,10 @@ private:
 
   size_t memusage_impl() const override;
 
+  /// Looks up a list of addresses in bulk under `in` or `not_in`.
+  caf::expected<ids>
+  lookup_membership(relational_operator op, view<list> xs) const;
+
   std::array<byte_index, 16> bytes_;
   type_index v4_;
 };
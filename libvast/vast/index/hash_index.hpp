@@ -215,16 +215,18 @@ private:
       return op == relational_operator::equal ? scan(eq) : scan(ne);
     }
     if (op == relational_operator::in || op == relational_operator::not_in) {
-      // Ensure that the RHS is a list of strings.
+      // Ensure that the RHS is a list, and hash each of its elements once into
+      // a set of digests that we can probe in constant time during the scan.
+      using key_set = std::unordered_set<key, key_hasher>;
       auto keys = caf::visit(
         detail::overload{
-          [&](auto xs) -> caf::expected<std::vector<key>> {
+          [&](auto xs) -> caf::expected<key_set> {
             using view_type = decltype(xs);
             if constexpr (std::is_same_v<view_type, view<list>>) {
-              std::vector<key> result;
+              key_set result;
               result.reserve(xs.size());
               for (auto x : xs)
-                result.emplace_back(find_digest(x));
+                result.insert(find_digest(x));
               return result;
             } else {
               return caf::make_error(ec::type_clash, "expected list on RHS",
@@ -237,12 +239,10 @@ private:
         return keys.error();
       // We're good to go with: create the set predicates an run the scan.
       auto in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::any_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) > 0;
       };
       auto not_in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::none_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) == 0;
       };
       return op == relational_operator::in ? scan(in_pred) : scan(not_in_pred);
     }
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/error.hpp"
+#include "vast/ewah_bitmap.hpp"
+#include "vast/ids.hpp"
+#include "vast/value_index.hpp"
+#include "vast/view.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+#include <caf/meta/type_name.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vast {
+
+/// An index for timestamps that exploits that events arrive almost sorted by
+/// time. The index splits the column into *runs* of consecutive IDs and stores
+/// each run as a sequence of zig-zag and variable-byte encoded deltas between
+/// neighboring values. Every run consists of blocks of `block_size` values
+/// with their minimum and maximum, such that a lookup can skip or fill whole
+/// blocks and only decodes the blocks at the boundary of the queried range.
+/// A run whose values are sorted answers lookups with a binary search over its
+/// blocks followed by a bitmap range fill.
+class time_index : public value_index {
+public:
+  /// The number of values per block.
+  static constexpr size_t block_size = 64;
+
+  /// A sequence of up to `block_size` values in a run.
+  struct block {
+    /// The smallest value in the block.
+    int64_t min;
+
+    /// The largest value in the block.
+    int64_t max;
+
+    /// The first value in the block, from which decoding starts.
+    int64_t first;
+
+    /// The offset of the delta of the second value in the encoded bytes.
+    uint64_t offset;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, block& x) {
+      return f(caf::meta::type_name("vast.time_index.block"), x.min, x.max,
+               x.first, x.offset);
+    }
+  };
+
+  /// A sequence of values with consecutive IDs.
+  struct run {
+    /// The ID of the first value.
+    id first;
+
+    /// The number of values.
+    uint64_t size;
+
+    /// The index of the first block of this run.
+    uint64_t blocks;
+
+    /// Whether the values are sorted in ascending order.
+    bool sorted;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, run& x) {
+      return f(caf::meta::type_name("vast.time_index.run"), x.first, x.size,
+               x.blocks, x.sorted);
+    }
+  };
+
+  /// Constructs a time index.
+  /// @param t A time type.
+  /// @param opts Runtime context for index parameterization.
+  explicit time_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  size_t memusage_impl() const override;
+
+  /// Computes the IDs of all values in the closed interval *[lo, hi]*.
+  ids lookup_range(int64_t lo, int64_t hi) const;
+
+  std::vector<run> runs_;
+  std::vector<block> blocks_;
+  std::vector<uint8_t> deltas_;
+  int64_t last_ = 0;
+};
+
+} // namespace vast
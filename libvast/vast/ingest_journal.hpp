@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/aliases.hpp"
+#include "vast/path.hpp"
+
+#include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vast {
+
+/// @relates ingest_journal
+using ingest_journal_ptr = std::unique_ptr<ingest_journal>;
+
+/// A write-ahead log for imported table slices. The journal appends slices to
+/// a sequence of files in a directory, and makes them durable in groups with
+/// a single `fdatasync(2)` per commit. A journal file is discarded once all of
+/// its slices were persisted by the components downstream.
+///
+/// Each file consists of a sequence of records with the following layout,
+/// where all integers are in native byte order:
+///
+///     +--------+--------+----------+-------------------+
+///     |  size  | offset | checksum | table slice bytes |
+///     +--------+--------+----------+-------------------+
+///       uint64   uint64   uint64     size bytes
+///
+/// Records are padded with zeros to a multiple of 8 bytes, which keeps the
+/// FlatBuffers tables of the table slices aligned when reading them back.
+/// The checksum is the XXH64 digest of the table slice bytes. A record that
+/// is incomplete or fails verification terminates its file, since it can only
+/// be the result of a crash while writing.
+class ingest_journal {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Opens the journal in a directory.
+  /// @param dir The directory that holds the journal files.
+  /// @param max_file_size The size in bytes after which the journal starts a
+  ///        new file.
+  /// @returns The journal, or an error if *dir* is not usable.
+  static caf::expected<ingest_journal_ptr>
+  make(path dir, size_t max_file_size);
+
+  ~ingest_journal() noexcept;
+
+  ingest_journal(const ingest_journal&) = delete;
+  ingest_journal& operator=(const ingest_journal&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// @returns the number of bytes that await the next commit.
+  size_t pending() const noexcept;
+
+  /// @returns the number of files in the journal.
+  size_t files() const noexcept;
+
+  /// @returns the number of bytes in all journal files.
+  size_t size() const noexcept;
+
+  /// @returns the number of commits since opening the journal.
+  size_t commits() const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Reads back all journaled table slices in the order they were appended.
+  /// Truncates the files after the last valid record, and closes the journal
+  /// for further appends to existing files.
+  /// @returns The recovered slices.
+  caf::expected<std::vector<table_slice>> replay();
+
+  /// Buffers a table slice for the next commit.
+  /// @param slice The slice to append.
+  /// @pre `slice.offset() != invalid_id`
+  void append(const table_slice& slice);
+
+  /// Writes all buffered slices and waits for them to become durable. On
+  /// failure, the current file is truncated to its last complete commit and
+  /// the slices stay buffered.
+  /// @returns An error if writing or syncing failed.
+  caf::error commit();
+
+  /// Removes all files that only contain slices with IDs below a watermark.
+  /// @param watermark The lowest ID that is not yet persisted elsewhere.
+  /// @returns An error if removing a file failed.
+  caf::error truncate(id watermark);
+
+private:
+  /// A single file of the journal.
+  struct file_info {
+    vast::path path;
+    id first = invalid_id;
+    id last = 0; ///< One past the highest contained ID.
+    size_t size = 0;
+  };
+
+  ingest_journal(path dir, size_t max_file_size);
+
+  /// Opens a new file for the next commit.
+  caf::error rotate();
+
+  path dir_;
+  size_t max_file_size_;
+  std::vector<file_info> files_;
+  int fd_ = -1;
+  std::vector<std::byte> buffer_;
+  id buffer_first_ = invalid_id;
+  id buffer_last_ = 0;
+  size_t commits_ = 0;
+};
+
+} // namespace vast
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/fwd.hpp"
+#include "vast/span.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vast {
+
+/// A stable 64-bit identifier of a table layout. The value 0 is reserved for
+/// table slices that predate layout fingerprints.
+using layout_fingerprint = uint64_t;
+
+/// Computes the fingerprint of a CAF-serialized layout.
+/// @param serialized_layout The CAF-serialized layout.
+/// @returns The fingerprint of *serialized_layout*; never 0.
+layout_fingerprint
+fingerprint(span<const std::byte> serialized_layout) noexcept;
+
+/// A process-wide registry that maps layout fingerprints to a single shared
+/// instance of the corresponding layout. Table slices look up their layout
+/// here instead of deserializing it for every slice.
+/// @note Layouts are never evicted, since the number of distinct layouts is
+/// bounded by the schema.
+/// @note A fingerprint only identifies a layout if the interner saw no other
+/// layout with the same fingerprint before. The interner verifies every match
+/// against the full layout, and hands out an uninterned copy for layouts whose
+/// fingerprint collides with an interned one.
+class layout_interner {
+public:
+  /// @returns The process-wide interner.
+  static layout_interner& instance() noexcept;
+
+  /// Retrieves the layout for a fingerprint, deserializing it only if it was
+  /// not seen before.
+  /// @param id The fingerprint of *serialized_layout*.
+  /// @param serialized_layout The CAF-serialized layout.
+  /// @returns The interned layout, or `nullptr` if deserialization failed.
+  std::shared_ptr<const record_type>
+  intern(layout_fingerprint id, span<const std::byte> serialized_layout);
+
+  /// Retrieves the layout for a fingerprint, copying *layout* only if it was
+  /// not seen before.
+  /// @param id The fingerprint of *layout*.
+  /// @param layout The known layout.
+  /// @returns The interned layout.
+  std::shared_ptr<const record_type>
+  intern(layout_fingerprint id, const record_type& layout);
+
+  /// Retrieves a previously interned layout.
+  /// @param id The fingerprint of the layout.
+  /// @returns The interned layout, or `nullptr` if *id* is unknown.
+  std::shared_ptr<const record_type> find(layout_fingerprint id) const;
+
+  /// Resolves the layout of an encoded table slice, which either embeds its
+  /// layout or references a layout that was interned from the layout
+  /// dictionary of its segment.
+  /// @param id The fingerprint stored in the slice, or 0 if absent.
+  /// @param serialized_layout The embedded layout, or an empty span if the
+  /// slice references its layout by fingerprint only.
+  /// @returns The fingerprint and the interned layout; the latter is `nullptr`
+  /// if the layout could not be resolved.
+  std::pair<layout_fingerprint, std::shared_ptr<const record_type>>
+  resolve(layout_fingerprint id, span<const std::byte> serialized_layout);
+
+  /// @returns The number of interned layouts.
+  size_t size() const;
+
+private:
+  /// An interned layout.
+  struct entry {
+    /// The shared instance of the layout.
+    std::shared_ptr<const record_type> layout;
+
+    /// The CAF-serialized layout, or empty if the layout was interned from a
+    /// deserialized instance and not seen in serialized form yet.
+    std::vector<std::byte> serialized_layout;
+  };
+
+  layout_interner() = default;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<layout_fingerprint, entry> layouts_;
+};
+
+} // namespace vast
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/concept/hashable/xxhash.hpp"
+#include "vast/data.hpp"
+#include "vast/view.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace vast {
+
+/// The set of values on the RHS of a bulk membership predicate, e.g., a large
+/// list of indicators in `:addr in [...]`. The set sorts and deduplicates its
+/// elements once at construction and computes the base digests that Bloom
+/// filters with a `double_hasher` derive their probe positions from, so that
+/// probing many synopses with the same set does not hash every element again.
+class membership_set {
+public:
+  /// The hash function of the precomputed digests.
+  using hash_function = xxhash64;
+
+  /// The type of a single digest.
+  using digest_type = hash_function::result_type;
+
+  /// The seeds of the two hash functions that produce the base digests. These
+  /// are the default seeds of the `double_hasher`.
+  static constexpr size_t seed1 = 0;
+  static constexpr size_t seed2 = 1;
+
+  /// The two base digests of an element.
+  struct digest_pair {
+    digest_type h1 = 0;
+    digest_type h2 = 0;
+  };
+
+  membership_set() = default;
+
+  /// Constructs a membership set from a list of values.
+  /// @param xs The values in the set.
+  explicit membership_set(view<list> xs);
+
+  /// @returns The sorted and deduplicated elements.
+  const list& values() const noexcept;
+
+  /// @returns The base digests of all elements, in the order of `values()`.
+  /// Only string and address elements have non-zero digests, because only
+  /// those have Bloom filter synopses.
+  const std::vector<digest_pair>& digests() const noexcept;
+
+  /// @returns The number of elements in the set.
+  size_t size() const noexcept;
+
+  /// @returns Whether the set is empty.
+  bool empty() const noexcept;
+
+  /// Tests whether the set contains an element.
+  /// @param x The element to look for.
+  bool contains(const data& x) const;
+
+private:
+  list values_;
+  std::vector<digest_pair> digests_;
+};
+
+} // namespace vast
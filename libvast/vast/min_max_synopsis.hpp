@@ -66,10 +66,17 @@ public:
       case relational_operator::in:
         return membership();
       case relational_operator::not_in:
-        if (auto result = membership())
-          return !*result;
-        else
-          return result;
+        // Only a column that consists of a single value from the list alone
+        // cannot match.
+        if (auto xs = caf::get_if<view<list>>(&rhs)) {
+          if (min_ != max_)
+            return true;
+          for (auto x : **xs)
+            if (auto y = caf::get_if<view<T>>(&x); y && *y == min_)
+              return false;
+          return true;
+        }
+        return caf::none;
       case relational_operator::equal:
       case relational_operator::not_equal:
       case relational_operator::less:
@@ -131,7 +138,8 @@ private:
       case relational_operator::equal:
         return min_ <= x && x <= max_;
       case relational_operator::not_equal:
-        return !(min_ <= x && x <= max_);
+        // Only a column that consists of *x* alone cannot match.
+        return !(min_ == x && x == max_);
       case relational_operator::less:
         return min_ < x;
       case relational_operator::less_equal:
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/min_max_synopsis.hpp"
+#include "vast/synopsis.hpp"
+
+#include <limits>
+#include <type_traits>
+#include <typeinfo>
+
+namespace vast {
+
+/// A min-max synopsis for [count](@ref count_type),
+/// [integer](@ref integer_type), [real](@ref real_type), and
+/// [duration](@ref duration_type) columns.
+template <class T>
+class numeric_synopsis final : public min_max_synopsis<T> {
+public:
+  using super = min_max_synopsis<T>;
+
+  explicit numeric_synopsis(vast::type x)
+    : super{std::move(x), highest(), lowest()} {
+    // nop
+  }
+
+  numeric_synopsis(vast::type x, T min, T max)
+    : super{std::move(x), min, max} {
+    // nop
+  }
+
+  bool equals(const synopsis& other) const noexcept override {
+    if (typeid(other) != typeid(numeric_synopsis))
+      return false;
+    auto& dref = static_cast<const numeric_synopsis&>(other);
+    return this->type() == dref.type() && this->min() == dref.min()
+           && this->max() == dref.max();
+  }
+
+private:
+  static T lowest() {
+    if constexpr (std::is_arithmetic_v<T>)
+      return std::numeric_limits<T>::lowest();
+    else
+      return T::min();
+  }
+
+  static T highest() {
+    if constexpr (std::is_arithmetic_v<T>)
+      return std::numeric_limits<T>::max();
+    else
+      return T::max();
+  }
+};
+
+} // namespace vast
@@ -13,10 +13,19 @@
 
 #pragma once
 
+#include "vast/aliases.hpp"
+#include "vast/hyperloglog.hpp"
 #include "vast/qualified_record_field.hpp"
 #include "vast/synopsis.hpp"
 #include "vast/table_slice.hpp"
 
+#include <caf/optional.hpp>
+
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace vast {
 
 /// Contains one synopsis per partition column.
@@ -33,12 +42,41 @@ struct partition_synopsis {
   ///          synopsis.
   size_t memusage() const;
 
+  /// Merges the sketches of the number of distinct values of all columns that
+  /// match a field. A field matches a column if it is a suffix of the
+  /// column's fully qualified name, e.g., `id.orig_h` matches
+  /// `zeek.conn.id.orig_h`.
+  /// @param field The field to look for.
+  /// @returns The merged sketch, or none if no column with a sketch matches.
+  caf::optional<hyperloglog> sketch(std::string_view field) const;
+
   /// Synopsis data structures for types.
   std::unordered_map<type, synopsis_ptr> type_synopses_;
 
   /// Synopsis data structures for individual columns.
   std::unordered_map<qualified_record_field, synopsis_ptr> field_synopses_;
 
+  /// Sketches of the number of distinct values for individual columns.
+  std::unordered_map<qualified_record_field, hyperloglog> field_sketches_;
+
+  /// Columns that contain null values, which synopses do not account for.
+  std::unordered_set<qualified_record_field> null_fields_;
+
+  /// Whether `null_fields_` is known. Synopses written by older versions did
+  /// not keep track of null values.
+  bool tracks_nulls_ = true;
+
+  /// The ID of the first event in the partition.
+  id offset = invalid_id;
+
+  /// The number of events in the partition.
+  uint64_t events = 0;
+
+  /// The sorted, half-open ID intervals of the events in the partition. A
+  /// partition covers more than one interval if the INDEX distributes table
+  /// slices over multiple active partitions.
+  std::vector<std::pair<id, id>> id_ranges;
+
   // -- flatbuffer -------------------------------------------------------------
 
   friend caf::expected<flatbuffers::Offset<fbs::partition_synopsis::v0>>
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/min_max_synopsis.hpp"
+#include "vast/synopsis.hpp"
+
+#include <optional>
+#include <vector>
+
+namespace vast {
+
+/// A synopsis for transport-layer ports, i.e., [count](@ref count_type)
+/// columns of type `port`. Ports typically have a low cardinality per
+/// partition, so the synopsis keeps the exact set of values until it exceeds
+/// a small size, and degrades to a min-max synopsis afterwards.
+class port_synopsis final : public min_max_synopsis<count> {
+public:
+  using super = min_max_synopsis<count>;
+
+  /// The maximum number of distinct values before the synopsis degrades.
+  static constexpr size_t max_values = 64;
+
+  explicit port_synopsis(vast::type x);
+
+  /// Constructs a port synopsis from its parts.
+  /// @param min The smallest value.
+  /// @param max The largest value.
+  /// @param values The sorted set of distinct values, or `std::nullopt` if
+  ///        there were more than *max_values*.
+  port_synopsis(count min, count max, std::optional<std::vector<count>> values);
+
+  void add(data_view x) override;
+
+  caf::optional<bool>
+  lookup(relational_operator op, data_view rhs) const override;
+
+  bool equals(const synopsis& other) const noexcept override;
+
+  size_t memusage() const override;
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  /// @returns the sorted set of distinct values, or `nullptr` if the synopsis
+  /// degraded to a min-max synopsis.
+  const std::vector<count>* values() const noexcept;
+
+private:
+  bool contains(count x) const;
+
+  std::vector<count> values_;
+  bool overflow_ = false;
+};
+
+} // namespace vast
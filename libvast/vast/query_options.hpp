@@ -23,7 +23,12 @@ namespace vast {
 enum class query_options : uint32_t {
   none = 0x00,
   historical = 0x01,
-  continuous = 0x02
+  continuous = 0x02,
+  explain = 0x04,
+  low_priority = 0x08,
+  high_priority = 0x10,
+  ascending = 0x20,
+  descending = 0x40
 };
 
 /// Concatenates two query options.
@@ -37,6 +42,11 @@ constexpr query_options no_query_options = query_options::none;
 constexpr query_options historical = query_options::historical;
 constexpr query_options continuous = query_options::continuous;
 constexpr query_options unified = historical + continuous;
+constexpr query_options explain = query_options::explain;
+constexpr query_options low_priority = query_options::low_priority;
+constexpr query_options high_priority = query_options::high_priority;
+constexpr query_options ascending = query_options::ascending;
+constexpr query_options descending = query_options::descending;
 
 constexpr bool has_query_option(query_options haystack, query_options needle) {
   return (static_cast<uint32_t>(haystack) & static_cast<uint32_t>(needle)) != 0;
@@ -50,6 +60,26 @@ constexpr bool has_continuous_option(query_options opts) {
   return has_query_option(opts, continuous);
 }
 
+constexpr bool has_explain_option(query_options opts) {
+  return has_query_option(opts, explain);
+}
+
+constexpr bool has_low_priority_option(query_options opts) {
+  return has_query_option(opts, low_priority);
+}
+
+constexpr bool has_high_priority_option(query_options opts) {
+  return has_query_option(opts, high_priority);
+}
+
+constexpr bool has_ascending_option(query_options opts) {
+  return has_query_option(opts, ascending);
+}
+
+constexpr bool has_descending_option(query_options opts) {
+  return has_query_option(opts, descending);
+}
+
 constexpr bool has_unified_option(query_options opts) {
   return has_query_option(opts, historical)
          && has_query_option(opts, continuous);
@@ -16,6 +16,7 @@
 #include "vast/aliases.hpp"
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/table_slice.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/segment.hpp"
 #include "vast/uuid.hpp"
 
@@ -23,6 +24,7 @@
 #include <caf/fwd.hpp>
 
 #include <cstddef>
+#include <unordered_set>
 #include <vector>
 
 namespace vast {
@@ -73,6 +75,8 @@ private:
   std::vector<flatbuffers::Offset<fbs::FlatTableSlice>> flat_slices_;
   std::vector<table_slice> slices_; // For queries to an unfinished segment.
   std::vector<fbs::interval::v0> intervals_;
+  std::vector<flatbuffers::Offset<fbs::layout::v0>> layouts_;
+  std::unordered_set<layout_fingerprint> layout_ids_;
 };
 
 } // namespace vast
@@ -23,6 +23,8 @@
 #include "vast/store.hpp"
 #include "vast/uuid.hpp"
 
+#include <optional>
+
 namespace vast {
 
 /// @relates segment_store
@@ -82,8 +84,12 @@ public:
 
   caf::expected<std::vector<table_slice>> get(const ids& xs) override;
 
+  id watermark() const override;
+
   caf::error flush() override;
 
+  uint64_t bytes() const override;
+
   void inspect_status(caf::settings& xs, system::status_verbosity v) override;
 
 private:
@@ -106,6 +112,14 @@ private:
   /// @returns The number of events in `x`.
   uint64_t drop(segment& x);
 
+  /// Drops a segment from disk without loading it if all of its events are in
+  /// a given set of IDs.
+  /// @param id The ID of the segment to drop.
+  /// @param xs The set of IDs to erase.
+  /// @returns The number of events in the segment, or `std::nullopt` if *xs*
+  ///          does not cover the entire segment.
+  std::optional<uint64_t> try_drop(const uuid& id, const ids& xs);
+
   /// Drops a segment-under-construction by resetting the builder and forcing
   /// it to generate a new segment ID.
   /// @param x The segment-under-construction to drop.
@@ -122,6 +136,9 @@ private:
 
   uint64_t num_events_ = 0;
 
+  /// The size of all segment files on disk.
+  uint64_t bytes_ = 0;
+
   /// Maps event IDs to candidate segments.
   detail::range_map<id, uuid> segments_;
 
@@ -15,8 +15,12 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/aliases.hpp"
+
 #include <caf/expected.hpp>
 
+#include <cstdint>
+
 namespace vast {
 
 /// A key-value store for events.
@@ -56,10 +60,16 @@ public:
   /// @returns The table slice according to *xs*.
   virtual caf::expected<std::vector<table_slice>> get(const ids& xs) = 0;
 
+  /// @returns the lowest ID that may not be in persistent storage yet.
+  virtual id watermark() const = 0;
+
   /// Flushes in-memory state to persistent storage.
   /// @returns No error on success.
   virtual caf::error flush() = 0;
 
+  /// @returns the number of bytes that the store occupies on disk.
+  virtual uint64_t bytes() const = 0;
+
   /// Fills `xs` with implementation-specific status information.
   virtual void inspect_status(caf::settings& xs, system::status_verbosity v)
     = 0;
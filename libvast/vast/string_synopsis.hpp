@@ -33,12 +33,16 @@ synopsis_ptr
 make_string_synopsis(vast::type type, bloom_filter_parameters params,
                      std::vector<size_t> seeds = {});
 
-/// A synopsis for strings.
 template <class HashFunction>
+synopsis_ptr
+make_blocked_string_synopsis(vast::type type, bloom_filter_parameters params);
+
+/// A synopsis for strings.
+template <class HashFunction, class BloomFilter = bloom_filter<HashFunction>>
 class string_synopsis final
-  : public bloom_filter_synopsis<std::string, HashFunction> {
+  : public bloom_filter_synopsis<std::string, HashFunction, BloomFilter> {
 public:
-  using super = bloom_filter_synopsis<std::string, HashFunction>;
+  using super = bloom_filter_synopsis<std::string, HashFunction, BloomFilter>;
 
   /// Constructs a string synopsis from an `string_type` and a Bloom
   /// filter.
@@ -56,14 +60,18 @@ public:
   }
 };
 
+/// A string synopsis backed by a blocked Bloom filter.
+template <class HashFunction>
+using blocked_string_synopsis
+  = string_synopsis<HashFunction, blocked_bloom_filter<HashFunction>>;
+
 /// @relates buffered_synopsis_traits
 template <>
 struct buffered_synopsis_traits<std::string> {
   template <typename HashFunction>
-  static synopsis_ptr make(vast::type type, bloom_filter_parameters p,
-                           std::vector<size_t> seeds = {}) {
-    return make_string_synopsis<HashFunction>(std::move(type), std::move(p),
-                                              std::move(seeds));
+  static synopsis_ptr make(vast::type type, bloom_filter_parameters p) {
+    return make_blocked_string_synopsis<HashFunction>(std::move(type),
+                                                      std::move(p));
   }
 
   static size_t memusage(const std::unordered_set<std::string>& x) {
@@ -100,6 +108,26 @@ make_string_synopsis(vast::type type, bloom_filter_parameters params,
   return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
 }
 
+/// Factory to construct a string synopsis backed by a blocked Bloom filter.
+/// @tparam HashFunction The hash function to use for the Bloom filter.
+/// @param type A type instance carrying an `string_type`.
+/// @param params The Bloom filter parameters.
+/// @returns A type-erased pointer to a synopsis.
+/// @pre `caf::holds_alternative<string_type>(type)`.
+/// @relates string_synopsis
+template <class HashFunction>
+synopsis_ptr
+make_blocked_string_synopsis(vast::type type, bloom_filter_parameters params) {
+  VAST_ASSERT(caf::holds_alternative<string_type>(type));
+  auto x = make_blocked_bloom_filter<HashFunction>(params);
+  if (!x) {
+    VAST_WARN("{} failed to construct blocked Bloom filter", __func__);
+    return nullptr;
+  }
+  using synopsis_type = blocked_string_synopsis<HashFunction>;
+  return std::make_unique<synopsis_type>(std::move(type), std::move(*x));
+}
+
 /// Factory to construct a buffered string synopsis.
 /// @tparam HashFunction The hash function to use for the Bloom filter.
 /// @param type A type instance carrying an `string_type`.
@@ -128,8 +156,14 @@ make_buffered_string_synopsis(vast::type type, bloom_filter_parameters params) {
 template <class HashFunction>
 synopsis_ptr make_string_synopsis(vast::type type, const caf::settings& opts) {
   VAST_ASSERT(caf::holds_alternative<string_type>(type));
-  if (auto xs = parse_parameters(type))
+  if (auto xs = parse_parameters(type)) {
+    // Types annotated by older versions of VAST describe a standard Bloom
+    // filter; we keep reading them as such.
+    if (has_blocked_parameters(type))
+      return make_blocked_string_synopsis<HashFunction>(std::move(type),
+                                                       std::move(*xs));
     return make_string_synopsis<HashFunction>(std::move(type), std::move(*xs));
+  }
   // If no explicit Bloom filter parameters were attached to the type, we try
   // to use the maximum partition size of the index as upper bound for the
   // expected number of events.
@@ -143,14 +177,15 @@ synopsis_ptr make_string_synopsis(vast::type type, const caf::settings& opts) {
   params.n = *max_part_size;
   params.p = caf::get_or(opts, "string-synopsis-fp-rate",
                          defaults::system::string_synopsis_fp_rate);
-  auto annotated_type = annotate_parameters(type, params);
+  auto annotated_type = annotate_blocked_parameters(type, params);
   // Create either a a buffered_string_synopsis or a plain string synopsis
   // depending on the callers preference.
   auto buffered = caf::get_or(opts, "buffer-input-data", false);
   auto result
     = buffered
         ? make_buffered_string_synopsis<HashFunction>(std::move(type), params)
-        : make_string_synopsis<HashFunction>(std::move(annotated_type), params);
+        : make_blocked_string_synopsis<HashFunction>(std::move(annotated_type),
+                                                     params);
   if (!result)
     VAST_ERROR("{} failed to evaluate Bloom filter parameters: {} {}", __func__,
                params.n, params.p);
@@ -56,6 +56,14 @@ public:
   virtual caf::optional<bool> lookup(relational_operator op,
                                      data_view rhs) const = 0;
 
+  /// Tests whether a bulk membership predicate matches, i.e., whether the
+  /// synopsis may contain any element of a membership set. This is equivalent
+  /// to `lookup(relational_operator::in, xs)` for the list of elements, but
+  /// allows synopses to reuse the digests that the set computed up front.
+  /// @param xs The set of values on the RHS of the `in` predicate.
+  /// @returns The evaluation result of `*this in xs`.
+  virtual caf::optional<bool> lookup_any(const membership_set& xs) const;
+
   /// @returns A best-effort estimate of the size (in bytes) of this synopsis.
   virtual size_t memusage() const = 0;
 
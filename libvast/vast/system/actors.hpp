@@ -59,6 +59,12 @@ using flush_listener_actor = typed_actor_fwd<
   // Reacts to the requested flush message.
   caf::reacts_to<atom::flush>>::unwrap;
 
+/// The DISK USAGE LISTENER actor interface.
+using disk_usage_listener_actor = typed_actor_fwd<
+  // Adjusts the size of the database directory by the number of bytes that
+  // the sender wrote (positive) or removed (negative).
+  caf::reacts_to<atom::write, int64_t>>::unwrap;
+
 /// The ARCHIVE CLIENT actor interface.
 using archive_client_actor = typed_actor_fwd<
   // An ARCHIVE CLIENT receives table slices from the ARCHIVE for partial
@@ -173,7 +179,30 @@ using meta_index_actor = typed_actor_fwd<
     atom::ok>,
   // Evaluate the expression.
   caf::replies_to<expression>::with< //
-    std::vector<uuid>>>::unwrap;
+    std::vector<uuid>>,
+  // Returns the earliest and the latest timestamp of the given partitions.
+  caf::replies_to<atom::resolve, std::vector<uuid>>::with< //
+    std::vector<time>, std::vector<time>>,
+  // Estimates the number of distinct values of a field in the candidate
+  // partitions of the expression.
+  caf::replies_to<atom::distinct, expression, std::string>::with<uint64_t>,
+  // Erases the synopsis of a single partition.
+  caf::replies_to<atom::erase, uuid>::with< //
+    atom::ok>,
+  // Returns the partitions whose events all satisfy the expression, i.e.,
+  // the partitions to erase for it. Their synopses remain until erased
+  // individually.
+  caf::replies_to<atom::erase, expression>::with< //
+    std::vector<uuid>>,
+  // Returns small partitions with the same layouts that can be merged into a
+  // partition of at most the given number of events, and their ids.
+  caf::replies_to<atom::merge, atom::candidate, uint64_t, uint64_t>::with< //
+    std::vector<uuid>, ids>,
+  // Atomically replaces the synopses of several partitions with the synopsis
+  // of the partition they were merged into.
+  caf::replies_to<atom::replace, std::vector<uuid>, uuid,
+                  std::shared_ptr<partition_synopsis>>::with< //
+    atom::ok>>::unwrap;
 
 /// The INDEX actor interface.
 using index_actor = typed_actor_fwd<
@@ -183,12 +212,43 @@ using index_actor = typed_actor_fwd<
   caf::reacts_to<accountant_actor>,
   // Subscribes a FLUSH LISTENER to the INDEX.
   caf::reacts_to<atom::subscribe, atom::flush, flush_listener_actor>,
-  // Evaluatates an expression.
-  caf::reacts_to<expression>,
+  // Subscribes a DISK USAGE LISTENER to the files the INDEX writes and
+  // removes.
+  caf::reacts_to<atom::subscribe, atom::write, disk_usage_listener_actor>,
+  // Evaluatates an expression with the given priority.
+  caf::reacts_to<expression, query_priority>,
+  // Evaluates an expression with the given priority, and schedules the
+  // candidate partitions by their time bounds for the given order.
+  caf::reacts_to<expression, query_priority, query_order>,
   // Queries PARTITION actors for a given query id.
   caf::reacts_to<uuid, uint32_t>,
   // Erases the given events from the INDEX, and returns their ids.
-  caf::replies_to<atom::erase, uuid>::with<ids>>
+  caf::replies_to<atom::erase, uuid>::with<ids>,
+  // Erases all partitions whose events all satisfy the expression, and
+  // returns their ids.
+  caf::replies_to<atom::erase, expression>::with<ids>,
+  // Returns the lowest ID that the INDEX may not have persisted yet.
+  caf::replies_to<atom::persist, atom::id>::with<id>,
+  // Returns the persisted partitions ordered by the time of their latest
+  // event, and the number of bytes each of them occupies on disk.
+  caf::replies_to<atom::erase, atom::candidate>::with< //
+    std::vector<uuid>, std::vector<uint64_t>>,
+  // Estimates the number of distinct values of a field in the persisted
+  // partitions that may match the expression.
+  caf::replies_to<atom::distinct, expression, std::string>::with<uint64_t>,
+  // INTERNAL: Seals active partitions that exceeded their timeout.
+  caf::reacts_to<atom::internal, atom::flush>,
+  // INTERNAL: Shuts down surplus query supervisors after the pool idled.
+  caf::reacts_to<atom::internal, atom::worker>,
+  // Returns small partitions to merge and their ids, or nothing while busy
+  // with ingestion.
+  caf::replies_to<atom::merge, atom::candidate>::with< //
+    std::vector<uuid>, ids>,
+  // Replaces the given partitions with a single partition built from their
+  // table slices, and returns the ID of the new partition.
+  caf::replies_to<atom::merge, std::vector<uuid>,
+                  std::vector<table_slice>>::with< //
+    uuid>>
   // Conform to the protocol of the STREAM SINK actor for table slices.
   ::extend_with<stream_sink_actor<table_slice>>
   // Conform to the protocol of the QUERY SUPERVISOR MASTER actor.
@@ -203,6 +263,9 @@ using archive_actor = typed_actor_fwd<
   caf::reacts_to<atom::exporter, caf::actor>,
   // Registers the ARCHIVE with the ACCOUNTANT.
   caf::reacts_to<accountant_actor>,
+  // Subscribes a DISK USAGE LISTENER to the files the ARCHIVE writes and
+  // removes.
+  caf::reacts_to<atom::subscribe, atom::write, disk_usage_listener_actor>,
   // Starts handling a query for the given ids.
   caf::reacts_to<ids, archive_client_actor>,
   // INTERNAL: Handles a query for the given ids, and sends the table slices
@@ -212,7 +275,9 @@ using archive_actor = typed_actor_fwd<
   caf::reacts_to<atom::telemetry>,
   // Erase the events with the given ids.
   caf::replies_to<atom::erase, ids>::with< //
-    atom::done>>
+    atom::done>,
+  // Returns the lowest ID that the ARCHIVE may not have persisted yet.
+  caf::replies_to<atom::persist, atom::id>::with<id>>
   // Conform to the protocol of the STREAM SINK actor for table slices.
   ::extend_with<stream_sink_actor<table_slice>>
   // Conform to the procotol of the STATUS CLIENT actor.
@@ -246,12 +311,23 @@ using type_registry_actor = typed_actor_fwd<
   // Conform to the procotol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
+/// The COMPACTOR actor interface.
+using compactor_actor = typed_actor_fwd<
+  // Starts the next compaction cycle.
+  caf::reacts_to<atom::run>>
+  // Conform to the protocol of the ARCHIVE CLIENT actor.
+  ::extend_with<archive_client_actor>
+  // Conform to the protocol of the STATUS CLIENT actor.
+  ::extend_with<status_client_actor>::unwrap;
+
 /// The DISK MONITOR actor interface.
 using disk_monitor_actor = typed_actor_fwd<
   // Checks the monitoring requirements.
   caf::reacts_to<atom::ping>,
   // Purge events as required for the monitoring requirements.
   caf::reacts_to<atom::erase>>
+  // Conform to the protocol of the DISK USAGE LISTENER actor.
+  ::extend_with<disk_usage_listener_actor>
   // Conform to the protocol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
@@ -268,7 +344,11 @@ using filesystem_actor = typed_actor_fwd<
     chunk_ptr>,
   // Memory-maps a file.
   caf::replies_to<atom::mmap, path>::with< //
-    chunk_ptr>>
+    chunk_ptr>,
+  // Hints that the given files will be memory-mapped soon, allowing the
+  // operating system to read them ahead asynchronously.
+  caf::replies_to<atom::prefetch, std::vector<path>>::with< //
+    atom::ok>>
   // Conform to the procotol of the STATUS CLIENT actor.
   ::extend_with<status_client_actor>::unwrap;
 
@@ -377,7 +457,9 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast_actors, caf::id_block::vast_atoms::end)
   VAST_ADD_TYPE_ID((vast::system::analyzer_plugin_actor))
   VAST_ADD_TYPE_ID((vast::system::archive_actor))
   VAST_ADD_TYPE_ID((vast::system::archive_client_actor))
+  VAST_ADD_TYPE_ID((vast::system::compactor_actor))
   VAST_ADD_TYPE_ID((vast::system::disk_monitor_actor))
+  VAST_ADD_TYPE_ID((vast::system::disk_usage_listener_actor))
   VAST_ADD_TYPE_ID((vast::system::evaluator_actor))
   VAST_ADD_TYPE_ID((vast::system::exporter_actor))
   VAST_ADD_TYPE_ID((vast::system::filesystem_actor))
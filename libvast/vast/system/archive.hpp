@@ -34,6 +34,8 @@ namespace vast::system {
 struct archive_state {
   void send_report();
   void next_session();
+  /// Reports changes of the store size to the DISK USAGE LISTENER.
+  void notify_disk_usage();
   archive_actor::pointer self;
   std::unique_ptr<vast::store> store;
   std::unique_ptr<vast::store::lookup> session;
@@ -43,6 +45,8 @@ struct archive_state {
   std::unordered_set<caf::actor_addr> active_exporters;
   vast::system::measurement measurement;
   accountant_actor accountant;
+  disk_usage_listener_actor disk_usage_listener;
+  uint64_t reported_bytes = 0;
   static inline const char* name = "archive";
 };
 
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/system/actors.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/time.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/typed_event_based_actor.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vast::system {
+
+/// The state of the COMPACTOR actor.
+struct compactor_state {
+  /// Requests the next group of partitions to merge from the INDEX.
+  void run();
+
+  /// Schedules the next compaction cycle.
+  void schedule();
+
+  /// Pointer to the parent actor.
+  compactor_actor::pointer self;
+
+  /// The timespan between two compaction cycles.
+  duration interval;
+
+  /// The partitions of the current compaction cycle.
+  std::vector<uuid> partitions;
+
+  /// The table slices of the partitions of the current compaction cycle.
+  std::vector<table_slice> slices;
+
+  /// The number of events the ARCHIVE should deliver for the partitions of
+  /// the current compaction cycle.
+  uint64_t expected_events = 0;
+
+  /// The total number of partitions that the COMPACTOR merged.
+  size_t merged_partitions = 0;
+
+  /// Node handle of the ARCHIVE.
+  archive_actor archive;
+
+  /// Node handle of the INDEX.
+  index_actor index;
+
+  static inline const char* name = "compactor";
+};
+
+/// Periodically merges small partitions of the INDEX into larger ones. The
+/// COMPACTOR rebuilds merged partitions from the events in the ARCHIVE, and
+/// the INDEX only hands out partitions to merge while it is not busy with
+/// ingestion.
+/// @param self The actor handle.
+/// @param interval The timespan between two compaction cycles.
+/// @param archive The actor handle of the ARCHIVE.
+/// @param index The actor handle of the INDEX.
+compactor_actor::behavior_type
+compactor(compactor_actor::stateful_pointer<compactor_state> self,
+          duration interval, archive_actor archive, index_actor index);
+
+} // namespace vast::system
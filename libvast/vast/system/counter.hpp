@@ -17,9 +17,11 @@
 
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/query_processor.hpp"
 
+#include <string>
 #include <unordered_map>
 
 namespace vast::system {
@@ -39,7 +41,7 @@ public:
   counter_state(caf::event_based_actor* self);
 
   void init(expression expr, index_actor index, archive_actor archive,
-            bool skip_candidate_check);
+            bool skip_candidate_check, std::string distinct);
 
 protected:
   // -- implementation hooks ---------------------------------------------------
@@ -49,11 +51,21 @@ protected:
   void process_end_of_hits() override;
 
 private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Asks the INDEX for an estimate of the number of distinct values of the
+  /// `distinct_` field instead of counting events.
+  void estimate_distinct(const index_actor& index);
+
   // -- member variables -------------------------------------------------------
 
   /// Stores whether we can skip candidate checks.
   bool skip_candidate_check_;
 
+  /// Stores the field whose distinct values to count; empty means that we
+  /// count events.
+  std::string distinct_;
+
   /// Stores the user-defined query.
   expression expr_;
 
@@ -70,11 +82,12 @@ private:
   ids hits_;
 
   /// Caches expr_ tailored to different layouts.
-  std::unordered_map<type, expression> checkers_;
+  std::unordered_map<layout_fingerprint, expression> checkers_;
 };
 
 caf::behavior
 counter(caf::stateful_actor<counter_state>* self, expression expr,
-        index_actor index, archive_actor archive, bool skip_candidate_check);
+        index_actor index, archive_actor archive, bool skip_candidate_check,
+        std::string distinct);
 
 } // namespace vast::system
@@ -132,9 +132,12 @@ datagram_source(datagram_source_actor<Reader>* self,
       auto events = capacity * self->state.table_slice_size;
       if (self->state.requested)
         events = std::min(events, *self->state.requested - self->state.count);
+      auto start = stopwatch::now();
       auto [err, produced] = self->state.reader.read(
         events, self->state.table_slice_size, push_slice);
       t.stop(produced);
+      self->state.read_latency_metric->add(stopwatch::now() - start);
+      self->state.events_metric->add(produced);
       self->state.count += produced;
       if (self->state.requested && self->state.count >= *self->state.requested)
         self->state.done = true;
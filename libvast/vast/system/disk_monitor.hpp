@@ -20,6 +20,8 @@
 
 #include <caf/typed_event_based_actor.hpp>
 
+#include <cstdint>
+
 namespace vast::system {
 
 struct disk_monitor_state {
@@ -34,24 +36,29 @@ struct disk_monitor_state {
   /// Whether an erasing run is currently in progress.
   bool purging;
 
+  /// The size of the database directory. The DISK MONITOR scans the
+  /// directory once at startup, and the INDEX and the ARCHIVE report the
+  /// files they write and remove afterwards.
+  uint64_t size = 0;
+
   /// Node handle of the ARCHIVE.
   archive_actor archive;
 
   /// Node handle of the INDEX.
   index_actor index;
 
-  /// The timespan between scans.
+  /// The timespan between two checks of the size.
   std::chrono::seconds scan_interval;
 
   constexpr static const char* name = "disk_monitor";
 };
 
-/// Periodically scans the size of the database directory and deletes data
+/// Periodically checks the size of the database directory and deletes data
 /// once it exceeds some threshold.
 /// @param self The actor handle.
 /// @param high_water Start erasing data if this limit is exceeded.
 /// @param low_water Erase until this limit is no longer exceeded.
-/// @param scan_interval The timespan between scans.
+/// @param scan_interval The timespan between two checks of the size.
 /// @param db_dir The path to the database directory.
 /// @param archive The actor handle of the ARCHIVE.
 /// @param index The actor handle of the INDEX.
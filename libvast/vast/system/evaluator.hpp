@@ -41,6 +41,10 @@ struct evaluator_state {
   /// tree.
   void handle_missing_result(const offset& position, const caf::error& err);
 
+  /// Accounts for a single INDEXER lookup in the profile of the client.
+  void profile_lookup(const offset& position, const ids& result,
+                      duration latency);
+
   /// Evaluates the predicate-tree and may produces new deltas.
   void evaluate();
 
@@ -79,6 +83,14 @@ struct evaluator_state {
   static inline const char* name = "evaluator";
 };
 
+/// Combines the hits of the predicates in an expression, resolving
+/// conjunctions, disjunctions, and negations.
+/// @param expr The expression.
+/// @param hits The hits of the predicates, keyed by their position in *expr*.
+/// @relates evaluator_state
+ids evaluate_hits(const expression& expr,
+                  const evaluator_state::predicate_hits_map& hits);
+
 /// Wraps a query expression in an actor. Upon receiving hits from INDEXER
 /// actors, re-evaluates the expression and relays new hits to the INDEX CLIENT.
 /// @pre `!eval.empty()`
@@ -20,14 +20,20 @@
 #include "vast/ids.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/actors.hpp"
+#include "vast/system/query_order.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/actor.hpp>
+#include <caf/optional.hpp>
 #include <caf/scheduled_actor.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace vast::system {
 
 struct exporter_state {
@@ -35,6 +41,20 @@ struct exporter_state {
 
   static inline const char* name = "exporter";
 
+  // -- member types -----------------------------------------------------------
+
+  /// A selected row of a time-ordered query.
+  struct ordered_row {
+    /// The value of the `timestamp` column of the row.
+    time timestamp;
+
+    /// The slice that contains the row.
+    table_slice slice;
+
+    /// The event ID of the row.
+    vast::id row;
+  };
+
   // -- member variables -------------------------------------------------------
 
   /// Stores a handle to the ARCHIVE for fetching candidates.
@@ -56,12 +76,36 @@ struct exporter_state {
   /// Stores hits from the INDEX.
   ids hits;
 
-  /// Caches tailored candidate checkers.
-  std::unordered_map<type, expression> checkers;
+  /// Caches tailored candidate checkers per layout fingerprint.
+  std::unordered_map<layout_fingerprint, expression> checkers;
+
+  /// Stores the fields the user asked for; empty means all fields.
+  std::vector<std::string> fields;
+
+  /// Caches the flat column indices that match `fields` per layout
+  /// fingerprint. An empty list means that no column matches.
+  std::unordered_map<layout_fingerprint, std::vector<size_t>> projections;
 
   /// Caches results for the SINK.
   std::vector<table_slice> results;
 
+  /// The order of the query results.
+  query_order order = query_order::none;
+
+  /// Caches the flat index of the `timestamp` column per layout fingerprint
+  /// for time-ordered queries. Layouts without such a column map to none.
+  std::unordered_map<layout_fingerprint, caf::optional<size_t>>
+    timestamp_columns;
+
+  /// Stores the best rows of a time-ordered query, sorted by timestamp, until
+  /// all partitions that may contribute to the results finished.
+  std::vector<ordered_row> ordered;
+
+  /// Stores, for every candidate partition of a time-ordered query in the
+  /// order in which the INDEX schedules them, a bound that no timestamp of
+  /// this or any later partition precedes.
+  std::vector<time> bounds;
+
   /// Stores the time point for when this actor got started via 'run'.
   std::chrono::system_clock::time_point start;
 
@@ -85,8 +129,9 @@ struct exporter_state {
 /// @param self The actor handle of the exporter.
 /// @param expr The AST of the query.
 /// @param opts The query options.
+/// @param fields The fields to project results onto; empty means all fields.
 exporter_actor::behavior_type
 exporter(exporter_actor::stateful_pointer<exporter_state> self, expression expr,
-         query_options opts);
+         query_options opts, std::vector<std::string> fields);
 
 } // namespace vast::system
@@ -28,6 +28,13 @@ struct filesystem_statistics {
     uint64_t failed = 0;
     uint64_t bytes = 0;
 
+    ops& operator+=(const ops& other) noexcept {
+      successful += other.successful;
+      failed += other.failed;
+      bytes += other.bytes;
+      return *this;
+    }
+
     template <class Inspector>
     friend auto inspect(Inspector& f, ops& x) ->
       typename Inspector::result_type {
@@ -39,12 +46,13 @@ struct filesystem_statistics {
   ops writes;
   ops reads;
   ops mmaps;
+  ops prefetches;
 
   template <class Inspector>
   friend auto inspect(Inspector& f, filesystem_statistics& x) ->
     typename Inspector::result_type {
     return f(caf::meta::type_name("vast.system.filesystem_statistics"),
-             x.writes, x.reads, x.mmaps);
+             x.writes, x.reads, x.mmaps, x.prefetches);
   }
 };
 
@@ -17,6 +17,7 @@
 
 #include "vast/aliases.hpp"
 #include "vast/data.hpp"
+#include "vast/ingest_journal.hpp"
 #include "vast/path.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/instrumentation.hpp"
@@ -78,6 +79,9 @@ struct importer_state {
   /// @returns various status metrics.
   caf::typed_response_promise<caf::settings> status(status_verbosity v) const;
 
+  /// Removes journal files whose events both ARCHIVE and INDEX persisted.
+  void truncate_journal();
+
   /// The active id block.
   id_block current;
 
@@ -105,6 +109,16 @@ struct importer_state {
   /// The index actor.
   index_actor index;
 
+  /// The archive actor.
+  archive_actor archive;
+
+  /// The write-ahead log for imported table slices, if enabled.
+  ingest_journal_ptr journal;
+
+  /// Whether a truncation of the journal awaits the watermarks of ARCHIVE and
+  /// INDEX.
+  bool truncating_journal = false;
+
   accountant_actor accountant;
 
   /// Name of this actor in log events.
@@ -15,7 +15,9 @@
 
 #include "vast/fwd.hpp"
 
+#include "vast/defaults.hpp"
 #include "vast/detail/lru_cache.hpp"
+#include "vast/detail/range_map.hpp"
 #include "vast/detail/stable_map.hpp"
 #include "vast/expression.hpp"
 #include "vast/fbs/index.hpp"
@@ -23,6 +25,10 @@
 #include "vast/system/actors.hpp"
 #include "vast/system/meta_index.hpp"
 #include "vast/system/partition.hpp"
+#include "vast/system/query_order.hpp"
+#include "vast/system/query_result_cache.hpp"
+#include "vast/system/query_scheduler.hpp"
+#include "vast/time.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/actor.hpp>
@@ -33,6 +39,9 @@
 #include <caf/response_promise.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -52,13 +61,65 @@ struct active_partition_info {
   /// The UUID of the partition.
   uuid id;
 
+  /// The point in time when the partition was created.
+  time created;
+
   template <class Inspector>
   friend auto inspect(Inspector& f, active_partition_info& x) {
     return f(caf::meta::type_name("active_partition_info"), x.actor,
-             x.stream_slot, x.capacity, x.id);
+             x.stream_slot, x.capacity, x.id, x.created);
   }
 };
 
+/// Determines how the INDEX distributes table slices over its concurrently
+/// active partitions.
+enum class partition_sharding {
+  /// Assigns consecutive table slices to the active partitions in turn.
+  round_robin,
+  /// Assigns all table slices of a layout to the same active partition.
+  layout,
+  /// Assigns every layout group its own active partitions, such that no
+  /// partition contains events of multiple layout groups.
+  homogeneous,
+};
+
+/// Parses the name of a partition sharding policy.
+/// @param str One of "round-robin", "layout", or "homogeneous".
+/// @returns The sharding policy, or an error for an unknown name.
+caf::expected<partition_sharding> to_partition_sharding(std::string_view str);
+
+/// Identifies one of the concurrently active partitions of the INDEX. Used as
+/// filter for the outbound paths of the INDEX stream stage.
+struct partition_shard {
+  /// The position of the active partition.
+  size_t index = 0;
+
+  /// The number of concurrently active partitions.
+  size_t count = 1;
+
+  /// The policy for assigning table slices to active partitions.
+  partition_sharding sharding = partition_sharding::round_robin;
+
+  /// The sorted names of the layouts that belong to this shard. Only used
+  /// for homogeneous sharding, where the INDEX assigns layouts dynamically.
+  std::vector<std::string> layouts = {};
+
+  /// The number of table slices that the INDEX distributed so far, shared
+  /// with the INDEX state. Only used for round-robin sharding.
+  std::shared_ptr<const size_t> slices = nullptr;
+
+  /// @returns the position of the active partition for a table slice.
+  /// @pre `sharding != partition_sharding::homogeneous`
+  size_t select(const table_slice& slice) const;
+};
+
+/// Helper class used to route table slices to the correct active partition
+/// in the CAF stream stage.
+struct partition_shard_selector {
+  bool operator()(const partition_shard& filter,
+                  const table_slice& slice) const;
+};
+
 /// Accumulates statistics for a given layout.
 struct layout_statistics {
   uint64_t count; ///< Number of events indexed.
@@ -107,6 +168,14 @@ struct query_state {
   /// Unscheduled partitions.
   std::vector<uuid> partitions;
 
+  /// The priority class of the query.
+  query_priority priority = query_priority::normal;
+
+  /// The order of the query results. Unless this is `query_order::none`, the
+  /// unscheduled partitions are sorted by their time bounds and must be
+  /// evaluated in that order.
+  query_order order = query_order::none;
+
   template <class Inspector>
   friend auto inspect(Inspector& f, query_state& x) {
     return f(caf::meta::type_name("query_state"), x.id, x.expression,
@@ -118,9 +187,9 @@ struct query_state {
 struct index_state {
   // -- type aliases -----------------------------------------------------------
 
-  using index_stream_stage_ptr
-    = caf::stream_stage_ptr<table_slice,
-                            caf::broadcast_downstream_manager<table_slice>>;
+  using index_stream_stage_ptr = caf::stream_stage_ptr<
+    table_slice, caf::broadcast_downstream_manager<
+                   table_slice, partition_shard, partition_shard_selector>>;
 
   // -- constructor ------------------------------------------------------------
 
@@ -145,14 +214,34 @@ struct index_state {
 
   // -- query handling ---------------------------------------------------------
 
-  bool worker_available();
+  /// Hands runnable query requests to idle workers, and spawns additional
+  /// workers for the remaining runnable requests as long as the pool did not
+  /// reach its maximum size.
+  void schedule_queries();
 
-  std::optional<query_supervisor_actor> next_worker();
+  /// Evaluates the next batch of partitions of a query on a worker.
+  void dispatch(query_supervisor_actor worker, query_request request);
+
+  /// Spawns a new worker that announces itself once it is ready.
+  void spawn_worker();
+
+  /// Returns a worker to the pool after it finished a query request, or
+  /// after it started. Schedules shrinking the pool if it has more idle
+  /// workers than it keeps for new queries.
+  void release_worker(query_supervisor_actor worker);
+
+  /// Shuts down the idle workers beyond the ones the pool keeps for new
+  /// queries, unless the pool dispatched a query request within the idle
+  /// timeout.
+  void shrink_workers();
 
   /// Get the actor handles for up to `num_partitions` PARTITION actors,
   /// spawning them if needed.
+  /// @param cached Collects the hits of partitions that the result cache
+  ///               answers without evaluation.
   std::vector<std::pair<uuid, partition_actor>>
-  collect_query_actors(query_state& lookup, uint32_t num_partitions);
+  collect_query_actors(query_state& lookup, uint32_t num_partitions,
+                       ids& cached);
 
   // -- flush handling ---------------------------------------------------------
 
@@ -162,13 +251,64 @@ struct index_state {
   /// Sends a notification to all listeners and clears the listeners list.
   void notify_flush_listeners();
 
+  // -- disk usage -------------------------------------------------------------
+
+  /// Records the size of a persisted partition and reports it to the DISK
+  /// USAGE LISTENER.
+  void add_partition_bytes(const uuid& id);
+
+  /// Forgets the size of a removed partition and reports it to the DISK USAGE
+  /// LISTENER.
+  void remove_partition_bytes(const uuid& id);
+
   // -- partition handling -----------------------------------------------------
 
   /// Creates a new active partition.
-  void create_active_partition();
+  /// @param shard The position of the active partition.
+  void create_active_partition(size_t shard);
+
+  /// Decommissions an active partition.
+  /// @param shard The position of the active partition.
+  void decomission_active_partition(size_t shard);
+
+  /// @returns whether *id* refers to one of the active partitions.
+  bool is_active_partition(const uuid& id) const;
+
+  /// @returns the position of the active partition for a table slice, adding
+  /// a new shard for homogeneous sharding if the layout is not known yet.
+  size_t shard_of(const table_slice& slice);
+
+  /// @returns the stream filter for an active partition.
+  /// @param shard The position of the active partition.
+  partition_shard shard_filter(size_t shard) const;
+
+  /// Decommissions all active partitions that exist for longer than the
+  /// active partition timeout.
+  void seal_stale_partitions();
+
+  /// Removes the shard of a decommissioned partition with homogeneous
+  /// sharding, such that the layouts of the shard get a new shard once their
+  /// next table slice arrives.
+  /// @param shard The position of the decommissioned partition.
+  /// @pre `sharding == partition_sharding::homogeneous`
+  void remove_shard(size_t shard);
+
+  /// @returns the value index options for a new partition.
+  caf::settings partition_index_options() const;
+
+  /// @returns the synopsis options for a new partition.
+  caf::settings partition_synopsis_options() const;
 
-  /// Decommissions the active partition.
-  void decomission_active_partition();
+  /// Deletes the retired partitions that no pending query references
+  /// anymore.
+  void remove_retired_partitions();
+
+  /// Ends the compaction in progress and resumes the erasures that waited
+  /// for it.
+  void finish_compaction();
+
+  /// @returns the lowest ID that may not be persisted in a partition yet.
+  id watermark() const;
 
   // -- data members -----------------------------------------------------------
 
@@ -178,8 +318,31 @@ struct index_state {
   /// The streaming stage.
   index_stream_stage_ptr stage;
 
-  /// The single active (read/write) partition.
-  active_partition_info active_partition = {};
+  /// The active (read/write) partitions, indexed by their shard. An entry
+  /// without actor indicates that the shard has no active partition yet.
+  std::vector<active_partition_info> active_partitions;
+
+  /// The policy for distributing table slices over the active partitions.
+  partition_sharding sharding = partition_sharding::round_robin;
+
+  /// The number of table slices distributed with round-robin sharding. The
+  /// stream filters of the active partitions share the counter.
+  std::shared_ptr<size_t> round_robin_slices = std::make_shared<size_t>(0);
+
+  /// Maps layout names to the name of their layout group. Layouts that are
+  /// not part of a configured group form a group of their own.
+  std::unordered_map<std::string, std::string> layout_groups;
+
+  /// Maps layout names to their shard for homogeneous sharding.
+  std::unordered_map<std::string, size_t> layout_shards;
+
+  /// Maps layout groups to their shard for homogeneous sharding.
+  std::unordered_map<std::string, size_t> group_shards;
+
+  /// The duration after which the INDEX seals an active partition even if it
+  /// is not yet full. A zero duration disables time-based sealing. Sealing a
+  /// partition with homogeneous sharding also removes its shard.
+  duration active_partition_timeout = {};
 
   /// Partitions that are currently in the process of persisting.
   // TODO: An alternative to keeping an explicit set of unpersisted partitions
@@ -189,6 +352,15 @@ struct index_state {
   // unpin them after they're safely on disk.
   std::unordered_map<uuid, partition_actor> unpersisted;
 
+  /// Maps the active and unpersisted partitions to the first ID they contain.
+  std::unordered_map<uuid, id> unpersisted_offsets;
+
+  /// Maps the IDs of all events in persisted partitions to their partition.
+  detail::range_map<id, uuid> persisted_ids;
+
+  /// One past the highest ID that the index has seen.
+  id ingested_end = 0;
+
   /// The set of passive (read-only) partitions currently loaded into memory.
   /// Uses the `partition_factory` to load new partitions as needed, and evicts
   /// old entries when the size exceeds `max_inmem_partitions`.
@@ -197,6 +369,35 @@ struct index_state {
   /// The set of partitions that exist on disk.
   std::unordered_set<uuid> persisted_partitions;
 
+  /// Partitions that compaction replaced with a merged partition. They stay
+  /// on disk until no pending query references them anymore, and the
+  /// persisted index state lists them so a restart removes leftovers.
+  std::unordered_set<uuid> retired_partitions;
+
+  /// Caches the hits of queries in passive partitions; `nullptr` if
+  /// disabled.
+  std::shared_ptr<query_result_cache> result_cache;
+
+  /// Whether a compaction is currently in progress.
+  bool compacting = false;
+
+  /// The partitions that the compaction in progress merges.
+  std::vector<uuid> compaction_inputs;
+
+  /// Whether an erasure of one of the `compaction_inputs` cancelled the
+  /// compaction in progress.
+  bool compaction_cancelled = false;
+
+  /// Erasures of compaction inputs that wait for the compaction to finish.
+  std::vector<std::pair<uuid, caf::typed_response_promise<ids>>>
+    deferred_erasures;
+
+  /// The partitions that are currently being erased.
+  std::unordered_set<uuid> erasing_partitions;
+
+  /// The point in time when the INDEX received the last table slice.
+  time last_ingest = {};
+
   /// This set to true after the index finished reading the meta index state
   /// from disk.
   bool accept_queries;
@@ -214,9 +415,30 @@ struct index_state {
   /// Maps query IDs to pending lookup state.
   std::unordered_map<uuid, query_state> pending;
 
+  /// Decides which query requests run next.
+  query_scheduler scheduler{defaults::system::num_query_supervisors};
+
   /// Caches idle workers.
   std::vector<query_supervisor_actor> idle_workers;
 
+  /// Maps busy workers to the priority class of their current request.
+  std::unordered_map<caf::actor_id, query_priority> busy_workers;
+
+  /// The number of workers, including the busy and starting ones.
+  size_t num_workers = 0;
+
+  /// The number of spawned workers that did not announce themselves yet.
+  size_t starting_workers = 0;
+
+  /// The maximum number of workers.
+  size_t max_workers = defaults::system::num_query_supervisors;
+
+  /// The time of the last dispatched query request.
+  time last_dispatch = {};
+
+  /// Whether the INDEX scheduled shrinking the pool of workers.
+  bool shrink_scheduled = false;
+
   /// The META INDEX actor.
   meta_index_actor meta_index;
 
@@ -238,12 +460,23 @@ struct index_state {
   /// List of actors that wait for the next flush event.
   std::vector<flush_listener_actor> flush_listeners;
 
+  /// The number of bytes that the files of each persisted or retired
+  /// partition occupy on disk.
+  std::unordered_map<uuid, uint64_t> partition_bytes;
+
+  /// Gets notified about the files that the INDEX writes and removes.
+  disk_usage_listener_actor disk_usage_listener;
+
   /// Actor handle of the filesystem actor.
   filesystem_actor filesystem;
 
   // The false positive rate for the meta index.
   double meta_index_fp_rate;
 
+  /// The precision of the sketches of the number of distinct values per
+  /// field in the partition synopses; zero disables the sketches.
+  size_t hyperloglog_precision = defaults::system::hyperloglog_precision;
+
   static inline const char* name = "index";
 };
 
@@ -260,7 +493,8 @@ pack(flatbuffers::FlatBufferBuilder& builder, const index_state& x);
 /// @param dir The directory of the index.
 /// @param partition_capacity The maximum number of events per partition.
 /// @param taste_partitions How many lookup partitions to schedule immediately.
-/// @param num_workers The maximum amount of concurrent lookups.
+/// @param num_workers The maximum amount of concurrent lookups. The INDEX
+///                    grows its pool of workers up to this size on demand.
 /// @param meta_index_fp_rate The false positive rate for the meta index.
 /// @pre `partition_capacity > 0
 index_actor::behavior_type
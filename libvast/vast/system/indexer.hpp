@@ -28,8 +28,6 @@
 
 namespace vast::system {
 
-// TODO: Create a separate `passive_indexer_state`, similar to how partitions
-// are handled.
 struct indexer_state {
   /// The name of this indexer.
   std::string name;
@@ -56,10 +54,4 @@ active_indexer_actor::behavior_type
 active_indexer(active_indexer_actor::stateful_pointer<indexer_state> self,
                type index_type, caf::settings index_opts);
 
-/// An indexer that was recovered from on-disk state. It can only respond
-/// to queries, but not add eny more entries.
-indexer_actor::behavior_type
-passive_indexer(indexer_actor::stateful_pointer<indexer_state> self,
-                uuid partition_id, value_index_ptr idx);
-
 } // namespace vast::system
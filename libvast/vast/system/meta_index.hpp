@@ -17,6 +17,7 @@
 
 #include "vast/fbs/index.hpp"
 #include "vast/fbs/partition.hpp"
+#include "vast/hyperloglog.hpp"
 #include "vast/ids.hpp"
 #include "vast/partition_synopsis.hpp"
 #include "vast/qualified_record_field.hpp"
@@ -26,11 +27,14 @@
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
+#include <caf/optional.hpp>
 #include <caf/settings.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace vast::system {
@@ -61,6 +65,41 @@ public:
   /// @returns A vector of UUIDs representing candidate partitions.
   std::vector<uuid> lookup(const expression& expr) const;
 
+  /// Retrieves the list of partitions whose events all satisfy a given
+  /// expression. Unlike `lookup()`, the result never contains false
+  /// positives, so the events of these partitions can be erased without
+  /// evaluating the expression. Since synopses ignore null values, fields
+  /// that contain null values never cover a partition.
+  /// @param expr The expression to check.
+  /// @returns A sorted vector of UUIDs representing the covered partitions.
+  std::vector<uuid> covered(const expression& expr) const;
+
+  /// Retrieves the earliest and the latest timestamp of a partition, i.e., the
+  /// bounds of all of its columns of type `timestamp`. The bounds are open if
+  /// the partition is unknown or has no synopsis for such a column.
+  /// @param partition The partition to look at.
+  /// @returns The closed interval that contains all timestamps of *partition*.
+  std::pair<time, time> time_bounds(const uuid& partition) const;
+
+  /// Merges the sketches of the number of distinct values of a field across
+  /// several partitions. The INDEX can use the per-partition sketches to
+  /// estimate the selectivity of a predicate when scheduling partitions.
+  /// @param partitions The partitions to look at.
+  /// @param field The field to look for; see `partition_synopsis::sketch()`.
+  /// @returns The merged sketch, or none if no partition has a sketch for a
+  ///          column that matches *field*.
+  caf::optional<hyperloglog>
+  sketch(const std::vector<uuid>& partitions, std::string_view field) const;
+
+  /// Selects partitions to merge during compaction. Only partitions with the
+  /// same set of layouts qualify, and the result consists of the oldest run
+  /// of such partitions in ID order whose events fit into one partition.
+  /// @param threshold The maximum number of events of a qualifying partition.
+  /// @param capacity The maximum number of events of the merged partition.
+  /// @returns Either no or at least two UUIDs of partitions to merge.
+  std::vector<uuid>
+  compaction_candidates(uint64_t threshold, uint64_t capacity) const;
+
   /// @returns A best-effort estimate of the amount of memory used for this meta
   /// index (in bytes).
   size_t memusage() const;
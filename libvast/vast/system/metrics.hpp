@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/system/report.hpp"
+#include "vast/time.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace vast::system {
+
+/// The number of shards that spread concurrent updates of a single metric.
+/// Every thread writes to one shard, so that threads on different cores do
+/// not contend for the same cache line.
+inline constexpr size_t metric_shards = 8;
+
+/// @returns The shard that the calling thread updates.
+size_t metric_shard() noexcept;
+
+/// A monotonically increasing value, e.g., the number of processed events.
+class counter_metric {
+public:
+  /// Increments the counter.
+  /// @param x The increment.
+  void add(uint64_t x = 1) noexcept {
+    shards_[metric_shard()].value.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// @returns The sum of all increments.
+  uint64_t value() const noexcept;
+
+private:
+  struct alignas(64) shard {
+    std::atomic<uint64_t> value = 0;
+  };
+
+  std::array<shard, metric_shards> shards_;
+};
+
+/// A value that can go up and down, e.g., the number of pending requests.
+class gauge_metric {
+public:
+  /// Replaces the current value.
+  void set(int64_t x) noexcept {
+    value_.store(x, std::memory_order_relaxed);
+  }
+
+  /// Adjusts the current value.
+  void add(int64_t x) noexcept {
+    value_.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// @returns The current value.
+  int64_t value() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<int64_t> value_ = 0;
+};
+
+/// A latency histogram in the style of HDR histograms: every power of two
+/// splits into a fixed number of linear sub-buckets, which bounds the
+/// relative error of all quantiles independent of the recorded magnitudes.
+class histogram_metric {
+public:
+  /// The base-2 logarithm of the number of sub-buckets per power of two.
+  static constexpr size_t sub_bucket_bits = 3;
+
+  /// The number of sub-buckets per power of two. The relative error of a
+  /// quantile is at most `1 / sub_buckets`.
+  static constexpr size_t sub_buckets = size_t{1} << sub_bucket_bits;
+
+  /// The total number of buckets, which covers the full range of `uint64_t`.
+  static constexpr size_t num_buckets = (64 - sub_bucket_bits + 1)
+                                        << sub_bucket_bits;
+
+  /// The recorded values since the last snapshot.
+  struct snapshot {
+    /// @returns An upper bound for the *q*-quantile of the recorded values.
+    /// @param q The quantile in the range [0, 1].
+    /// @pre `count > 0`
+    uint64_t quantile(double q) const noexcept;
+
+    /// The number of values per bucket.
+    std::array<uint64_t, num_buckets> buckets = {};
+
+    /// The number of recorded values.
+    uint64_t count = 0;
+
+    /// The sum of all recorded values.
+    uint64_t sum = 0;
+  };
+
+  /// @returns The bucket that counts *x*.
+  static size_t bucket(uint64_t x) noexcept;
+
+  /// @returns The largest value that falls into bucket *i*.
+  static uint64_t upper_bound(size_t i) noexcept;
+
+  /// Records a single value.
+  void add(uint64_t x) noexcept {
+    auto& s = shards_[metric_shard()];
+    s.buckets[bucket(x)].fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  /// Records a single latency in nanoseconds.
+  void add(duration x) noexcept {
+    add(x.count() > 0 ? static_cast<uint64_t>(x.count()) : 0u);
+  }
+
+  /// Moves all values recorded since the last call into a snapshot.
+  snapshot take() noexcept;
+
+private:
+  struct alignas(64) shard {
+    std::array<std::atomic<uint64_t>, num_buckets> buckets = {};
+    std::atomic<uint64_t> sum = 0;
+  };
+
+  std::array<shard, metric_shards> shards_;
+};
+
+/// A registry of pre-registered metrics. Registration takes a lock, but all
+/// updates of a registered metric are lock-free and never allocate, which
+/// makes them cheap enough for the hot paths of indexers and sources. The
+/// ACCOUNTANT periodically takes a snapshot of the registry and forwards it
+/// to its sinks.
+/// @note Metrics are never unregistered, so their names should identify a
+/// kind of component rather than a single instance.
+class metrics_registry {
+public:
+  /// @returns The process-wide registry.
+  static metrics_registry& instance() noexcept;
+
+  /// Retrieves a counter, registering it if it does not exist yet.
+  /// @param name The key of the counter in the reports of the registry.
+  /// @returns A reference that remains valid for the lifetime of the
+  ///          registry.
+  counter_metric& make_counter(const std::string& name);
+
+  /// Retrieves a gauge, registering it if it does not exist yet.
+  /// @param name The key of the gauge in the reports of the registry.
+  /// @returns A reference that remains valid for the lifetime of the
+  ///          registry.
+  gauge_metric& make_gauge(const std::string& name);
+
+  /// Retrieves a histogram, registering it if it does not exist yet.
+  /// @param name The key prefix of the histogram in the reports of the
+  ///             registry.
+  /// @returns A reference that remains valid for the lifetime of the
+  ///          registry.
+  histogram_metric& make_histogram(const std::string& name);
+
+  /// Reports the current value of all counters and gauges, and summarizes
+  /// the values that all histograms recorded since the last snapshot as
+  /// `<name>.count`, `<name>.mean`, `<name>.p50`, `<name>.p99`, and
+  /// `<name>.max`. Histograms without new values do not appear in the
+  /// report.
+  report snapshot();
+
+private:
+  std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<counter_metric>> counters_;
+  std::map<std::string, std::unique_ptr<gauge_metric>> gauges_;
+  std::map<std::string, std::unique_ptr<histogram_metric>> histograms_;
+};
+
+} // namespace vast::system
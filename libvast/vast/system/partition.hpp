@@ -26,10 +26,12 @@
 #include "vast/system/evaluator.hpp"
 #include "vast/system/indexer.hpp"
 #include "vast/system/instrumentation.hpp"
+#include "vast/system/query_result_cache.hpp"
 #include "vast/table_slice_column.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 #include "vast/value_index.hpp"
+#include "vast/zone_map.hpp"
 
 #include <caf/optional.hpp>
 #include <caf/stream_slot.hpp>
@@ -100,6 +102,9 @@ struct active_partition_state {
   /// Options to be used when adding events to the partition_synopsis.
   caf::settings synopsis_opts;
 
+  /// The zone maps of all table slices in this partition.
+  std::vector<zone_map> zone_maps;
+
   /// A readable name for this partition
   std::string name;
 
@@ -150,7 +155,10 @@ struct passive_partition_state {
 
   // -- utility functions ------------------------------------------------------
 
-  indexer_actor indexer_at(size_t position) const;
+  /// Gets the value index at a certain position, deserializing it on first
+  /// access.
+  /// @returns The value index, or `nullptr` if it could not be deserialized.
+  const value_index* index_at(size_t position) const;
 
   // -- data members -----------------------------------------------------------
 
@@ -166,6 +174,10 @@ struct passive_partition_state {
   /// Maps type names to ids. Used the answer #type queries.
   std::unordered_map<std::string, ids> type_ids;
 
+  /// The zone maps of all table slices in this partition. Empty for
+  /// partitions written by older versions.
+  std::vector<zone_map> zone_maps;
+
   /// A readable name for this partition
   std::string name;
 
@@ -175,7 +187,8 @@ struct passive_partition_state {
   /// The number of events in the partition.
   size_t events;
 
-  /// The raw memory of the partition, used to spawn indexers on demand.
+  /// The raw memory of the partition, used to deserialize value indexes on
+  /// demand.
   chunk_ptr partition_chunk;
 
   /// Stores a list of expressions that could not be answered immediately.
@@ -186,9 +199,13 @@ struct passive_partition_state {
   /// A typed view into the `partition_chunk`.
   const fbs::partition::v0* flatbuffer;
 
-  /// Maps qualified fields to indexer actors. This is mutable since
-  /// indexers are spawned lazily on first access.
-  mutable std::vector<indexer_actor> indexers;
+  /// The value indexes in the order of the fields of `combined_layout`. This
+  /// is mutable since the value indexes are deserialized lazily on first
+  /// access.
+  mutable std::vector<value_index_ptr> indexes;
+
+  /// Caches the hits of evaluated expressions; may be `nullptr`.
+  std::shared_ptr<query_result_cache> cache;
 };
 
 // -- flatbuffers --------------------------------------------------------------
@@ -200,6 +217,15 @@ caf::error unpack(const fbs::partition::v0& x, passive_partition_state& y);
 
 caf::error unpack(const fbs::partition::v0& x, partition_synopsis& y);
 
+/// Selects the table slices of a partition that may contain events matching
+/// an expression.
+/// @param zone_maps The zone maps of the partition.
+/// @param expr The expression.
+/// @returns The IDs of the selected table slices, or `caf::none` if the
+///          partition has no zone maps.
+caf::optional<ids>
+select_slices(const std::vector<zone_map>& zone_maps, const expression& expr);
+
 // -- behavior -----------------------------------------------------------------
 
 /// Spawns a partition.
@@ -218,8 +244,11 @@ active_partition_actor::behavior_type active_partition(
 /// @param id The UUID of this partition.
 /// @param filesystem The actor handle of the filesystem actor.
 /// @param path The path where the partition flatbuffer can be found.
+/// @param cache The cache for the hits of evaluated expressions; may be
+///              `nullptr`.
 partition_actor::behavior_type passive_partition(
   partition_actor::stateful_pointer<passive_partition_state> self, uuid id,
-  filesystem_actor filesystem, vast::path path);
+  filesystem_actor filesystem, vast::path path,
+  std::shared_ptr<query_result_cache> cache);
 
 } // namespace vast::system
@@ -16,6 +16,7 @@
 #include "vast/fwd.hpp"
 
 #include "vast/expression.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/system/node.hpp"
 #include "vast/type.hpp"
 
@@ -58,8 +59,9 @@ struct pivoter_state {
   std::unordered_set<std::string> requested_ids;
 
   /// A cache for the connections between a source type and the target type,
-  /// to avoid multiple computations of those.
-  mutable std::unordered_map<record_type, caf::optional<record_field>> cache;
+  /// to avoid multiple computations of those. Keyed by layout fingerprint.
+  mutable std::unordered_map<layout_fingerprint, caf::optional<record_field>>
+    cache;
 
   /// A tracking counter of spawned exporters. Used for lifetime management.
   size_t running_exporters = 0;
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/atoms.hpp"
+#include "vast/path.hpp"
+#include "vast/system/filesystem_statistics.hpp"
+
+#include <caf/event_based_actor.hpp>
+#include <caf/expected.hpp>
+#include <caf/result.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vast::system {
+
+/// Advises the operating system to page in files ahead of reading them.
+/// Prefetching is only a hint, so files that cannot be advised on count as
+/// failed without failing the whole call.
+/// @param filenames The absolute paths of the files to prefetch.
+/// @returns Statistics about the prefetched files, or an error if the platform
+///          does not support posix_fadvise(2).
+caf::expected<filesystem_statistics::ops>
+prefetch_files(const std::vector<path>& filenames);
+
+/// Calls `prefetch_files` for a single request, and replies with the number
+/// of successful and failed files and the number of prefetched bytes.
+/// @param self The actor handle.
+caf::behavior prefetcher(caf::event_based_actor* self);
+
+/// Prefetches files in a detached PREFETCHER, so that opening and advising on
+/// many files does not block the FILESYSTEM actor, and adds the outcome to
+/// the statistics of the FILESYSTEM.
+/// @param self The FILESYSTEM actor handle.
+/// @param filenames The absolute paths of the files to prefetch.
+/// @returns A response promise that completes once all files are advised on.
+template <class Self>
+caf::result<atom::ok>
+prefetch_detached(Self self, std::vector<path> filenames) {
+  auto rp = self->template make_response_promise<atom::ok>();
+  auto worker = self->template spawn<caf::detached>(prefetcher);
+  self
+    ->request(worker, caf::infinite, atom::prefetch_v, std::move(filenames))
+    .then(
+      [self, rp](uint64_t successful, uint64_t failed,
+                 uint64_t bytes) mutable {
+        self->state.stats.prefetches
+          += filesystem_statistics::ops{successful, failed, bytes};
+        rp.deliver(atom::ok_v);
+      },
+      [rp](caf::error& err) mutable { rp.deliver(std::move(err)); });
+  return rp;
+}
+
+} // namespace vast::system
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/query_options.hpp"
+
+#include <caf/expected.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace vast::system {
+
+/// The order in which a query delivers its results.
+enum class query_order : uint8_t {
+  /// Results arrive in whatever order the partitions finish.
+  none,
+  /// Results arrive sorted by `:timestamp`, earliest first.
+  ascending,
+  /// Results arrive sorted by `:timestamp`, latest first.
+  descending,
+};
+
+/// Parses the name of a query order.
+/// @param str Either "asc" or "desc".
+/// @returns The order, or an error for an unknown name.
+caf::expected<query_order> to_query_order(std::string_view str);
+
+/// @returns The order that the options of a query request.
+query_order to_query_order(query_options opts);
+
+/// @relates query_order
+const char* to_string(query_order x);
+
+} // namespace vast::system
@@ -94,8 +94,9 @@ public:
 
   /// Sends the query `expr` to `index` and transitions from `idle` to
   /// `await_query_id`.
+  /// @param priority The priority class of the query.
   /// @pre `state() == idle`
-  void start(expression expr, index_actor index);
+  void start(expression expr, index_actor index, query_priority priority);
 
   /// @pre `state() == collect_hits`
   /// @pre `n > 0`
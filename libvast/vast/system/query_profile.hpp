@@ -0,0 +1,138 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/time.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/fwd.hpp>
+#include <caf/meta/type_name.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace vast::system {
+
+/// Statistics about the INDEXER lookups for a single predicate of a query.
+struct predicate_profile {
+  uint64_t lookups = 0; ///< Number of INDEXER lookups.
+  uint64_t hits = 0;    ///< Number of IDs that all lookups returned.
+  duration latency{};   ///< Accumulated latency of all lookups.
+};
+
+template <class Inspector>
+auto inspect(Inspector& f, predicate_profile& x) {
+  return f(caf::meta::type_name("predicate_profile"), x.lookups, x.hits,
+           x.latency);
+}
+
+/// A breakdown of the work that a query caused in every stage of the lookup
+/// path, from the META INDEX to the candidate check in the EXPORTER.
+struct query_profile {
+  uuid id = uuid::nil(); ///< The query ID that the INDEX assigned.
+  duration runtime{};    ///< Total runtime of the query.
+
+  // -- META INDEX -------------------------------------------------------------
+
+  uint64_t candidates = 0;      ///< Candidate partitions.
+  duration meta_index_lookup{}; ///< Time until the candidates arrived.
+
+  // -- partitions -------------------------------------------------------------
+
+  uint64_t partitions_evaluated = 0; ///< Partitions that evaluated the query.
+  uint64_t partitions_loaded = 0;    ///< Partitions loaded from disk.
+  uint64_t bytes_mapped = 0;         ///< Size of the evaluated partitions.
+
+  // -- INDEXER ----------------------------------------------------------------
+
+  /// Lookup statistics per predicate, keyed by its string representation.
+  std::map<std::string, predicate_profile> predicates;
+
+  // -- ARCHIVE ----------------------------------------------------------------
+
+  uint64_t slices_decoded = 0; ///< Table slices decoded from segments.
+  uint64_t rows_decoded = 0;   ///< Rows in the decoded table slices.
+  duration archive_lookup{};   ///< Time spent decoding table slices.
+
+  // -- EXPORTER ---------------------------------------------------------------
+
+  uint64_t rows_checked = 0;  ///< Candidate rows that the EXPORTER checked.
+  uint64_t rows_selected = 0; ///< Candidate rows that passed the check.
+  duration candidate_check{}; ///< Time spent in the candidate check.
+};
+
+template <class Inspector>
+auto inspect(Inspector& f, query_profile& x) {
+  return f(caf::meta::type_name("query_profile"), x.id, x.runtime,
+           x.candidates, x.meta_index_lookup, x.partitions_evaluated,
+           x.partitions_loaded, x.bytes_mapped, x.predicates, x.slices_decoded,
+           x.rows_decoded, x.archive_lookup, x.rows_checked, x.rows_selected,
+           x.candidate_check);
+}
+
+/// Converts a query profile into a record, e.g., for rendering it as JSON.
+/// @relates query_profile
+bool convert(const query_profile& x, data& y);
+
+/// Collects the profiles of all queries that run with the explain option.
+/// Every component on the lookup path contributes to the profile of a query
+/// via the handle of the EXPORTER that issued it, since that is the only
+/// piece of information that all components share. Collecting profiles
+/// requires that the components run in the same process as the EXPORTER.
+class query_profiler {
+public:
+  /// @returns The process-wide profiler.
+  static query_profiler& instance() noexcept;
+
+  /// Starts collecting a profile.
+  /// @param client The ID of the EXPORTER that issues the query.
+  void enable(caf::actor_id client);
+
+  /// Stops collecting a profile.
+  /// @param client The ID of the EXPORTER that issued the query.
+  /// @returns The profile collected so far.
+  query_profile take(caf::actor_id client);
+
+  /// @returns Whether there is at least one profile being collected. This is
+  /// a cheap check that allows for skipping expensive preparations when
+  /// nobody is interested in a profile.
+  bool active() const noexcept {
+    return active_.load(std::memory_order_relaxed) > 0;
+  }
+
+  /// Updates the profile of a query if its profile is being collected.
+  /// @param client The ID of the EXPORTER that issued the query.
+  /// @param f The function that updates the profile.
+  template <class F>
+  void update(caf::actor_id client, F&& f) {
+    if (!active())
+      return;
+    auto lock = std::unique_lock{mutex_};
+    if (auto it = profiles_.find(client); it != profiles_.end())
+      f(it->second);
+  }
+
+private:
+  std::atomic<size_t> active_ = 0;
+  std::mutex mutex_;
+  std::unordered_map<caf::actor_id, query_profile> profiles_;
+};
+
+} // namespace vast::system
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/ids.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/fwd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace vast::system {
+
+/// Caches the hits of normalized expressions per passive partition, so that
+/// repeated queries only need to evaluate partitions that changed since. The
+/// cache evicts the least recently used entries once its memory usage exceeds
+/// the configured capacity. All member functions are thread-safe, since the
+/// INDEX consults the cache while the PARTITION actors fill it.
+/// @note The cache relies on passive partitions being immutable: a partition
+/// that gets erased or merged into another must be invalidated explicitly.
+class query_result_cache {
+public:
+  /// Constructs a cache.
+  /// @param capacity The maximum memory usage in bytes.
+  explicit query_result_cache(size_t capacity);
+
+  /// Retrieves the hits of an expression in a partition.
+  /// @param partition The UUID of the partition.
+  /// @param expr The string representation of the normalized expression.
+  /// @returns The cached hits, or `std::nullopt` if there are none.
+  std::optional<ids> lookup(const uuid& partition, const std::string& expr);
+
+  /// @returns Whether the cache holds the hits of an expression in a
+  /// partition, without affecting the eviction order.
+  bool contains(const uuid& partition, const std::string& expr) const;
+
+  /// Stores the hits of an expression in a partition.
+  /// @param partition The UUID of the partition.
+  /// @param expr The string representation of the normalized expression.
+  /// @param hits The hits of *expr* in *partition*.
+  void insert(const uuid& partition, std::string expr, ids hits);
+
+  /// Drops all cached hits of a partition.
+  /// @param partition The UUID of the partition.
+  void invalidate(const uuid& partition);
+
+  /// @returns The number of cached entries.
+  size_t size() const;
+
+  /// @returns The approximate memory usage of the cached entries in bytes.
+  size_t memusage() const;
+
+  /// Adds statistics about the cache to a status object.
+  void inspect_status(caf::settings& xs) const;
+
+private:
+  using key_type = std::pair<uuid, std::string>;
+
+  struct entry {
+    key_type key;
+    ids hits;
+    size_t memusage;
+  };
+
+  using entry_list = std::list<entry>;
+
+  void evict();
+
+  void erase(entry_list::iterator it);
+
+  size_t capacity_;
+  size_t memusage_ = 0;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  mutable std::mutex mutex_;
+  /// The cached entries, with the most recently used at the front.
+  entry_list entries_;
+  /// Maps keys to entries, ordered by partition first to allow for efficient
+  /// invalidation.
+  std::map<key_type, entry_list::iterator> index_;
+};
+
+} // namespace vast::system
@@ -0,0 +1,128 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/system/actors.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/expected.hpp>
+#include <caf/fwd.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string_view>
+
+namespace vast::system {
+
+/// The priority class of a query.
+enum class query_priority : uint8_t {
+  /// Background queries, e.g., of the ERASER. They may occupy at most half of
+  /// the QUERY SUPERVISOR actors of the INDEX.
+  low,
+  /// The default for queries. Together with background queries, they leave
+  /// one QUERY SUPERVISOR actor for queries of a higher class.
+  normal,
+  /// Queries that the INDEX always schedules first.
+  high,
+};
+
+/// Parses the name of a query priority class.
+/// @param str One of "low", "normal", or "high".
+/// @returns The priority class, or an error for an unknown name.
+caf::expected<query_priority> to_query_priority(std::string_view str);
+
+/// @relates query_priority
+const char* to_string(query_priority x);
+
+/// A request for evaluating the next batch of partitions of a query.
+struct query_request {
+  /// The ID of the query.
+  uuid query_id;
+
+  /// The maximum number of partitions to evaluate.
+  uint32_t num_partitions;
+
+  /// The client that receives the hits.
+  index_client_actor client;
+
+  /// The priority class of the query.
+  query_priority priority;
+};
+
+/// Decides which query requests the INDEX hands to its QUERY SUPERVISOR
+/// actors. Requests of a higher priority class always go first, and requests
+/// of the same class run in the order of their arrival. Since every client
+/// has at most one batch of partitions in flight, this interleaves the
+/// batches of concurrent queries of the same class.
+class query_scheduler {
+public:
+  /// Constructs a scheduler.
+  /// @param max_workers The maximum number of concurrently running requests.
+  explicit query_scheduler(size_t max_workers);
+
+  /// Enqueues a request.
+  void push(query_request request);
+
+  /// Dequeues the oldest request of the highest priority class that did not
+  /// exhaust its share of the workers yet.
+  /// @returns The request, or `std::nullopt` if no request may run now.
+  std::optional<query_request> pop();
+
+  /// Marks a running request as finished.
+  /// @param priority The priority class of the request.
+  void release(query_priority priority);
+
+  /// Drops all queued requests of a query.
+  void drop(const uuid& query_id);
+
+  /// @returns The number of queued requests.
+  size_t queued() const;
+
+  /// @returns The number of running requests.
+  size_t running() const;
+
+  /// @returns The number of queued requests that could run now if there were
+  /// enough workers.
+  size_t runnable() const;
+
+  /// Adds statistics about the queued and running requests to a status
+  /// object.
+  void inspect_status(caf::settings& xs) const;
+
+private:
+  static constexpr size_t num_classes = 3;
+
+  /// @returns Whether another request of class *i* may run in addition to
+  /// the given number of running requests per class.
+  bool may_run(const std::array<size_t, num_classes>& running, size_t i) const;
+
+  size_t max_workers_;
+
+  /// The maximum number of concurrently running requests of a class and all
+  /// lower classes.
+  std::array<size_t, num_classes> limits_;
+
+  /// The number of running requests per class.
+  std::array<size_t, num_classes> running_ = {};
+
+  /// The queued requests per class.
+  std::array<std::deque<query_request>, num_classes> queues_;
+};
+
+} // namespace vast::system
@@ -31,6 +31,7 @@
 #include "vast/schema.hpp"
 #include "vast/system/actors.hpp"
 #include "vast/system/instrumentation.hpp"
+#include "vast/system/metrics.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/status_verbosity.hpp"
 #include "vast/table_slice.hpp"
@@ -87,8 +88,8 @@ struct source_state {
   /// Filters events, i.e., causes the source to drop all matching events.
   expression filter;
 
-  /// Maps types to the tailored filter.
-  std::unordered_map<type, expression> checkers;
+  /// Maps layout fingerprints to the tailored filter.
+  std::unordered_map<layout_fingerprint, expression> checkers;
 
   /// Actor for collecting statistics.
   accountant_actor accountant;
@@ -128,6 +129,12 @@ struct source_state {
   /// Current metrics for the accountant.
   measurement metrics;
 
+  /// Counts the events that all sources with the same reader produced.
+  counter_metric* events_metric = nullptr;
+
+  /// Tracks the latency of reading from the input.
+  histogram_metric* read_latency_metric = nullptr;
+
   /// The amount of time to wait until the next wakeup.
   std::chrono::milliseconds wakeup_delay = std::chrono::milliseconds::zero();
 
@@ -149,6 +156,10 @@ struct source_state {
     new (&reader) Reader(std::move(rd));
     name = reader.name();
     reader_initialized = true;
+    auto& registry = metrics_registry::instance();
+    auto prefix = "source." + std::string{name};
+    events_metric = &registry.make_counter(prefix + ".events");
+    read_latency_metric = &registry.make_histogram(prefix + ".read.latency");
     requested = std::move(max_events);
     local_schema = std::move(sch);
     accountant = std::move(acc);
@@ -263,11 +274,14 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
       auto events = num * self->state.table_slice_size;
       if (st.requested)
         events = std::min(events, *st.requested - st.count);
+      auto start = stopwatch::now();
       auto t = timer::start(st.metrics);
       auto [err, produced]
         = st.reader.read(events, self->state.table_slice_size, push_slice);
       VAST_DEBUG("{} read {} events", self, produced);
       t.stop(produced);
+      st.read_latency_metric->add(stopwatch::now() - start);
+      st.events_metric->add(produced);
       st.count += produced;
       auto finish = [&] {
         st.done = true;
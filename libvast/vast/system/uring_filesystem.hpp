@@ -0,0 +1,137 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/config.hpp"
+#include "vast/path.hpp"
+#include "vast/system/actors.hpp"
+#include "vast/system/filesystem_statistics.hpp"
+#include "vast/time.hpp"
+
+#include <caf/typed_event_based_actor.hpp>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace vast::system {
+
+/// A histogram of operation latencies with exponentially growing buckets.
+struct latency_histogram {
+  /// The number of buckets. Bucket *i* counts all operations that took less
+  /// than 2^i microseconds, and the last bucket counts all remaining ones.
+  static constexpr size_t num_buckets = 24;
+
+  /// Records a single operation.
+  /// @param latency The time the operation took.
+  void add(duration latency) noexcept;
+
+  /// The number of operations per bucket.
+  std::array<uint64_t, num_buckets> buckets = {};
+};
+
+/// Checks whether the running kernel supports io_uring.
+/// @returns `true` iff VAST was built with io_uring support and setting up a
+///          ring succeeds.
+bool has_uring() noexcept;
+
+#if VAST_ENABLE_URING
+
+/// The internal interface of the io_uring filesystem, which extends the
+/// FILESYSTEM actor with a message for reaping completed operations.
+using uring_filesystem_actor = typed_actor_fwd<
+  // Reaps completed operations.
+  caf::reacts_to<atom::internal, atom::resume>>
+  // Conform to the protocol of the FILESYSTEM actor.
+  ::extend_with<filesystem_actor>::unwrap;
+
+/// The state for the io_uring filesystem.
+/// @relates uring_filesystem
+struct uring_filesystem_state {
+  /// A read or write request that is currently in flight.
+  struct operation;
+
+  /// A single read or write of a part of an operation.
+  struct submission {
+    uint64_t operation;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  /// The io_uring instance.
+  struct ring;
+
+  uring_filesystem_state();
+  ~uring_filesystem_state() noexcept;
+
+  /// Statistics about filesystem operations.
+  filesystem_statistics stats;
+
+  /// Latencies of completed writes.
+  latency_histogram write_latencies;
+
+  /// Latencies of completed reads.
+  latency_histogram read_latencies;
+
+  /// The filesystem root.
+  path root;
+
+  /// The ring, or `nullptr` if it failed to initialize.
+  std::unique_ptr<ring> uring;
+
+  /// The number of submission queue entries.
+  size_t queue_depth = 0;
+
+  /// The submissions currently in the ring, keyed by a running id.
+  std::unordered_map<uint64_t, submission> in_flight;
+
+  /// The id of the next submission.
+  uint64_t next_submission = 0;
+
+  /// The highest number of submissions that were in the ring at once.
+  size_t max_in_flight = 0;
+
+  /// Submissions that did not fit into the ring yet.
+  std::deque<submission> backlog;
+
+  /// All operations that did not complete yet, keyed by a running id.
+  std::unordered_map<uint64_t, std::unique_ptr<operation>> operations;
+
+  /// The id of the next operation.
+  uint64_t next_operation = 0;
+
+  /// The actor name.
+  static inline const char* name = "uring-filesystem";
+};
+
+/// A filesystem that batches reads and writes through io_uring. Requests are
+/// split into blocks that are submitted to the ring together with those of
+/// all other pending requests, and large writes bypass the page cache.
+/// @param self The actor handle.
+/// @param root The filesystem root. The actor prepends this path to all
+///             operations that include a path parameter.
+/// @param queue_depth The number of submission queue entries.
+/// @returns The actor behavior.
+uring_filesystem_actor::behavior_type uring_filesystem(
+  uring_filesystem_actor::stateful_pointer<uring_filesystem_state> self,
+  path root, size_t queue_depth);
+
+#endif // VAST_ENABLE_URING
+
+} // namespace vast::system
@@ -16,12 +16,16 @@
 #include "vast/fwd.hpp"
 
 #include "vast/chunk.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/table_slice_encoding.hpp"
 #include "vast/type.hpp"
 #include "vast/view.hpp"
 
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/type_name.hpp>
+#include <caf/optional.hpp>
+
+#include <flatbuffers/flatbuffers.h>
 
 #include <cstddef>
 #include <vector>
@@ -64,7 +68,7 @@ public:
   /// @note Constructs an invalid table slice if the verification of the
   /// FlatBuffers table fails.
   explicit table_slice(chunk_ptr&& chunk, enum verify verify,
-                       record_type layout) noexcept;
+                       const record_type& layout) noexcept;
 
   /// Construct a table slice from a flattened table slice embedded in a chunk,
   /// and shares the chunk's lifetime.
@@ -115,6 +119,10 @@ public:
   /// @returns The table layout.
   const record_type& layout() const noexcept;
 
+  /// @returns The fingerprint of the table layout, which is equal for all
+  /// slices with the same layout and thus suitable as key for per-layout state.
+  layout_fingerprint layout_id() const noexcept;
+
   /// @returns The number of rows in the slice.
   size_type rows() const noexcept;
 
@@ -169,6 +177,8 @@ public:
   /// Returns an immutable view on the underlying binary representation of a
   /// table slice.
   /// @param slice The table slice to view.
+  /// @note For slices created by `select`, this is the binary representation
+  /// of the parent slice; use `materialize` before persisting such slices.
   friend span<const std::byte> as_bytes(const table_slice& slice) noexcept;
 
   /// Opt-in to CAF's type inspection API.
@@ -176,12 +186,36 @@ public:
   friend auto inspect(Inspector& f, table_slice& x) ->
     typename Inspector::result_type {
     auto chunk = x.chunk_;
+    auto view_begin = x.view_begin_;
+    auto view_end = x.view_end_;
+    // Slices that reference their layout by fingerprint ship the layout
+    // alongside, since the receiver may not have interned it yet.
+    auto layout = caf::optional<record_type>{};
+    if constexpr (Inspector::reads_state) {
+      // Views that cover only a small part of their parent ship a copy of
+      // their rows instead of the entire parent.
+      if (x.is_view() && x.rows() * 2 < x.parent_rows()) {
+        auto copy = materialize(x);
+        chunk = copy.chunk_;
+        view_begin = copy.view_begin_;
+        view_end = copy.view_end_;
+      } else if (x.chunk_ && !x.embeds_layout()) {
+        layout = x.layout();
+      }
+    }
     return f(caf::meta::type_name("vast.table_slice"), chunk, x.offset_,
+             view_begin, view_end, layout,
              caf::meta::load_callback([&]() noexcept -> caf::error {
                // When VAST allows for external tools to hook directly into the
                // table slice streams, this should be switched to verify if the
                // chunk is unique.
-               x = table_slice{std::move(chunk), table_slice::verify::no};
+               if (layout)
+                 x = table_slice{std::move(chunk), table_slice::verify::no,
+                                 *layout};
+               else
+                 x = table_slice{std::move(chunk), table_slice::verify::no};
+               x.view_begin_ = view_begin;
+               x.view_end_ = view_end;
                return caf::none;
              }));
   }
@@ -196,9 +230,17 @@ public:
   friend table_slice
   rebuild(table_slice slice, enum table_slice_encoding encoding) noexcept;
 
+  /// Creates a table slice that owns exactly the rows of a slice returned by
+  /// `select`, which otherwise shares the data of its parent.
+  /// @param slice The slice to materialize.
+  /// @returns `slice` if it does not share the data of a parent, or a copy of
+  /// its rows in the same encoding otherwise.
+  friend table_slice materialize(const table_slice& slice);
+
   /// Selects all rows in `slice` with event IDs in `selection` and appends
   /// produced table slices to `result`. Cuts `slice` into multiple slices if
-  /// `selection` produces gaps.
+  /// `selection` produces gaps. The produced slices are views that share the
+  /// data of `slice` rather than copies.
   /// @param result The container for appending generated table slices.
   /// @param slice The input table slice.
   /// @param selection ID set for selecting events from `slice`.
@@ -206,9 +248,31 @@ public:
   friend void select(std::vector<table_slice>& result, const table_slice& slice,
                      const ids& selection);
 
+  /// Adds a table slice to a builder as a nested buffer that references its
+  /// layout by fingerprint instead of embedding it. Segments store such slices
+  /// together with a dictionary of their layouts.
+  /// @param builder The builder for the enclosing buffer. This disables the
+  ///        deduplication of its vtables, because the nested buffer must not
+  ///        refer to memory outside of it.
+  /// @param slice The input table slice.
+  /// @returns The byte vector that holds the nested buffer.
+  /// @pre `slice.encoding() != table_slice_encoding::none`
+  friend flatbuffers::Offset<flatbuffers::Vector<uint8_t>>
+  pack_without_layout(flatbuffers::FlatBufferBuilder& builder,
+                      const table_slice& slice);
+
 private:
   // -- implementation details -------------------------------------------------
 
+  /// @returns Whether the underlying FlatBuffers table embeds the layout.
+  bool embeds_layout() const noexcept;
+
+  /// @returns Whether the slice is a view on a row range of its chunk.
+  bool is_view() const noexcept;
+
+  /// @returns The number of rows in the underlying FlatBuffers table.
+  size_type parent_rows() const noexcept;
+
   /// A pointer to the underlying chunk, which contains a `vast.fbs.TableSlice`
   /// FlatBuffers table.
   /// @note On construction and destruction, the ref-count of `chunk_` is used
@@ -223,6 +287,11 @@ private:
   /// slice do not contain the offset.
   id offset_ = invalid_id;
 
+  /// The row range `[view_begin_, view_end_)` of the underlying FlatBuffers
+  /// table that this slice refers to, or `[0, 0)` if it refers to all rows.
+  size_type view_begin_ = 0;
+  size_type view_end_ = 0;
+
   /// A pointer to the table slice state. As long as the layout cannot be
   /// represented from a FlatBuffers table directly, it is prohibitively
   /// expensive to deserialize the layout.
@@ -269,6 +338,16 @@ table_slice truncate(const table_slice& slice, size_t num_rows);
 std::pair<table_slice, table_slice>
 split(const table_slice& slice, size_t partition_point);
 
+/// Restricts a table slice to a subset of its columns.
+/// @param slice The input table slice.
+/// @param columns The flat indices of the columns to keep, in order.
+/// @returns A new table slice of the same encoding as *slice* that contains
+///          only *columns*, or an invalid table slice on failure.
+/// @pre `slice.encoding() != table_slice_encoding::none`
+/// @pre `!columns.empty()`
+table_slice
+project(const table_slice& slice, const std::vector<size_t>& columns);
+
 /// Counts the number of total rows of multiple table slices.
 /// @param slices The table slices to count.
 /// @returns The sum of rows across *slices*.
@@ -14,13 +14,17 @@
 #pragma once
 
 #include "vast/fwd.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/span.hpp"
 #include "vast/view.hpp"
 
 #include <caf/meta/type_name.hpp>
 #include <caf/ref_counted.hpp>
+#include <caf/variant.hpp>
 
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace vast {
 
@@ -33,6 +37,12 @@ public:
   /// The default size of the buffer that the builder works with.
   static constexpr size_t default_buffer_size = 8192;
 
+  /// A column of values with a statically known type for bulk appends.
+  using column_view
+    = caf::variant<span<const bool>, span<const integer>, span<const count>,
+                   span<const real>, span<const duration>, span<const time>,
+                   span<const std::string_view>, span<const address>>;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   /// Forbid default-construction.
@@ -76,6 +86,14 @@ public:
     }
   }
 
+  /// Appends a columnar batch of rows, given as one column of values per
+  /// field of the flattened layout, each with the same number of values.
+  /// Either all rows of the batch are appended or none.
+  /// @param columns The values of the columns in layout order.
+  /// @returns `true` on success.
+  /// @pre No row is partially added.
+  [[nodiscard]] bool append_columns(span<const column_view> columns);
+
   /// Constructs a table_slice from the currently accumulated state. After
   /// calling this function, implementations must reset their internal state
   /// such that subsequent calls to add will restart with a new table_slice.
@@ -97,6 +115,12 @@ public:
   /// @returns The table layout.
   const record_type& layout() const noexcept;
 
+  /// @returns The CAF-serialized table layout.
+  span<const std::byte> serialized_layout() const noexcept;
+
+  /// @returns The fingerprint of the table layout.
+  layout_fingerprint layout_id() const noexcept;
+
   /// @returns An identifier for the implementing class.
   virtual table_slice_encoding implementation_id() const noexcept = 0;
 
@@ -124,9 +148,28 @@ protected:
   /// @returns `true` on success.
   virtual bool add_impl(data_view x) = 0;
 
+  /// Appends a columnar batch whose columns match the layout. The default
+  /// implementation adds the batch row by row.
+  /// @param columns The values of the columns.
+  /// @returns `true` on success.
+  virtual bool append_columns_impl(span<const column_view> columns);
+
+  /// Checks whether a column of values matches the type of a column.
+  /// @param column The index of the column in the flattened layout.
+  /// @param xs The values of the column.
+  /// @returns `true` if *xs* can be appended to *column*.
+  bool is_compatible(size_t column, const column_view& xs) const;
+
 private:
   // -- implementation details -------------------------------------------------
   record_type layout_;
+
+  /// The layout in its serialized form, cached to avoid serializing it again
+  /// for every finished slice.
+  std::vector<char> serialized_layout_;
+
+  /// The fingerprint of `serialized_layout_`.
+  layout_fingerprint layout_id_;
 };
 
 // -- intrusive_ptr facade -----------------------------------------------------
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/aliases.hpp"
+#include "vast/qualified_record_field.hpp"
+#include "vast/synopsis.hpp"
+
+#include <caf/settings.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace vast {
+
+/// A zone map summarizes the contents of a single table slice inside a
+/// partition. Unlike a partition synopsis, it only keeps the cheap synopses
+/// that bound the values of a column, e.g., their minimum and maximum, and
+/// it has no synopses for string and address columns.
+struct zone_map {
+  /// The ID of the first event in the slice.
+  id offset = 0;
+
+  /// The number of events in the slice.
+  uint64_t events = 0;
+
+  /// Synopsis data structures for individual columns. Columns without a
+  /// synopsis may contain any value.
+  std::unordered_map<qualified_record_field, synopsis_ptr> field_synopses;
+
+  /// The columns with a synopsis that contain null values. The synopses do
+  /// not see null values, but null values satisfy negated predicates such as
+  /// `x != 42`.
+  std::unordered_set<qualified_record_field> fields_with_nulls;
+
+  // -- flatbuffer -------------------------------------------------------------
+
+  friend caf::expected<flatbuffers::Offset<fbs::zone_map::v0>>
+  pack(flatbuffers::FlatBufferBuilder& builder, const zone_map& x);
+
+  friend caf::error unpack(const fbs::zone_map::v0& x, zone_map& y);
+};
+
+/// Builds the zone map for a table slice.
+/// @param slice The table slice to summarize.
+/// @param synopsis_options The options used to create the synopses of the
+///        enclosing partition.
+/// @returns The zone map for *slice*.
+zone_map make_zone_map(const table_slice& slice,
+                       const caf::settings& synopsis_options);
+
+/// Checks whether the table slice described by a zone map may contain events
+/// that satisfy an expression. Like the meta index, this check is
+/// conservative: it never rules out a slice that contains matching events.
+/// @param zm The zone map of the slice.
+/// @param expr The expression to check.
+/// @returns `false` if the slice cannot contain matching events.
+bool may_match(const zone_map& zm, const expression& expr);
+
+} // namespace vast
@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "fixtures/mock_index.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/expression.hpp"
+#include "vast/system/query_scheduler.hpp"
+#include "vast/system/status_verbosity.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/uuid.hpp"
+
+#include <caf/config_value.hpp>
+#include <caf/typed_event_based_actor.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace vast;
+
+namespace fixtures {
+
+system::index_actor::behavior_type
+mock_index(system::index_actor::stateful_pointer<mock_index_state> self,
+           mock_index_handlers handlers) {
+  self->state.handlers = std::move(handlers);
+  // Query results are not part of the typed INDEX interface, so the handlers
+  // send them through the untyped actor handle.
+  auto anon_self = [self] {
+    return caf::actor_cast<caf::event_based_actor*>(self);
+  };
+  auto sender = [self] {
+    return caf::actor_cast<caf::actor>(self->current_sender());
+  };
+  return {
+    [=](atom::worker, system::query_supervisor_actor) {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::done, uuid) { FAIL("no mock implementation available"); },
+    [=](caf::stream<table_slice>) -> caf::inbound_stream_slot<table_slice> {
+      FAIL("no mock implementation available");
+    },
+    [=](system::accountant_actor) { FAIL("no mock implementation available"); },
+    [=](atom::status,
+        system::status_verbosity) -> caf::config_value::dictionary {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::subscribe, atom::flush, system::flush_listener_actor) {
+      FAIL("no mock implementation available");
+    },
+    [=](expression& expr, system::query_priority priority) {
+      if (!self->state.handlers.query)
+        FAIL("no mock implementation available");
+      self->state.handlers.query(anon_self(), sender(), expr, priority);
+    },
+    [=](expression&, system::query_priority, system::query_order) {
+      FAIL("no mock implementation available");
+    },
+    [=](const uuid& query_id, uint32_t n) {
+      if (!self->state.handlers.more_hits)
+        FAIL("no mock implementation available");
+      self->state.handlers.more_hits(anon_self(), sender(), query_id, n);
+    },
+    [=](atom::erase, uuid) -> ids { FAIL("no mock implementation available"); },
+    [=](atom::erase, expression& expr) -> ids {
+      if (!self->state.handlers.erase)
+        FAIL("no mock implementation available");
+      return self->state.handlers.erase(expr);
+    },
+    [=](atom::persist, atom::id) -> id {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::distinct, expression&, std::string&) -> uint64_t {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::internal, atom::flush) {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::merge, atom::candidate) -> caf::result<std::vector<uuid>, ids> {
+      FAIL("no mock implementation available");
+    },
+    [=](atom::merge, std::vector<uuid>&, std::vector<table_slice>&) -> uuid {
+      FAIL("no mock implementation available");
+    },
+  };
+}
+
+} // namespace fixtures
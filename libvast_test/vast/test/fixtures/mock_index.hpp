@@ -0,0 +1,62 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/fwd.hpp"
+
+#include "vast/ids.hpp"
+#include "vast/system/actors.hpp"
+
+#include <caf/actor.hpp>
+#include <caf/event_based_actor.hpp>
+
+#include <cstdint>
+#include <functional>
+
+namespace fixtures {
+
+/// The parts of the INDEX interface that tests can mock. Every handler
+/// receives the mock INDEX and the sender of the message. Messages without a
+/// handler fail the test.
+struct mock_index_handlers {
+  /// Handles a new query.
+  std::function<void(caf::event_based_actor*, const caf::actor&,
+                     vast::expression&, vast::system::query_priority)>
+    query = {};
+
+  /// Handles a request for more hits of a query.
+  std::function<void(caf::event_based_actor*, const caf::actor&,
+                     const vast::uuid&, uint32_t)>
+    more_hits = {};
+
+  /// Handles a request to erase all partitions that lie entirely within an
+  /// expression.
+  std::function<vast::ids(vast::expression&)> erase = {};
+};
+
+/// The state of a mock INDEX.
+struct mock_index_state {
+  static inline constexpr const char* name = "mock-index";
+
+  mock_index_handlers handlers;
+};
+
+/// A mock INDEX for testing the actors that query it.
+/// @param self The actor handle.
+/// @param handlers The implemented parts of the INDEX interface.
+vast::system::index_actor::behavior_type
+mock_index(vast::system::index_actor::stateful_pointer<mock_index_state> self,
+           mock_index_handlers handlers);
+
+} // namespace fixtures
@@ -21,6 +21,7 @@
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/utils.hpp"
 #include "vast/ids.hpp"
+#include "vast/layout_interner.hpp"
 #include "vast/io/read.hpp"
 #include "vast/path.hpp"
 #include "vast/qualified_record_field.hpp"
@@ -447,6 +448,19 @@ void print_segment_v0(const vast::fbs::segment::v0* segment,
   std::cout << indent << "uuid: " << to_string(id) << "\n";
   std::cout << indent << "events: " << segment->events() << "\n";
   if (formatting.verbosity >= output_verbosity::verbose) {
+    // Table slices may reference their layout in the layout dictionary of the
+    // segment, which we need to intern before accessing the slices.
+    if (auto layouts = segment->layouts()) {
+      for (auto layout : *layouts) {
+        if (!layout->layout())
+          continue;
+        auto serialized_layout = vast::span<const std::byte>{
+          reinterpret_cast<const std::byte*>(layout->layout()->data()),
+          layout->layout()->size()};
+        vast::layout_interner::instance().intern(layout->id(),
+                                                 serialized_layout);
+      }
+    }
     std::cout << indent << "table_slices:\n";
     indented_scope _(indent);
     size_t total_size = 0;
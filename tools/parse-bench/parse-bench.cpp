@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+// Compares the throughput of the generic field parsers of the CSV and Zeek
+// readers with the specialized field parser.
+//
+// usage: parse-bench [iterations]
+
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
+#include "vast/data.hpp"
+#include "vast/format/field_parser.hpp"
+#include "vast/format/zeek.hpp"
+#include "vast/type.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace vast;
+using namespace vast::format;
+
+namespace {
+
+using iterator_type = field_parser::iterator_type;
+
+struct workload {
+  const char* name;
+  type t;
+  field_parser::dialect dialect;
+  field_parser::rule_type generic;
+  std::vector<std::string> fields;
+};
+
+// Generates a deterministic set of inputs for every workload.
+std::vector<std::string> generate(size_t n, std::string (*f)(size_t)) {
+  std::vector<std::string> result;
+  result.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    result.push_back(f(i));
+  return result;
+}
+
+template <class F>
+double measure(size_t iterations, const std::vector<std::string>& fields,
+               F parse) {
+  auto start = std::chrono::steady_clock::now();
+  data x;
+  for (size_t i = 0; i < iterations; ++i)
+    for (auto& field : fields)
+      if (!parse(std::string_view{field}, x)) {
+        std::cerr << "failed to parse " << field << std::endl;
+        std::exit(1);
+      }
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed = stop - start;
+  return static_cast<double>(iterations * fields.size()) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+  constexpr size_t num_fields = 10'000;
+  auto zeek_rule = [](const type& t) {
+    return zeek::make_zeek_parser<iterator_type>(t);
+  };
+  auto csv_time = field_parser::rule_type{
+    parsers::time ->* [](time x) { return x; }};
+  std::vector<workload> workloads;
+  workloads.push_back({"count", count_type{}, field_parser::dialect::zeek,
+                       zeek_rule(count_type{}),
+                       generate(num_fields, [](size_t i) {
+                         return std::to_string(i * 7919);
+                       })});
+  workloads.push_back({"integer", integer_type{}, field_parser::dialect::zeek,
+                       zeek_rule(integer_type{}),
+                       generate(num_fields, [](size_t i) {
+                         return std::to_string(static_cast<int64_t>(i) - 5000);
+                       })});
+  workloads.push_back({"real", real_type{}, field_parser::dialect::zeek,
+                       zeek_rule(real_type{}),
+                       generate(num_fields, [](size_t i) {
+                         auto frac = std::to_string(i % 97);
+                         return std::to_string(i) + "." + frac;
+                       })});
+  workloads.push_back({"epoch time", time_type{}, field_parser::dialect::zeek,
+                       zeek_rule(time_type{}),
+                       generate(num_fields, [](size_t i) {
+                         return std::to_string(1258531221 + i) + ".486539";
+                       })});
+  workloads.push_back({"iso 8601 time", time_type{}, field_parser::dialect::csv,
+                       csv_time, generate(num_fields, [](size_t i) {
+                         auto secs = std::to_string(10 + i % 50);
+                         return "2011-08-12T14:59:" + secs + ".994970Z";
+                       })});
+  workloads.push_back({"ipv4 address", address_type{},
+                       field_parser::dialect::zeek, zeek_rule(address_type{}),
+                       generate(num_fields, [](size_t i) {
+                         return "192.168." + std::to_string(i / 256 % 256) + "."
+                                + std::to_string(i % 256);
+                       })});
+  workloads.push_back({"ipv6 address", address_type{},
+                       field_parser::dialect::zeek, zeek_rule(address_type{}),
+                       generate(num_fields, [](size_t i) {
+                         return "fe80::219:e3ff:fee7:" + std::to_string(i);
+                       })});
+  std::cout << std::left << std::setw(16) << "workload" << std::right
+            << std::setw(16) << "generic/s" << std::setw(16) << "fast/s"
+            << std::setw(10) << "speedup" << '\n';
+  for (auto& w : workloads) {
+    auto generic = measure(iterations, w.fields,
+                           [&](std::string_view field, data& x) {
+                             return w.generic(field, x);
+                           });
+    auto p = field_parser{w.t, w.dialect, w.generic};
+    auto fast = measure(iterations, w.fields,
+                        [&](std::string_view field, data& x) {
+                          return p.parse(field, x);
+                        });
+    std::cout << std::left << std::setw(16) << w.name << std::right
+              << std::fixed << std::setprecision(0) << std::setw(16)
+              << generic << std::setw(16) << fast << std::setprecision(2)
+              << std::setw(9) << fast / generic << "x\n";
+  }
+  return 0;
+}